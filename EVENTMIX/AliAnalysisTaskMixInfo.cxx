@@ -229,12 +229,18 @@ void AliAnalysisTaskMixInfo::PrintEventInfo()
       TObjArrayIter next(fInputEHMix->GetEventPool()->GetListOfEventCuts());
       AliMixEventCutObj *cut;
       AliInputEventHandler *ihMain = fInputEHMain->GetFirstInputEventHandler();
-      AliMultiInputEventHandler *ihMultiMix = fInputEHMix->GetFirstMultiInputHandler();
-      AliInputEventHandler *ihMix = 0;
-      if (ihMultiMix) ihMix = ihMultiMix->GetFirstInputEventHandler();
-      if (!ihMix) return;
+      // mixed event from event pool memory in in-memory mode
+      AliMixEventPool *evPool = fInputEHMix->GetEventPool();
+      AliVEvent *evMix = (evPool && evPool->IsInMemory()) ? fInputEHMix->GetMixedEvent() : 0;
+      if (!evMix) {
+         AliMultiInputEventHandler *ihMultiMix = fInputEHMix->GetFirstMultiInputHandler();
+         AliInputEventHandler *ihMix = 0;
+         if (ihMultiMix) ihMix = ihMultiMix->GetFirstInputEventHandler();
+         if (!ihMix) return;
+         evMix = ihMix->GetEvent();
+      }
       while ((cut = (AliMixEventCutObj *) next())) {
-         cut->PrintValues(ihMain->GetEvent(), ihMix->GetEvent());
+         cut->PrintValues(ihMain->GetEvent(), evMix);
       }
    }
 }
@@ -8,6 +8,8 @@
 //          Martin Vala (martin.vala@cern.ch)
 //
 
+#include <TMath.h>
+
 #include "AliLog.h"
 #include "AliESDEvent.h"
 #include "AliAODEvent.h"
@@ -27,7 +29,8 @@ AliMixEventCutObj::AliMixEventCutObj(AliMixEventCutObj::EEPAxis_t type, Float_t
    fCutMax(max),
    fCutStep(step),
    fCutSmallVal(0),
-   fCurrentVal(min)
+   fCurrentVal(min),
+   fBinEdges()
 {
    //
    // Default constructor
@@ -45,7 +48,8 @@ AliMixEventCutObj::AliMixEventCutObj(const AliMixEventCutObj &obj) : TObject(obj
    fCutMax(obj.fCutMax),
    fCutStep(obj.fCutStep),
    fCutSmallVal(obj.fCutSmallVal),
-   fCurrentVal(obj.fCurrentVal)
+   fCurrentVal(obj.fCurrentVal),
+   fBinEdges(obj.fBinEdges)
 {
    //
    // Copy constructor
@@ -69,6 +73,7 @@ AliMixEventCutObj &AliMixEventCutObj::operator=(const AliMixEventCutObj &obj)
       fCutStep = obj.fCutStep;
       fCutSmallVal = obj.fCutSmallVal;
       fCurrentVal = obj.fCurrentVal;
+      fBinEdges = obj.fBinEdges;
 //       fNoMore = obj.fNoMore;
    }
    return *this;
@@ -147,6 +152,38 @@ Int_t AliMixEventCutObj::GetBinNumber(Float_t num) const
    return -1;
 }
 
+//_________________________________________________________________________________________________
+Int_t AliMixEventCutObj::GetBinNumberDirect(Float_t num) const
+{
+   //
+   // Returns bin (index) number in current cut, same as GetBinNumber,
+   // found by binary search in the bin edges (see InitBinEdges).
+   // Returns -1 in case of out of range
+   //
+   Int_t nBins = fBinEdges.GetSize();
+   if (nBins < 1) return GetBinNumber(num);
+   Int_t binNum = TMath::BinarySearch(nBins, fBinEdges.GetArray(), num);
+   if (binNum < 0) return -1;
+   if (num < fBinEdges[binNum] + fCutStep - fCutSmallVal) return binNum + 1;
+   return -1;
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventCutObj::InitBinEdges()
+{
+   //
+   // Stores the lower bin edges, computed as in GetBinNumber
+   // (the last bin can be partial)
+   //
+   fBinEdges.Set(0);
+   if (fCutStep < 1e-5) return;
+   Int_t nBins = 0;
+   for (Float_t iCurrent = fCutMin; iCurrent < fCutMax; iCurrent += fCutStep) nBins++;
+   fBinEdges.Set(nBins);
+   nBins = 0;
+   for (Float_t iCurrent = fCutMin; iCurrent < fCutMax; iCurrent += fCutStep) fBinEdges.SetAt(iCurrent, nBins++);
+}
+
 //_________________________________________________________________________________________________
 Int_t AliMixEventCutObj::GetIndex(AliVEvent *ev)
 {
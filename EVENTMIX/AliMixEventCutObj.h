@@ -13,6 +13,7 @@
 
 #include <TObject.h>
 #include <TString.h>
+#include <TArrayF.h>
 
 class AliVEvent;
 class AliAODEvent;
@@ -43,6 +44,9 @@ public:
    Float_t     GetStep() const { return fCutStep; }
    Short_t     GetType() const { return fCutType; }
    Int_t       GetBinNumber(Float_t num) const;
+   Int_t       GetBinNumberDirect(Float_t num) const;
+   Int_t       GetNumberOfBinsDirect() const { return fBinEdges.GetSize(); }
+   void        InitBinEdges();
    Int_t       GetIndex(AliVEvent *ev);
    Double_t    GetValue(AliVEvent *ev);
    Double_t    GetValue(AliESDEvent *ev);
@@ -64,7 +68,9 @@ private:
 
    Float_t     fCurrentVal;    // current value
 
-   ClassDef(AliMixEventCutObj, 3)
+   TArrayF     fBinEdges;      //! lower bin edges used by GetBinNumberDirect
+
+   ClassDef(AliMixEventCutObj, 4)
 };
 
 #endif
@@ -11,6 +11,9 @@
 #include <TEntryList.h>
 
 #include "AliLog.h"
+#include "AliVEvent.h"
+#include "AliESDEvent.h"
+#include "AliAODEvent.h"
 #include "AliMixEventCutObj.h"
 
 #include "AliMixEventPool.h"
@@ -23,7 +26,15 @@ AliMixEventPool::AliMixEventPool(const char *name, const char *title) : TNamed(n
    fListOfEventCuts(),
    fBinNumber(0),
    fBufferSize(0),
-   fMixNumber(0)
+   fMixNumber(0),
+   fPoolMode(kEntryList),
+   fInMemoryDepth(0),
+   fNumberOfBins(0),
+   fBinStride(),
+   fEventBuffer(),
+   fEventBufferEntry(),
+   fEventBufferHead(),
+   fEventBufferCount()
 {
    //
    // Default constructor.
@@ -37,7 +48,15 @@ AliMixEventPool::AliMixEventPool(const AliMixEventPool &obj) : TNamed(obj),
    fListOfEventCuts(obj.fListOfEventCuts),
    fBinNumber(obj.fBinNumber),
    fBufferSize(obj.fBufferSize),
-   fMixNumber(obj.fMixNumber)
+   fMixNumber(obj.fMixNumber),
+   fPoolMode(obj.fPoolMode),
+   fInMemoryDepth(obj.fInMemoryDepth),
+   fNumberOfBins(0),
+   fBinStride(),
+   fEventBuffer(),
+   fEventBufferEntry(),
+   fEventBufferHead(),
+   fEventBufferCount()
 {
    //
    // Copy constructor
@@ -59,6 +78,11 @@ AliMixEventPool &AliMixEventPool::operator=(const AliMixEventPool &obj)
       fBinNumber = obj.fBinNumber;
       fBufferSize = obj.fBufferSize;
       fMixNumber = obj.fMixNumber;
+      fPoolMode = obj.fPoolMode;
+      fInMemoryDepth = obj.fInMemoryDepth;
+      // buffered events are not copied
+      ResetEventBuffers();
+      fNumberOfBins = 0;
    }
    return *this;
 }
@@ -71,6 +95,7 @@ AliMixEventPool::~AliMixEventPool()
    // Destructor
    //
    AliDebug(AliLog::kDebug + 5, "<-");
+   ResetEventBuffers();
    AliDebug(AliLog::kDebug + 5, "->");
 }
 //_________________________________________________________________________________________________
@@ -99,6 +124,12 @@ void AliMixEventPool::Print(const Option_t *option) const
       el = (TEntryList *) fListOfEntryList.At(i);
       AliDebug(AliLog::kDebug, Form("EntryList[%d] %lld", i, el->GetN()));
    }
+   if (fPoolMode == kInMemory) {
+      AliDebug(AliLog::kDebug, Form("InMemory depth=%d bins=%d", fInMemoryDepth, fNumberOfBins));
+      for (Int_t i = 0; i < fNumberOfBins; i++) {
+         AliDebug(AliLog::kDebug, Form("EventBuffer[%d] %d", i, fEventBufferCount.At(i)));
+      }
+   }
 }
 //_________________________________________________________________________________________________
 Int_t AliMixEventPool::Init()
@@ -107,10 +138,14 @@ Int_t AliMixEventPool::Init()
    // Init event pool
    //
    AliDebug(AliLog::kDebug + 5, "<-");
-   CreateEntryListsRecursivly(fListOfEventCuts.GetEntries() - 1);
-   fBinNumber++;
-   AliDebug(AliLog::kDebug, Form("fBinnumber = %d", fBinNumber));
-   AddEntryList();
+   // entry lists are filled also in in-memory mode (GetListOfEntryLists)
+   if (fListOfEntryList.GetEntries() == 0) {
+      CreateEntryListsRecursivly(fListOfEventCuts.GetEntries() - 1);
+      fBinNumber++;
+      AliDebug(AliLog::kDebug, Form("fBinnumber = %d", fBinNumber));
+      AddEntryList();
+   }
+   if (fPoolMode == kInMemory) InitEventBuffers();
    AliDebug(AliLog::kDebug + 5, "->");
    return 0;
 }
@@ -289,3 +324,147 @@ Bool_t AliMixEventPool::SetCutValuesFromBinIndex(Int_t index)
 
    return kTRUE;
 }
+
+//_________________________________________________________________________________________________
+void AliMixEventPool::InitEventBuffers()
+{
+   //
+   // Computes strides of flat bin index and allocates ring buffers
+   // (used only in in-memory mode)
+   //
+   AliDebug(AliLog::kDebug + 5, "<-");
+   ResetEventBuffers();
+   Int_t numCuts = fListOfEventCuts.GetEntriesFast();
+   fBinStride.Set(numCuts);
+   fNumberOfBins = (numCuts > 0) ? 1 : 0;
+   AliMixEventCutObj *cut;
+   for (Int_t i = 0; i < numCuts; i++) {
+      cut = (AliMixEventCutObj *) fListOfEventCuts.At(i);
+      fBinStride.SetAt(fNumberOfBins, i);
+      // same bins as GetBinNumber (including partial last bin)
+      cut->InitBinEdges();
+      if (cut->GetNumberOfBinsDirect() < 1) {
+         AliError(Form("Cut %s has no bins !!!", cut->GetCutName()));
+         fNumberOfBins = 0;
+         break;
+      }
+      fNumberOfBins *= cut->GetNumberOfBinsDirect();
+   }
+   if (fInMemoryDepth < 1) fInMemoryDepth = 1;
+   Int_t nSlots = fNumberOfBins * fInMemoryDepth;
+   fEventBuffer.Expand(nSlots);
+   fEventBufferEntry.Set(nSlots);
+   fEventBufferEntry.Reset(-1);
+   fEventBufferHead.Set(fNumberOfBins);
+   fEventBufferHead.Reset();
+   fEventBufferCount.Set(fNumberOfBins);
+   fEventBufferCount.Reset();
+   AliDebug(AliLog::kDebug, Form("fNumberOfBins = %d depth = %d", fNumberOfBins, fInMemoryDepth));
+   AliDebug(AliLog::kDebug + 5, "->");
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventPool::ResetEventBuffers()
+{
+   //
+   // Deletes all buffered events
+   //
+   fEventBuffer.Delete();
+   fEventBufferEntry.Reset(-1);
+   fEventBufferHead.Reset();
+   fEventBufferCount.Reset();
+}
+
+//_________________________________________________________________________________________________
+Int_t AliMixEventPool::FindBinIndex(AliVEvent *ev)
+{
+   //
+   // Returns flat bin index (starting from 0) computed directly from cut binning.
+   // First cut is the fastest running index (same ordering as SetCutValuesFromBinIndex).
+   // Returns -1 when event is out of range
+   //
+   if (!ev || fNumberOfBins < 1) return -1;
+   Int_t numCuts = fListOfEventCuts.GetEntriesFast();
+   Int_t index = 0, bin;
+   AliMixEventCutObj *cut;
+   for (Int_t i = 0; i < numCuts; i++) {
+      cut = (AliMixEventCutObj *) fListOfEventCuts.At(i);
+      bin = cut->GetBinNumberDirect(cut->GetValue(ev));
+      if (bin < 1) return -1;
+      index += (bin - 1) * fBinStride.At(i);
+   }
+   return index;
+}
+
+//_________________________________________________________________________________________________
+Bool_t AliMixEventPool::AddEvent(AliVEvent *ev, Long64_t entry, Int_t binIndex)
+{
+   //
+   // Stores copy of event in ring buffer of bin binIndex.
+   // Oldest event is dropped when buffer is full. The event objects of the
+   // buffer are allocated once and the following events are copied into them
+   //
+   if (!ev || binIndex < 0 || binIndex >= fNumberOfBins) return kFALSE;
+   Int_t head = fEventBufferHead.At(binIndex);
+   Int_t slot = binIndex * fInMemoryDepth + head;
+   if (!CopyEvent(ev, fEventBuffer.At(slot))) {
+      delete fEventBuffer.At(slot);
+      fEventBuffer.AddAt(ev->Clone(), slot);
+   }
+   fEventBufferEntry.SetAt(entry, slot);
+   fEventBufferHead.SetAt((head + 1) % fInMemoryDepth, binIndex);
+   if (fEventBufferCount.At(binIndex) < fInMemoryDepth) fEventBufferCount.SetAt(fEventBufferCount.At(binIndex) + 1, binIndex);
+   AliDebug(AliLog::kDebug, Form("Entry %lld was added to bin %d (%d events)", entry, binIndex, fEventBufferCount.At(binIndex)));
+   return kTRUE;
+}
+
+//_________________________________________________________________________________________________
+Bool_t AliMixEventPool::CopyEvent(AliVEvent *ev, TObject *target) const
+{
+   //
+   // Copies event into already allocated buffered event of same type.
+   // Returns kFALSE when target has to be (re)created
+   //
+   if (!target || target->IsA() != ev->IsA()) return kFALSE;
+   if (ev->IsA() == AliESDEvent::Class()) {
+      *((AliESDEvent *) target) = *((AliESDEvent *) ev);
+      return kTRUE;
+   }
+   if (ev->IsA() == AliAODEvent::Class()) {
+      *((AliAODEvent *) target) = *((AliAODEvent *) ev);
+      return kTRUE;
+   }
+   return kFALSE;
+}
+
+//_________________________________________________________________________________________________
+Int_t AliMixEventPool::GetNumberOfEventsInBin(Int_t binIndex) const
+{
+   //
+   // Returns number of buffered events in bin
+   //
+   if (binIndex < 0 || binIndex >= fNumberOfBins) return 0;
+   return fEventBufferCount.At(binIndex);
+}
+
+//_________________________________________________________________________________________________
+AliVEvent *AliMixEventPool::GetEvent(Int_t binIndex, Int_t i) const
+{
+   //
+   // Returns i-th buffered event in bin (i=0 is the most recent one)
+   //
+   if (i < 0 || i >= GetNumberOfEventsInBin(binIndex)) return 0;
+   Int_t pos = (fEventBufferHead.At(binIndex) - 1 - i + fInMemoryDepth) % fInMemoryDepth;
+   return (AliVEvent *) fEventBuffer.At(binIndex * fInMemoryDepth + pos);
+}
+
+//_________________________________________________________________________________________________
+Long64_t AliMixEventPool::GetEventEntry(Int_t binIndex, Int_t i) const
+{
+   //
+   // Returns chain entry of i-th buffered event in bin (i=0 is the most recent one)
+   //
+   if (i < 0 || i >= GetNumberOfEventsInBin(binIndex)) return -1;
+   Int_t pos = (fEventBufferHead.At(binIndex) - 1 - i + fInMemoryDepth) % fInMemoryDepth;
+   return fEventBufferEntry.At(binIndex * fInMemoryDepth + pos);
+}
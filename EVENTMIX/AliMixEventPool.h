@@ -12,6 +12,8 @@
 #define ALIMIXEVENTPOOL_H
 
 #include <TObjArray.h>
+#include <TArrayI.h>
+#include <TArrayL64.h>
 #include <TNamed.h>
 
 class TEntryList;
@@ -19,6 +21,8 @@ class AliMixEventCutObj;
 class AliVEvent;
 class AliMixEventPool : public TNamed {
 public:
+   enum EPoolMode { kEntryList = 0, kInMemory = 1 };
+
    AliMixEventPool(const char *name = "mixEventPool", const char *title = "Mix event pool");
    AliMixEventPool(const AliMixEventPool &obj);
    AliMixEventPool &operator= (const AliMixEventPool &obj);
@@ -39,7 +43,7 @@ public:
 
    void        AddCut(AliMixEventCutObj *cut);
 
-   Bool_t      NeedInit() { return (fListOfEntryList.GetEntries() == 0); }
+   Bool_t      NeedInit() { return (fListOfEntryList.GetEntries() == 0) || (fPoolMode == kInMemory && fNumberOfBins == 0); }
    TObjArray  *GetListOfEntryLists() { return &fListOfEntryList; }
    TObjArray  *GetListOfEventCuts() { return &fListOfEventCuts; }
 
@@ -49,6 +53,19 @@ public:
    Int_t       GetBufferSize() const { return fBufferSize; }
    Int_t       GetMixNumber() const { return fMixNumber; }
 
+   // in-memory mode (flat bin index + ring buffer of events per bin)
+   void        SetInMemory(Int_t depth) { fPoolMode = (depth > 0) ? kInMemory : kEntryList; fInMemoryDepth = depth; }
+   Bool_t      IsInMemory() const { return (fPoolMode == kInMemory); }
+   Int_t       GetInMemoryDepth() const { return fInMemoryDepth; }
+   Int_t       GetNumberOfBins() const { return fNumberOfBins; }
+
+   Int_t       FindBinIndex(AliVEvent *ev);
+   Bool_t      AddEvent(AliVEvent *ev, Long64_t entry, Int_t binIndex);
+   Int_t       GetNumberOfEventsInBin(Int_t binIndex) const;
+   AliVEvent  *GetEvent(Int_t binIndex, Int_t i) const;
+   Long64_t    GetEventEntry(Int_t binIndex, Int_t i) const;
+   void        ResetEventBuffers();
+
 private:
 
    TObjArray   fListOfEntryList;       // list of entry lists
@@ -58,7 +75,20 @@ private:
    Int_t       fBufferSize;            // buffer size
    Int_t       fMixNumber;             // mixing number
 
-   ClassDef(AliMixEventPool, 1)
+   Int_t       fPoolMode;              // pool mode (see EPoolMode)
+   Int_t       fInMemoryDepth;         // number of events kept per bin in in-memory mode
+
+   Int_t       fNumberOfBins;          //! number of bins (in-memory mode)
+   TArrayI     fBinStride;             //! stride of each cut in flat bin index
+   TObjArray   fEventBuffer;           //! ring buffers of events (fNumberOfBins x fInMemoryDepth)
+   TArrayL64   fEventBufferEntry;      //! chain entry of buffered events
+   TArrayI     fEventBufferHead;       //! next slot to be written in each bin
+   TArrayI     fEventBufferCount;      //! number of buffered events in each bin
+
+   void        InitEventBuffers();
+   Bool_t      CopyEvent(AliVEvent *ev, TObject *target) const;
+
+   ClassDef(AliMixEventPool, 2)
 };
 
 #endif
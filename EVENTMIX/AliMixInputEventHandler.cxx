@@ -11,6 +11,10 @@
 #include <TChain.h>
 #include <TChainElement.h>
 #include <TSystem.h>
+#include <TMath.h>
+#include <TClass.h>
+#include <TBaseClass.h>
+#include <TObjString.h>
 
 #include "AliLog.h"
 #include "AliAnalysisManager.h"
@@ -43,12 +47,16 @@ AliMixInputEventHandler::AliMixInputEventHandler(const Int_t size, const Int_t m
    fCurrentBinIndex(-1),
    fOfflineTriggerMask(0),
    fCurrentMixEntry(),
-   fCurrentEntryMainTree(0)
+   fCurrentEntryMainTree(0),
+   fCurrentMixEvent(0),
+   fInMemoryTasks(),
+   fInMemoryChecked(kFALSE)
 {
    //
    // Default constructor.
    //
    AliDebug(AliLog::kDebug + 10, "<-");
+   fInMemoryTasks.SetOwner(kTRUE);
    SetMixNumber(mixNum);
    AliDebug(AliLog::kDebug + 10, "->");
 }
@@ -195,6 +203,10 @@ Bool_t AliMixInputEventHandler::GetEntry()
    if (!fEventPool) {
       MixStd();
    }
+   // events are served from event pool memory
+   else if (fEventPool->IsInMemory() && CheckInMemoryTasks()) {
+      MixInMemory();
+   }
    // if buffer size is higher then 1
    else if (fBufferSize > 1) {
       MixBuffer();
@@ -495,6 +507,72 @@ Bool_t AliMixInputEventHandler::MixEventsMoreTimesWithBuffer()
    return kFALSE;
 }
 
+//_____________________________________________________________________________
+Bool_t AliMixInputEventHandler::MixInMemory()
+{
+   //
+   // Mix with events kept in memory of event pool (no entry lists, no chain re-read)
+   //
+   AliDebug(AliLog::kDebug + 5, "<-");
+   AliDebug(AliLog::kDebug + 1, "Mix method");
+   // get correct handler
+   AliAnalysisManager *mgr = AliAnalysisManager::GetAnalysisManager();
+   AliMultiInputEventHandler *mh = dynamic_cast<AliMultiInputEventHandler *>(mgr->GetInputEventHandler());
+   AliInputEventHandler *inEvHMain = 0;
+   if (mh) inEvHMain = dynamic_cast<AliInputEventHandler *>(mh->GetFirstInputEventHandler());
+   else inEvHMain = dynamic_cast<AliInputEventHandler *>(mgr->GetInputEventHandler());
+   if (!inEvHMain) return kFALSE;
+
+   // check for PhysSelection
+   if (!IsEventCurrentSelected()) return kFALSE;
+
+   fCurrentMixEntry.Reset();
+   fCurrentMixEvent = 0;
+
+   // find out zero chain entries
+   Long64_t zeroChainEntries = fMixIntupHandlerInfoTmp->GetChain()->GetEntries() - inEvHMain->GetTree()->GetTree()->GetEntries();
+   Long64_t currentMainEntry = inEvHMain->GetTree()->GetTree()->GetReadEntry() + zeroChainEntries;
+
+   AliDebug(AliLog::kDebug + 3, Form("++++++++++++++ BEGIN SETUP EVENT %lld +++++++++++++++++++", fEntryCounter));
+   // reset mix number
+   fNumberMixed = 0;
+   AliVEvent *evMain = inEvHMain->GetEvent();
+   Int_t binIndex = fEventPool->FindBinIndex(evMain);
+   if (binIndex < 0) {
+      AliDebug(AliLog::kDebug + 3, Form("++++++++++++++ END SETUP EVENT %lld SKIPPED (out of bins) +++++++++++++++++++", fEntryCounter));
+      UserExecMixAllTasks(fEntryCounter, -1, currentMainEntry, -1, 0);
+      return kTRUE;
+   }
+   // bin index starts from 1 (as idEntryList in other modes)
+   Int_t idEntryList = binIndex + 1;
+   Int_t nInBin = fEventPool->GetNumberOfEventsInBin(binIndex);
+   if (!nInBin || (!fDoMixIfNotEnoughEvents && nInBin < fMixNumber)) {
+      if (!fDoMixIfNotEnoughEvents) idEntryList = -1;
+      UserExecMixAllTasks(fEntryCounter, idEntryList, currentMainEntry, -1, 0);
+      AliDebug(AliLog::kDebug + 3, Form("++++++++++++++ END SETUP EVENT %lld SKIPPED (%d) NOT ENOUGH EVENTS TO MIX => NEED=%d +++++++++++++++++++", fEntryCounter, nInBin, fMixNumber));
+   } else {
+      Int_t mixNum = TMath::Min(fMixNumber, nInBin);
+      Long64_t entryMixReal = 0;
+      for (Int_t counter = 0; counter < mixNum; counter++) {
+         fCurrentMixEntry.Reset();
+         fCurrentMixEvent = fEventPool->GetEvent(binIndex, counter);
+         entryMixReal = fEventPool->GetEventEntry(binIndex, counter);
+         fCurrentMixEntry.Enter(entryMixReal);
+         fNumberMixed++;
+         UserExecMixAllTasks(fEntryCounter, idEntryList, currentMainEntry, entryMixReal, fNumberMixed);
+      }
+      fCurrentMixEvent = 0;
+   }
+   // current event is stored after mixing, so it is not mixed with itself
+   fEventPool->AddEvent(evMain, currentMainEntry, binIndex);
+   fEventPool->AddEntry(currentMainEntry, evMain);
+
+   AliDebug(AliLog::kDebug + 3, Form("fEntryCounter=%lld fMixEventNumber=%d", fEntryCounter, fNumberMixed));
+   AliDebug(AliLog::kDebug + 3, Form("++++++++++++++ END SETUP EVENT %lld +++++++++++++++++++", fEntryCounter));
+   AliDebug(AliLog::kDebug + 5, "->");
+   return kTRUE;
+}
+
 //_____________________________________________________________________________
 Bool_t AliMixInputEventHandler::FinishEvent()
 {
@@ -605,6 +683,9 @@ Bool_t AliMixInputEventHandler::GetEntryMixedEvent(Int_t id) {
    // (Should be used in UserExecMix() only)
    //
 
+   // event is already in memory
+   if (fCurrentMixEvent) return kTRUE;
+
    AliMixInputHandlerInfo *mihi = (AliMixInputHandlerInfo *) fMixTrees.At(id);
 
    Long64_t entryMix = fCurrentMixEntry.GetEntry(fCurrentMixEntry.GetN()-id-1);
@@ -625,3 +706,58 @@ Bool_t AliMixInputEventHandler::GetEntryMixedEvent(Int_t id) {
 
    return kTRUE;
 }
+
+//_____________________________________________________________________________
+AliVEvent *AliMixInputEventHandler::GetMixedEvent(Int_t id) {
+   //
+   // Returns mixed event. In in-memory mode event is taken from event pool,
+   // otherwise from input handler with id (Should be used in UserExecMix() only)
+   //
+
+   if (fCurrentMixEvent) return fCurrentMixEvent;
+   AliInputEventHandler *ih = (AliInputEventHandler *)InputEventHandler(id);
+   if (!ih) return 0;
+   return ih->GetEvent();
+}
+
+//_____________________________________________________________________________
+void AliMixInputEventHandler::AddInMemoryTask(const char *taskName) {
+   //
+   // Declares that task takes mixed events from GetMixedEvent() in UserExecMix(),
+   // which is needed for in-memory mode of event pool
+   //
+
+   if (!fInMemoryTasks.FindObject(taskName)) fInMemoryTasks.Add(new TObjString(taskName));
+}
+
+//_____________________________________________________________________________
+Bool_t AliMixInputEventHandler::CheckInMemoryTasks() {
+   //
+   // In in-memory mode input handlers of mixed events are not filled,
+   // so every task with UserExecMix() has to be declared by AddInMemoryTask().
+   // Otherwise in-memory mode is switched off (entry lists are used).
+   //
+
+   if (fInMemoryChecked) return fEventPool->IsInMemory();
+   fInMemoryChecked = kTRUE;
+
+   AliAnalysisManager *mgr = AliAnalysisManager::GetAnalysisManager();
+   TObjArrayIter next(mgr->GetTasks());
+   AliAnalysisTaskSE *mixTask = 0;
+   while ((mixTask = dynamic_cast<AliAnalysisTaskSE *>(next()))) {
+      if (fInMemoryTasks.FindObject(mixTask->GetName())) continue;
+      // looks for UserExecMix() in classes between task class and AliAnalysisTaskSE
+      TClass *cl = mixTask->IsA();
+      while (cl && cl != AliAnalysisTaskSE::Class()) {
+         if (cl->GetListOfMethods()->FindObject("UserExecMix")) {
+            AliError(Form("Task %s (%s) takes mixed events from input handlers, in-memory mode of event pool is switched off (see AddInMemoryTask)", mixTask->GetName(), mixTask->ClassName()));
+            fEventPool->SetInMemory(0);
+            fEventPool->ResetEventBuffers();
+            return kFALSE;
+         }
+         TBaseClass *base = (TBaseClass *) cl->GetListOfBases()->First();
+         cl = base ? base->GetClassPointer() : 0;
+      }
+   }
+   return kTRUE;
+}
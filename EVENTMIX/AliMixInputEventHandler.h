@@ -73,6 +73,8 @@ public:
 
    Bool_t                  GetEntryMainEvent();
    Bool_t                  GetEntryMixedEvent(Int_t idHandler=0);
+   AliVEvent              *GetMixedEvent(Int_t idHandler=0);
+   void                    AddInMemoryTask(const char *taskName);
 protected:
 
    TObjArray               fMixTrees;              // buffer of input handlers
@@ -99,18 +101,23 @@ private:
 
    TEntryList fCurrentMixEntry;    //! array of mix entries currently used (user should touch)
    Long64_t fCurrentEntryMainTree; //! current entry in current tree (main event)
+   AliVEvent *fCurrentMixEvent;    //! current mixed event served from event pool memory (in-memory mode)
+   TObjArray fInMemoryTasks;       // names of tasks which take mixed events from GetMixedEvent() (in-memory mode)
+   Bool_t    fInMemoryChecked;     //! tasks were checked for in-memory mode
 
    virtual Bool_t          MixStd();
    virtual Bool_t          MixBuffer();
    virtual Bool_t          MixEventsMoreTimesWithOneEvent();
    virtual Bool_t          MixEventsMoreTimesWithBuffer();
+   virtual Bool_t          MixInMemory();
+   Bool_t                  CheckInMemoryTasks();
 
    void                    UserExecMixAllTasks(Long64_t entryCounter, Int_t idEntryList, Long64_t entryMainReal, Long64_t entryMixReal, Int_t numMixed);
 
    AliMixInputEventHandler(const AliMixInputEventHandler &handler);
    AliMixInputEventHandler &operator=(const AliMixInputEventHandler &handler);
 
-   ClassDef(AliMixInputEventHandler, 5)
+   ClassDef(AliMixInputEventHandler, 7)
 };
 
 #endif
@@ -13,6 +13,7 @@
 #include "AliExternalBDT.h"
 
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -141,3 +142,24 @@ double AliExternalBDT::Predict(double *features, int size, bool useRawScore) {
       &out_size);
   return output;
 }
+
+bool AliExternalBDT::PredictBatch(const float *features, size_t nRows, int nColumns, float *output, bool useRawScore) {
+  if (nRows == 0) return true;
+  CDenseBatchHandle batch;
+  /// NaN marks missing values, any finite feature is used as is (as in Predict)
+  if (TreeliteAssembleDenseBatch(features, NAN, nRows, static_cast<size_t>(nColumns), &batch) != 0) {
+    std::cerr << "Dense batch creation failed" << std::endl;
+    return false;
+  }
+  size_t out_size{0u};
+  TreelitePredictorQueryResultSize(fPredictor, batch, 0, &out_size);
+  assert(out_size == nRows);
+  const int status = TreelitePredictorPredictBatch(fPredictor, batch, 0, 0,
+      static_cast<int>(useRawScore), output, &out_size);
+  TreeliteDeleteDenseBatch(batch);
+  if (status != 0) {
+    std::cerr << "Batch prediction failed" << std::endl;
+    return false;
+  }
+  return true;
+}
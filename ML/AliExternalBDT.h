@@ -30,6 +30,9 @@ public:
   bool LoadXGBoostModel(std::string path);
 
   double Predict(double *features, int size, bool useRaw = false);
+  /// Batched prediction on a row-major (nRows x nColumns) feature matrix,
+  /// scores are written into the caller-owned output buffer (size nRows)
+  bool PredictBatch(const float *features, size_t nRows, int nColumns, float *output, bool useRaw = false);
 
 private:
   bool CompileAndLoadModelLibrary();
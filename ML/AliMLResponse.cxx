@@ -12,6 +12,8 @@
 
 #include "AliMLResponse.h"
 
+#include <algorithm>
+
 #include "yaml-cpp/yaml.h"
 
 #include "AliExternalBDT.h"
@@ -29,7 +31,7 @@ ClassImp(AliMLResponse);
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse()
     : TNamed(), fConfigFilePath{}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{}, fNVariables{},
-      fBinsBegin{}, fRaw{} {
+      fBinsBegin{}, fRaw{}, fBatchRows{}, fBatchFeatures{}, fBatchScores{}, fBatchFailed{} {
   //
   // Default constructor
   //
@@ -38,7 +40,7 @@ AliMLResponse::AliMLResponse()
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse(const Char_t *name, const Char_t *title)
     : TNamed(name, title), fConfigFilePath{""}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{},
-      fNVariables{}, fBinsBegin{}, fRaw{} {
+      fNVariables{}, fBinsBegin{}, fRaw{}, fBatchRows{}, fBatchFeatures{}, fBatchScores{}, fBatchFailed{} {
   //
   // Standard constructor
   //
@@ -55,7 +57,8 @@ AliMLResponse::~AliMLResponse() {
 AliMLResponse::AliMLResponse(const AliMLResponse &source)
     : TNamed(source.GetName(), source.GetTitle()), fConfigFilePath{source.fConfigFilePath}, fModels{source.fModels},
       fCentClasses{source.fCentClasses}, fBins{source.fBins}, fVariableNames{source.fVariableNames},
-      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw} {
+      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw},
+      fBatchRows{}, fBatchFeatures{}, fBatchScores{}, fBatchFailed{} {
   //
   // Copy constructor
   //
@@ -195,4 +198,67 @@ bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varm
 bool AliMLResponse::IsSelected(double binvar, std::vector<double> variables) {
   double score{0.};
   return IsSelected(binvar, variables, score);
-}
\ No newline at end of file
+}
+//_______________________________________________________________________________
+bool AliMLResponse::PredictBatch(const float *features, const double *binvars, int nRows, float *scores) {
+  if ((int)fBatchRows.size() != fNBins + 2) fBatchRows.resize(fNBins + 2);
+  for (auto &rows : fBatchRows) rows.clear();
+  fBatchFailed.assign(fBatchRows.size(), false);
+  bool success = true;
+
+  for (int iRow = 0; iRow < nRows; ++iRow) {
+    fBatchRows[FindBin(binvars[iRow])].push_back(iRow);
+  }
+
+  for (int bin = 0; bin < (int)fBatchRows.size(); ++bin) {
+    const vector<int> &rows = fBatchRows[bin];
+    if (rows.empty()) continue;
+    /// same bin range as in Predict
+    if (bin == 0 || bin >= fNBins) {
+      AliWarning("Binned variable outside range, no model available!");
+      for (int iRow : rows) scores[iRow] = -999.;
+      continue;
+    }
+    const int nBinRows = (int)rows.size();
+    if (nBinRows == nRows) {
+      /// all rows in the same bin: no need to gather/scatter
+      if (!fModels[bin - 1].GetModel()->PredictBatch(features, nRows, fNVariables, scores, fRaw)) {
+        AliError(Form("Batched prediction failed for bin %d, the candidates are rejected!", bin));
+        for (int iRow : rows) scores[iRow] = -999.;
+        fBatchFailed[bin] = true;
+        success = false;
+      }
+      continue;
+    }
+    fBatchFeatures.resize((size_t)nBinRows * fNVariables);
+    fBatchScores.resize(nBinRows);
+    for (int iBinRow = 0; iBinRow < nBinRows; ++iBinRow) {
+      std::copy(features + (size_t)rows[iBinRow] * fNVariables, features + (size_t)(rows[iBinRow] + 1) * fNVariables,
+                fBatchFeatures.begin() + (size_t)iBinRow * fNVariables);
+    }
+    if (!fModels[bin - 1].GetModel()->PredictBatch(fBatchFeatures.data(), nBinRows, fNVariables, fBatchScores.data(), fRaw)) {
+      AliError(Form("Batched prediction failed for bin %d, the candidates are rejected!", bin));
+      fBatchScores.assign(nBinRows, -999.);
+      fBatchFailed[bin] = true;
+      success = false;
+    }
+    for (int iBinRow = 0; iBinRow < nBinRows; ++iBinRow) {
+      scores[rows[iBinRow]] = fBatchScores[iBinRow];
+    }
+  }
+  return success;
+}
+
+//_______________________________________________________________________________
+bool AliMLResponse::IsSelectedBatch(const float *features, const double *binvars, int nRows, float *scores,
+                                    bool *selected) {
+  const bool success = PredictBatch(features, binvars, nRows, scores);
+  /// rows are still grouped by bin from PredictBatch
+  for (int bin = 0; bin < (int)fBatchRows.size(); ++bin) {
+    const bool hasModel = !(bin == 0 || bin >= fNBins) && !fBatchFailed[bin];
+    for (int iRow : fBatchRows[bin]) {
+      selected[iRow] = hasModel && scores[iRow] >= fModels[bin - 1].GetScoreCut();
+    }
+  }
+  return success;
+}
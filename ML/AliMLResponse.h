@@ -61,6 +61,16 @@ public:
   /// overload for getting the model score too
   template <typename F> bool IsSelected(double binvar, std::vector<double> variables, F &score);
 
+  /// batched prediction: features is a row-major (nRows x fNVariables) matrix in the order of the
+  /// variables in the config, binvars holds the binned variable of each row. Rows are grouped by bin
+  /// and each model is called once with all its rows. Scores are written into the caller-owned
+  /// buffer (size nRows), rows outside the bin range get -999. Returns false if the prediction of
+  /// a model failed, the rows of that bin then get -999 too
+  bool PredictBatch(const float *features, const double *binvars, int nRows, float *scores);
+  /// batched selection: selected (size nRows) is true if the score is above the threshold of the bin,
+  /// rows of a bin whose prediction failed are not selected. Returns false if a prediction failed
+  bool IsSelectedBatch(const float *features, const double *binvars, int nRows, float *scores, bool *selected);
+
 protected:
   std::string fConfigFilePath;    /// path of the config file
 
@@ -76,6 +86,11 @@ protected:
 
   bool fRaw;    /// set to true to use raw score instead of probability
 
+  std::vector<std::vector<int>> fBatchRows;    //!<! row indices of the current batch in each bin
+  std::vector<float> fBatchFeatures;           //!<! gathered features of the rows of one bin
+  std::vector<float> fBatchScores;             //!<! scores of the rows of one bin
+  std::vector<bool> fBatchFailed;              //!<! bins of the current batch whose prediction failed
+
   /// \cond CLASSIMP
   ClassDef(AliMLResponse, 2);    ///
   /// \endcond
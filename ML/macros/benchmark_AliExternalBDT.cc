@@ -0,0 +1,189 @@
+#include <TFile.h>
+#include <TStopwatch.h>
+#include <TTree.h>
+#include <TTreeReader.h>
+#include <TTreeReaderValue.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AliExternalBDT.h"
+#include "AliMLResponse.h"
+
+#define DELTA 1.0e-6
+
+/// Compares the per-candidate AliExternalBDT::Predict with the batched
+/// AliExternalBDT::PredictBatch: checks that the scores are the same and
+/// prints the number of candidates per second for both paths.
+/// The same is then done for AliMLResponse::Predict and AliMLResponse::PredictBatch with
+/// the candidates spread over several bins of the binned variable, so that the grouping
+/// of the rows by bin is exercised
+int benchmark_AliExternalBDT(string path = "", int nRepetitions = 10, int batchSize = 4096) {
+
+  string tree_path, model_path;
+
+  if (path == "") {
+    tree_path  = "test_tree_pt8_12.root";
+    model_path = "test_xgboost_pt8_12.model";
+  } else {
+    tree_path  = path + "/" + "test_tree_pt8_12.root";
+    model_path = path + "/" + "test_xgboost_pt8_12.model";
+  }
+
+  const int nFeatures = 12;
+  std::vector<float> features;
+
+  TFile *fInput = new TFile(tree_path.data(), "READ");
+
+  TTreeReader fReader("tree_real_data", fInput);
+
+  TTreeReaderValue<float> fValueDeltaMass(fReader, "delta_mass_KK");
+  TTreeReaderValue<float> fValueDLen(fReader, "d_len");
+  TTreeReaderValue<float> fValueNormDLXY(fReader, "norm_dl_xy");
+  TTreeReaderValue<float> fValueSigVert(fReader, "sig_vert");
+  TTreeReaderValue<float> fValueCosPiKPhi(fReader, "cos_PiKPhi_3");
+  TTreeReaderValue<float> fValueNormIP(fReader, "norm_IP");
+  TTreeReaderValue<float> fValueSigCombK0(fReader, "sigComb_K_0");
+  TTreeReaderValue<float> fValueSigCombK1(fReader, "sigComb_K_1");
+  TTreeReaderValue<float> fValueSigCombK2(fReader, "sigComb_K_2");
+  TTreeReaderValue<float> fValueSigCombPi0(fReader, "sigComb_Pi_0");
+  TTreeReaderValue<float> fValueSigCombPi1(fReader, "sigComb_Pi_1");
+  TTreeReaderValue<float> fValueSigCombPi2(fReader, "sigComb_Pi_2");
+
+  while (fReader.Next()) {
+    float row[nFeatures] = {*fValueDeltaMass,  *fValueDLen,       *fValueNormDLXY,
+                            *fValueSigVert,    *fValueCosPiKPhi,  *fValueNormIP,
+                            *fValueSigCombK0,  *fValueSigCombK1,  *fValueSigCombK2,
+                            *fValueSigCombPi0, *fValueSigCombPi1, *fValueSigCombPi2};
+    features.insert(features.end(), row, row + nFeatures);
+  }
+  fInput->Close();
+
+  const size_t nCandidates = features.size() / nFeatures;
+  if (nCandidates == 0) {
+    std::cout << "BENCHMARK: no candidates found!" << std::endl;
+    return 1;
+  }
+
+  AliExternalBDT *fBDT = new AliExternalBDT();
+  if (!fBDT->LoadXGBoostModel(model_path.data())) {
+    return 1;
+  }
+
+  std::vector<float> scoresSingle(nCandidates), scoresBatch(nCandidates);
+
+  /// per-candidate path
+  TStopwatch timer;
+  timer.Start();
+  for (int iRep = 0; iRep < nRepetitions; ++iRep) {
+    for (size_t iCand = 0; iCand < nCandidates; ++iCand) {
+      double row[nFeatures];
+      for (int iFeat = 0; iFeat < nFeatures; ++iFeat) row[iFeat] = features[iCand * nFeatures + iFeat];
+      scoresSingle[iCand] = fBDT->Predict(row, nFeatures, true);
+    }
+  }
+  timer.Stop();
+  const double timeSingle = timer.RealTime();
+
+  /// batched path
+  timer.Start();
+  for (int iRep = 0; iRep < nRepetitions; ++iRep) {
+    for (size_t iFirst = 0; iFirst < nCandidates; iFirst += batchSize) {
+      size_t nRows = std::min(nCandidates - iFirst, (size_t)batchSize);
+      fBDT->PredictBatch(&features[iFirst * nFeatures], nRows, nFeatures, &scoresBatch[iFirst], true);
+    }
+  }
+  timer.Stop();
+  const double timeBatch = timer.RealTime();
+  delete fBDT;
+
+  for (size_t iCand = 0; iCand < nCandidates; ++iCand) {
+    if (std::abs(scoresSingle[iCand] - scoresBatch[iCand]) > DELTA) {
+      std::cout << "BENCHMARK: Fail! Score mismatch for candidate " << iCand << ": " << scoresSingle[iCand]
+                << " vs " << scoresBatch[iCand] << std::endl;
+      return 1;
+    }
+  }
+
+  const double nTotal = (double)nCandidates * nRepetitions;
+  std::cout << "BENCHMARK: " << nCandidates << " candidates x " << nRepetitions << " repetitions" << std::endl;
+  std::cout << "BENCHMARK: Predict       " << nTotal / timeSingle << " candidates/s" << std::endl;
+  std::cout << "BENCHMARK: PredictBatch  " << nTotal / timeBatch << " candidates/s (batch size " << batchSize
+            << ", speed-up x" << timeSingle / timeBatch << ")" << std::endl;
+
+  /// AliMLResponse with the same model in 4 bins of the binned variable
+  const std::vector<std::string> varNames = {"delta_mass_KK", "d_len",       "norm_dl_xy",  "sig_vert",
+                                             "cos_PiKPhi_3",  "norm_IP",     "sigComb_K_0", "sigComb_K_1",
+                                             "sigComb_K_2",   "sigComb_Pi_0", "sigComb_Pi_1", "sigComb_Pi_2"};
+  const int nBins = 4;
+  const string config_path = (path == "") ? "benchmark_config.yml" : path + "/" + "benchmark_config.yml";
+  std::ofstream config(config_path.data());
+  config << "BINS: [0, 2, 4, 6, 8, 10]\n";
+  config << "N_MODELS: " << nBins + 1 << "\n";
+  config << "NUM_VAR: " << nFeatures << "\n";
+  config << "VAR_NAMES: [";
+  for (int iFeat = 0; iFeat < nFeatures; ++iFeat) config << (iFeat ? ", " : "") << varNames[iFeat];
+  config << "]\n";
+  config << "RAW_SCORE: true\n";
+  config << "MODELS:\n";
+  for (int iModel = 0; iModel < nBins + 1; ++iModel) {
+    config << "  - {path: " << model_path << ", library: kXGBoost, cut: 0.}\n";
+  }
+  config.close();
+
+  AliMLResponse *fResponse = new AliMLResponse("benchmark", "benchmark");
+  fResponse->CompileModels(config_path);
+
+  /// binned variable in ]0, 8[, i.e. in the 4 bins with a model (the last bin is outside the range
+  /// of Predict), with consecutive candidates in different bins
+  std::vector<double> binvars(nCandidates);
+  for (size_t iCand = 0; iCand < nCandidates; ++iCand) binvars[iCand] = 8. * ((iCand * 7) % 100 + 0.5) / 100.;
+
+  std::vector<float> scoresResponse(nCandidates), scoresResponseBatch(nCandidates);
+  std::vector<bool> selectedResponse(nCandidates);
+  timer.Start();
+  for (int iRep = 0; iRep < nRepetitions; ++iRep) {
+    for (size_t iCand = 0; iCand < nCandidates; ++iCand) {
+      std::vector<double> row(features.begin() + iCand * nFeatures, features.begin() + (iCand + 1) * nFeatures);
+      selectedResponse[iCand] = fResponse->IsSelected(binvars[iCand], row, scoresResponse[iCand]);
+    }
+  }
+  timer.Stop();
+  const double timeResponse = timer.RealTime();
+
+  std::unique_ptr<bool[]> selectedResponseBatch(new bool[nCandidates]);
+  timer.Start();
+  for (int iRep = 0; iRep < nRepetitions; ++iRep) {
+    for (size_t iFirst = 0; iFirst < nCandidates; iFirst += batchSize) {
+      size_t nRows = std::min(nCandidates - iFirst, (size_t)batchSize);
+      if (!fResponse->IsSelectedBatch(&features[iFirst * nFeatures], &binvars[iFirst], nRows,
+                                      &scoresResponseBatch[iFirst], &selectedResponseBatch[iFirst])) {
+        std::cout << "BENCHMARK: Fail! Batched prediction failed" << std::endl;
+        return 1;
+      }
+    }
+  }
+  timer.Stop();
+  const double timeResponseBatch = timer.RealTime();
+  delete fResponse;
+
+  for (size_t iCand = 0; iCand < nCandidates; ++iCand) {
+    if (std::abs(scoresResponse[iCand] - scoresResponseBatch[iCand]) > DELTA ||
+        selectedResponse[iCand] != selectedResponseBatch[iCand]) {
+      std::cout << "BENCHMARK: Fail! AliMLResponse mismatch for candidate " << iCand << ": " << scoresResponse[iCand]
+                << " vs " << scoresResponseBatch[iCand] << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "BENCHMARK: AliMLResponse, " << nBins << " bins" << std::endl;
+  std::cout << "BENCHMARK: IsSelected      " << nTotal / timeResponse << " candidates/s" << std::endl;
+  std::cout << "BENCHMARK: IsSelectedBatch " << nTotal / timeResponseBatch << " candidates/s (batch size "
+            << batchSize << ", speed-up x" << timeResponse / timeResponseBatch << ")" << std::endl;
+  return 0;
+}
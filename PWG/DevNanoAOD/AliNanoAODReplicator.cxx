@@ -68,6 +68,7 @@ class AliAODRecoDecay;
 #include "TCanvas.h"
 #include "AliNanoAODHeader.h"
 #include "AliNanoAODCustomSetter.h"
+#include "AliNanoAODTrackColumns.h"
 #include "AliV0ReaderV1.h"
 #include "AliAnalysisNanoAODCuts.h"
 
@@ -112,7 +113,9 @@ AliAODBranchReplicator(),
   fInputArrayName(""),
   fOutputArrayName("tracks"),
   fKeepDaughters(),
-  fClonedVertices()
+  fClonedVertices(),
+  fFillTrackColumns(kFALSE),
+  fTrackColumns(0x0)
   {
   // Default ctor. we need it to avoid instantiating a wrong mapping when reading from file
   }
@@ -152,7 +155,9 @@ AliNanoAODReplicator::AliNanoAODReplicator(const char* name, const char* title)
   fInputArrayName(""),
   fOutputArrayName("tracks"),
   fKeepDaughters(),
-  fClonedVertices()
+  fClonedVertices(),
+  fFillTrackColumns(kFALSE),
+  fTrackColumns(0x0)
 {
   // default ctor
 }
@@ -163,6 +168,7 @@ AliNanoAODReplicator::~AliNanoAODReplicator()
   // dtor
   delete fTrackCuts;
   delete fList;
+  delete fTrackColumns;
 }
 
 //_____________________________________________________________________________
@@ -884,6 +890,13 @@ void AliNanoAODReplicator::ReplicateAndFilter(const AliAODEvent& source)
   if ( fMCMode > 0 ) {
     FilterMC(source);      
   }
+
+  // Columnar copy of the tracks (after FilterMC, which relabels them)
+  if (fFillTrackColumns) {
+    if (!fTrackColumns)
+      fTrackColumns = new AliNanoAODTrackColumns;
+    fTrackColumns->Fill(fTracks);
+  }
 }
 
 void AliNanoAODReplicator::Terminate()
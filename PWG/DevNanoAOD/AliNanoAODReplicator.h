@@ -51,6 +51,7 @@ class AliAnalysisTaskSE;
 class AliNanoAODTrack;
 class AliAODTrack;
 class AliNanoAODCustomSetter;
+class AliNanoAODTrackColumns;
 class AliAODZDC;
 
 class AliNanoAODReplicator : public AliAODBranchReplicator
@@ -97,6 +98,10 @@ class AliNanoAODReplicator : public AliAODBranchReplicator
   void SetOutputArrayName(TString name) {fOutputArrayName=name;}
 
   void SetVarListHeaderTC(TString var) {fVarListHeader_fTC=var;}
+
+  // columnar copy of the replicated tracks, for the tasks running after the filter in the same train
+  void SetFillTrackColumns(Bool_t b = kTRUE) { fFillTrackColumns = b; }
+  AliNanoAODTrackColumns* GetTrackColumns() const { return fTrackColumns; }
     
  private:
 
@@ -156,10 +161,13 @@ class AliNanoAODReplicator : public AliAODBranchReplicator
   std::map<AliAODVertex*, std::vector<TObject*> > fKeepDaughters; //! Tracks needed as references to V0s and cascades
   std::map<AliAODVertex*, AliAODVertex*> fClonedVertices; //! avoid that vertices are stored several times
 
+  Bool_t fFillTrackColumns; // if kTRUE the replicated tracks are also stored in fTrackColumns
+  AliNanoAODTrackColumns* fTrackColumns; //! columnar copy of the replicated tracks
+
   AliNanoAODReplicator(const AliNanoAODReplicator&);
   AliNanoAODReplicator& operator=(const AliNanoAODReplicator&);
 
-  ClassDef(AliNanoAODReplicator, 7) // Branch replicator for ESD to muon AOD.
+  ClassDef(AliNanoAODReplicator, 8) // Branch replicator for ESD to muon AOD.
 };
 
 #endif
@@ -0,0 +1,149 @@
+/**************************************************************************
+ * Copyright(c) 1998-2007, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+//-------------------------------------------------------------------------
+//     Columnar (structure-of-arrays) view of the NanoAOD tracks of one event
+//-------------------------------------------------------------------------
+
+#include <TClonesArray.h>
+#include <TMath.h>
+#include "AliLog.h"
+#include "AliAODEvent.h"
+
+#include "AliNanoAODTrack.h"
+#include "AliNanoAODTrackMapping.h"
+#include "AliNanoAODTrackColumns.h"
+
+ClassImp(AliNanoAODTrackColumns)
+
+//______________________________________________________________________________
+AliNanoAODTrackColumns::AliNanoAODTrackColumns() :
+  TObject(),
+  fMapping(0x0),
+  fIndexPt(-1),
+  fIndexPhi(-1),
+  fIndexTheta(-1),
+  fIndexFilterMap(-1),
+  fHasKinematics(kFALSE),
+  fNVars(0),
+  fNVarsInt(0),
+  fNTracks(0),
+  fCapacity(0),
+  fVars(),
+  fVarsInt(),
+  fEta(),
+  fPx(),
+  fPy(),
+  fPz(),
+  fCharge(),
+  fLabel(),
+  fTracks()
+{
+  // default constructor
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::Clear(Option_t* /*opt*/)
+{
+  // forget the tracks of the current event, the memory is kept for the next one
+  fNTracks = 0;
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::CacheMapping(const AliNanoAODTrackMapping* mapping)
+{
+  // cache the indices of the variables, done once per mapping (i.e. per file)
+  fMapping = mapping;
+  fNVars = mapping->GetSize();
+  fNVarsInt = mapping->GetSizeInt();
+  fIndexPt = mapping->GetPt();
+  fIndexPhi = mapping->GetPhi();
+  fIndexTheta = mapping->GetTheta();
+  fIndexFilterMap = mapping->GetFilterMap();
+  fHasKinematics = (fIndexPt != -1 && fIndexPhi != -1 && fIndexTheta != -1);
+  fCapacity = 0; // the layout of the columns depends on the number of variables
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::Reserve(Int_t nTracks)
+{
+  // allocate the columns for nTracks tracks. The content is not kept
+  if (nTracks <= fCapacity)
+    return;
+
+  fCapacity = TMath::Max(TMath::Max(nTracks, 2 * fCapacity), 64);
+  fVars.assign((size_t)fNVars * fCapacity, 0.);
+  fVarsInt.assign((size_t)fNVarsInt * fCapacity, 0);
+  fEta.resize(fCapacity);
+  fPx.resize(fCapacity);
+  fPy.resize(fCapacity);
+  fPz.resize(fCapacity);
+  fCharge.resize(fCapacity);
+  fLabel.resize(fCapacity);
+  fTracks.resize(fCapacity);
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::Fill(const AliAODEvent* event)
+{
+  // fill the columns with the tracks of a NanoAOD event
+  Fill(event ? event->GetTracks() : 0x0);
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::Fill(const TClonesArray* tracks)
+{
+  // fill the columns with an array of AliNanoAODTrack
+  fNTracks = 0;
+  if (!tracks || tracks->GetEntriesFast() == 0)
+    return;
+  if (!tracks->GetClass()->InheritsFrom(AliNanoAODTrack::Class())) {
+    AliError(Form("Array of %s instead of AliNanoAODTrack", tracks->GetClass()->GetName()));
+    return;
+  }
+
+  const AliNanoAODTrackMapping* mapping = AliNanoAODTrackMapping::GetInstance();
+  if (mapping != fMapping)
+    CacheMapping(mapping);
+
+  const Int_t nTracks = tracks->GetEntriesFast();
+  Reserve(nTracks);
+
+  // transpose the per-track storage into the columns
+  for (Int_t i = 0; i < nTracks; i++) {
+    AliNanoAODTrack* track = static_cast<AliNanoAODTrack*>(tracks->UncheckedAt(i));
+    fTracks[i] = track;
+    for (Int_t v = 0; v < fNVars; v++)
+      fVars[(size_t)v * fCapacity + i] = track->GetVar(v);
+    for (Int_t v = 0; v < fNVarsInt; v++)
+      fVarsInt[(size_t)v * fCapacity + i] = track->GetVarInt(v);
+    fCharge[i] = track->Charge();
+    fLabel[i] = track->GetLabel();
+  }
+  fNTracks = nTracks;
+
+  // kinematics computed once per event, on plain arrays
+  if (fHasKinematics) {
+    const Float_t* pt = GetPt();
+    const Float_t* phi = GetPhi();
+    const Float_t* theta = GetTheta();
+    for (Int_t i = 0; i < nTracks; i++) {
+      fPx[i] = pt[i] * TMath::Cos(phi[i]);
+      fPy[i] = pt[i] * TMath::Sin(phi[i]);
+      fPz[i] = pt[i] / TMath::Tan(theta[i]);
+      fEta[i] = -TMath::Log(TMath::Tan(0.5 * theta[i]));
+    }
+  }
+}
@@ -0,0 +1,136 @@
+#ifndef AliNanoAODTrackColumns_H
+#define AliNanoAODTrackColumns_H
+/* Copyright(c) 1998-2007, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+//-------------------------------------------------------------------------
+//     Columnar (structure-of-arrays) view of the NanoAOD tracks of one event
+//     Each mapped variable is stored in one contiguous array for all the
+//     tracks of the event. The mapping indices are cached once, the
+//     kinematic variables (px, py, pz, eta) are computed once per event.
+//     Loops over the tracks then run on plain arrays, without the virtual
+//     calls and the mapping lookups of AliNanoAODTrack.
+//
+//     Usage:
+//       AliNanoAODTrackColumns columns;
+//       columns.Fill(aodEvent);
+//       const Float_t* pt = columns.GetPt();
+//       for (Int_t i = 0; i < columns.GetNumberOfTracks(); i++) ... pt[i] ...
+//-------------------------------------------------------------------------
+
+#include <TObject.h>
+#include <vector>
+
+class TClonesArray;
+class AliAODEvent;
+class AliNanoAODTrack;
+class AliNanoAODTrackMapping;
+class AliNanoAODTrackColumns;
+
+class AliNanoAODTrackView {
+public:
+  AliNanoAODTrackView(const AliNanoAODTrackColumns* columns, Int_t index) : fColumns(columns), fIndex(index) {}
+
+  inline Float_t Pt() const;
+  inline Float_t Phi() const;
+  inline Float_t Theta() const;
+  inline Float_t Eta() const;
+  inline Float_t Px() const;
+  inline Float_t Py() const;
+  inline Float_t Pz() const;
+  inline Short_t Charge() const;
+  inline Int_t   GetLabel() const;
+  inline Bool_t  TestFilterBit(UInt_t filterBit) const;
+  inline Float_t GetVar(Int_t index) const;
+  inline Int_t   GetVarInt(Int_t index) const;
+  inline AliNanoAODTrack* GetTrack() const;
+  Int_t GetIndex() const { return fIndex; }
+
+private:
+  const AliNanoAODTrackColumns* fColumns; // columns of the event
+  Int_t fIndex;                           // index of the track in the event
+};
+
+class AliNanoAODTrackColumns : public TObject {
+public:
+  AliNanoAODTrackColumns();
+  virtual ~AliNanoAODTrackColumns() {}
+
+  void Fill(const AliAODEvent* event);
+  void Fill(const TClonesArray* tracks);
+  virtual void Clear(Option_t* opt = "");
+  void ResetMapping() { fMapping = 0x0; } // re-read the mapping indices at the next Fill, e.g. for a new file
+
+  Int_t GetNumberOfTracks() const  { return fNTracks; }
+  Int_t GetNumberOfVars() const    { return fNVars; }
+  Int_t GetNumberOfVarsInt() const { return fNVarsInt; }
+
+  // column of a mapped variable (index from AliNanoAODTrackMapping), 0x0 if not mapped
+  const Float_t* GetColumn(Int_t index) const    { return (index >= 0 && index < fNVars) ? &fVars[(size_t)index * fCapacity] : 0x0; }
+  const Int_t*   GetColumnInt(Int_t index) const { return (index >= 0 && index < fNVarsInt) ? &fVarsInt[(size_t)index * fCapacity] : 0x0; }
+
+  // kinematics, 0x0 if pt, phi or theta are not mapped
+  const Float_t* GetPt() const    { return GetColumn(fIndexPt); }
+  const Float_t* GetPhi() const   { return GetColumn(fIndexPhi); }
+  const Float_t* GetTheta() const { return GetColumn(fIndexTheta); }
+  const Float_t* GetEta() const   { return fHasKinematics ? &fEta[0] : 0x0; }
+  const Float_t* GetPx() const    { return fHasKinematics ? &fPx[0] : 0x0; }
+  const Float_t* GetPy() const    { return fHasKinematics ? &fPy[0] : 0x0; }
+  const Float_t* GetPz() const    { return fHasKinematics ? &fPz[0] : 0x0; }
+  const Short_t* GetCharge() const    { return fNTracks ? &fCharge[0] : 0x0; }
+  const Int_t*   GetLabel() const     { return fNTracks ? &fLabel[0] : 0x0; }
+  const Int_t*   GetFilterMap() const { return GetColumnInt(fIndexFilterMap); }
+
+  AliNanoAODTrack* GetTrack(Int_t i) const { return fTracks[i]; }
+  AliNanoAODTrackView GetView(Int_t i) const { return AliNanoAODTrackView(this, i); }
+
+  Float_t GetVar(Int_t index, Int_t i) const  { return fVars[(size_t)index * fCapacity + i]; }
+  Int_t GetVarInt(Int_t index, Int_t i) const { return fVarsInt[(size_t)index * fCapacity + i]; }
+
+private:
+  AliNanoAODTrackColumns(const AliNanoAODTrackColumns&);
+  AliNanoAODTrackColumns& operator=(const AliNanoAODTrackColumns&);
+
+  void CacheMapping(const AliNanoAODTrackMapping* mapping);
+  void Reserve(Int_t nTracks);
+
+  const AliNanoAODTrackMapping* fMapping; //! mapping used for the cached indices
+  Int_t fIndexPt;                  //! cached index of pt
+  Int_t fIndexPhi;                 //! cached index of phi
+  Int_t fIndexTheta;               //! cached index of theta
+  Int_t fIndexFilterMap;           //! cached index of the filter map
+  Bool_t fHasKinematics;           //! pt, phi and theta are mapped
+
+  Int_t fNVars;                    //! number of float variables
+  Int_t fNVarsInt;                 //! number of int variables
+  Int_t fNTracks;                  //! number of tracks in the event
+  Int_t fCapacity;                 //! number of tracks allocated per column
+
+  std::vector<Float_t> fVars;      //! float columns, column i starts at i*fCapacity
+  std::vector<Int_t> fVarsInt;     //! int columns, column i starts at i*fCapacity
+  std::vector<Float_t> fEta;       //! pseudorapidity
+  std::vector<Float_t> fPx;        //! x component of momentum
+  std::vector<Float_t> fPy;        //! y component of momentum
+  std::vector<Float_t> fPz;        //! z component of momentum
+  std::vector<Short_t> fCharge;    //! charge
+  std::vector<Int_t> fLabel;       //! MC label
+  std::vector<AliNanoAODTrack*> fTracks; //! tracks, in the same order as the columns
+
+  ClassDef(AliNanoAODTrackColumns, 1); // Columnar view of the NanoAOD tracks of one event
+};
+
+Float_t AliNanoAODTrackView::Pt() const    { return fColumns->GetPt()[fIndex]; }
+Float_t AliNanoAODTrackView::Phi() const   { return fColumns->GetPhi()[fIndex]; }
+Float_t AliNanoAODTrackView::Theta() const { return fColumns->GetTheta()[fIndex]; }
+Float_t AliNanoAODTrackView::Eta() const   { return fColumns->GetEta()[fIndex]; }
+Float_t AliNanoAODTrackView::Px() const    { return fColumns->GetPx()[fIndex]; }
+Float_t AliNanoAODTrackView::Py() const    { return fColumns->GetPy()[fIndex]; }
+Float_t AliNanoAODTrackView::Pz() const    { return fColumns->GetPz()[fIndex]; }
+Short_t AliNanoAODTrackView::Charge() const { return fColumns->GetCharge()[fIndex]; }
+Int_t   AliNanoAODTrackView::GetLabel() const { return fColumns->GetLabel()[fIndex]; }
+Bool_t  AliNanoAODTrackView::TestFilterBit(UInt_t filterBit) const { return (Bool_t) ((filterBit & (UInt_t) fColumns->GetFilterMap()[fIndex]) != 0); }
+Float_t AliNanoAODTrackView::GetVar(Int_t index) const  { return fColumns->GetVar(index, fIndex); }
+Int_t   AliNanoAODTrackView::GetVarInt(Int_t index) const { return fColumns->GetVarInt(index, fIndex); }
+AliNanoAODTrack* AliNanoAODTrackView::GetTrack() const { return fColumns->GetTrack(fIndex); }
+
+#endif
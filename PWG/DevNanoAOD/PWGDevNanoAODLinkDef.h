@@ -23,6 +23,8 @@
 #pragma link C++ class AliNanoAODSimpleSetterCRCZDC+;
 #pragma link C++ class AliNanoAODSimpleSetterJet+;
 #pragma link C++ class AliNanoAODTrackMapping+;
+#pragma link C++ class AliNanoAODTrackColumns+;
+#pragma link C++ class AliNanoAODTrackView;
 #pragma link C++ class AliAnalysisTaskNanoSimple;
 #pragma link C++ class AliAnalysisTaskNanoValidator;
 
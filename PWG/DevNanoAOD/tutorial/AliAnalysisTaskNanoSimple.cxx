@@ -9,6 +9,7 @@
 
 #include "AliNanoAODHeader.h"
 #include "AliNanoAODTrack.h"
+#include "AliNanoAODTrackColumns.h"
 
 #include "AliAODConversionPhoton.h"
 
@@ -22,7 +23,9 @@ ClassImp(AliAnalysisTaskNanoSimple)
 AliAnalysisTaskNanoSimple:: AliAnalysisTaskNanoSimple(const char* name):
 AliAnalysisTaskSE(name),
 // general configuration
-fListOfHistos(0x0)
+fListOfHistos(0x0),
+fColumns(),
+fTPCsignalIndex(-1)
 {
   // Default constructor
 
@@ -59,6 +62,17 @@ void  AliAnalysisTaskNanoSimple::UserCreateOutputObjects()
   PostData(1, fListOfHistos);
 }
 
+//____________________________________________________________________
+Bool_t AliAnalysisTaskNanoSimple::UserNotify()
+{
+  // new file: the NanoAOD mapping may differ, refresh the cached indices
+
+  fColumns.ResetMapping();
+  fTPCsignalIndex = AliNanoAODTrackMapping::GetInstance()->GetTPCsignal();
+
+  return kTRUE;
+}
+
 //____________________________________________________________________
 void  AliAnalysisTaskNanoSimple::UserExec(Option_t */*option*/)
 {
@@ -115,8 +129,16 @@ void  AliAnalysisTaskNanoSimple::UserExec(Option_t */*option*/)
       //Printf("  TPC_sigma_proton = %f               TOF_sigma_proton = %f", pidResponse->NumberOfSigmasTPC(track, AliPID::kProton), pidResponse->NumberOfSigmasTOF(track, AliPID::kProton));
   }
   
-  // V0 access - as usual
   AliAODEvent* aod = dynamic_cast<AliAODEvent*> (fInputEvent);
+
+  // Columnar access: one array per variable for all tracks of the event, e.g. for loops over track pairs
+  fColumns.Fill(aod);
+  const Float_t* eta = fColumns.GetEta();
+  const Float_t* tpcSignal = fColumns.GetColumn(fTPCsignalIndex);
+  for (Int_t i = 0; eta && i < fColumns.GetNumberOfTracks(); i++)
+    Printf("track %d: eta = %f  charge = %d  TPC signal = %f", i, eta[i], fColumns.GetCharge()[i], tpcSignal ? tpcSignal[i] : -999.);
+
+  // V0 access - as usual
   if (aod->GetV0s()) {
     for (int i = 0; i < aod->GetNumberOfV0s(); i++) {
       Printf("V0 %d: dca = %f", i, aod->GetV0(i)->DcaV0ToPrimVertex());
@@ -2,6 +2,7 @@
 #define AliAnalysisTaskNanoSimple_H
 
 #include "AliAnalysisTaskSE.h"
+#include "AliNanoAODTrackColumns.h"
 
 class  AliAnalysisTaskNanoSimple : public AliAnalysisTaskSE
 {
@@ -12,6 +13,7 @@ public:
   // Implementation of interace methods
   virtual     void   UserCreateOutputObjects();
   virtual     void   UserExec(Option_t *option);
+  virtual     Bool_t UserNotify();
 
 private:
   AliAnalysisTaskNanoSimple(const  AliAnalysisTaskNanoSimple &det);
@@ -20,7 +22,10 @@ private:
   // Histogram settings
   TList*              fListOfHistos;    //  Output list of containers
 
-  ClassDef(AliAnalysisTaskNanoSimple, 1); // Analysis task for correlation development
+  AliNanoAODTrackColumns fColumns;      //! columnar view of the tracks, mapping refreshed per file
+  Int_t               fTPCsignalIndex;  //! index of the TPC signal in the mapping of the current file
+
+  ClassDef(AliAnalysisTaskNanoSimple, 2); // Analysis task for correlation development
 };
 
 #endif
@@ -31,6 +31,8 @@
 #include "AliVParticle.h"
 #include "AliTLorentzVector.h"
 
+#include "AliAnalysisManager.h"
+#include "AliEmcalContainerAcceptanceCache.h"
 #include "AliEmcalContainerUtils.h"
 
 #include "AliEmcalContainer.h"
@@ -56,10 +58,12 @@ AliEmcalContainer::AliEmcalContainer():
   fMaxMCLabel(-1),
   fMassHypothesis(-1),
   fIsEmbedding(kFALSE),
+  fUseAcceptanceCache(kFALSE),
   fClArray(0),
   fCurrentID(0),
   fLabelMap(0),
   fLoadedClass(0),
+  fAcceptanceCache(0),
   fClassName()
 {
   fVertex[0] = 0;
@@ -86,10 +90,12 @@ AliEmcalContainer::AliEmcalContainer(const char *name):
   fMaxMCLabel(-1),
   fMassHypothesis(-1),
   fIsEmbedding(kFALSE),
+  fUseAcceptanceCache(kFALSE),
   fClArray(0),
   fCurrentID(0),
   fLabelMap(0),
   fLoadedClass(0),
+  fAcceptanceCache(0),
   fClassName()
 {
   fVertex[0] = 0;
@@ -97,6 +103,12 @@ AliEmcalContainer::AliEmcalContainer(const char *name):
   fVertex[2] = 0;
 }
 
+AliEmcalContainer::~AliEmcalContainer()
+{
+  // the cache is deleted with the last of the equivalent containers
+  AliEmcalContainerAcceptanceCache::ReleaseCache(fAcceptanceCache);
+}
+
 TObject *AliEmcalContainer::operator[](int index) const {
   if(index >= 0 && index < GetNEntries()) return fClArray->At(index);
   return NULL;
@@ -165,9 +177,27 @@ void AliEmcalContainer::NextEvent(const AliVEvent * event)
   if (!event) return;
 
   GetVertexFromEvent(event);
+
+  // The array is connected in ExecOnce, the derived containers are set up by now
+  if (fUseAcceptanceCache && !fAcceptanceCache) fAcceptanceCache = AliEmcalContainerAcceptanceCache::GetCache(this);
+}
+
+const AliEmcalContainerAcceptanceCache *AliEmcalContainer::GetAcceptanceCache() const
+{
+  if (!fAcceptanceCache) return 0;
+
+  AliAnalysisManager *mgr = AliAnalysisManager::GetAnalysisManager();
+  if (!mgr) return 0;
+
+  Long64_t entry = mgr->GetCurrentEntry();
+  if (!fAcceptanceCache->IsValid(entry, GetNEntries())) fAcceptanceCache->Fill(this, entry);
+  return fAcceptanceCache;
 }
 
 Int_t AliEmcalContainer::GetNAcceptEntries() const{
+  const AliEmcalContainerAcceptanceCache *cache = GetAcceptanceCache();
+  if (cache) return cache->GetNAccepted();
+
   Int_t result = 0;
   for(int index = 0; index < GetNEntries(); index++){
     UInt_t rejectionReason = 0;
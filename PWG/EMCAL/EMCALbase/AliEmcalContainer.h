@@ -36,6 +36,7 @@ class AliTLorentzVector;
 class AliVEvent;
 class AliNamedArrayI;
 class AliVParticle;
+class AliEmcalContainerAcceptanceCache;
 
 #include <TNamed.h>
 #include <TClonesArray.h>
@@ -164,9 +165,9 @@ class AliEmcalContainer : public TObject {
   AliEmcalContainer(const char *name); 
 
   /**
-   * @brief Destructor
+   * @brief Destructor, releasing the acceptance cache
    */
-  virtual ~AliEmcalContainer(){;}
+  virtual ~AliEmcalContainer();
 
   /**
    * @brief Index operator.
@@ -289,6 +290,25 @@ class AliEmcalContainer : public TObject {
    */
   Bool_t                      GetIsEmbedding() const                    { return fIsEmbedding; }
 
+  /**
+   * @brief Share the selection of the entries with the equivalent containers
+   *
+   * The selection and the momenta of all entries are then evaluated once per event
+   * for all the containers of the same class, connected to the same array and with
+   * the same settings (see AliEmcalContainerAcceptanceCache), and used by the iterators
+   * and GetNAcceptEntries. Only for arrays which are not modified after the first
+   * container of the group was iterated over in the event.
+   * @param[in] b If true the acceptance cache is used
+   */
+  void                        SetUseAcceptanceCache(Bool_t b)           { fUseAcceptanceCache = b; }
+  Bool_t                      GetUseAcceptanceCache() const             { return fUseAcceptanceCache; }
+
+  /**
+   * @brief Get the acceptance cache filled for the current event
+   * @return Acceptance cache, NULL if the container does not use it (or outside of an analysis manager)
+   */
+  const AliEmcalContainerAcceptanceCache *GetAcceptanceCache() const;
+
   const char*                 GetName()                       const { return fName.Data()               ; }
 
   /**
@@ -389,11 +409,13 @@ class AliEmcalContainer : public TObject {
   Int_t                       fMaxMCLabel;              ///< maximum MC label
   Double_t                    fMassHypothesis;          ///< if < 0 it will use a PID mass when available
   Bool_t                      fIsEmbedding;             ///< if true, this container will connect to an external event
+  Bool_t                      fUseAcceptanceCache;      ///< if true, the selection is shared with the equivalent containers
   TClonesArray               *fClArray;                 //!<! Pointer to array in input event
   Int_t                       fCurrentID;               //!<! current ID for automatic loops
   AliNamedArrayI             *fLabelMap;                //!<! Label-Index map
   Double_t                    fVertex[3];               //!<! event vertex array
   TClass                     *fLoadedClass;             //!<! Class of the objects contained in the TClonesArray
+  AliEmcalContainerAcceptanceCache *fAcceptanceCache;   //!<! Selection shared with the equivalent containers
 
  private:
   TString                     fClassName;               ///< name of the class in the TClonesArray
@@ -401,6 +423,6 @@ class AliEmcalContainer : public TObject {
   AliEmcalContainer(const AliEmcalContainer& obj); // copy constructor
   AliEmcalContainer& operator=(const AliEmcalContainer& other); // assignment
 
-  ClassDef(AliEmcalContainer,9);
+  ClassDef(AliEmcalContainer,10);
 };
 #endif
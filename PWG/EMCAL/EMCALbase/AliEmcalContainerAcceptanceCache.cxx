@@ -0,0 +1,154 @@
+/************************************************************************************
+ * Copyright (C) 2016, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <map>
+
+#include <TBufferFile.h>
+#include <TMD5.h>
+#include <TString.h>
+
+#include "AliLog.h"
+#include "AliTLorentzVector.h"
+
+#include "AliEmcalContainer.h"
+#include "AliEmcalContainerAcceptanceCache.h"
+
+AliEmcalContainerAcceptanceCache::AliEmcalContainerAcceptanceCache():
+  fEntry(-1),
+  fNEntries(-1),
+  fAcceptedIndices(),
+  fAccepted(),
+  fRejectionReasons(),
+  fPx(),
+  fPy(),
+  fPz(),
+  fE(),
+  fAcceptedPt(),
+  fAcceptedEta(),
+  fAcceptedPhi(),
+  fAcceptedE(),
+  fKey(),
+  fNUsers(0)
+{
+}
+
+namespace {
+  /// Caches of the equivalent containers, a cache is deleted when its last container releases it.
+  /// The map itself is never destroyed, so that containers deleted at exit can still release their cache.
+  std::map<std::string, AliEmcalContainerAcceptanceCache> &AcceptanceCacheRegistry()
+  {
+    static std::map<std::string, AliEmcalContainerAcceptanceCache> *registry = new std::map<std::string, AliEmcalContainerAcceptanceCache>;
+    return *registry;
+  }
+}
+
+/**
+ * Two containers are equivalent if they are of the same class, connected to the same
+ * array and if their persistent members, apart from the name, are identical. The
+ * latter is checked with the MD5 sum of a streamed copy of the container, in which
+ * the cut objects owned by the container (e.g. the track selection) are included.
+ * @param[in] cont Container
+ * @return Key identifying the equivalent containers
+ */
+std::string AliEmcalContainerAcceptanceCache::MakeKey(const AliEmcalContainer *cont)
+{
+  AliEmcalContainer *config = static_cast<AliEmcalContainer*>(cont->Clone());
+  config->SetName("");
+  TBufferFile buffer(TBuffer::kWrite);
+  buffer.WriteObjectAny(config, config->IsA());
+  delete config;
+
+  TMD5 md5;
+  md5.Update(reinterpret_cast<const UChar_t*>(buffer.Buffer()), buffer.Length());
+  md5.Final();
+
+  return Form("%s_%p_%s", cont->IsA()->GetName(), static_cast<const void*>(cont->GetArray()), md5.AsString());
+}
+
+AliEmcalContainerAcceptanceCache *AliEmcalContainerAcceptanceCache::GetCache(const AliEmcalContainer *cont)
+{
+  if (!cont->GetArray()) return 0;
+  std::string key = MakeKey(cont);
+  AliDebugGeneralStream("AliEmcalContainerAcceptanceCache", 2) << "Container " << cont->GetName() << " uses the acceptance cache " << key << "\n";
+  // std::map does not move its elements, the pointer stays valid until the cache is released
+  AliEmcalContainerAcceptanceCache *cache = &AcceptanceCacheRegistry()[key];
+  cache->fKey = key;
+  cache->fNUsers++;
+  return cache;
+}
+
+void AliEmcalContainerAcceptanceCache::ReleaseCache(AliEmcalContainerAcceptanceCache *cache)
+{
+  if (!cache) return;
+  if (--cache->fNUsers > 0) return;
+  const std::string key = cache->fKey; // the cache is deleted by the erase
+  AliDebugGeneralStream("AliEmcalContainerAcceptanceCache", 2) << "Deleting the acceptance cache " << key << "\n";
+  AcceptanceCacheRegistry().erase(key);
+}
+
+Int_t AliEmcalContainerAcceptanceCache::GetNCaches()
+{
+  return AcceptanceCacheRegistry().size();
+}
+
+void AliEmcalContainerAcceptanceCache::Fill(const AliEmcalContainer *cont, Long64_t entry)
+{
+  fEntry = entry;
+  fNEntries = cont->GetNEntries();
+
+  fAcceptedIndices.clear();
+  fAcceptedPt.clear();
+  fAcceptedEta.clear();
+  fAcceptedPhi.clear();
+  fAcceptedE.clear();
+  fAccepted.resize(fNEntries);
+  fRejectionReasons.resize(fNEntries);
+  fPx.resize(fNEntries);
+  fPy.resize(fNEntries);
+  fPz.resize(fNEntries);
+  fE.resize(fNEntries);
+
+  AliTLorentzVector mom;
+  for (Int_t i = 0; i < fNEntries; i++) {
+    UInt_t rejectionReason = 0;
+    Bool_t accepted = cont->AcceptObject(i, rejectionReason);
+    cont->GetMomentum(mom, i);
+
+    fAccepted[i] = accepted;
+    fRejectionReasons[i] = rejectionReason;
+    fPx[i] = mom.Px();
+    fPy[i] = mom.Py();
+    fPz[i] = mom.Pz();
+    fE[i] = mom.E();
+
+    if (!accepted) continue;
+    fAcceptedIndices.push_back(i);
+    fAcceptedPt.push_back(mom.Pt());
+    fAcceptedEta.push_back(mom.Eta());
+    fAcceptedPhi.push_back(mom.Phi_0_2pi());
+    fAcceptedE.push_back(mom.E());
+  }
+}
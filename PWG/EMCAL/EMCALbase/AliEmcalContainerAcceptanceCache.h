@@ -0,0 +1,163 @@
+/************************************************************************************
+ * Copyright (C) 2016, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALCONTAINERACCEPTANCECACHE_H
+#define ALIEMCALCONTAINERACCEPTANCECACHE_H
+
+#include <string>
+#include <vector>
+
+#include <TLorentzVector.h>
+
+class AliEmcalContainer;
+
+/**
+ * @class AliEmcalContainerAcceptanceCache
+ * @brief Selection and momenta of the entries of an EMCAL container in the current event
+ * @ingroup EMCALCOREFW
+ *
+ * The accepted() and accepted_momentum() iterators apply the selection of the container
+ * to every entry each time they are created, and all_momentum() rebuilds the momentum
+ * vectors of all entries. In a train many tasks use containers with identical settings
+ * on the same array, so the same cuts are evaluated many times per event.
+ *
+ * Containers with AliEmcalContainer::SetUseAcceptanceCache share an object of this
+ * class with all the equivalent containers (same class, same array, same streamed
+ * configuration, see GetCache). The first container asking for it in an event fills
+ * - the list of accepted indices,
+ * - the rejection reason of every entry,
+ * - the momentum of every entry, as returned by AliEmcalContainer::GetMomentum,
+ * - packed \f$ p_{t} \f$, \f$ \eta \f$, \f$ \phi \f$ (in [0, 2\f$\pi\f$]) and E arrays
+ *   of the accepted entries, for tasks which only need the kinematics,
+ * and the other containers reuse it until the next event.
+ */
+class AliEmcalContainerAcceptanceCache {
+ public:
+  AliEmcalContainerAcceptanceCache();
+  ~AliEmcalContainerAcceptanceCache() {}
+
+  /**
+   * @brief Get the cache shared by all the containers equivalent to cont.
+   *
+   * Must be called once the container is connected to its array.
+   * Each call must be matched by a call to ReleaseCache.
+   * @param[in] cont Container
+   * @return Shared cache (owned by the registry)
+   */
+  static AliEmcalContainerAcceptanceCache *GetCache(const AliEmcalContainer *cont);
+
+  /**
+   * @brief Release a cache obtained with GetCache
+   *
+   * The registry deletes the cache once all the containers using it released it.
+   * Containers do so in their destructor, i.e. when the task owning them is deleted.
+   * @param[in] cache Cache returned by GetCache
+   */
+  static void ReleaseCache(AliEmcalContainerAcceptanceCache *cache);
+
+  /**
+   * @brief Number of caches in the registry
+   * @return Number of caches used by at least one container
+   */
+  static Int_t GetNCaches();
+
+  /**
+   * @brief Key identifying the containers equivalent to cont
+   *
+   * Must be called once the container is connected to its array.
+   * @param[in] cont Container
+   * @return Key (class, array and MD5 sum of the streamed configuration)
+   */
+  static std::string MakeKey(const AliEmcalContainer *cont);
+
+  /**
+   * @brief Whether the content was filled for the given event
+   * @param[in] entry Entry of the event in the analysis manager
+   * @param[in] nEntries Number of entries in the array of the container
+   * @return True if the content can be used
+   */
+  Bool_t          IsValid(Long64_t entry, Int_t nEntries) const { return fEntry == entry && fNEntries == nEntries; }
+
+  /**
+   * @brief Apply the selection of the container to all its entries
+   * @param[in] cont Container (one of the equivalent containers)
+   * @param[in] entry Entry of the event in the analysis manager
+   */
+  void            Fill(const AliEmcalContainer *cont, Long64_t entry);
+
+  Int_t           GetNEntries()                   const { return fNEntries                            ; }
+  Int_t           GetNAccepted()                  const { return fAcceptedIndices.size()              ; }
+  const Int_t    *GetAcceptedIndices()            const { return fAcceptedIndices.data()              ; }
+  Bool_t          IsAccepted(Int_t i)             const { return fAccepted[i]                         ; }
+  UInt_t          GetRejectionReason(Int_t i)     const { return fRejectionReasons[i]                 ; }
+  inline void     GetMomentum(TLorentzVector &mom, Int_t i) const;
+
+  /// \f$ p_{t} \f$ of the accepted entries, in the order of GetAcceptedIndices
+  const Double_t *GetAcceptedPt()                 const { return fAcceptedPt.data()                   ; }
+  /// \f$ \eta \f$ of the accepted entries, in the order of GetAcceptedIndices
+  const Double_t *GetAcceptedEta()                const { return fAcceptedEta.data()                  ; }
+  /// \f$ \phi \f$ (in [0, 2\f$\pi\f$]) of the accepted entries, in the order of GetAcceptedIndices
+  const Double_t *GetAcceptedPhi()                const { return fAcceptedPhi.data()                  ; }
+  /// Energy of the accepted entries, in the order of GetAcceptedIndices
+  const Double_t *GetAcceptedE()                  const { return fAcceptedE.data()                    ; }
+
+ protected:
+  Long64_t              fEntry;              ///< entry of the event the content belongs to
+  Int_t                 fNEntries;           ///< number of entries in the array
+  std::vector<Int_t>    fAcceptedIndices;    ///< indices of the accepted entries
+  std::vector<Char_t>   fAccepted;           ///< selection of each entry
+  std::vector<UInt_t>   fRejectionReasons;   ///< rejection reason of each entry
+  std::vector<Double_t> fPx;                 ///< momentum of each entry, x
+  std::vector<Double_t> fPy;                 ///< momentum of each entry, y
+  std::vector<Double_t> fPz;                 ///< momentum of each entry, z
+  std::vector<Double_t> fE;                  ///< energy of each entry
+  std::vector<Double_t> fAcceptedPt;         ///< \f$ p_{t} \f$ of the accepted entries
+  std::vector<Double_t> fAcceptedEta;        ///< \f$ \eta \f$ of the accepted entries
+  std::vector<Double_t> fAcceptedPhi;        ///< \f$ \phi \f$ of the accepted entries
+  std::vector<Double_t> fAcceptedE;          ///< energy of the accepted entries
+  std::string           fKey;                ///< key of the cache in the registry
+  Int_t                 fNUsers;             ///< number of containers using the cache
+
+ private:
+  AliEmcalContainerAcceptanceCache(const AliEmcalContainerAcceptanceCache&);            // not implemented
+  AliEmcalContainerAcceptanceCache &operator=(const AliEmcalContainerAcceptanceCache&); // not implemented
+};
+
+/**
+ * @brief Momentum of the entry i, identical to the one of AliEmcalContainer::GetMomentum
+ * @param[out] mom Momentum vector (null vector if the index is out of range)
+ * @param[in] i Index of the entry in the array
+ */
+void AliEmcalContainerAcceptanceCache::GetMomentum(TLorentzVector &mom, Int_t i) const
+{
+  if (i < 0 || i >= fNEntries) {
+    mom.SetPxPyPzE(0, 0, 0, 0);
+    return;
+  }
+  mom.SetPxPyPzE(fPx[i], fPy[i], fPz[i], fE[i]);
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include <type_traits>
 #include <TArrayI.h>
 #include "AliTLorentzVector.h"
+#include "AliEmcalContainerAcceptanceCache.h"
 
 
 #if (__GNUC__ >= 3) && !defined(__INTEL_COMPILER)
@@ -151,7 +152,8 @@ public:
       }
       else {
         this->fCurrentElement.second = (*fkData)[fCurrent];
-        fkData->GetContainer()->GetMomentum(this->fCurrentElement.first, fkData->GetInternalIndex(fCurrent));
+        if (fkData->fkCache) fkData->fkCache->GetMomentum(this->fCurrentElement.first, fkData->GetInternalIndex(fCurrent));
+        else fkData->GetContainer()->GetMomentum(this->fCurrentElement.first, fkData->GetInternalIndex(fCurrent));
       }
     }
   };
@@ -215,6 +217,7 @@ protected:
 
 private:
   const AliEmcalContainer     *fkContainer;         ///< Container to be iterated over
+  const AliEmcalContainerAcceptanceCache *fkCache;  ///< Selection and momenta of the container in the current event (if used)
   TArrayI                     fAcceptIndices;       ///< Array of accepted indices
   Bool_t                      fUseAccepted;         ///< Switch between accepted and all objects
 
@@ -242,6 +245,7 @@ namespace EMCALIterableContainer {
 template <typename T, typename STAR>
 AliEmcalIterableContainerT<T, STAR>::AliEmcalIterableContainerT():
   fkContainer(NULL),
+  fkCache(NULL),
   fAcceptIndices(),
   fUseAccepted(kFALSE)
 {
@@ -257,6 +261,7 @@ AliEmcalIterableContainerT<T, STAR>::AliEmcalIterableContainerT():
 template <typename T, typename STAR>
 AliEmcalIterableContainerT<T, STAR>::AliEmcalIterableContainerT(const AliEmcalContainer *cont, bool useAccept):
   fkContainer(cont),
+  fkCache(cont->GetAcceptanceCache()),
   fAcceptIndices(),
   fUseAccepted(useAccept)
 {
@@ -271,6 +276,7 @@ AliEmcalIterableContainerT<T, STAR>::AliEmcalIterableContainerT(const AliEmcalCo
 template <typename T, typename STAR>
 AliEmcalIterableContainerT<T, STAR>::AliEmcalIterableContainerT(const AliEmcalIterableContainerT<T, STAR> &ref):
   fkContainer(ref.fkContainer),
+  fkCache(ref.fkCache),
   fAcceptIndices(ref.fAcceptIndices),
   fUseAccepted(ref.fUseAccepted)
 {
@@ -287,6 +293,7 @@ template <typename T, typename STAR>
 AliEmcalIterableContainerT<T, STAR> &AliEmcalIterableContainerT<T, STAR>::operator=(const AliEmcalIterableContainerT<T, STAR>& ref) {
   if(this != &ref){
     fkContainer = ref.fkContainer;
+    fkCache = ref.fkCache;
     fAcceptIndices = ref.fAcceptIndices;
     fUseAccepted = ref.fUseAccepted;
   }
@@ -329,10 +336,15 @@ T *AliEmcalIterableContainerT<T, STAR>::operator[](int index) const {
 /**
  * Build list of accepted indices inside the container.
  * For this all objects inside the container are checked
- * for being accepted or not.
+ * for being accepted or not, unless the container shares
+ * its selection via the acceptance cache.
  */
 template <typename T, typename STAR>
 void AliEmcalIterableContainerT<T, STAR>::BuildAcceptIndices(){
+  if (fkCache) {
+    fAcceptIndices.Set(fkCache->GetNAccepted(), fkCache->GetAcceptedIndices());
+    return;
+  }
   fAcceptIndices.Set(fkContainer->GetNAcceptEntries());
   int acceptCounter = 0;
   for(int index = 0; index < fkContainer->GetNEntries(); index++){
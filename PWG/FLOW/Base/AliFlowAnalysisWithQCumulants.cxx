@@ -46,6 +46,7 @@
 #include "TArrayD.h"
 #include "TRandom.h"
 #include "TF1.h"
+#include <algorithm>
 
 class TH1;
 class TH2;
@@ -134,9 +135,17 @@ AliFlowAnalysisWithQCumulants::AliFlowAnalysisWithQCumulants():
  fUse2DHistograms(kFALSE),
  fFillProfilesVsMUsingWeights(kTRUE),
  fUseQvectorTerms(kFALSE),
+ fUseQvectorKernel(kTRUE),
  fReQ(NULL),
  fImQ(NULL),
  fSpk(NULL),
+ fTrackPhiEBE(),
+ fTrackPtEBE(),
+ fTrackEtaEBE(),
+ fTrackWeightEBE(),
+ fTrackTypeEBE(),
+ fDiffEntriesEBE(),
+ fDiffNCellsEBE(0),
  fIntFlowCorrelationsEBE(NULL),
  fIntFlowEventWeightsForCorrelationsEBE(NULL),
  fIntFlowCorrelationsAllEBE(NULL),
@@ -355,20 +364,11 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
  this->CheckPointersUsedInMake();
  
  // b) Define local variables:
- Double_t dPhi = 0.; // azimuthal angle in the laboratory frame
- Double_t dPt  = 0.; // transverse momentum
- Double_t dEta = 0.; // pseudorapidity
- Double_t wPhi = 1.; // phi weight
- Double_t wPt  = 1.; // pt weight
- Double_t wEta = 1.; // eta weight
- Double_t wTrack = 1.; // track weight
- Int_t nCounterNoRPs = 0; // needed only for shuffling
  fNumberOfRPsEBE = anEvent->GetNumberOfRPs(); // number of RPs (i.e. number of reference particles)
  if(fExactNoRPs > 0 && fNumberOfRPsEBE<fExactNoRPs){return;}
  fNumberOfPOIsEBE = anEvent->GetNumberOfPOIs(); // number of POIs (i.e. number of particles of interest)
  fReferenceMultiplicityEBE = anEvent->GetReferenceMultiplicity(); // reference multiplicity for current event
  //Printf("Reference multiplicity (QC): %.1f",fReferenceMultiplicityEBE);
- Double_t ptEta[2] = {0.,0.}; // 0 = dPt, 1 = dEta
   
  // c) Fill the common control histograms and call the method to fill fAvMultiplicity:
  this->FillCommonControlHistograms(anEvent);                                                               
@@ -376,6 +376,182 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
  if(fStoreControlHistograms){this->FillControlHistograms(anEvent);}                                                              
                                                                                                                                                                                                                                                                                         
  // d) Loop over data and calculate e-b-e quantities Q_{n,k}, S_{p,k} and s_{p,k}:
+ if(fUseQvectorKernel)
+ {
+  this->GatherTracksEBE(anEvent);
+  this->CalculateQvectorsEBE();
+ } else
+   {
+    this->FillQvectorsPerTrack(anEvent);
+   }
+
+ // e) Calculate the final expressions for S_{p,k} and s_{p,k} (important !!!!):
+ for(Int_t p=0;p<8;p++)
+ {
+  for(Int_t k=0;k<9;k++)
+  {
+   (*fSpk)(p,k)=pow((*fSpk)(p,k),p+1);
+   // ... for the time being s_{p,k} dosn't need higher powers, so no need to finalize it here ...
+  } // end of for(Int_t k=0;k<9;k++)  
+ } // end of for(Int_t p=0;p<8;p++)
+ 
+ // f) Call the methods which calculate correlations for reference flow:
+ if(!fEvaluateIntFlowNestedLoops)
+ {
+  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+  {
+   if(fNumberOfRPsEBE>1){this->CalculateIntFlowCorrelations();} // without using particle weights
+  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+    {
+     if(fNumberOfRPsEBE>1){this->CalculateIntFlowCorrelationsUsingParticleWeights();} // with using particle weights   
+    }        
+  // Whether or not using particle weights the following is calculated in the same way:  
+  if(fNumberOfRPsEBE>3){this->CalculateIntFlowProductOfCorrelations();}
+  if(fNumberOfRPsEBE>1){this->CalculateIntFlowSumOfEventWeights();}
+  if(fNumberOfRPsEBE>1){this->CalculateIntFlowSumOfProductOfEventWeights();}  
+  // Non-isotropic terms:
+  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+  {
+   if(fNumberOfRPsEBE>0){this->CalculateIntFlowCorrectionsForNUASinTerms();}
+   if(fNumberOfRPsEBE>0){this->CalculateIntFlowCorrectionsForNUACosTerms();}
+  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+    {
+     if(fNumberOfRPsEBE>0){this->CalculateIntFlowCorrectionsForNUASinTermsUsingParticleWeights();}
+     if(fNumberOfRPsEBE>0){this->CalculateIntFlowCorrectionsForNUACosTermsUsingParticleWeights();}     
+    }      
+  // Whether or not using particle weights the following is calculated in the same way:  
+  if(fNumberOfRPsEBE>0){this->CalculateIntFlowProductOfCorrectionTermsForNUA();}     
+  if(fNumberOfRPsEBE>0){this->CalculateIntFlowSumOfEventWeightsNUA();}     
+  if(fNumberOfRPsEBE>0){this->CalculateIntFlowSumOfProductOfEventWeightsNUA();}     
+  // Mixed harmonics:
+  if(fCalculateMixedHarmonics){this->CalculateMixedHarmonics();}
+ } // end of if(!fEvaluateIntFlowNestedLoops)
+
+ // g) Call the methods which calculate correlations for differential flow:
+ if(!fEvaluateDiffFlowNestedLoops && fCalculateDiffFlow)
+ {
+  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+  {
+   // Without using particle weights:
+   this->CalculateDiffFlowCorrelations("RP","Pt"); 
+   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrelations("RP","Eta");}
+   this->CalculateDiffFlowCorrelations("POI","Pt");
+   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrelations("POI","Eta");}
+   // Non-isotropic terms:
+   this->CalculateDiffFlowCorrectionsForNUASinTerms("RP","Pt");
+   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUASinTerms("RP","Eta");}
+   this->CalculateDiffFlowCorrectionsForNUASinTerms("POI","Pt");
+   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUASinTerms("POI","Eta");}
+   this->CalculateDiffFlowCorrectionsForNUACosTerms("RP","Pt");
+   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUACosTerms("RP","Eta");}
+   this->CalculateDiffFlowCorrectionsForNUACosTerms("POI","Pt");
+   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUACosTerms("POI","Eta");}   
+  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+    {
+     // With using particle weights:   
+     this->CalculateDiffFlowCorrelationsUsingParticleWeights("RP","Pt"); 
+     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrelationsUsingParticleWeights("RP","Eta");} 
+     this->CalculateDiffFlowCorrelationsUsingParticleWeights("POI","Pt"); 
+     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrelationsUsingParticleWeights("POI","Eta");} 
+     // Non-isotropic terms:
+     this->CalculateDiffFlowCorrectionsForNUASinTermsUsingParticleWeights("RP","Pt");
+     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUASinTermsUsingParticleWeights("RP","Eta");}
+     this->CalculateDiffFlowCorrectionsForNUASinTermsUsingParticleWeights("POI","Pt");
+     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUASinTermsUsingParticleWeights("POI","Eta");}
+     this->CalculateDiffFlowCorrectionsForNUACosTermsUsingParticleWeights("RP","Pt");
+     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUACosTermsUsingParticleWeights("RP","Eta");}
+     this->CalculateDiffFlowCorrectionsForNUACosTermsUsingParticleWeights("POI","Pt");
+     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUACosTermsUsingParticleWeights("POI","Eta");}   
+    }     
+  // Whether or not using particle weights the following is calculated in the same way:  
+  this->CalculateDiffFlowProductOfCorrelations("RP","Pt");
+  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowProductOfCorrelations("RP","Eta");}
+  this->CalculateDiffFlowProductOfCorrelations("POI","Pt");
+  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowProductOfCorrelations("POI","Eta");}
+  this->CalculateDiffFlowSumOfEventWeights("RP","Pt");
+  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowSumOfEventWeights("RP","Eta");}
+  this->CalculateDiffFlowSumOfEventWeights("POI","Pt");
+  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowSumOfEventWeights("POI","Eta");}
+  this->CalculateDiffFlowSumOfProductOfEventWeights("RP","Pt");
+  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowSumOfProductOfEventWeights("RP","Eta");}
+  this->CalculateDiffFlowSumOfProductOfEventWeights("POI","Pt");
+  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowSumOfProductOfEventWeights("POI","Eta");}   
+ } // end of if(!fEvaluateDiffFlowNestedLoops && fCalculateDiffFlow)
+
+ // h) Call the methods which calculate correlations for 2D differential flow:
+ if(!fEvaluateDiffFlowNestedLoops && fCalculate2DDiffFlow)
+ {
+  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+  {
+   // Without using particle weights:
+   this->Calculate2DDiffFlowCorrelations("RP"); 
+   this->Calculate2DDiffFlowCorrelations("POI");
+   // Non-isotropic terms:
+   // ... to be ctd ...
+  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+    {
+     // With using particle weights:   
+     // ... to be ctd ...  
+     // Non-isotropic terms:
+     // ... to be ctd ...
+    }     
+  // Whether or not using particle weights the following is calculated in the same way:  
+  // ... to be ctd ...   
+ } // end of if(!fEvaluateDiffFlowNestedLoops && fCalculate2DDiffFlow)
+ 
+ // i) Call the methods which calculate other differential correlators:
+ if(!fEvaluateDiffFlowNestedLoops && fCalculateDiffFlow)
+ {
+  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+  {
+   // Without using particle weights:
+   this->CalculateOtherDiffCorrelators("RP","Pt"); 
+   if(fCalculateDiffFlowVsEta){this->CalculateOtherDiffCorrelators("RP","Eta");}
+   this->CalculateOtherDiffCorrelators("POI","Pt"); 
+   if(fCalculateDiffFlowVsEta){this->CalculateOtherDiffCorrelators("POI","Eta");}     
+  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+    {
+     // With using particle weights:   
+     // ... to be ctd ...  
+    }     
+  // Whether or not using particle weights the following is calculated in the same way:  
+  // ... to be ctd ...   
+ } // end of if(!fEvaluateDiffFlowNestedLoops)
+ 
+ // j) Distributions of correlations:
+ if(fStoreDistributions){this->StoreDistributionsOfCorrelations();}
+ 
+ // k) Store phi distribution for one event to illustrate flow: 
+ if(fStorePhiDistributionForOneEvent){this->StorePhiDistributionForOneEvent(anEvent);}
+   
+ // l) Cross-check with nested loops correlators for reference flow:
+ if(fEvaluateIntFlowNestedLoops){this->EvaluateIntFlowNestedLoops(anEvent);} 
+
+ // m) Cross-check with nested loops correlators for differential flow:
+ if(fEvaluateDiffFlowNestedLoops){this->EvaluateDiffFlowNestedLoops(anEvent);} 
+ 
+ // n) Reset all event-by-event quantities (very important !!!!):
+ this->ResetEventByEventQuantities();
+ 
+} // end of AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::FillQvectorsPerTrack(AliFlowEventSimple *anEvent)
+{
+ // Calculate e-b-e quantities Q_{n,k}, S_{p,k} and s_{p,k} filling fReQ, fImQ, fSpk and the e-b-e profiles track by track.
+ // Remark: This is the original implementation, kept for cross-checking CalculateQvectorsEBE() (see SetUseQvectorKernel()).
+
+ Double_t dPhi = 0.; // azimuthal angle in the laboratory frame
+ Double_t dPt  = 0.; // transverse momentum
+ Double_t dEta = 0.; // pseudorapidity
+ Double_t wPhi = 1.; // phi weight
+ Double_t wPt  = 1.; // pt weight
+ Double_t wEta = 1.; // eta weight
+ Double_t wTrack = 1.; // track weight
+ Int_t nCounterNoRPs = 0; // needed only for shuffling
+ Double_t ptEta[2] = {0.,0.}; // 0 = dPt, 1 = dEta
+ 
  Int_t nPrim = anEvent->NumberOfTracks();  // nPrim = total number of primary tracks
  AliFlowTrackSimple *aftsTrack = NULL;
  Int_t n = fHarmonic; // shortcut for the harmonic 
@@ -548,155 +724,332 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
     }
  } // end of for(Int_t i=0;i<nPrim;i++) 
 
- // e) Calculate the final expressions for S_{p,k} and s_{p,k} (important !!!!):
- for(Int_t p=0;p<8;p++)
+} // end of void AliFlowAnalysisWithQCumulants::FillQvectorsPerTrack(AliFlowEventSimple *anEvent)
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::GatherTracksEBE(AliFlowEventSimple *anEvent)
+{
+ // Gather phi, pt, eta, particle weight and type of all RPs and POIs in this event into flat arrays.
+ // Remark: Particle weights are determined as in FillQvectorsPerTrack(), POIs which are not RPs are not weighted.
+
+ fTrackPhiEBE.clear();
+ fTrackPtEBE.clear();
+ fTrackEtaEBE.clear();
+ fTrackWeightEBE.clear();
+ fTrackTypeEBE.clear();
+
+ Int_t nPrim = anEvent->NumberOfTracks(); // nPrim = total number of primary tracks
+ Int_t nCounterNoRPs = 0; // needed only for shuffling
+ AliFlowTrackSimple *aftsTrack = NULL;
+ for(Int_t i=0;i<nPrim;i++) 
+ { 
+  if(fExactNoRPs > 0 && nCounterNoRPs>fExactNoRPs){continue;}
+  aftsTrack=anEvent->GetTrack(i);
+  if(!aftsTrack)
+  {
+   printf("\n WARNING (QC): No particle (i.e. aftsTrack is a NULL pointer in AFAWQC::GatherTracksEBE())!!!!\n\n");
+   continue;
+  }
+  Bool_t bRP = aftsTrack->InRPSelection();
+  Bool_t bPOI = aftsTrack->InPOISelection();
+  if(!(bRP || bPOI)){continue;} // safety measure: consider only tracks which are RPs or POIs
+  Double_t dPhi = aftsTrack->Phi();
+  Double_t dPt  = aftsTrack->Pt();
+  Double_t dEta = aftsTrack->Eta();
+  Double_t wPhi = 1.; // phi weight
+  Double_t wPt  = 1.; // pt weight
+  Double_t wEta = 1.; // eta weight
+  Double_t wTrack = 1.; // track weight
+  if(bRP)
+  {
+   nCounterNoRPs++;
+   if(fUsePhiWeights && fPhiWeights && fnBinsPhi) // determine phi weight for this particle:
+   {
+    wPhi = fPhiWeights->GetBinContent(1+(Int_t)(TMath::Floor(dPhi*fnBinsPhi/TMath::TwoPi())));
+   }
+   if(fUsePtWeights && fPtWeights && fnBinsPt) // determine pt weight for this particle:
+   {
+    wPt = fPtWeights->GetBinContent(1+(Int_t)(TMath::Floor((dPt-fPtMin)/fPtBinWidth))); 
+   }              
+   if(fUseEtaWeights && fEtaWeights && fEtaBinWidth) // determine eta weight for this particle: 
+   {
+    wEta = fEtaWeights->GetBinContent(1+(Int_t)(TMath::Floor((dEta-fEtaMin)/fEtaBinWidth))); 
+   }      
+   if(fUseTrackWeights) // access track weight:
+   {
+    wTrack = aftsTrack->Weight(); 
+   }
+  } // end of if(bRP)
+  fTrackPhiEBE.push_back(dPhi);
+  fTrackPtEBE.push_back(dPt);
+  fTrackEtaEBE.push_back(dEta);
+  fTrackWeightEBE.push_back(wPhi*wPt*wEta*wTrack);
+  fTrackTypeEBE.push_back((bRP ? 1 : 0) + (bPOI ? 2 : 0));
+ } // end of for(Int_t i=0;i<nPrim;i++) 
+
+} // end of void AliFlowAnalysisWithQCumulants::GatherTracksEBE(AliFlowEventSimple *anEvent)
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::CalculateQvectorsEBE()
+{
+ // Calculate e-b-e quantities Q_{n,k}, S_{p,k} and s_{p,k} from the flat arrays filled in GatherTracksEBE():
+ //  a) Reserve the flat buffers and reset the e-b-e statistics;
+ //  b) Loop over tracks: cos(m*n*phi) and sin(m*n*phi) from the Chebyshev recursion, w^k from successive products,
+ //     sums accumulated in the flat buffers (the inner loops run over contiguous arrays and are vectorized by the compiler);
+ //  c) Copy the flat buffers into fReQ, fImQ and fSpk;
+ //  d) Copy the flat buffers into the e-b-e profiles for differential flow and reset them.
+ // Remark: Tracks are summed in the same order as in FillQvectorsPerTrack(), so the results differ only by the rounding of cos, sin and w^k.
+
+ const Int_t nTracks = (Int_t)fTrackPhiEBE.size();
+ const Int_t n = fHarmonic; // shortcut for the harmonic 
+ const Int_t nPe = 1+(Int_t)fCalculateDiffFlowVsEta; // pt or eta
+ const Int_t typeMask[3] = {1,2,3}; // 0 = RP, 1 = POI, 2 = RP && POI
+ const Bool_t bStatOverflows = TH1::GetStatOverflows();
+
+ // a) Reserve the flat buffers:
+ for(Int_t m=0;m<12;m++)
  {
   for(Int_t k=0;k<9;k++)
   {
-   (*fSpk)(p,k)=pow((*fSpk)(p,k),p+1);
-   // ... for the time being s_{p,k} dosn't need higher powers, so no need to finalize it here ...
-  } // end of for(Int_t k=0;k<9;k++)  
- } // end of for(Int_t p=0;p<8;p++)
- 
- // f) Call the methods which calculate correlations for reference flow:
- if(!fEvaluateIntFlowNestedLoops)
+   fQvectorEBE[0][m][k] = 0.;
+   fQvectorEBE[1][m][k] = 0.;
+  }
+ }
+ for(Int_t k=0;k<9;k++)
  {
-  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+  fSkEBE[k] = 0.;
+ }
+ TAxis *axis[2] = {NULL,NULL};
+ Int_t nCells[2] = {0,0}; // number of bins including underflow and overflow
+ if(fCalculateDiffFlow)
+ {
+  for(Int_t pe=0;pe<nPe;pe++)
   {
-   if(fNumberOfRPsEBE>1){this->CalculateIntFlowCorrelations();} // without using particle weights
-  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+   axis[pe] = fReRPQ1dEBE[0][pe][0][0]->GetXaxis(); // all e-b-e profiles vs pt (eta) have the same binning
+   nCells[pe] = axis[pe]->GetNbins()+2;
+  }
+  Int_t nCellsMax = TMath::Max(nCells[0],nCells[1]);
+  if(nCellsMax != fDiffNCellsEBE) // buffers are kept empty between events, hence reset only when resized
+  {
+   fDiffNCellsEBE = nCellsMax;
+   for(Int_t q=0;q<4;q++){fDiffQvectorEBE[q].assign(3*2*fDiffNCellsEBE*4*9,0.);}
+   for(Int_t s=0;s<2;s++){fDiffSkEBE[s].assign(3*2*fDiffNCellsEBE*9,0.);}
+   fDiffEntriesEBE.assign(3*2*fDiffNCellsEBE,0.);
+  }
+  for(Int_t t=0;t<3;t++)
+  {
+   for(Int_t pe=0;pe<2;pe++)
+   {
+    for(Int_t s=0;s<4;s++)
     {
-     if(fNumberOfRPsEBE>1){this->CalculateIntFlowCorrelationsUsingParticleWeights();} // with using particle weights   
-    }        
-  // Whether or not using particle weights the following is calculated in the same way:  
-  if(fNumberOfRPsEBE>3){this->CalculateIntFlowProductOfCorrelations();}
-  if(fNumberOfRPsEBE>1){this->CalculateIntFlowSumOfEventWeights();}
-  if(fNumberOfRPsEBE>1){this->CalculateIntFlowSumOfProductOfEventWeights();}  
-  // Non-isotropic terms:
-  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+     fDiffStatsEBE[t][pe][s] = 0.;
+    }
+   }
+  }
+ } // end of if(fCalculateDiffFlow)
+
+ // b) Loop over tracks:
+ Double_t dCos[12] = {0.}; // cos((m+1)*n*phi)
+ Double_t dSin[12] = {0.}; // sin((m+1)*n*phi)
+ Double_t dWk[9] = {0.}; // w^k
+ for(Int_t i=0;i<nTracks;i++)
+ {
+  const Double_t dPhi = fTrackPhiEBE[i];
+  dCos[0] = TMath::Cos(n*dPhi);
+  dSin[0] = TMath::Sin(n*dPhi);
+  const Double_t dTwoCos = 2.*dCos[0];
+  dCos[1] = dTwoCos*dCos[0]-1.;
+  dSin[1] = dTwoCos*dSin[0];
+  for(Int_t m=2;m<12;m++)
+  {
+   dCos[m] = dTwoCos*dCos[m-1]-dCos[m-2];
+   dSin[m] = dTwoCos*dSin[m-1]-dSin[m-2];
+  }
+  const Double_t dW = fTrackWeightEBE[i];
+  dWk[0] = 1.;
+  for(Int_t k=1;k<9;k++)
   {
-   if(fNumberOfRPsEBE>0){this->CalculateIntFlowCorrectionsForNUASinTerms();}
-   if(fNumberOfRPsEBE>0){this->CalculateIntFlowCorrectionsForNUACosTerms();}
-  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+   dWk[k] = dWk[k-1]*dW;
+  }
+  const Int_t type = fTrackTypeEBE[i];
+  // Re[Q_{m*n,k}], Im[Q_{m*n,k}] and S_{1,k} (RPs only):
+  if(type & 1)
+  {
+   for(Int_t m=0;m<12;m++)
+   {
+    Double_t *dReQ = fQvectorEBE[0][m];
+    Double_t *dImQ = fQvectorEBE[1][m];
+    for(Int_t k=0;k<9;k++)
     {
-     if(fNumberOfRPsEBE>0){this->CalculateIntFlowCorrectionsForNUASinTermsUsingParticleWeights();}
-     if(fNumberOfRPsEBE>0){this->CalculateIntFlowCorrectionsForNUACosTermsUsingParticleWeights();}     
-    }      
-  // Whether or not using particle weights the following is calculated in the same way:  
-  if(fNumberOfRPsEBE>0){this->CalculateIntFlowProductOfCorrectionTermsForNUA();}     
-  if(fNumberOfRPsEBE>0){this->CalculateIntFlowSumOfEventWeightsNUA();}     
-  if(fNumberOfRPsEBE>0){this->CalculateIntFlowSumOfProductOfEventWeightsNUA();}     
-  // Mixed harmonics:
-  if(fCalculateMixedHarmonics){this->CalculateMixedHarmonics();}
- } // end of if(!fEvaluateIntFlowNestedLoops)
-
- // g) Call the methods which calculate correlations for differential flow:
- if(!fEvaluateDiffFlowNestedLoops && fCalculateDiffFlow)
- {
-  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+     dReQ[k] += dWk[k]*dCos[m];
+     dImQ[k] += dWk[k]*dSin[m];
+    }
+   }
+   for(Int_t k=0;k<9;k++)
+   {
+    fSkEBE[k] += dWk[k];
+   }
+  } // end of if(type & 1)
+  // r_{m*n,k}, p_{m*n,k}, q_{m*n,k} and s_{p,k} vs pt and eta:
+  if(fCalculateDiffFlow)
   {
-   // Without using particle weights:
-   this->CalculateDiffFlowCorrelations("RP","Pt"); 
-   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrelations("RP","Eta");}
-   this->CalculateDiffFlowCorrelations("POI","Pt");
-   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrelations("POI","Eta");}
-   // Non-isotropic terms:
-   this->CalculateDiffFlowCorrectionsForNUASinTerms("RP","Pt");
-   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUASinTerms("RP","Eta");}
-   this->CalculateDiffFlowCorrectionsForNUASinTerms("POI","Pt");
-   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUASinTerms("POI","Eta");}
-   this->CalculateDiffFlowCorrectionsForNUACosTerms("RP","Pt");
-   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUACosTerms("RP","Eta");}
-   this->CalculateDiffFlowCorrectionsForNUACosTerms("POI","Pt");
-   if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUACosTerms("POI","Eta");}   
-  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+   const Double_t ptEta[2] = {fTrackPtEBE[i],fTrackEtaEBE[i]};
+   for(Int_t pe=0;pe<nPe;pe++)
+   {
+    const Int_t bin = axis[pe]->FindBin(ptEta[pe]);
+    const Bool_t bInStats = bStatOverflows || (bin > 0 && bin < nCells[pe]-1);
+    for(Int_t t=0;t<3;t++)
     {
-     // With using particle weights:   
-     this->CalculateDiffFlowCorrelationsUsingParticleWeights("RP","Pt"); 
-     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrelationsUsingParticleWeights("RP","Eta");} 
-     this->CalculateDiffFlowCorrelationsUsingParticleWeights("POI","Pt"); 
-     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrelationsUsingParticleWeights("POI","Eta");} 
-     // Non-isotropic terms:
-     this->CalculateDiffFlowCorrectionsForNUASinTermsUsingParticleWeights("RP","Pt");
-     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUASinTermsUsingParticleWeights("RP","Eta");}
-     this->CalculateDiffFlowCorrectionsForNUASinTermsUsingParticleWeights("POI","Pt");
-     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUASinTermsUsingParticleWeights("POI","Eta");}
-     this->CalculateDiffFlowCorrectionsForNUACosTermsUsingParticleWeights("RP","Pt");
-     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUACosTermsUsingParticleWeights("RP","Eta");}
-     this->CalculateDiffFlowCorrectionsForNUACosTermsUsingParticleWeights("POI","Pt");
-     if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowCorrectionsForNUACosTermsUsingParticleWeights("POI","Eta");}   
-    }     
-  // Whether or not using particle weights the following is calculated in the same way:  
-  this->CalculateDiffFlowProductOfCorrelations("RP","Pt");
-  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowProductOfCorrelations("RP","Eta");}
-  this->CalculateDiffFlowProductOfCorrelations("POI","Pt");
-  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowProductOfCorrelations("POI","Eta");}
-  this->CalculateDiffFlowSumOfEventWeights("RP","Pt");
-  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowSumOfEventWeights("RP","Eta");}
-  this->CalculateDiffFlowSumOfEventWeights("POI","Pt");
-  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowSumOfEventWeights("POI","Eta");}
-  this->CalculateDiffFlowSumOfProductOfEventWeights("RP","Pt");
-  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowSumOfProductOfEventWeights("RP","Eta");}
-  this->CalculateDiffFlowSumOfProductOfEventWeights("POI","Pt");
-  if(fCalculateDiffFlowVsEta){this->CalculateDiffFlowSumOfProductOfEventWeights("POI","Eta");}   
- } // end of if(!fEvaluateDiffFlowNestedLoops && fCalculateDiffFlow)
+     if((type & typeMask[t]) != typeMask[t]){continue;}
+     const Int_t cell = (t*2+pe)*fDiffNCellsEBE+bin;
+     Double_t *dReQ = &fDiffQvectorEBE[0][cell*36];
+     Double_t *dReQ2 = &fDiffQvectorEBE[1][cell*36];
+     Double_t *dImQ = &fDiffQvectorEBE[2][cell*36];
+     Double_t *dImQ2 = &fDiffQvectorEBE[3][cell*36];
+     for(Int_t m=0;m<4;m++)
+     {
+      for(Int_t k=0;k<9;k++)
+      {
+       const Double_t dRe = dWk[k]*dCos[m];
+       const Double_t dIm = dWk[k]*dSin[m];
+       dReQ[m*9+k] += dRe;
+       dReQ2[m*9+k] += dRe*dRe;
+       dImQ[m*9+k] += dIm;
+       dImQ2[m*9+k] += dIm*dIm;
+      }
+     }
+     if(t != 1) // s_{p,k} is not needed for POIs
+     {
+      Double_t *dSk = &fDiffSkEBE[0][cell*9];
+      Double_t *dSk2 = &fDiffSkEBE[1][cell*9];
+      for(Int_t k=0;k<9;k++)
+      {
+       dSk[k] += dWk[k];
+       dSk2[k] += dWk[k]*dWk[k];
+      }
+     }
+     fDiffEntriesEBE[cell] += 1.;
+     fDiffStatsEBE[t][pe][0] += 1.;
+     if(bInStats)
+     {
+      fDiffStatsEBE[t][pe][1] += 1.;
+      fDiffStatsEBE[t][pe][2] += ptEta[pe];
+      fDiffStatsEBE[t][pe][3] += ptEta[pe]*ptEta[pe];
+     }
+    } // end of for(Int_t t=0;t<3;t++)
+   } // end of for(Int_t pe=0;pe<nPe;pe++)
+  } // end of if(fCalculateDiffFlow)
+  // 2D profiles are filled directly, only cos, sin and w^k are reused:
+  if(fCalculate2DDiffFlow)
+  {
+   for(Int_t t=0;t<3;t++)
+   {
+    if((type & typeMask[t]) != typeMask[t]){continue;}
+    for(Int_t k=0;k<9;k++)
+    {
+     for(Int_t m=0;m<4;m++)
+     {
+      fReRPQ2dEBE[t][m][k]->Fill(fTrackPtEBE[i],fTrackEtaEBE[i],dWk[k]*dCos[m],1.);
+      fImRPQ2dEBE[t][m][k]->Fill(fTrackPtEBE[i],fTrackEtaEBE[i],dWk[k]*dSin[m],1.);
+     }
+     if(t != 1){fs2dEBE[t][k]->Fill(fTrackPtEBE[i],fTrackEtaEBE[i],dWk[k],1.);}
+    }
+   } // end of for(Int_t t=0;t<3;t++)
+  } // end of if(fCalculate2DDiffFlow)
+ } // end of for(Int_t i=0;i<nTracks;i++)
 
- // h) Call the methods which calculate correlations for 2D differential flow:
- if(!fEvaluateDiffFlowNestedLoops && fCalculate2DDiffFlow)
+ // c) Copy the flat buffers into fReQ, fImQ and fSpk (final calculation of S_{p,k} follows in Make()):
+ for(Int_t m=0;m<12;m++)
  {
-  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+  for(Int_t k=0;k<9;k++)
   {
-   // Without using particle weights:
-   this->Calculate2DDiffFlowCorrelations("RP"); 
-   this->Calculate2DDiffFlowCorrelations("POI");
-   // Non-isotropic terms:
-   // ... to be ctd ...
-  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
-    {
-     // With using particle weights:   
-     // ... to be ctd ...  
-     // Non-isotropic terms:
-     // ... to be ctd ...
-    }     
-  // Whether or not using particle weights the following is calculated in the same way:  
-  // ... to be ctd ...   
- } // end of if(!fEvaluateDiffFlowNestedLoops && fCalculate2DDiffFlow)
- 
- // i) Call the methods which calculate other differential correlators:
- if(!fEvaluateDiffFlowNestedLoops && fCalculateDiffFlow)
+   (*fReQ)(m,k) += fQvectorEBE[0][m][k];
+   (*fImQ)(m,k) += fQvectorEBE[1][m][k];
+  }
+ }
+ for(Int_t p=0;p<8;p++)
  {
-  if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+  for(Int_t k=0;k<9;k++)
   {
-   // Without using particle weights:
-   this->CalculateOtherDiffCorrelators("RP","Pt"); 
-   if(fCalculateDiffFlowVsEta){this->CalculateOtherDiffCorrelators("RP","Eta");}
-   this->CalculateOtherDiffCorrelators("POI","Pt"); 
-   if(fCalculateDiffFlowVsEta){this->CalculateOtherDiffCorrelators("POI","Eta");}     
-  } else // to if(!(fUsePhiWeights||fUsePtWeights||fUseEtaWeights||fUseTrackWeights))
+   (*fSpk)(p,k) += fSkEBE[k];
+  }
+ }
+
+ // d) Copy the flat buffers into the e-b-e profiles for differential flow and reset them:
+ if(!fCalculateDiffFlow){return;}
+ for(Int_t t=0;t<3;t++)
+ {
+  for(Int_t pe=0;pe<nPe;pe++)
+  {
+   const Int_t cell0 = (t*2+pe)*fDiffNCellsEBE;
+   const Double_t *dEntries = &fDiffEntriesEBE[cell0];
+   for(Int_t m=0;m<4;m++)
+   {
+    for(Int_t k=0;k<9;k++)
     {
-     // With using particle weights:   
-     // ... to be ctd ...  
-    }     
-  // Whether or not using particle weights the following is calculated in the same way:  
-  // ... to be ctd ...   
- } // end of if(!fEvaluateDiffFlowNestedLoops)
- 
- // j) Distributions of correlations:
- if(fStoreDistributions){this->StoreDistributionsOfCorrelations();}
- 
- // k) Store phi distribution for one event to illustrate flow: 
- if(fStorePhiDistributionForOneEvent){this->StorePhiDistributionForOneEvent(anEvent);}
-   
- // l) Cross-check with nested loops correlators for reference flow:
- if(fEvaluateIntFlowNestedLoops){this->EvaluateIntFlowNestedLoops(anEvent);} 
+     this->FillProfileFromBuffersEBE(fReRPQ1dEBE[t][pe][m][k],&fDiffQvectorEBE[0][cell0*36+m*9+k],&fDiffQvectorEBE[1][cell0*36+m*9+k],36,dEntries,fDiffStatsEBE[t][pe]);
+     this->FillProfileFromBuffersEBE(fImRPQ1dEBE[t][pe][m][k],&fDiffQvectorEBE[2][cell0*36+m*9+k],&fDiffQvectorEBE[3][cell0*36+m*9+k],36,dEntries,fDiffStatsEBE[t][pe]);
+    }
+   }
+   if(t != 1)
+   {
+    for(Int_t k=0;k<9;k++)
+    {
+     this->FillProfileFromBuffersEBE(fs1dEBE[t][pe][k],&fDiffSkEBE[0][cell0*9+k],&fDiffSkEBE[1][cell0*9+k],9,dEntries,fDiffStatsEBE[t][pe]);
+    }
+   }
+   // reset only the bins which were filled:
+   for(Int_t b=0;b<nCells[pe];b++)
+   {
+    if(fDiffEntriesEBE[cell0+b] == 0.){continue;}
+    for(Int_t q=0;q<4;q++){std::fill(fDiffQvectorEBE[q].begin()+(cell0+b)*36,fDiffQvectorEBE[q].begin()+(cell0+b+1)*36,0.);}
+    for(Int_t s=0;s<2;s++){std::fill(fDiffSkEBE[s].begin()+(cell0+b)*9,fDiffSkEBE[s].begin()+(cell0+b+1)*9,0.);}
+    fDiffEntriesEBE[cell0+b] = 0.;
+   }
+  } // end of for(Int_t pe=0;pe<nPe;pe++)
+ } // end of for(Int_t t=0;t<3;t++)
 
- // m) Cross-check with nested loops correlators for differential flow:
- if(fEvaluateDiffFlowNestedLoops){this->EvaluateDiffFlowNestedLoops(anEvent);} 
- 
- // n) Reset all event-by-event quantities (very important !!!!):
- this->ResetEventByEventQuantities();
- 
-} // end of AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
+} // end of void AliFlowAnalysisWithQCumulants::CalculateQvectorsEBE()
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::FillProfileFromBuffersEBE(TProfile *profile, const Double_t *sumY, const Double_t *sumY2, Int_t stride, const Double_t *entries, const Double_t *stats)
+{
+ // Add the content of flat buffers to profile, as TProfile::Fill(x,y,1.) would do for each entry:
+ //  sumY[b*stride] and sumY2[b*stride] are sum of y and sum of y^2 in bin b, entries[b] is the number of entries in bin b,
+ //  stats = [number of fills, number of fills counted in statistics, sum of x, sum of x^2].
+
+ if(!profile || stats[0] == 0.){return;}
+ Double_t profileStats[6] = {0.}; // [sum w, sum w^2, sum wx, sum wx^2, sum wy, sum wy^2]
+ profile->GetStats(profileStats); // before the bin contents are changed (statistics of an empty profile are recalculated from them)
+ const Int_t nBins = profile->GetNbinsX();
+ const Bool_t bStatOverflows = TH1::GetStatOverflows();
+ Double_t *dSumWY = profile->GetArray();
+ Double_t *dSumWY2 = profile->GetSumw2()->GetArray();
+ TArrayD *binSumw2 = profile->GetBinSumw2();
+ for(Int_t b=0;b<nBins+2;b++)
+ {
+  if(entries[b] == 0.){continue;}
+  dSumWY[b] += sumY[b*stride];
+  dSumWY2[b] += sumY2[b*stride];
+  profile->SetBinEntries(b,profile->GetBinEntries(b)+entries[b]);
+  if(binSumw2->fN){binSumw2->fArray[b] += entries[b];}
+  if(bStatOverflows || (b > 0 && b <= nBins))
+  {
+   profileStats[4] += sumY[b*stride];
+   profileStats[5] += sumY2[b*stride];
+  }
+ }
+ profileStats[0] += stats[1];
+ profileStats[1] += stats[1];
+ profileStats[2] += stats[2];
+ profileStats[3] += stats[3];
+ profile->PutStats(profileStats);
+ profile->SetEntries(profile->GetEntries()+stats[0]);
+
+} // end of void AliFlowAnalysisWithQCumulants::FillProfileFromBuffersEBE(...)
 
 //=======================================================================================================================
 
@@ -15245,6 +15598,20 @@ void AliFlowAnalysisWithQCumulants::InitializeArraysForIntFlow()
 {
  // Initialize all arrays used to calculate integrated flow.
  
+ for(Int_t ri=0;ri<2;ri++) // real or imaginary part
+ {
+  for(Int_t m=0;m<12;m++) // multiple of harmonic
+  {
+   for(Int_t k=0;k<9;k++) // power of particle weight
+   {
+    fQvectorEBE[ri][m][k] = 0.;
+   }
+  }
+ }
+ for(Int_t k=0;k<9;k++) // power of particle weight
+ {
+  fSkEBE[k] = 0.;
+ }
  for(Int_t sc=0;sc<2;sc++) // sin or cos terms
  {
   fIntFlowCorrectionTermsForNUAEBE[sc] = NULL;
@@ -15352,6 +15719,10 @@ void AliFlowAnalysisWithQCumulants::InitializeArraysForDiffFlow()
      fs1dEBE[t][pe][k] = NULL; // to be improved (this doesn't need to be within loop over m)
     }   
    }
+   for(Int_t s=0;s<4;s++) // statistics of the profiles
+   {
+    fDiffStatsEBE[t][pe][s] = 0.;
+   }
   }
  }
  // 1D:
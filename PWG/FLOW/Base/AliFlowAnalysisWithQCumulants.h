@@ -18,6 +18,7 @@
 #include "TH2D.h"
 #include "TRandom3.h"
 #include "AliFlowCommonConstants.h"
+#include <vector>
 
 class TObjArray;
 class TList;
@@ -82,6 +83,10 @@ class AliFlowAnalysisWithQCumulants{
     virtual void FillCommonControlHistograms(AliFlowEventSimple *anEvent);
     virtual void FillControlHistograms(AliFlowEventSimple *anEvent);
     virtual void ResetEventByEventQuantities();
+    virtual void FillQvectorsPerTrack(AliFlowEventSimple *anEvent);
+    virtual void GatherTracksEBE(AliFlowEventSimple *anEvent);
+    virtual void CalculateQvectorsEBE();
+    virtual void FillProfileFromBuffersEBE(TProfile *profile, const Double_t *sumY, const Double_t *sumY2, Int_t stride, const Double_t *entries, const Double_t *stats);
     // 2b.) Reference flow:
     virtual void CalculateIntFlowCorrelations(); 
     virtual void CalculateIntFlowCorrelationsUsingParticleWeights();
@@ -287,6 +292,8 @@ class AliFlowAnalysisWithQCumulants{
   Bool_t GetFillProfilesVsMUsingWeights() const {return this->fFillProfilesVsMUsingWeights;};
   void SetUseQvectorTerms(Bool_t const uqvt){this->fUseQvectorTerms = uqvt;if(uqvt){this->fStoreControlHistograms = kTRUE;}};
   Bool_t GetUseQvectorTerms() const {return this->fUseQvectorTerms;};
+  void SetUseQvectorKernel(Bool_t const uqvk){this->fUseQvectorKernel = uqvk;};
+  Bool_t GetUseQvectorKernel() const {return this->fUseQvectorKernel;};
 
   // Reference flow profiles:
   void SetAvMultiplicity(TProfile* const avMultiplicity) {this->fAvMultiplicity = avMultiplicity;};
@@ -627,11 +634,24 @@ class AliFlowAnalysisWithQCumulants{
   Bool_t fUse2DHistograms; // use TH2D instead of TProfile to improve numerical stability in reference flow calculation 
   Bool_t fFillProfilesVsMUsingWeights; // if the width of multiplicity bin is 1, weights are not needed  
   Bool_t fUseQvectorTerms; // use TH2D with separate Q-vector terms instead of TProfile to improve numerical stability in reference flow calculation 
+  Bool_t fUseQvectorKernel; // accumulate Q-vectors on flat arrays and fill fReQ, fImQ, fSpk and fReRPQ1dEBE, ... once per event (kTRUE by default)
 
   //  3c.) event-by-event quantities:
   TMatrixD *fReQ; //! fReQ[m][k] = sum_{i=1}^{M} w_{i}^{k} cos(m*phi_{i})
   TMatrixD *fImQ; //! fImQ[m][k] = sum_{i=1}^{M} w_{i}^{k} sin(m*phi_{i})
   TMatrixD *fSpk; //! fSM[p][k] = (sum_{i=1}^{M} w_{i}^{k})^{p+1}
+  std::vector<Double_t> fTrackPhiEBE; //! phi of RPs and POIs in this event (gathered by GatherTracksEBE)
+  std::vector<Double_t> fTrackPtEBE; //! pt of RPs and POIs in this event
+  std::vector<Double_t> fTrackEtaEBE; //! eta of RPs and POIs in this event
+  std::vector<Double_t> fTrackWeightEBE; //! wPhi*wPt*wEta*wTrack for RPs, 1 for POIs which are not RPs
+  std::vector<Int_t> fTrackTypeEBE; //! 1 = RP, 2 = POI, 3 = RP && POI
+  Double_t fQvectorEBE[2][12][9]; //! [0=Re,1=Im][m][k], flat buffer copied into fReQ and fImQ
+  Double_t fSkEBE[9]; //! sum_{i=1}^{M} w_{i}^{k}, flat buffer used to fill fSpk
+  std::vector<Double_t> fDiffQvectorEBE[4]; //! [0=Re,1=Re^2,2=Im,3=Im^2] per [t][pe][bin][m][k], flat buffers copied into fReRPQ1dEBE and fImRPQ1dEBE
+  std::vector<Double_t> fDiffSkEBE[2]; //! [0=s,1=s^2] per [t][pe][bin][k], flat buffers copied into fs1dEBE
+  std::vector<Double_t> fDiffEntriesEBE; //! entries per [t][pe][bin]
+  Double_t fDiffStatsEBE[3][2][4]; //! [t][pe][0=fills,1=fills in range,2=sum x,3=sum x^2] for the statistics of the profiles
+  Int_t fDiffNCellsEBE; //! number of bins (including underflow and overflow) reserved per [t][pe] in the flat buffers
   TH1D *fIntFlowCorrelationsEBE; // 1st bin: <2>, 2nd bin: <4>, 3rd bin: <6>, 4th bin: <8>
   TH1D *fIntFlowEventWeightsForCorrelationsEBE; // 1st bin: eW_<2>, 2nd bin: eW_<4>, 3rd bin: eW_<6>, 4th bin: eW_<8>
   TH1D *fIntFlowCorrelationsAllEBE; // to be improved (add comment)
@@ -847,7 +867,7 @@ class AliFlowAnalysisWithQCumulants{
   TH2D *fBootstrapCumulants; // x-axis => QC{2}, QC{4}, QC{6}, QC{8}; y-axis => subsample # 
   TH2D *fBootstrapCumulantsVsM[4]; // index => QC{2}, QC{4}, QC{6}, QC{8}; x-axis => multiplicity; y-axis => subsample # 
 
-  ClassDef(AliFlowAnalysisWithQCumulants, 4);
+  ClassDef(AliFlowAnalysisWithQCumulants, 5);
 
 };
 
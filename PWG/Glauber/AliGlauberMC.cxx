@@ -22,10 +22,15 @@
 //  update:      You Zhou, Nikhef, yzhou@nikhef.nl
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <Riostream.h>
 #include <TMath.h>
 #include <TEllipse.h>
 #include <TRandom.h>
+#include <TRandom3.h>
+#include <TROOT.h>
 #include <TNamed.h>
 #include <TObjArray.h>
 #include <TNtuple.h>
@@ -40,6 +45,8 @@
 using std::flush;
 ClassImp(AliGlauberMC)
 
+static const Int_t kNtupleVars = 48; // number of variables of the ntuple
+
 //______________________________________________________________________________
 AliGlauberMC::AliGlauberMC(Option_t* NA, Option_t* NB, Double_t xsect) :
   TNamed(),
@@ -172,7 +179,14 @@ AliGlauberMC::AliGlauberMC(Option_t* NA, Option_t* NB, Double_t xsect) :
   fOmega(0),
   fSig0(0),
   fLambda(0),
-  fSigFluc(0)
+  fSigFluc(0),
+  fNThreads(1),
+  fSeed(0),
+  fRandom(0),
+  fSigFlucCumulative(),
+  fCellStart(),
+  fCellNucleons(),
+  fCandidates()
 {
   //ctor
   for (UInt_t i=0; i<(sizeof(fdNdEtaParam)/sizeof(fdNdEtaParam[0])); i++)
@@ -322,7 +336,14 @@ AliGlauberMC::AliGlauberMC(const AliGlauberMC& in):
   fOmega(in.fOmega),
   fSig0(in.fSig0),
   fLambda(in.fLambda),
-  fSigFluc(in.fSigFluc)
+  fSigFluc(in.fSigFluc),
+  fNThreads(in.fNThreads),
+  fSeed(in.fSeed),
+  fRandom(0),
+  fSigFlucCumulative(),
+  fCellStart(),
+  fCellNucleons(),
+  fCandidates()
 {
   //copy ctor
   memcpy(fdNdEtaParam,in.fdNdEtaParam,sizeof(fdNdEtaParam));
@@ -453,6 +474,8 @@ AliGlauberMC& AliGlauberMC::operator=(const AliGlauberMC& in)
   fSxyCom=in.fSxyCom;
   fX=in.fX;
   fNpp=in.fNpp;
+  fNThreads=in.fNThreads;
+  fSeed=in.fSeed;
   return *this;
 }
 
@@ -461,13 +484,8 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
 {
   // prepare event
 
-  if (fDoFluc) {
-    if (!fSigFluc) {
-      fSigFluc = new TF1("fSigFluc","[0]*x/[3]/(x/[3]+[1])*exp(-((x/[1]/[3]-1)/[2])^2)",0,250);
-      fSigFluc->SetParameters(1,fSig0,fOmega,fLambda);
-      cout << "Setting fluc: " << fSig0 << " " << fOmega << " " << fLambda << endl;
-    }
-  }
+  if (fDoFluc && !fSigFluc)
+    CreateSigFluc();
 
   fANucleus.ThrowNucleons(-bgen/2.);
   fNucleonsA = fANucleus.GetNucleons();
@@ -480,7 +498,7 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
     nucleonA->SetInNucleusA();
     nucleonA->SetSigNN(fXSect);
     if (fDoFluc)
-      nucleonA->SetSigNN(fSigFluc->GetRandom());
+      nucleonA->SetSigNN(GetRandomSigNN());
   }
   fBNucleus.ThrowNucleons(bgen/2.);
   fNucleonsB = fBNucleus.GetNucleons();
@@ -493,17 +511,11 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
     nucleonB->SetInNucleusB();
     nucleonB->SetSigNN(fXSect);
     if (fDoFluc)
-      nucleonB->SetSigNN(fSigFluc->GetRandom());
+      nucleonB->SetSigNN(GetRandomSigNN());
   }
 
-  if (fDoFluc) {
-    if (!fSigFluc) {
-      fSigFluc = new TF1("fSigFluc","[0]*x/[3]/(x/[3]+[1])*exp(-((x/[1]/[3]-1)/[2])^2)",0,250);
-      fSigFluc->SetParameters(1,fSig0,fOmega,fLambda);
-      cout << "Setting fluc: " << fSig0 << " " << fOmega << " " << fLambda << endl;
-    }
-    fXSect = fSigFluc->GetRandom();
-  }
+  if (fDoFluc)
+    fXSect = GetRandomSigNN();
   // "ball" diameter = distance at which two balls interact
   Double_t d2 = (Double_t)fXSect/(TMath::Pi()*10); // in fm^2
 
@@ -511,13 +523,9 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
   Double_t Nco   = 0;
   Double_t Ncohc = 0; // hard core
 
-  // for each of the A nucleons in nucleus B
-  for (Int_t i = 0; i<fBN; i++)
+  // collision test of nucleon j of nucleus A with nucleon i of nucleus B
+  auto collide = [&](AliGlauberNucleon *nucleonB, AliGlauberNucleon *nucleonA)
   {
-    AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
-    for (Int_t j = 0 ; j < fAN ; j++)
-    {
-      AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
       Double_t dx = nucleonB->GetX()-nucleonA->GetX();
       Double_t dy = nucleonB->GetY()-nucleonA->GetY();
       Double_t dij = dx*dx+dy*dy;
@@ -536,7 +544,89 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
 	if (dij<d2/4)
 	  ++Ncohc;
       }
+  };
+
+  // largest "ball" diameter of the pairs
+  Double_t d2Max = d2;
+  if (fDoFluc) {
+    d2Max = 0;
+    for (Int_t j = 0; j<fAN; j++)
+      d2Max = TMath::Max(d2Max,((AliGlauberNucleon*)fNucleonsA->UncheckedAt(j))->GetSigNN()/(TMath::Pi()*10));
+    for (Int_t i = 0; i<fBN; i++)
+      d2Max = TMath::Max(d2Max,((AliGlauberNucleon*)fNucleonsB->UncheckedAt(i))->GetSigNN()/(TMath::Pi()*10));
+  }
+
+  const Int_t kMinPairsCells = 1000; // below, all pairs are tested
+  const Int_t kMaxCells      = 64;   // max number of cells along x and y
+  if (fAN*fBN<kMinPairsCells || d2Max<=0) {
+    // for each of the A nucleons in nucleus B
+    for (Int_t i = 0; i<fBN; i++)
+    {
+      AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
+      for (Int_t j = 0 ; j < fAN ; j++)
+        collide(nucleonB,(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j)));
+    }
+  } else {
+    // cell list of the nucleons of nucleus A in the transverse plane, with cells
+    // at least as large as the ball diameter: the nucleons of nucleus B are tested
+    // only with the nucleons of A in the 3x3 cells around them, in the order of
+    // the loop over all pairs (same results)
+    Double_t xmin = 1e30, xmax = -1e30, ymin = 1e30, ymax = -1e30;
+    for (Int_t j = 0; j<fAN; j++) {
+      AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
+      xmin = TMath::Min(xmin,nucleonA->GetX());
+      xmax = TMath::Max(xmax,nucleonA->GetX());
+      ymin = TMath::Min(ymin,nucleonA->GetY());
+      ymax = TMath::Max(ymax,nucleonA->GetY());
+    }
+    const Double_t size = TMath::Sqrt(d2Max)*1.001;
+    const Double_t sizeX = TMath::Max(size,(xmax-xmin)/(kMaxCells-1));
+    const Double_t sizeY = TMath::Max(size,(ymax-ymin)/(kMaxCells-1));
+    const Int_t nx = TMath::Min(Int_t((xmax-xmin)/sizeX)+1,kMaxCells);
+    const Int_t ny = TMath::Min(Int_t((ymax-ymin)/sizeY)+1,kMaxCells);
+
+    // counting sort of the nucleons of A by cell, in the order of j within the cells
+    fCellStart.assign(nx*ny+1,0);
+    fCellNucleons.resize(fAN);
+    fCandidates.resize(fAN);
+    for (Int_t j = 0; j<fAN; j++) {
+      AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
+      Int_t cx = TMath::Min(Int_t((nucleonA->GetX()-xmin)/sizeX),nx-1);
+      Int_t cy = TMath::Min(Int_t((nucleonA->GetY()-ymin)/sizeY),ny-1);
+      fCandidates[j] = cy*nx+cx;
+      fCellStart[fCandidates[j]]++;
+    }
+    for (Int_t c = 1; c<nx*ny; c++)
+      fCellStart[c] += fCellStart[c-1];
+    fCellStart[nx*ny] = fAN;
+    for (Int_t j = fAN-1; j>=0; j--)
+      fCellNucleons[--fCellStart[fCandidates[j]]] = j;
+
+    for (Int_t i = 0; i<fBN; i++)
+    {
+      AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
+      Double_t fx = TMath::Floor((nucleonB->GetX()-xmin)/sizeX);
+      Double_t fy = TMath::Floor((nucleonB->GetY()-ymin)/sizeY);
+      if (fx<-1 || fx>nx || fy<-1 || fy>ny)
+        continue; // no nucleon of A within the ball diameter
+      Int_t cx = Int_t(fx);
+      Int_t cy = Int_t(fy);
+      Int_t nCandidates = 0;
+      for (Int_t ky = TMath::Max(cy-1,0); ky<=TMath::Min(cy+1,ny-1); ky++) {
+        for (Int_t kx = TMath::Max(cx-1,0); kx<=TMath::Min(cx+1,nx-1); kx++) {
+          Int_t c = ky*nx+kx;
+          for (Int_t k = fCellStart[c]; k<fCellStart[c+1]; k++)
+            fCandidates[nCandidates++] = fCellNucleons[k];
+        }
+      }
+      std::sort(fCandidates.begin(),fCandidates.begin()+nCandidates);
+      for (Int_t k = 0; k<nCandidates; k++)
+        collide(nucleonB,(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(fCandidates[k])));
     }
+    // cross section of the last pair, as after the loop over all pairs
+    if (fDoFluc)
+      fXSect = TMath::Max(((AliGlauberNucleon*)fNucleonsA->UncheckedAt(fAN-1))->GetSigNN(),
+                          ((AliGlauberNucleon*)fNucleonsB->UncheckedAt(fBN-1))->GetSigNN());
   }
 
   if (Nco>0) {
@@ -1267,7 +1357,7 @@ Int_t AliGlauberMC::NegativeBinomialRandom(Int_t k, Double_t nmean) const
   {
     array[i] = NegativeBinomialDistribution(i,k,nmean) + array[i-1];
   }
-  Double_t r = gRandom->Uniform(0,1);
+  Double_t r = GetRandomGenerator()->Uniform(0,1);
   return TMath::BinarySearch(fMaxPlot,array,r)+2;
 
 }
@@ -1278,7 +1368,7 @@ Int_t AliGlauberMC::NegativeBinomialRandomSV(Double_t k, Double_t nbar) const
   // negative binomial distribution generator, S. Voloshin, 09-May-2007
   Double_t sum=0.;
   Int_t i=0;
-  Double_t ran=gRandom->Rndm();
+  Double_t ran=GetRandomGenerator()->Rndm();
   Double_t trm=1./pow(1.+nbar/k,k);
   if (trm==0.)
   {
@@ -1308,7 +1398,7 @@ Int_t AliGlauberMC::DoubleNegativeBinomialRandom( Int_t k,
   {
     array[i] = alpha*NegativeBinomialDistribution(i,k,nmean)+(1-alpha)*NegativeBinomialDistribution(i,k2,nmean2) + array[i-1];
   }
-  Double_t r = gRandom->Uniform(0,1);
+  Double_t r = GetRandomGenerator()->Uniform(0,1);
   return TMath::BinarySearch(fMaxPlot,array,r)+2;
 }
 
@@ -1506,12 +1596,39 @@ Bool_t AliGlauberMC::NextEvent(Double_t bgen)
   {
     if(bgen<0||!succes) //get impactparameter
     {
-      bgen = TMath::Sqrt((fBMax*fBMax-fBMin*fBMin)*gRandom->Rndm()+fBMin*fBMin);
+      bgen = TMath::Sqrt((fBMax*fBMax-fBMin*fBMin)*GetRandomGenerator()->Rndm()+fBMin*fBMin);
     }
     if ( (succes=CalcEvent(bgen)) ) break; //ends if we have particparts
   }
   return succes;
 }
+
+//______________________________________________________________________________
+TRandom *AliGlauberMC::GetRandomGenerator() const
+{
+  //random generator of the events
+  return fRandom ? fRandom : gRandom;
+}
+
+//______________________________________________________________________________
+void AliGlauberMC::CreateSigFluc()
+{
+  //parameterization for fluctuating sigNN
+  fSigFluc = new TF1("fSigFluc","[0]*x/[3]/(x/[3]+[1])*exp(-((x/[1]/[3]-1)/[2])^2)",0,250);
+  fSigFluc->SetParameters(1,fSig0,fOmega,fLambda);
+  cout << "Setting fluc: " << fSig0 << " " << fOmega << " " << fLambda << endl;
+  if (fRandom)
+    AliGlauberNucleus::MakeCumulative(fSigFluc,fSigFlucCumulative);
+}
+
+//______________________________________________________________________________
+Double_t AliGlauberMC::GetRandomSigNN()
+{
+  //fluctuating sigNN (TF1::GetRandom uses gRandom, so the table is used with fRandom)
+  if (fRandom)
+    return AliGlauberNucleus::GetRandomFromCumulative(fSigFluc,fSigFlucCumulative,fRandom);
+  return fSigFluc->GetRandom();
+}
 //______________________________________________________________________________
 Double_t AliGlauberMC::GetEpsilon2Part() const
 {
@@ -1694,6 +1811,13 @@ void AliGlauberMC::Run(Int_t nevents)
                       "Npart:Ncoll:B:MeanX:MeanY:MeanX2:MeanY2:MeanXY:VarX:VarY:VarXY:MeanXSystem:MeanYSystem:MeanXA:MeanYA:MeanXB:MeanYB:VarE:Stoa:VarEColl:VarECom:VarEPart:VarEPartColl:VarEPartCom:dNdEta:dNdEtaGBW:dNdEtaTwoNBD:xsect:tAA:Epsl2:Epsl3:Epsl4:Epsl5:E2Coll:E3Coll:E4Coll:E5Coll:E2Com:E3Com:E4Com:E5Com:Psi2:Psi3:Psi4:Psi5:BNN:signn:Ncollw");
     fnt->SetDirectory(0);
   }
+  if (fNThreads>1 || fSeed>0)
+  {
+    RunInThreads(nevents);
+    return;
+  }
+
+  // one thread without seed: events from gRandom and TF1::GetRandom as before
   Int_t q = 0;
   Int_t u = 0;
   for (Int_t i = 0; i<nevents; i++)
@@ -1706,68 +1830,8 @@ void AliGlauberMC::Run(Int_t nevents)
     }
 
     q++;
-    Float_t v[48];
-    v[0]  = GetNpart();
-    v[1]  = GetNcoll();
-    v[2]  = fBMC;
-    v[3]  = fMeanXParts;
-    v[4]  = fMeanYParts;
-    v[5]  = fMeanX2Parts;
-    v[6]  = fMeanY2Parts;
-    v[7]  = fMeanXYParts;
-    v[8]  = fSx2Parts;
-    v[9]  = fSy2Parts;
-    v[10] = fSxyParts;
-    v[11] = fMeanXSystem;
-    v[12] = fMeanYSystem;
-    v[13] = fMeanXA;
-    v[14] = fMeanYA;
-    v[15] = fMeanXB;
-    v[16] = fMeanYB;
-    v[17] = GetEccentricity();
-    v[18] = GetStoa();
-    v[19] = GetEccentricityColl();
-    v[20] = GetEccentricityCom();
-    v[21] = GetEccentricityPart();
-    v[22] = GetEccentricityPartColl();
-    v[23] = GetEccentricityPartCom();
-    if (fDoPartProd)
-    {
-      v[24] = GetdNdEta();
-      v[25] = GetdNdEta();
-      v[26] = v[24]+v[25];
-    }
-    else
-    {
-      v[24] = 0;
-      v[25] = 0;
-      v[26] = 0;
-    }
-    v[27]=fXSect;
-
-    Float_t mytAA=-999;
-    if (GetNcoll()>0) mytAA=GetNcoll()/fXSect;
-    v[28]=mytAA;
-    //_____________epsilon2,3,4,4_______
-    v[29] = GetEpsilon2Part();
-    v[30] = GetEpsilon3Part();
-    v[31] = GetEpsilon4Part();
-    v[32] = GetEpsilon5Part();
-    v[33] = GetEpsilon2Coll();
-    v[34] = GetEpsilon3Coll();
-    v[35] = GetEpsilon4Coll();
-    v[36] = GetEpsilon5Coll();
-    v[37] = GetEpsilon2Com();
-    v[38] = GetEpsilon3Com();
-    v[39] = GetEpsilon4Com();
-    v[40] = GetEpsilon5Com();
-    v[41] = GetPsi2();
-    v[42] = GetPsi3();
-    v[43] = GetPsi4();
-    v[44] = GetPsi5();
-    v[45] = fBNN;
-    v[46] = fXSect;
-    v[47] = fNcollw;
+    Float_t v[kNtupleVars];
+    GetNtupleValues(v);
 
     //always at the end
     fnt->Fill(v);
@@ -1777,6 +1841,197 @@ void AliGlauberMC::Run(Int_t nevents)
   std::cout << "Generating Event # " << nevents << "... \r" << endl << "Done! Succesfull events:  " << q << "  discarded events:  " << u <<"."<< endl;
 }
 
+//______________________________________________________________________________
+void AliGlauberMC::GetNtupleValues(Float_t *v) const
+{
+  //values of the ntuple for the current event
+  v[0]  = GetNpart();
+  v[1]  = GetNcoll();
+  v[2]  = fBMC;
+  v[3]  = fMeanXParts;
+  v[4]  = fMeanYParts;
+  v[5]  = fMeanX2Parts;
+  v[6]  = fMeanY2Parts;
+  v[7]  = fMeanXYParts;
+  v[8]  = fSx2Parts;
+  v[9]  = fSy2Parts;
+  v[10] = fSxyParts;
+  v[11] = fMeanXSystem;
+  v[12] = fMeanYSystem;
+  v[13] = fMeanXA;
+  v[14] = fMeanYA;
+  v[15] = fMeanXB;
+  v[16] = fMeanYB;
+  v[17] = GetEccentricity();
+  v[18] = GetStoa();
+  v[19] = GetEccentricityColl();
+  v[20] = GetEccentricityCom();
+  v[21] = GetEccentricityPart();
+  v[22] = GetEccentricityPartColl();
+  v[23] = GetEccentricityPartCom();
+  if (fDoPartProd)
+  {
+    v[24] = GetdNdEta();
+    v[25] = GetdNdEta();
+    v[26] = v[24]+v[25];
+  }
+  else
+  {
+    v[24] = 0;
+    v[25] = 0;
+    v[26] = 0;
+  }
+  v[27]=fXSect;
+
+  Float_t mytAA=-999;
+  if (GetNcoll()>0) mytAA=GetNcoll()/fXSect;
+  v[28]=mytAA;
+  //_____________epsilon2,3,4,4_______
+  v[29] = GetEpsilon2Part();
+  v[30] = GetEpsilon3Part();
+  v[31] = GetEpsilon4Part();
+  v[32] = GetEpsilon5Part();
+  v[33] = GetEpsilon2Coll();
+  v[34] = GetEpsilon3Coll();
+  v[35] = GetEpsilon4Coll();
+  v[36] = GetEpsilon5Coll();
+  v[37] = GetEpsilon2Com();
+  v[38] = GetEpsilon3Com();
+  v[39] = GetEpsilon4Com();
+  v[40] = GetEpsilon5Com();
+  v[41] = GetPsi2();
+  v[42] = GetPsi3();
+  v[43] = GetPsi4();
+  v[44] = GetPsi5();
+  v[45] = fBNN;
+  v[46] = fXSect;
+  v[47] = fNcollw;
+}
+
+//______________________________________________________________________________
+AliGlauberMC *AliGlauberMC::CreateWorker() const
+{
+  //copy of the settings with its own nuclei and random generator, for RunInThreads
+  //(the copy constructor shares the functions of the nuclei)
+  AliGlauberMC *worker = new AliGlauberMC(fANucleus.GetName(),fBNucleus.GetName(),fXSect);
+  worker->fRandom = new TRandom3();
+  const AliGlauberNucleus *nuclei[2] = {&fANucleus,&fBNucleus};
+  AliGlauberNucleus *workerNuclei[2] = {&worker->fANucleus,&worker->fBNucleus};
+  for (Int_t i=0; i<2; i++)
+  {
+    workerNuclei[i]->SetN(nuclei[i]->GetN());
+    workerNuclei[i]->SetR(nuclei[i]->GetR());
+    workerNuclei[i]->SetA(nuclei[i]->GetA());
+    workerNuclei[i]->SetW(nuclei[i]->GetW());
+    workerNuclei[i]->SetMinDist(nuclei[i]->GetMinDist());
+    workerNuclei[i]->SetRandom(worker->fRandom);
+  }
+  worker->fBMin = fBMin;
+  worker->fBMax = fBMax;
+  worker->fMultType = fMultType;
+  memcpy(worker->fdNdEtaParam,fdNdEtaParam,sizeof(fdNdEtaParam));
+  worker->fX = fX;
+  worker->fNpp = fNpp;
+  worker->fDoPartProd = fDoPartProd;
+  worker->SetDoFluc(fOmega,fSig0,fLambda,fDoFluc);
+  if (fDoFluc)
+    worker->CreateSigFluc();
+  return worker;
+}
+
+//______________________________________________________________________________
+void AliGlauberMC::RunInThreads(Int_t nevents)
+{
+  //run on fNThreads threads: the events are generated in chunks of kChunkSize events,
+  //each with its own random generator seeded with fSeed + chunk index, and the ntuple
+  //is filled with the events of the chunks in their order. For a given seed, the
+  //ntuple is the same with any number of threads, including one. The radii and NN cross
+  //sections are sampled from tabulated cumulative distributions (see
+  //AliGlauberNucleus::SetRandom), so the events differ from the ones of the serial Run
+  //without seed.
+  const Int_t kChunkSize = 1000;
+  const Int_t nThreads = TMath::Max(fNThreads,1);
+  UInt_t seed = fSeed;
+  if (seed==0)
+  {
+    seed = 1 + gRandom->Integer(kMaxInt);
+    cout << "Seed of the random generators: " << seed << endl;
+  }
+  if (nThreads>1)
+    ROOT::EnableThreadSafety();
+
+  // the workers are created here, the TF1 constructor is not thread safe
+  std::vector<AliGlauberMC*> workers(nThreads);
+  for (Int_t iThread=0; iThread<nThreads; iThread++)
+    workers[iThread] = CreateWorker();
+
+  // ntuple rows of the chunks of one round
+  const Int_t nChunks = (nevents+kChunkSize-1)/kChunkSize;
+  const Int_t nChunksPerRound = 4*nThreads;
+  std::vector<std::vector<Float_t> > rows(nChunksPerRound);
+  std::vector<Int_t> discarded(nChunksPerRound);
+
+  Int_t q = 0;
+  Int_t u = 0;
+  for (Int_t firstChunk=0; firstChunk<nChunks; firstChunk+=nChunksPerRound)
+  {
+    const Int_t lastChunk = TMath::Min(firstChunk+nChunksPerRound,nChunks);
+    std::atomic<Int_t> nextChunk(firstChunk);
+    auto generateChunks = [&](Int_t iThread)
+    {
+      AliGlauberMC *worker = workers[iThread];
+      for (Int_t chunk=nextChunk++; chunk<lastChunk; chunk=nextChunk++)
+      {
+        std::vector<Float_t> &chunkRows = rows[chunk-firstChunk];
+        chunkRows.clear();
+        discarded[chunk-firstChunk] = 0;
+        worker->fRandom->SetSeed(seed+chunk);
+        worker->fXSect = fXSect;
+        const Int_t lastEvent = TMath::Min((chunk+1)*kChunkSize,nevents);
+        for (Int_t i=chunk*kChunkSize; i<lastEvent; i++)
+        {
+          if (!worker->NextEvent())
+          {
+            discarded[chunk-firstChunk]++;
+            continue;
+          }
+          chunkRows.resize(chunkRows.size()+kNtupleVars);
+          worker->GetNtupleValues(&chunkRows[chunkRows.size()-kNtupleVars]);
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (Int_t iThread=1; iThread<nThreads; iThread++)
+      threads.emplace_back(generateChunks,iThread);
+    generateChunks(0);
+    for (auto &thread : threads) thread.join();
+
+    //always at the end
+    for (Int_t chunk=firstChunk; chunk<lastChunk; chunk++)
+    {
+      const std::vector<Float_t> &chunkRows = rows[chunk-firstChunk];
+      for (size_t row=0; row<chunkRows.size(); row+=kNtupleVars)
+        fnt->Fill(&chunkRows[row]);
+      q += chunkRows.size()/kNtupleVars;
+      u += discarded[chunk-firstChunk];
+    }
+    std::cout << "Generating Event # " << TMath::Min(lastChunk*kChunkSize,nevents) << "... \r" << flush;
+  }
+
+  for (Int_t iThread=0; iThread<nThreads; iThread++)
+  {
+    AliGlauberMC *worker = workers[iThread];
+    fEvents += worker->fEvents;
+    fTotalEvents += worker->fTotalEvents;
+    fMaxNpartFound = TMath::Max(fMaxNpartFound,worker->fMaxNpartFound);
+    delete worker->fSigFluc;
+    delete worker->fRandom;
+    delete worker;
+  }
+  std::cout << "Generating Event # " << nevents << "... \r" << endl << "Done! Succesfull events:  " << q << "  discarded events:  " << u <<"."<< endl;
+}
+
 //---------------------------------------------------------------------------------
 void AliGlauberMC::RunAndSaveNtuple( Int_t n,
                                      const Option_t *sysA,
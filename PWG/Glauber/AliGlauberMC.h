@@ -16,9 +16,11 @@
 #include "AliGlauberNucleus.h"
 #include <Riostream.h>
 #include <TNamed.h>
+#include <vector>
 
 class TObjArray;
 class TNtuple;
+class TRandom;
 
 using std::cout;
 using std::endl;
@@ -100,6 +102,8 @@ public:
    void   Seta(Double_t a)  {fANucleus.SetA(a); fBNucleus.SetA(a);}
    void   SetDoFluc(Double_t omega, Double_t sig0, Double_t lam, Bool_t on=kTRUE) 
             {fDoFluc=on;fOmega=omega;fSig0=sig0;fLambda=lam;}
+   void   SetNThreads(Int_t n)        {fNThreads = n;}
+   void   SetSeed(UInt_t seed)        {fSeed = seed;}
    static void       PrintVersion()         {cout << "AliGlauberMC " << Version() << endl;}
    static const char *Version()             {return "v1.2";}
    static void       RunAndSaveNtuple( Int_t n,
@@ -251,9 +255,22 @@ private:
    Double_t     fSig0;           //regularization parameter 
    Double_t     fLambda;         //lambda parameter
    TF1         *fSigFluc;        //!parameterization for fluctuating sigNN
+   Int_t        fNThreads;       //number of threads of Run
+   UInt_t       fSeed;           //seed of the random generators of Run, same events for any number of threads (0: serial gRandom with one thread, from gRandom with more)
+   TRandom     *fRandom;         //!random generator of the events (gRandom if 0)
+   std::vector<Double_t> fSigFlucCumulative; //!cumulative distribution of fSigFluc used with fRandom
+   std::vector<Int_t> fCellStart;    //!first entry of each cell in fCellNucleons
+   std::vector<Int_t> fCellNucleons; //!nucleons of nucleus A ordered by transverse cell
+   std::vector<Int_t> fCandidates;   //!nucleons of nucleus A in the cells around a nucleon of nucleus B
    Bool_t       CalcResults(Double_t bgen);
+   void         CreateSigFluc();
+   Double_t     GetRandomSigNN();
+   TRandom     *GetRandomGenerator() const;
+   void         GetNtupleValues(Float_t *v) const;
+   AliGlauberMC *CreateWorker() const;
+   void         RunInThreads(Int_t nevents);
 
-   ClassDef(AliGlauberMC,4)
+   ClassDef(AliGlauberMC,5)
 };
 
 #endif
@@ -23,6 +23,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <Riostream.h>
 #include <TMath.h>
 #include <TEllipse.h>
@@ -49,7 +50,9 @@ AliGlauberNucleus::AliGlauberNucleus(Option_t* iname, Int_t iN, Double_t iR, Dou
   fF(0),
   fTrials(0),
   fFunction(ifunc),
-  fNucleons(NULL)
+  fNucleons(NULL),
+  fRandom(0),
+  fCumulative()
 {
    if (fN==0) {
       cout << "Setting up nucleus " << iname << endl;
@@ -77,7 +80,9 @@ AliGlauberNucleus::AliGlauberNucleus(const AliGlauberNucleus& in):
   fF(in.fF),
   fTrials(in.fTrials),
   fFunction(in.fFunction),
-  fNucleons(NULL)
+  fNucleons(NULL),
+  fRandom(0),
+  fCumulative()
 {
   //copy ctor
   if (in.fNucleons)
@@ -97,6 +102,8 @@ AliGlauberNucleus& AliGlauberNucleus::operator=(const AliGlauberNucleus& in)
   fF=in.fF;
   fTrials=in.fTrials;
   fFunction=in.fFunction;
+  fRandom=0;
+  fCumulative.clear();
   delete fNucleons;
   fNucleons=static_cast<TObjArray*>((in.fNucleons)->Clone());
   fNucleons->SetOwner();
@@ -189,6 +196,8 @@ void AliGlauberNucleus::SetR(Double_t ir)
          fFunction->SetParameter(0,fR);
          break;
    }
+   if (fRandom)
+      MakeCumulative(fFunction,fCumulative);
 }
 
 //______________________________________________________________________________
@@ -206,6 +215,8 @@ void AliGlauberNucleus::SetA(Double_t ia)
          fFunction->SetParameter(1,fA);
          break;
    }
+   if (fRandom)
+      MakeCumulative(fFunction,fCumulative);
 }
 
 //______________________________________________________________________________
@@ -223,6 +234,70 @@ void AliGlauberNucleus::SetW(Double_t iw)
          fFunction->SetParameter(2,fW);
          break;
    }
+   if (fRandom)
+      MakeCumulative(fFunction,fCumulative);
+}
+
+//______________________________________________________________________________
+void AliGlauberNucleus::SetRandom(TRandom* rnd)
+{
+   // sets the generator of the nucleon positions (gRandom if 0)
+   // with a generator, the radii are sampled from a table of the cumulative
+   // distribution of rho(r) instead of TF1::GetRandom, which always uses gRandom
+
+   fRandom = rnd;
+   if (fRandom)
+      MakeCumulative(fFunction,fCumulative);
+   else
+      fCumulative.clear();
+}
+
+//______________________________________________________________________________
+void AliGlauberNucleus::MakeCumulative(TF1* func, std::vector<Double_t>& cumulative, Int_t nbins)
+{
+   // tabulates the normalized cumulative distribution of func in nbins bins of its range
+
+   const Double_t xmin = func->GetXmin();
+   const Double_t dx = (func->GetXmax()-xmin)/nbins;
+   cumulative.resize(nbins+1);
+   cumulative[0] = 0;
+   for (Int_t i = 0; i<nbins; i++) {
+      Double_t x = xmin + i*dx;
+      Double_t integral = dx/6*(func->Eval(x)+4*func->Eval(x+dx/2)+func->Eval(x+dx));
+      cumulative[i+1] = cumulative[i] + TMath::Abs(integral);
+   }
+   if (cumulative[nbins]>0) {
+      for (Int_t i = 1; i<=nbins; i++)
+         cumulative[i] /= cumulative[nbins];
+   }
+}
+
+//______________________________________________________________________________
+Double_t AliGlauberNucleus::GetRandomFromCumulative(const TF1* func, const std::vector<Double_t>& cumulative, TRandom* rnd)
+{
+   // random number distributed as func, from its table made by MakeCumulative
+   // (linear interpolation within the bins, as TF1::GetRandom)
+
+   const Int_t nbins = cumulative.size()-1;
+   const Double_t xmin = func->GetXmin();
+   const Double_t dx = (func->GetXmax()-xmin)/nbins;
+   Double_t u = rnd->Rndm();
+   Int_t bin = std::upper_bound(cumulative.begin(),cumulative.end(),u)-cumulative.begin()-1;
+   if (bin<0) bin = 0;
+   if (bin>=nbins) bin = nbins-1;
+   Double_t width = cumulative[bin+1]-cumulative[bin];
+   Double_t frac = (width>0) ? (u-cumulative[bin])/width : 0;
+   return xmin + (bin+frac)*dx;
+}
+
+//______________________________________________________________________________
+Double_t AliGlauberNucleus::GetRandomRadius()
+{
+   // radius of a nucleon, distributed as rho(r)
+
+   if (fRandom)
+      return GetRandomFromCumulative(fFunction,fCumulative,fRandom);
+   return fFunction->GetRandom();
 }
 
 //______________________________________________________________________________
@@ -243,12 +318,14 @@ void AliGlauberNucleus::ThrowNucleons(Double_t xshift)
    Double_t sumy=0;       
    Double_t sumz=0;       
 
+   TRandom *rnd = fRandom ? fRandom : gRandom;
+
    Bool_t hulthen = (TString(GetName())=="dh");
    if (fN==2 && hulthen) { //special treatmeant for Hulten
 
-      Double_t r = fFunction->GetRandom()/2;
-      Double_t phi = gRandom->Rndm() * 2 * TMath::Pi() ;
-      Double_t ctheta = 2*gRandom->Rndm() - 1 ;
+      Double_t r = GetRandomRadius()/2;
+      Double_t phi = rnd->Rndm() * 2 * TMath::Pi() ;
+      Double_t ctheta = 2*rnd->Rndm() - 1 ;
       Double_t stheta = sqrt(1-ctheta*ctheta);
      
       AliGlauberNucleon *nucleon1=(AliGlauberNucleon*)(fNucleons->UncheckedAt(0));
@@ -270,9 +347,9 @@ void AliGlauberNucleus::ThrowNucleons(Double_t xshift)
       nucleon->Reset();
       while(1) {
          fTrials++;
-         Double_t r = fFunction->GetRandom();
-         Double_t phi = gRandom->Rndm() * 2 * TMath::Pi() ;
-         Double_t ctheta = 2*gRandom->Rndm() - 1 ;
+         Double_t r = GetRandomRadius();
+         Double_t phi = rnd->Rndm() * 2 * TMath::Pi() ;
+         Double_t ctheta = 2*rnd->Rndm() - 1 ;
          Double_t stheta = TMath::Sqrt(1-ctheta*ctheta);
          Double_t x = r * stheta * cos(phi) + xshift;
          Double_t y = r * stheta * sin(phi);      
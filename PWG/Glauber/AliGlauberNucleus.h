@@ -16,8 +16,10 @@
 
 //class TNamed;
 #include <TNamed.h>
+#include <vector>
 class TObjArray;
 class TF1;
+class TRandom;
 
 class AliGlauberNucleus : public TNamed {
 private:
@@ -30,8 +32,11 @@ private:
    Int_t      fTrials;     //Store trials needed to complete nucleus
    TF1*       fFunction;   //Probability density function rho(r)
    TObjArray* fNucleons;   //Array of nucleons
+   TRandom*   fRandom;     //!Random generator of the nucleon positions (gRandom if 0)
+   std::vector<Double_t> fCumulative; //!Cumulative distribution of rho(r) used with fRandom
 
    void       Lookup(Option_t* name);
+   Double_t   GetRandomRadius();
 
 public:
    AliGlauberNucleus(Option_t* iname="Au", Int_t iN=0, Double_t iR=0, Double_t ia=0, Double_t iw=0, TF1* ifunc=0);
@@ -47,13 +52,18 @@ public:
    Double_t   GetW()             const {return fW;}
    TObjArray *GetNucleons()      const {return fNucleons;}
    Int_t      GetTrials()        const {return fTrials;}
+   Double_t   GetMinDist()       const {return fMinDist;}
    void       SetN(Int_t in)           {fN=in;}
    void       SetR(Double_t ir);
    void       SetA(Double_t ia);
    void       SetW(Double_t iw);
    void       SetMinDist(Double_t min) {fMinDist=min;}
+   void       SetRandom(TRandom* rnd);
    void       ThrowNucleons(Double_t xshift=0.);
 
+   static void     MakeCumulative(TF1* func, std::vector<Double_t>& cumulative, Int_t nbins=1000);
+   static Double_t GetRandomFromCumulative(const TF1* func, const std::vector<Double_t>& cumulative, TRandom* rnd);
+
    ClassDef(AliGlauberNucleus,1)
 };
 
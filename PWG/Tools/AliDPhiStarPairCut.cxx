@@ -0,0 +1,199 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+// Two-track (merging) cut on Delta phi*, see the header for the details
+//
+// Usage, for the pairs of the particles of one event (second = 0) or of two events:
+//   cut.SetRadii(0.8);
+//   cut.SetTracks(first, second, bSign);
+//   for each first particle i:
+//     const UChar_t* closePair = cut.SelectClosePairs(i, 0.02 * 2.5 * 3, 0.02 * 3);
+//     for each second particle j with closePair[j]:
+//       Float_t dphistarmin = cut.GetDPhiStarMin(i, j);
+//       if (TMath::Abs(dphistarmin) < 0.02 && TMath::Abs(deta) < 0.02) reject the pair
+
+#include "AliDPhiStarPairCut.h"
+
+#include "TObjArray.h"
+#include "AliVParticle.h"
+
+//________________________________________________________________________
+AliDPhiStarPairCut::AliDPhiStarPairCut() :
+  fMinRadius(0),
+  fMaxRadius(0),
+  fControlRadius(0),
+  fRadii(),
+  fFirst(),
+  fSecondTracks(),
+  fSecond(&fFirst),
+  fSelected(),
+  fDPhiStar(),
+  fDPhiStarAbs()
+{
+  // constructor
+
+  SetRadii(0.8);
+}
+
+//________________________________________________________________________
+void AliDPhiStarPairCut::SetRadii(Double_t minRadius, Double_t maxRadius, Double_t step)
+{
+  // sets the radii of the scan: from minRadius to maxRadius (included) in steps of step (m)
+  // call before SetTracks
+
+  fMinRadius = minRadius;
+  fMaxRadius = maxRadius;
+
+  // same radii as the loop in AliUEHistograms::FillCorrelations (rad < 2.51)
+  fRadii.clear();
+  for (Double_t rad=minRadius; rad<maxRadius+step; rad+=step)
+    fRadii.push_back(rad);
+
+  fDPhiStar.resize(fRadii.size());
+  fDPhiStarAbs.resize(fRadii.size());
+}
+
+//________________________________________________________________________
+void AliDPhiStarPairCut::SetTracks(const TObjArray* first, const TObjArray* second, Float_t bSign, const Float_t* secondEta)
+{
+  // copies the kinematics of the particles of the pairs (AliVParticles)
+  // second = 0: pairs of the particles of first
+  // secondEta: eta of the second particles (of first if second = 0) if already known
+
+  if (second)
+  {
+    Fill(fFirst, first, bSign, 0);
+    Fill(fSecondTracks, second, bSign, secondEta);
+    fSecond = &fSecondTracks;
+  }
+  else
+  {
+    Fill(fFirst, first, bSign, secondEta);
+    fSecond = &fFirst;
+  }
+
+  fSelected.resize(fSecond->fPt.size());
+}
+
+//________________________________________________________________________
+void AliDPhiStarPairCut::Fill(TrackSet& set, const TObjArray* particles, Float_t bSign, const Float_t* eta)
+{
+  // copies the kinematics and computes the curvature terms at the min and max radius
+
+  Int_t n = particles->GetEntriesFast();
+  set.fPhi.resize(n);
+  set.fPt.resize(n);
+  set.fEta.resize(n);
+  set.fCharge.resize(n);
+  set.fTermMin.resize(n);
+  set.fTermMax.resize(n);
+  set.fTermControl.resize((fControlRadius > 0) ? n : 0);
+  set.fTerms.resize(n * fRadii.size());
+  set.fHasTerms.assign(n, 0);
+
+  for (Int_t i=0; i<n; i++)
+  {
+    AliVParticle* particle = (AliVParticle*) particles->UncheckedAt(i);
+    set.fPhi[i] = particle->Phi();
+    set.fPt[i] = particle->Pt();
+    set.fEta[i] = (eta) ? eta[i] : (Float_t) particle->Eta();
+    set.fCharge[i] = (Float_t) particle->Charge() * bSign;
+    set.fTermMin[i] = GetTerm(set.fCharge[i], set.fPt[i], fMinRadius);
+    set.fTermMax[i] = GetTerm(set.fCharge[i], set.fPt[i], fMaxRadius);
+    if (fControlRadius > 0)
+      set.fTermControl[i] = GetTerm(set.fCharge[i], set.fPt[i], fControlRadius);
+  }
+}
+
+//________________________________________________________________________
+const Double_t* AliDPhiStarPairCut::GetTerms(TrackSet& set, Int_t i)
+{
+  // curvature terms of track i at the radii of the scan
+
+  const Int_t nRadii = fRadii.size();
+  Double_t* terms = &set.fTerms[i * nRadii];
+  if (!set.fHasTerms[i])
+  {
+    for (Int_t r=0; r<nRadii; r++)
+      terms[r] = GetTerm(set.fCharge[i], set.fPt[i], fRadii[r]);
+    set.fHasTerms[i] = 1;
+  }
+
+  return terms;
+}
+
+//________________________________________________________________________
+const UChar_t* AliDPhiStarPairCut::SelectClosePairs(Int_t i, Double_t maxDEta, Float_t limit)
+{
+  // flags the second particles j which need the scan of the radii with the first particle i:
+  // |Delta eta| < maxDEta and Delta phi* below limit at the min or max radius, or changing sign in between
+  // returns an array with one entry (0 or 1) per second particle, valid until the next call
+
+  const Int_t n = fSelected.size();
+  const Float_t* phi = fSecond->fPhi.data();
+  const Float_t* eta = fSecond->fEta.data();
+  const Double_t* termMin = fSecond->fTermMin.data();
+  const Double_t* termMax = fSecond->fTermMax.data();
+  UChar_t* selected = fSelected.data();
+
+  const Float_t phi1 = fFirst.fPhi[i];
+  const Float_t eta1 = fFirst.fEta[i];
+  const Double_t termMin1 = fFirst.fTermMin[i];
+  const Double_t termMax1 = fFirst.fTermMax[i];
+
+  // no branches, so that the loop can be vectorized
+  for (Int_t j=0; j<n; j++)
+  {
+    Float_t deta = eta1 - eta[j];
+    Float_t dphi = phi1 - phi[j];
+    Float_t dphistar1 = Wrap(dphi - termMin1 + termMin[j]);
+    Float_t dphistar2 = Wrap(dphi - termMax1 + termMax[j]);
+    selected[j] = (UChar_t) ((TMath::Abs(deta) < maxDEta) &
+                             ((TMath::Abs(dphistar1) < limit) | (TMath::Abs(dphistar2) < limit) | (dphistar1 * dphistar2 < 0)));
+  }
+
+  return selected;
+}
+
+//________________________________________________________________________
+Float_t AliDPhiStarPairCut::GetDPhiStarMin(Int_t i, Int_t j)
+{
+  // Delta phi* with the smallest absolute value between the min and max radius
+  // of the pair of first particle i and second particle j (1e5 if undefined)
+
+  const Int_t nRadii = fRadii.size();
+  const Double_t* terms1 = GetTerms(fFirst, i);
+  const Double_t* terms2 = GetTerms(*fSecond, j);
+  const Float_t dphi = fFirst.fPhi[i] - fSecond->fPhi[j];
+  Float_t* dphistar = fDPhiStar.data();
+  Float_t* dphistarabs = fDPhiStarAbs.data();
+
+  for (Int_t r=0; r<nRadii; r++)
+  {
+    dphistar[r] = Wrap(dphi - terms1[r] + terms2[r]);
+    dphistarabs[r] = TMath::Abs(dphistar[r]);
+  }
+
+  Float_t dphistarminabs = 1e5;
+  for (Int_t r=0; r<nRadii; r++)
+    dphistarminabs = (dphistarabs[r] < dphistarminabs) ? dphistarabs[r] : dphistarminabs;
+
+  // first radius with the minimum, as the scan of AliUEHistograms::FillCorrelations
+  for (Int_t r=0; r<nRadii; r++)
+    if (dphistarabs[r] == dphistarminabs)
+      return dphistar[r];
+
+  return 1e5;
+}
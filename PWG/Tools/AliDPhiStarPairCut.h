@@ -0,0 +1,105 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+// Two-track (merging) cut on the minimal distance Delta phi* of the pairs
+// between a min and a max radius in the TPC, as used by the correlation,
+// balance function and femtoscopy analyses.
+//
+// The kinematics of the tracks of an event is copied once in contiguous
+// arrays, with the curvature terms charge * bSign * asin(0.075 * r / pt) at the
+// min and max radius. SelectClosePairs evaluates the boundary check of one first
+// particle with all second particles in one loop (which the compiler can
+// vectorize), and GetDPhiStarMin scans the radii of a pair with the curvature
+// terms of the tracks, which are computed once per track and event when first needed.
+// GetDPhiStarControl gives Delta phi* at one more radius, e.g. for QA histograms.
+// The results are the same as with GetDPhiStar called for each radius.
+//
+#ifndef ALIDPHISTARPAIRCUT_H
+#define ALIDPHISTARPAIRCUT_H
+
+#include <vector>
+
+#include <TMath.h>
+
+class TObjArray;
+
+class AliDPhiStarPairCut
+{
+  public:
+    AliDPhiStarPairCut();
+
+    void SetRadii(Double_t minRadius, Double_t maxRadius = 2.5, Double_t step = 0.01);
+    void SetControlRadius(Float_t radius) { fControlRadius = radius; }
+    void SetTracks(const TObjArray* first, const TObjArray* second, Float_t bSign, const Float_t* secondEta = 0);
+
+    Int_t GetNRadii() const { return fRadii.size(); }
+    Float_t GetEta(Int_t i) const { return fFirst.fEta[i]; }
+
+    const UChar_t* SelectClosePairs(Int_t i, Double_t maxDEta, Float_t limit);
+    Float_t GetDPhiStarMin(Int_t i, Int_t j);
+    Float_t GetDPhiStarControl(Int_t i, Int_t j) const { return Wrap(fFirst.fPhi[i] - fSecond->fPhi[j] - fFirst.fTermControl[i] + fSecond->fTermControl[j]); }
+
+    static inline Float_t GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign);
+
+  private:
+    // tracks of the first or second particles of the pairs
+    struct TrackSet
+    {
+      std::vector<Float_t> fPhi;       // phi
+      std::vector<Float_t> fPt;        // pt
+      std::vector<Float_t> fEta;       // eta
+      std::vector<Float_t> fCharge;    // charge * bSign
+      std::vector<Double_t> fTermMin;  // curvature term at the min radius
+      std::vector<Double_t> fTermMax;  // curvature term at the max radius
+      std::vector<Double_t> fTermControl; // curvature term at the control radius
+      std::vector<Double_t> fTerms;    // curvature terms at all radii of the scan (track-major)
+      std::vector<UChar_t> fHasTerms;  // 1 if fTerms of the track are computed
+    };
+
+    void Fill(TrackSet& set, const TObjArray* particles, Float_t bSign, const Float_t* eta);
+    const Double_t* GetTerms(TrackSet& set, Int_t i);
+
+    static inline Double_t GetTerm(Float_t charge, Float_t pt, Float_t radius) { return charge * TMath::ASin(0.075 * radius / pt); }
+    static inline Float_t Wrap(Float_t dphistar);
+
+    Float_t fMinRadius;              // min radius (m)
+    Float_t fMaxRadius;              // max radius (m)
+    Float_t fControlRadius;          // radius of GetDPhiStarControl (m), 0 if not used
+    std::vector<Float_t> fRadii;     // radii of the scan
+    TrackSet fFirst;                 // first particles
+    TrackSet fSecondTracks;          // second particles (if different from the first ones)
+    TrackSet* fSecond;               // second particles
+    std::vector<UChar_t> fSelected;  // result of SelectClosePairs
+    std::vector<Float_t> fDPhiStar;  // Delta phi* of the scan
+    std::vector<Float_t> fDPhiStarAbs; // |Delta phi*| of the scan
+
+    AliDPhiStarPairCut(const AliDPhiStarPairCut&);             // not implemented
+    AliDPhiStarPairCut& operator=(const AliDPhiStarPairCut&);  // not implemented
+};
+
+Float_t AliDPhiStarPairCut::Wrap(Float_t dphistar)
+{
+  // brings Delta phi* back into [-pi, pi] as AliUEHistograms::GetDPhiStar
+  // (written with selects, so that the loops calling it can be vectorized)
+
+  static const Double_t kPi = TMath::Pi();
+
+  dphistar = (dphistar > kPi) ? (Float_t) (kPi * 2 - dphistar) : dphistar;
+  dphistar = (dphistar < -kPi) ? (Float_t) (-kPi * 2 - dphistar) : dphistar;
+  dphistar = (dphistar > kPi) ? (Float_t) (kPi * 2 - dphistar) : dphistar; // might look funny but is needed
+
+  return dphistar;
+}
+
+Float_t AliDPhiStarPairCut::GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign)
+{
+  //
+  // calculates dphistar of one pair at one radius
+  //
+
+  Float_t dphistar = phi1 - phi2 - GetTerm(charge1 * bSign, pt1, radius) + GetTerm(charge2 * bSign, pt2, radius);
+
+  return Wrap(dphistar);
+}
+
+#endif
@@ -28,6 +28,11 @@
 // the derivation from THnSparse is obviously against many OO rules. correct would be a common baseclass of THnSparse and THn.
 //
 // Templated version allows also the use of double as storage container
+//
+// block storage mode (SetBlockSize()): the bins of a step are split in blocks of a fixed number of bins
+// which are only allocated when one of their bins is filled. Large containers which are mostly empty
+// then only use memory for the filled regions, and FillParent/FillContainer and Merge only loop over
+// the allocated blocks
 // 
 // Author: Jan Fiete Grosse-Oetringhaus
 
@@ -50,6 +55,12 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT() :
   fNSteps(0),
   fValues(0),
   fSumw2(0),
+  fBlockSize(0),
+  fNBlocks(0),
+  fNBlockPointers(0),
+  fValueBlocks(0),
+  fSumw2Blocks(0),
+  fHasSumw2(0),
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
@@ -66,6 +77,12 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const Char_t* name, const Char_t*
   fNSteps(nSelStep),
   fValues(0),
   fSumw2(0),
+  fBlockSize(0),
+  fNBlocks(0),
+  fNBlockPointers(0),
+  fValueBlocks(0),
+  fSumw2Blocks(0),
+  fHasSumw2(0),
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
@@ -103,6 +120,12 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
   fNSteps(c.fNSteps),
   fValues(new TemplateArray*[c.fNSteps]),
   fSumw2(new TemplateArray*[c.fNSteps]),
+  fBlockSize(0),
+  fNBlocks(0),
+  fNBlockPointers(0),
+  fValueBlocks(0),
+  fSumw2Blocks(0),
+  fHasSumw2(0),
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
@@ -120,6 +143,7 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
     if (c.fSumw2[i])  fSumw2[i]  = new TemplateArray(*(c.fSumw2[i]));
   }
 
+  CopyBlocks(c);
 }
 
 template <class TemplateArray, typename TemplateType>
@@ -128,6 +152,7 @@ AliTHnT<TemplateArray, TemplateType>::~AliTHnT()
   // Destructor
   
   DeleteContainers();
+  FreeBlocks();
   
   delete[] fValues;
   delete[] fSumw2;
@@ -156,6 +181,319 @@ void AliTHnT<TemplateArray, TemplateType>::DeleteContainers()
       fSumw2[i] = 0;
     }
   }
+  
+  DeleteBlocks();
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::InitBlocks()
+{
+  // allocates the block tables of the block storage mode, no block is allocated
+  
+  if (fNBlockPointers <= 0)
+    return;
+  
+  fValueBlocks = new TemplateArray*[fNBlockPointers];
+  fSumw2Blocks = new TemplateArray*[fNBlockPointers];
+  memset(fValueBlocks, 0, fNBlockPointers*sizeof(TemplateArray*));
+  memset(fSumw2Blocks, 0, fNBlockPointers*sizeof(TemplateArray*));
+  
+  fHasSumw2 = new Bool_t[fNSteps];
+  for (Int_t i=0; i<fNSteps; i++)
+    fHasSumw2[i] = kFALSE;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::DeleteBlocks()
+{
+  // deletes the allocated blocks, the block tables are kept
+  
+  for (Int_t i=0; i<fNBlockPointers; i++)
+  {
+    delete fValueBlocks[i];
+    fValueBlocks[i] = 0;
+    delete fSumw2Blocks[i];
+    fSumw2Blocks[i] = 0;
+  }
+  
+  if (fHasSumw2)
+    for (Int_t i=0; i<fNSteps; i++)
+      fHasSumw2[i] = kFALSE;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FreeBlocks()
+{
+  // deletes the allocated blocks and the block tables
+  
+  for (Int_t i=0; i<fNBlockPointers; i++)
+  {
+    delete fValueBlocks[i];
+    delete fSumw2Blocks[i];
+  }
+  
+  delete[] fValueBlocks;
+  delete[] fSumw2Blocks;
+  delete[] fHasSumw2;
+  
+  fValueBlocks = 0;
+  fSumw2Blocks = 0;
+  fHasSumw2 = 0;
+  fNBlockPointers = 0;
+  fNBlocks = 0;
+  fBlockSize = 0;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::CopyBlocks(const AliTHnT& c)
+{
+  // copies the block storage mode and the allocated blocks of <c>, fNSteps and fNBins have to be set before
+  
+  FreeBlocks();
+  
+  fBlockSize = c.fBlockSize;
+  fNBlocks = c.fNBlocks;
+  fNBlockPointers = c.fNBlockPointers;
+  InitBlocks();
+  
+  for (Int_t i=0; i<fNBlockPointers; i++)
+  {
+    if (c.fValueBlocks[i]) fValueBlocks[i] = new TemplateArray(*(c.fValueBlocks[i]));
+    if (c.fSumw2Blocks[i]) fSumw2Blocks[i] = new TemplateArray(*(c.fSumw2Blocks[i]));
+  }
+  
+  if (fHasSumw2)
+    for (Int_t i=0; i<fNSteps; i++)
+      fHasSumw2[i] = c.fHasSumw2[i];
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::SetBlockSize(Int_t blockSize)
+{
+  // switches to the block storage mode with <blockSize> bins per block (0 switches back to one array per step)
+  // has to be called before the first fill
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    if (fValues[i] || GetNAllocatedBlocks(i) > 0)
+    {
+      AliError("The storage mode can only be changed before the first fill");
+      return;
+    }
+  }
+  
+  if (blockSize < 0)
+  {
+    AliError(Form("Invalid block size %d", blockSize));
+    return;
+  }
+  
+  Long64_t nBlocks = 0;
+  if (blockSize > 0)
+    nBlocks = (fNBins + blockSize - 1) / blockSize;
+  
+  if (nBlocks * fNSteps > kMaxInt)
+  {
+    AliError(Form("Too many blocks (%lld) for block size %d, keeping the present storage mode", nBlocks * fNSteps, blockSize));
+    return;
+  }
+  
+  FreeBlocks();
+  
+  fBlockSize = blockSize;
+  fNBlocks = (Int_t) nBlocks;
+  fNBlockPointers = (Int_t) nBlocks * fNSteps;
+  InitBlocks();
+  
+  if (fBlockSize > 0)
+    AliInfo(Form("Block storage mode: %d blocks of %d bins per step", fNBlocks, fBlockSize));
+}
+
+template <class TemplateArray, typename TemplateType>
+Int_t AliTHnT<TemplateArray, TemplateType>::GetNAllocatedBlocks(Int_t step) const
+{
+  // returns the number of allocated blocks of step <step> in the block storage mode
+  
+  Int_t count = 0;
+  for (Int_t j=0; j<fNBlocks; j++)
+    if (fValueBlocks[step * fNBlocks + j])
+      count++;
+  
+  return count;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::Sumw2()
+{
+  // stores the sum of the squared weights of all steps from now on
+  // in the block storage mode the sumw2 blocks are then allocated together with the value blocks,
+  // otherwise the value and sumw2 containers of all steps are allocated here
+  // the following fills then neither allocate the containers nor print messages
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    if (fBlockSize > 0)
+    {
+      if (!fHasSumw2[i])
+        CreateSumw2Blocks(i);
+      continue;
+    }
+    
+    if (!fValues[i])
+      fValues[i] = new TemplateArray(fNBins);
+    if (!fSumw2[i])
+      fSumw2[i] = new TemplateArray(*fValues[i]);
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+Long64_t AliTHnT<TemplateArray, TemplateType>::GetStorageSize() const
+{
+  // returns the memory used by the data containers (in bytes)
+  
+  Long64_t size = 0;
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    if (fValues[i])
+      size += fValues[i]->GetSize() * sizeof(TemplateType);
+    if (fSumw2[i])
+      size += fSumw2[i]->GetSize() * sizeof(TemplateType);
+  }
+  
+  size += 2 * (Long64_t) fNBlockPointers * sizeof(TemplateArray*);
+  for (Int_t i=0; i<fNBlockPointers; i++)
+  {
+    if (fValueBlocks[i])
+      size += fValueBlocks[i]->GetSize() * sizeof(TemplateType);
+    if (fSumw2Blocks[i])
+      size += fSumw2Blocks[i]->GetSize() * sizeof(TemplateType);
+  }
+  
+  return size;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::AllocateBlock(Int_t step, Int_t block)
+{
+  // allocates block <block> of step <step> (and its sumw2 block if sumw2 is stored for this step)
+  
+  Int_t index = step * fNBlocks + block;
+  Int_t length = GetBlockLength(block);
+  
+  fValueBlocks[index] = new TemplateArray(length);
+  if (fHasSumw2[step])
+    fSumw2Blocks[index] = new TemplateArray(length);
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::CreateSumw2Blocks(Int_t step)
+{
+  // creates the sumw2 blocks of step <step> 
+  // initialize with already filled entries (which have been filled with weight == 1), in this case sumw2 := values
+  
+  fHasSumw2[step] = kTRUE;
+  
+  for (Int_t j=0; j<fNBlocks; j++)
+  {
+    Int_t index = step * fNBlocks + j;
+    if (fValueBlocks[index] && !fSumw2Blocks[index])
+      fSumw2Blocks[index] = new TemplateArray(*fValueBlocks[index]);
+  }
+  
+  AliInfo(Form("Created sumw2 blocks for step %d", step));
+}
+
+template <class TemplateArray, typename TemplateType>
+TemplateType* AliTHnT<TemplateArray, TemplateType>::GetBlockBin(Int_t step, Long64_t bin, Bool_t sumw2, Bool_t create)
+{
+  // returns a pointer to the value (or sumw2 if <sumw2>) of global bin <bin> in the block storage mode
+  // returns 0 if the block is not allocated, unless <create> is set
+  
+  Int_t block = (Int_t) (bin / fBlockSize);
+  Int_t index = step * fNBlocks + block;
+  
+  if (!fValueBlocks[index])
+  {
+    if (!create)
+      return 0;
+    AllocateBlock(step, block);
+  }
+  
+  TemplateArray* array = (sumw2) ? fSumw2Blocks[index] : fValueBlocks[index];
+  if (!array)
+    return 0;
+  
+  return array->GetArray() + (bin - (Long64_t) block * fBlockSize);
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::AddBins(Int_t step, const TemplateType* values, const TemplateType* sumw2, Long64_t first, Long64_t n)
+{
+  // adds the <n> bins starting at global bin <first> to step <step>
+  // <values> and <sumw2> start at bin <first>, if <sumw2> is 0 the bins have been filled with weight 1 (sumw2 := values)
+  
+  if (fBlockSize == 0)
+  {
+    if (!fValues[step])
+      fValues[step] = new TemplateArray(fNBins);
+    if (sumw2 && !fSumw2[step])
+      fSumw2[step] = new TemplateArray(*fValues[step]);
+    
+    TemplateType* target = fValues[step]->GetArray() + first;
+    for (Long64_t l = 0; l<n; l++)
+      target[l] += values[l];
+    
+    if (fSumw2[step])
+    {
+      const TemplateType* source = (sumw2) ? sumw2 : values;
+      TemplateType* targetSumw2 = fSumw2[step]->GetArray() + first;
+      for (Long64_t l = 0; l<n; l++)
+	targetSumw2[l] += source[l];
+    }
+    
+    return;
+  }
+  
+  if (sumw2 && !fHasSumw2[step])
+    CreateSumw2Blocks(step);
+  
+  Long64_t last = first + n;
+  for (Long64_t begin = first; begin < last; )
+  {
+    Int_t block = (Int_t) (begin / fBlockSize);
+    Long64_t blockFirst = (Long64_t) block * fBlockSize;
+    Long64_t end = TMath::Min(blockFirst + GetBlockLength(block), last);
+    
+    const TemplateType* sourceValues = values + (begin - first);
+    const TemplateType* sourceSumw2 = (sumw2) ? sumw2 + (begin - first) : sourceValues;
+    Long64_t length = end - begin;
+    
+    // empty regions of a source with one array per step are not allocated
+    Bool_t empty = kTRUE;
+    for (Long64_t l = 0; l<length && empty; l++)
+      if (sourceValues[l] != 0 || sourceSumw2[l] != 0)
+	empty = kFALSE;
+    
+    if (!empty)
+    {
+      Int_t index = step * fNBlocks + block;
+      if (!fValueBlocks[index])
+	AllocateBlock(step, block);
+      
+      TemplateType* target = fValueBlocks[index]->GetArray() + (begin - blockFirst);
+      for (Long64_t l = 0; l<length; l++)
+	target[l] += sourceValues[l];
+      
+      if (fSumw2Blocks[index])
+      {
+	TemplateType* targetSumw2 = fSumw2Blocks[index]->GetArray() + (begin - blockFirst);
+	for (Long64_t l = 0; l<length; l++)
+	  targetSumw2[l] += sourceSumw2[l];
+      }
+    }
+    
+    begin = end;
+  }
 }
 
 //____________________________________________________________________
@@ -191,6 +529,7 @@ AliTHnT<TemplateArray, TemplateType> &AliTHnT<TemplateArray, TemplateType>::oper
       fValues = 0;
       fSumw2 = 0;
     }
+    CopyBlocks(c);
     delete [] axisCache;
     axisCache = new TAxis*[fNVars];
     memcpy(axisCache, c.axisCache, fNVars*sizeof(TAxis*));
@@ -226,6 +565,8 @@ void AliTHnT<TemplateArray, TemplateType>::Copy(TObject& c) const
     else
       target.fSumw2[i] = 0;
   }
+  
+  target.CopyBlocks(*this);
 }
 
 //____________________________________________________________________
@@ -256,6 +597,30 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
 
     for (Int_t i=0; i<fNSteps; i++)
     {
+      if (fBlockSize > 0 || entry->fBlockSize > 0)
+      {
+	// at least one of the two in the block storage mode: only the allocated blocks (or the filled regions) are added
+	if (entry->fBlockSize > 0)
+	{
+	  for (Int_t j=0; j<entry->fNBlocks; j++)
+	  {
+	    Int_t index = i * entry->fNBlocks + j;
+	    if (!entry->fValueBlocks[index])
+	      continue;
+	    
+	    const TemplateType* sumw2 = (entry->fSumw2Blocks[index]) ? entry->fSumw2Blocks[index]->GetArray() : 0;
+	    AddBins(i, entry->fValueBlocks[index]->GetArray(), sumw2, (Long64_t) j * entry->fBlockSize, entry->GetBlockLength(j));
+	  }
+	}
+	else if (entry->fValues[i])
+	{
+	  const TemplateType* sumw2 = (entry->fSumw2[i]) ? entry->fSumw2[i]->GetArray() : 0;
+	  AddBins(i, entry->fValues[i]->GetArray(), sumw2, 0, fNBins);
+	}
+	
+	continue;
+      }
+      
       if (entry->fValues[i])
       {
 	if (!fValues[i])
@@ -334,6 +699,25 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
 //     Printf("%lld", bin);
   }
 
+  if (fBlockSize > 0)
+  {
+    Int_t block = (Int_t) (bin / fBlockSize);
+    Int_t index = istep * fNBlocks + block;
+    
+    if (!fValueBlocks[index])
+      AllocateBlock(istep, block);
+    
+    if (weight != 1 && !fHasSumw2[istep])
+      CreateSumw2Blocks(istep);
+    
+    Long64_t offset = bin - (Long64_t) block * fBlockSize;
+    fValueBlocks[index]->GetArray()[offset] += weight;
+    if (fSumw2Blocks[index])
+      fSumw2Blocks[index]->GetArray()[offset] += weight * weight;
+    
+    return;
+  }
+
   if (!fValues[istep])
   {
     fValues[istep] = new TemplateArray(fNBins);
@@ -384,6 +768,63 @@ void AliTHnT<TemplateArray, TemplateType>::FillContainer(AliCFContainer* cont)
   
   for (Int_t i=0; i<fNSteps; i++)
   {
+    if (fBlockSize > 0)
+    {
+      // block storage mode: only the allocated blocks are visited, in the order of the global bin index as below
+      Int_t nAllocated = GetNAllocatedBlocks(i);
+      if (nAllocated == 0)
+	continue;
+      
+      THnSparse* target = cont->GetGrid(i)->GetGrid();
+      
+      Int_t* binIdx = new Int_t[fNVars];
+      Int_t* nBins  = new Int_t[fNVars];
+      for (Int_t j=0; j<fNVars; j++)
+	nBins[j] = target->GetAxis(j)->GetNbins();
+      
+      Long64_t count = 0;
+      
+      for (Int_t j=0; j<fNBlocks; j++)
+      {
+	Int_t index = i * fNBlocks + j;
+	if (!fValueBlocks[index])
+	  continue;
+	
+	TemplateType* source = fValueBlocks[index]->GetArray();
+	TemplateType* sourceSumw2 = source;
+	if (fSumw2Blocks[index])
+	  sourceSumw2 = fSumw2Blocks[index]->GetArray();
+	
+	Long64_t blockFirst = (Long64_t) j * fBlockSize;
+	Int_t length = GetBlockLength(j);
+	for (Int_t l=0; l<length; l++)
+	{
+	  if (source[l] == 0)
+	    continue;
+	  
+	  // global bin index -> axis bins (bins start from 1 in the axis)
+	  Long64_t globalBin = blockFirst + l;
+	  for (Int_t k=fNVars-1; k>=0; k--)
+	  {
+	    binIdx[k] = (Int_t) (globalBin % nBins[k]) + 1;
+	    globalBin /= nBins[k];
+	  }
+	  
+	  target->SetBinContent(binIdx, source[l]);
+	  target->SetBinError(binIdx, TMath::Sqrt(sourceSumw2[l]));
+	  
+	  count++;
+	}
+      }
+      
+      AliInfo(Form("Step %d: copied %lld entries out of %lld bins (%d of %d blocks allocated)", i, count, fNBins, nAllocated, fNBlocks));
+      
+      delete[] binIdx;
+      delete[] nBins;
+      
+      continue;
+    }
+    
     if (!fValues[i])
       continue;
       
@@ -461,6 +902,53 @@ void AliTHnT<TemplateArray, TemplateType>::ReduceAxis()
   
   for (Int_t i=0; i<fNSteps; i++)
   {
+    if (fBlockSize > 0)
+    {
+      // block storage mode: the bins of the last axis are consecutive in the global bin index
+      if (GetNAllocatedBlocks(i) == 0)
+	continue;
+      
+      Int_t nBinsAxis = GetAxis(axis, 0)->GetNbins();
+      Long64_t count = 0;
+      
+      for (Long64_t first = 0; first < fNBins; first += nBinsAxis)
+      {
+	count++;
+	
+	TemplateType sumValues = 0;
+	TemplateType sumSumw2 = 0;
+	Bool_t filled = kFALSE;
+	for (Long64_t globalBin = first; globalBin < first + nBinsAxis; globalBin++)
+	{
+	  TemplateType* value = GetBlockBin(i, globalBin, kFALSE, kFALSE);
+	  if (!value)
+	    continue;
+	  
+	  filled = kTRUE;
+	  sumValues += *value;
+	  *value = 0;
+	  
+	  TemplateType* sumw2 = GetBlockBin(i, globalBin, kTRUE, kFALSE);
+	  if (sumw2)
+	  {
+	    sumSumw2 += *sumw2;
+	    *sumw2 = 0;
+	  }
+	}
+	
+	if (!filled)
+	  continue;
+	
+	*GetBlockBin(i, first, kFALSE, kTRUE) = sumValues;
+	if (fHasSumw2[i])
+	  *GetBlockBin(i, first, kTRUE, kTRUE) = sumSumw2;
+      }
+      
+      AliInfo(Form("Step %d: reduced %lld bins to %lld entries", i, fNBins, count));
+      
+      continue;
+    }
+    
     if (!fValues[i])
       continue;
       
@@ -9,6 +9,9 @@
 // Use AliTHn instead of AliCFContainer and your memory consumption will be drastically reduced
 // As AliTHn derives from AliCFContainer, you can just replace your current AliCFContainer object by AliTHn
 // Once you have the merged output, call FillParent() and you can use AliCFContainer as usual
+//
+// With SetBlockSize() the bins are stored in blocks of a fixed number of bins which are allocated
+// on the first fill of one of their bins, instead of one array of all bins per step
 
 #include "TObject.h"
 #include "TString.h"
@@ -35,6 +38,11 @@ public:
   virtual void DeleteContainers() = 0;
   virtual void ReduceAxis() = 0;  
   
+  virtual void SetBlockSize(Int_t blockSize = fgkDefaultBlockSize) = 0;
+  virtual Long64_t GetStorageSize() const = 0;
+  
+  static const Int_t fgkDefaultBlockSize = 1024; // default number of bins per block in the block storage mode
+  
   ClassDef(AliTHnBase, 1) // AliTHn base class
 };
 
@@ -51,12 +59,19 @@ class AliTHnT : public AliTHnBase
   virtual void FillParent();
   virtual void FillContainer(AliCFContainer* cont);
   
+  // in the block storage mode the values are not in one array, GetValues and GetSumw2 return 0
   virtual TArray* GetValues(Int_t step) { return fValues[step]; }
   virtual TArray* GetSumw2(Int_t step)  { return fSumw2[step]; }
   
   virtual void DeleteContainers();
   virtual void ReduceAxis();
   
+  virtual void SetBlockSize(Int_t blockSize = fgkDefaultBlockSize);
+  Int_t GetBlockSize() const { return fBlockSize; }
+  Int_t GetNAllocatedBlocks(Int_t step) const;
+  void Sumw2();
+  virtual Long64_t GetStorageSize() const;
+  
   AliTHnT(const AliTHnT &c);
   AliTHnT& operator=(const AliTHnT& corr);
   virtual void Copy(TObject& c) const;
@@ -65,7 +80,16 @@ class AliTHnT : public AliTHnBase
   
 protected:
   void Init();
+  void InitBlocks();
+  void CopyBlocks(const AliTHnT& c);
+  void DeleteBlocks();
+  void FreeBlocks();
   Long64_t GetGlobalBinIndex(const Int_t* binIdx);
+  Int_t GetBlockLength(Int_t block) const { Long64_t rest = fNBins - (Long64_t) block * fBlockSize; return (rest < fBlockSize) ? (Int_t) rest : fBlockSize; }
+  void AllocateBlock(Int_t step, Int_t block);
+  void CreateSumw2Blocks(Int_t step);
+  TemplateType* GetBlockBin(Int_t step, Long64_t bin, Bool_t sumw2, Bool_t create);
+  void AddBins(Int_t step, const TemplateType* values, const TemplateType* sumw2, Long64_t first, Long64_t n);
   
   Long64_t fNBins;   // number of total bins
   Int_t    fNVars;   // number of variables
@@ -73,12 +97,19 @@ protected:
   TemplateArray **fValues;  //[fNSteps] data container
   TemplateArray **fSumw2;   //[fNSteps] data container
   
+  Int_t    fBlockSize;       // number of bins per block in the block storage mode, 0 if fValues and fSumw2 are used
+  Int_t    fNBlocks;         // number of blocks per step in the block storage mode
+  Int_t    fNBlockPointers;  // fNSteps * fNBlocks
+  TemplateArray **fValueBlocks;  //[fNBlockPointers] blocks of the data container, index step * fNBlocks + block, 0 if not allocated
+  TemplateArray **fSumw2Blocks;  //[fNBlockPointers] blocks of the sumw2 container
+  Bool_t*  fHasSumw2;        //[fNSteps] sumw2 blocks are allocated together with the value blocks of this step
+  
   TAxis** axisCache; //! cache axis pointers (about 50% of the time in Fill is spent in GetAxis otherwise)
   Int_t* fNbinsCache; //! cache Nbins per axis
   Double_t* fLastVars; //! caching of last used bins (in many loops some vars are the same for a while)
   Int_t* fLastBins; //! caching of last used bins (in many loops some vars are the same for a while)
   
-  ClassDef(AliTHnT, 5) // THn like container
+  ClassDef(AliTHnT, 6) // THn like container
 };
 
 typedef AliTHnT<TArrayF, Float_t> AliTHn;
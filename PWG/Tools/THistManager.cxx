@@ -21,6 +21,7 @@
 #include <vector>
 #include <TArrayD.h>
 #include <TAxis.h>
+#include <TError.h>
 #include <TH1.h>
 #include <TH2.h>
 #include <TH3.h>
@@ -42,14 +43,18 @@ ClassImp(THistManager)
 THistManager::THistManager():
 		TNamed(),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHandles(),
+		fShards()
 {
 }
 
 THistManager::THistManager(const char *name):
 		TNamed(name, Form("Histogram container %s", name)),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHandles(),
+		fShards()
 {
 	fHistos = new THashList();
 	fHistos->SetName(Form("histos%s", name));
@@ -57,6 +62,7 @@ THistManager::THistManager(const char *name):
 }
 
 THistManager::~THistManager(){
+  for(auto shard : fShards) delete shard;
 	if(fHistos && fIsOwner) delete fHistos;
 }
 
@@ -354,7 +360,7 @@ THnSparse* THistManager::CreateTHnSparse(const char *name, const char *title, in
   return hsparse;
 }
 
-void THistManager::CreateTProfile(const char* name, const char* title, int nbinsX, double xmin, double xmax, Option_t *opt) {
+TProfile* THistManager::CreateTProfile(const char* name, const char* title, int nbinsX, double xmin, double xmax, Option_t *opt) {
   TString dirname(basename(name)), hname(histname(name));
   THashList *parent(FindGroup(dirname));
   if(!parent) parent = CreateHistoGroup(dirname);
@@ -362,9 +368,10 @@ void THistManager::CreateTProfile(const char* name, const char* title, int nbins
 		Fatal("THistManager::CreateTProfile", "Object %s already exists in group %s", hname.Data(), dirname.Data());
   TProfile *hist = new TProfile(hname, title, nbinsX, xmin, xmax, opt);
   parent->Add(hist);
+  return hist;
 }
 
-void THistManager::CreateTProfile(const char* name, const char* title, int nbinsX, const double* xbins, Option_t *opt) {
+TProfile* THistManager::CreateTProfile(const char* name, const char* title, int nbinsX, const double* xbins, Option_t *opt) {
   TString dirname(basename(name)), hname(histname(name));
   THashList *parent(FindGroup(dirname));
   if(!parent) parent = CreateHistoGroup(dirname);
@@ -372,9 +379,10 @@ void THistManager::CreateTProfile(const char* name, const char* title, int nbins
 		Fatal("THistManager::CreateTHnSparse", "Object %s already exists in group %s", hname.Data(), dirname.Data());
   TProfile *hist = new TProfile(hname, title, nbinsX, xbins, opt);
   parent->Add(hist);
+  return hist;
 }
 
-void THistManager::CreateTProfile(const char* name, const char* title, const TArrayD& xbins, Option_t *opt){
+TProfile* THistManager::CreateTProfile(const char* name, const char* title, const TArrayD& xbins, Option_t *opt){
   TString dirname(basename(name)), hname(histname(name));
   THashList *parent(FindGroup(dirname));
   if(!parent) parent = CreateHistoGroup(dirname);
@@ -382,16 +390,17 @@ void THistManager::CreateTProfile(const char* name, const char* title, const TAr
 		Fatal("THistManager::CreateTHnSparse", "Object %s already exists in group %s", hname.Data(), dirname.Data());
   TProfile *hist = new TProfile(hname.Data(), title, xbins.GetSize()-1, xbins.GetArray(), opt);
   parent->Add(hist);
+  return hist;
 }
 
-void THistManager::CreateTProfile(const char *name, const char *title, const TBinning &xbins, Option_t *opt){
+TProfile* THistManager::CreateTProfile(const char *name, const char *title, const TBinning &xbins, Option_t *opt){
   TArrayD myxbins;
   try{
     xbins.CreateBinEdges(myxbins);
   } catch (std::exception &e){
     Fatal("THistManager::CreateProfile", "Exception raised: %s", e.what());
   }
-  CreateTProfile(name, title, myxbins, opt);
+  return CreateTProfile(name, title, myxbins, opt);
 }
 
 void THistManager::SetObject(TObject * const o, const char *group) {
@@ -625,6 +634,129 @@ void THistManager::FillProfile(const char* name, double x, double y, double weig
   hist->Fill(x, y, weight);
 }
 
+Int_t THistManager::RegisterHandle(TObject *hist, const char *caller){
+  TString location = TString::Format("THistManager::%s", caller);
+  if(!hist){
+    Fatal(location.Data(), "No histogram given");
+    return -1;
+  }
+  for(size_t ihandle = 0; ihandle < fHandles.size(); ihandle++){
+    if(fHandles[ihandle] == hist) return ihandle;
+  }
+  if(fShards.size()){
+    Fatal(location.Data(), "Handle for %s requested after the creation of the shards", hist->GetName());
+    return -1;
+  }
+  fHandles.push_back(hist);
+  return fHandles.size() - 1;
+}
+
+TObject *THistManager::GetHandleObject(Int_t index, const char *caller) const {
+  if(index < 0 || static_cast<size_t>(index) >= fHandles.size()){
+    Fatal(TString::Format("THistManager::%s", caller).Data(), "Invalid histogram handle %d", index);
+    return nullptr;
+  }
+  return fHandles[index];
+}
+
+THistManager::TH1Handle THistManager::GetHandleTH1(const char *name){
+  TH1 *hist = dynamic_cast<TH1 *>(FindObject(name));
+  if(!hist){
+    Fatal("THistManager::GetHandleTH1", "Histogram %s not found", name);
+    return TH1Handle();
+  }
+  return TH1Handle(RegisterHandle(hist, "GetHandleTH1"));
+}
+
+THistManager::TH2Handle THistManager::GetHandleTH2(const char *name){
+  TH2 *hist = dynamic_cast<TH2 *>(FindObject(name));
+  if(!hist){
+    Fatal("THistManager::GetHandleTH2", "Histogram %s not found", name);
+    return TH2Handle();
+  }
+  return TH2Handle(RegisterHandle(hist, "GetHandleTH2"));
+}
+
+THistManager::TH3Handle THistManager::GetHandleTH3(const char *name){
+  TH3 *hist = dynamic_cast<TH3 *>(FindObject(name));
+  if(!hist){
+    Fatal("THistManager::GetHandleTH3", "Histogram %s not found", name);
+    return TH3Handle();
+  }
+  return TH3Handle(RegisterHandle(hist, "GetHandleTH3"));
+}
+
+THistManager::THnSparseHandle THistManager::GetHandleTHnSparse(const char *name){
+  THnSparse *hist = dynamic_cast<THnSparse *>(FindObject(name));
+  if(!hist){
+    Fatal("THistManager::GetHandleTHnSparse", "Histogram %s not found", name);
+    return THnSparseHandle();
+  }
+  return THnSparseHandle(RegisterHandle(hist, "GetHandleTHnSparse"));
+}
+
+THistManager::TProfileHandle THistManager::GetHandleTProfile(const char *name){
+  TProfile *hist = dynamic_cast<TProfile *>(FindObject(name));
+  if(!hist){
+    Fatal("THistManager::GetHandleTProfile", "Histogram %s not found", name);
+    return TProfileHandle();
+  }
+  return TProfileHandle(RegisterHandle(hist, "GetHandleTProfile"));
+}
+
+void THistManager::FillTH1(const TH1Handle &handle, double x, double weight){
+  TH1 *hist = static_cast<TH1 *>(GetHandleObject(handle.GetIndex(), "FillTH1"));
+  if(!hist) return;
+  hist->Fill(x, weight);
+}
+
+void THistManager::FillTH2(const TH2Handle &handle, double x, double y, double weight){
+  TH2 *hist = static_cast<TH2 *>(GetHandleObject(handle.GetIndex(), "FillTH2"));
+  if(!hist) return;
+  hist->Fill(x, y, weight);
+}
+
+void THistManager::FillTH3(const TH3Handle &handle, double x, double y, double z, double weight){
+  TH3 *hist = static_cast<TH3 *>(GetHandleObject(handle.GetIndex(), "FillTH3"));
+  if(!hist) return;
+  hist->Fill(x, y, z, weight);
+}
+
+void THistManager::FillTHnSparse(const THnSparseHandle &handle, const double *x, double weight){
+  THnSparse *hist = static_cast<THnSparse *>(GetHandleObject(handle.GetIndex(), "FillTHnSparse"));
+  if(!hist) return;
+  hist->Fill(x, weight);
+}
+
+void THistManager::FillProfile(const TProfileHandle &handle, double x, double y, double weight){
+  TProfile *hist = static_cast<TProfile *>(GetHandleObject(handle.GetIndex(), "FillProfile"));
+  if(!hist) return;
+  hist->Fill(x, y, weight);
+}
+
+void THistManager::CreateShards(Int_t nshards){
+  if(fShards.size()){
+    Fatal("THistManager::CreateShards", "Shards already created, they have to be merged before");
+    return;
+  }
+  for(Int_t ishard = 0; ishard < nshards; ishard++)
+    fShards.push_back(new Shard(fHandles));
+}
+
+void THistManager::MergeShards(){
+  for(auto shard : fShards){
+    for(size_t ihandle = 0; ihandle < fHandles.size(); ihandle++){
+      TObject *target = fHandles[ihandle], *source = shard->GetObject(ihandle);
+      if(THnBase *hn = dynamic_cast<THnBase *>(target))
+        hn->Add(static_cast<THnBase *>(source));
+      else
+        static_cast<TH1 *>(target)->Add(static_cast<TH1 *>(source));
+    }
+    delete shard;
+  }
+  fShards.clear();
+}
+
 TObject *THistManager::FindObject(const char *name) const {
 	TString dirname(basename(name)), hname(histname(name));
 	THashList *parent(FindGroup(dirname));
@@ -659,6 +791,70 @@ TString THistManager::histname(const TString &path) const {
 	return TString(path(index+1, path.Length() - (index+1)));
 }
 
+//////////////////////////////////////////////////////////
+///                                                    ///
+/// Implementation of THistManager::Shard              ///
+///                                                    ///
+//////////////////////////////////////////////////////////
+
+THistManager::Shard::Shard(const std::vector<TObject *> &histos):
+    fHistos()
+{
+  fHistos.reserve(histos.size());
+  for(auto hist : histos){
+    TObject *copy = hist->Clone();
+    if(TH1 *hist1 = dynamic_cast<TH1 *>(copy)){
+      hist1->SetDirectory(nullptr);
+      hist1->Reset();
+    } else {
+      static_cast<THnBase *>(copy)->Reset();
+    }
+    fHistos.push_back(copy);
+  }
+}
+
+THistManager::Shard::~Shard(){
+  for(auto hist : fHistos) delete hist;
+}
+
+TObject *THistManager::Shard::GetHandleObject(Int_t index, const char *caller) const {
+  if(index < 0 || static_cast<size_t>(index) >= fHistos.size()){
+    ::Fatal(TString::Format("THistManager::Shard::%s", caller).Data(), "Invalid histogram handle %d", index);
+    return nullptr;
+  }
+  return fHistos[index];
+}
+
+void THistManager::Shard::FillTH1(const TH1Handle &handle, double x, double weight){
+  TH1 *hist = static_cast<TH1 *>(GetHandleObject(handle.GetIndex(), "FillTH1"));
+  if(!hist) return;
+  hist->Fill(x, weight);
+}
+
+void THistManager::Shard::FillTH2(const TH2Handle &handle, double x, double y, double weight){
+  TH2 *hist = static_cast<TH2 *>(GetHandleObject(handle.GetIndex(), "FillTH2"));
+  if(!hist) return;
+  hist->Fill(x, y, weight);
+}
+
+void THistManager::Shard::FillTH3(const TH3Handle &handle, double x, double y, double z, double weight){
+  TH3 *hist = static_cast<TH3 *>(GetHandleObject(handle.GetIndex(), "FillTH3"));
+  if(!hist) return;
+  hist->Fill(x, y, z, weight);
+}
+
+void THistManager::Shard::FillTHnSparse(const THnSparseHandle &handle, const double *x, double weight){
+  THnSparse *hist = static_cast<THnSparse *>(GetHandleObject(handle.GetIndex(), "FillTHnSparse"));
+  if(!hist) return;
+  hist->Fill(x, weight);
+}
+
+void THistManager::Shard::FillProfile(const TProfileHandle &handle, double x, double y, double weight){
+  TProfile *hist = static_cast<TProfile *>(GetHandleObject(handle.GetIndex(), "FillProfile"));
+  if(!hist) return;
+  hist->Fill(x, y, weight);
+}
+
 //////////////////////////////////////////////////////////
 ///                                                    ///
 /// Implementation of THistManager::iterator           ///
@@ -1030,6 +1226,80 @@ namespace TestTHistManager {
     return success ? 0 : 1;
   }
 
+  int THistManagerTestSuite::TestFillHandles(){
+    THistManager testmgr("testmgr");
+
+    THistManager::TH1Handle h1 = testmgr.GetHandle(testmgr.CreateTH1("Group1/Test1", "Test fill 1D histogram", 1, 0., 1.));
+    THistManager::TH2Handle h2 = testmgr.GetHandle(testmgr.CreateTH2("Group1/Test2", "Test fill 2D histogram", 1, 0., 1., 1, 0., 1.));
+    THistManager::TH3Handle h3 = testmgr.GetHandle(testmgr.CreateTH3("Group1/Test3", "Test fill 3D histogram", 1, 0., 1., 1, 0., 1., 1, 0., 1.));
+    int nbins[4] = {1,1,1,1}; double min[4] = {0.,0.,0.,0.}, max[4] = {1.,1.,1.,1.};
+    THistManager::THnSparseHandle hN = testmgr.GetHandle(testmgr.CreateTHnSparse("Group1/TestN", "Test Fill THnSparse", 4, nbins, min, max));
+    testmgr.CreateTProfile("Group2/Subgroup1/TestProfile", "Test fill Profile histogram", 1, 0., 1.);
+    THistManager::TProfileHandle hProfile = testmgr.GetHandleTProfile("Group2/Subgroup1/TestProfile");
+
+    bool success(true);
+    if(testmgr.GetHandleTH1("Group1/Test1").GetIndex() != h1.GetIndex()){
+      std::cout << "Group1/Test1: Handle by name differs from handle at creation" << std::endl;
+      success = false;
+    }
+
+    double point[4] = {0.5, 0.5, 0.5, 0.5};
+    for(int i = 0; i < 100; i++){
+      testmgr.FillTH1(h1, 0.5);
+      testmgr.FillTH2(h2, 0.5, 0.5);
+      testmgr.FillTH3(h3, 0.5, 0.5, 0.5);
+      testmgr.FillTHnSparse(hN, point);
+      testmgr.FillProfile(hProfile, 0.5, 1.);
+    }
+
+    testmgr.CreateShards(2);
+    for(int ishard = 0; ishard < 2; ishard++){
+      THistManager::Shard *shard = testmgr.GetShard(ishard);
+      for(int i = 0; i < 50; i++){
+        shard->FillTH1(h1, 0.5);
+        shard->FillTH2(h2, 0.5, 0.5);
+        shard->FillTH3(h3, 0.5, 0.5, 0.5);
+        shard->FillTHnSparse(hN, point);
+        shard->FillProfile(hProfile, 0.5, 1.);
+      }
+    }
+    testmgr.MergeShards();
+
+    // Evaluate test
+    TH1 *test1 = dynamic_cast<TH1 *>(testmgr.FindObject("Group1/Test1"));
+    if(!test1 || TMath::Abs(test1->GetBinContent(1) - 200) > DBL_EPSILON){
+      std::cout << "Group1/Test1: Value mismatch: expected 200, found " << (test1 ? test1->GetBinContent(1) : -1.) << std::endl;
+      success = false;
+    }
+    TH2 *test2 = dynamic_cast<TH2 *>(testmgr.FindObject("Group1/Test2"));
+    if(!test2 || TMath::Abs(test2->GetBinContent(1, 1) - 200) > DBL_EPSILON){
+      std::cout << "Group1/Test2: Value mismatch: expected 200, found " << (test2 ? test2->GetBinContent(1, 1) : -1.) << std::endl;
+      success = false;
+    }
+    TH3 *test3 = dynamic_cast<TH3 *>(testmgr.FindObject("Group1/Test3"));
+    if(!test3 || TMath::Abs(test3->GetBinContent(1, 1, 1) - 200) > DBL_EPSILON){
+      std::cout << "Group1/Test3: Value mismatch: expected 200, found " << (test3 ? test3->GetBinContent(1, 1, 1) : -1.) << std::endl;
+      success = false;
+    }
+    THnSparse *testN = dynamic_cast<THnSparse *>(testmgr.FindObject("Group1/TestN"));
+    int index[4] = {1,1,1,1};
+    if(!testN || TMath::Abs(testN->GetBinContent(index) - 200) > DBL_EPSILON){
+      std::cout << "Group1/TestN: Value mismatch: expected 200, found " << (testN ? testN->GetBinContent(index) : -1.) << std::endl;
+      success = false;
+    }
+    TProfile *testProfile = dynamic_cast<TProfile *>(testmgr.FindObject("Group2/Subgroup1/TestProfile"));
+    if(!testProfile || TMath::Abs(testProfile->GetBinContent(1) - 1) > DBL_EPSILON || TMath::Abs(testProfile->GetBinEntries(1) - 200) > DBL_EPSILON){
+      std::cout << "Group2/Subgroup1/TestProfile: Value mismatch: expected 1 (200 entries), found " << (testProfile ? testProfile->GetBinContent(1) : -1.) << std::endl;
+      success = false;
+    }
+    if(testmgr.GetNumberOfShards()){
+      std::cout << "Shards not deleted after merging" << std::endl;
+      success = false;
+    }
+
+    return success ? 0 : 1;
+  }
+
   int TestRunAll(){
     int testresult(0);
     THistManagerTestSuite testsuite;
@@ -1050,6 +1320,10 @@ namespace TestTHistManager {
     testresult += testsuite.TestFillGroupedHistograms();
     std::cout << "Result after test: " << testresult << std::endl;
 
+    std::cout << "Running test: Fill Handles" << std::endl;
+    testresult += testsuite.TestFillHandles();
+    std::cout << "Result after test: " << testresult << std::endl;
+
     return testresult;
   }
 
@@ -1072,4 +1346,9 @@ namespace TestTHistManager {
     THistManagerTestSuite testsuite;
     return testsuite.TestFillGroupedHistograms();
   }
+
+  int TestRunFillHandles(){
+    THistManagerTestSuite testsuite;
+    return testsuite.TestFillHandles();
+  }
 }
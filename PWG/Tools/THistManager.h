@@ -7,6 +7,7 @@
 #include <TIterator.h>
 #include <TNamed.h>
 #include <iterator>
+#include <vector>
 
 class TArrayD;
 class TAxis;
@@ -23,6 +24,48 @@ class TProfile;
  * @brief Histogram manager and components needed to make it work.
  */
 
+/**
+ * @class THistHandle
+ * @brief Typed handle of a histogram inside the THistManager
+ * @ingroup Histmanager
+ *
+ * A handle is obtained once from the histogram manager, either from
+ * the histogram returned by the Create method (THistManager::GetHandle)
+ * or from the histogram name (THistManager::GetHandleTH1, ...). Filling
+ * via the handle does not need any processing of the histogram path nor
+ * any lookup by name. The template parameter is the histogram type
+ * accepted by the Fill method.
+ */
+template<typename HistType>
+class THistHandle {
+public:
+  /**
+   * @brief Default constructor, creating an invalid handle
+   */
+  THistHandle(): fIndex(-1) {}
+
+  /**
+   * @brief Check whether the handle belongs to a histogram
+   * @return True if the handle is valid
+   */
+  Bool_t IsValid() const { return fIndex >= 0; }
+
+  /**
+   * @brief Get the position of the histogram in the handle table of the histogram manager
+   * @return Position in the handle table (-1 for invalid handles)
+   */
+  Int_t GetIndex() const { return fIndex; }
+
+  /**
+   * @brief Constructor, only used by the histogram manager
+   * @param[in] index Position of the histogram in the handle table
+   */
+  explicit THistHandle(Int_t index): fIndex(index) {}
+
+private:
+  Int_t fIndex;           ///< Position of the histogram in the handle table of the histogram manager
+};
+
 /**
  * @class THistManager
  * @brief Container class for histograms
@@ -95,10 +138,100 @@ class TProfile;
  * an argument for options. Automatic correction for the bin width is done when
  * specifying the argument *W*, followed by the direction. Adding multiple directions
  * the weight is calculated for all directions at the same time.
+ *
+ * ## Filling histograms via handles
+ *
+ * Filling histograms by name requires splitting the histogram path and a lookup
+ * of the group and of the histogram by name in each Fill call. For histograms filled
+ * many times per event a handle can be obtained once, at creation time or by name,
+ * and used in the Fill methods instead of the name:
+ *
+ * ~~~{.cxx}
+ * THistManager::TH1Handle hpt = mgr.GetHandle(mgr.CreateTH1("tracks/hPt", "pt-distribution", TLinearBinning(100, 0., 100.)));
+ * THistManager::TH2Handle hetaphi = mgr.GetHandleTH2("tracks/hEtaPhi");
+ * mgr.FillTH1(hpt, pt);
+ * ~~~
+ *
+ * Options (i.e. the correction for the bin width) are not available in the Fill methods
+ * with handles.
+ *
+ * ## Filling histograms from several threads
+ *
+ * Histograms with a handle can be filled concurrently from several threads via shards.
+ * CreateShards creates for each thread an empty copy of all histograms with a handle
+ * (the handles have to be requested before), each thread fills its own shard without any
+ * locking, and MergeShards adds the shards to the histograms of the manager, in the order of
+ * the shards, and deletes them:
+ *
+ * ~~~{.cxx}
+ * mgr.CreateShards(nthreads);
+ * // in thread ithread
+ * THistManager::Shard *shard = mgr.GetShard(ithread);
+ * shard->FillTH1(hpt, pt);
+ * // after all threads are done, i.e. at the end of the task
+ * mgr.MergeShards();
+ * ~~~
  */
 class THistManager : public TNamed {
 public:
 
+  typedef THistHandle<TH1> TH1Handle;                 ///< Handle of a 1D histogram
+  typedef THistHandle<TH2> TH2Handle;                 ///< Handle of a 2D histogram
+  typedef THistHandle<TH3> TH3Handle;                 ///< Handle of a 3D histogram
+  typedef THistHandle<THnSparse> THnSparseHandle;     ///< Handle of a THnSparse
+  typedef THistHandle<TProfile> TProfileHandle;       ///< Handle of a profile histogram
+
+  /**
+   * @class Shard
+   * @brief Thread-local copy of the histograms with a handle
+   * @ingroup Histmanager
+   *
+   * Each shard contains an empty copy of all histograms with a handle at
+   * the time the shards were created, at the same position in the handle
+   * table. A shard must only be filled from one thread at a time. The content
+   * is added to the histograms of the manager in THistManager::MergeShards.
+   */
+  class Shard {
+  public:
+    /**
+     * @brief Constructor, creating empty copies of the histograms
+     * @param[in] histos Handle table of the histogram manager
+     */
+    Shard(const std::vector<TObject *> &histos);
+
+    /**
+     * @brief Destructor, deleting the copies
+     */
+    ~Shard();
+
+    void FillTH1(const TH1Handle &handle, double x, double weight = 1.);
+    void FillTH2(const TH2Handle &handle, double x, double y, double weight = 1.);
+    void FillTH3(const TH3Handle &handle, double x, double y, double z, double weight = 1.);
+    void FillTHnSparse(const THnSparseHandle &handle, const double *x, double weight = 1.);
+    void FillProfile(const TProfileHandle &handle, double x, double y, double weight = 1.);
+
+    /**
+     * @brief Get the copy of a histogram
+     * @param[in] index Position of the histogram in the handle table
+     * @return Copy of the histogram in this shard
+     */
+    TObject *GetObject(Int_t index) const { return fHistos[index]; }
+
+  private:
+    Shard(const Shard &);
+    Shard &operator=(const Shard &);
+
+    /**
+     * @brief Get the copy of a histogram from a handle, fatal error for invalid handles
+     * @param[in] index Position of the histogram in the handle table
+     * @param[in] caller Name of the calling method for error messages
+     * @return Copy of the histogram in this shard
+     */
+    TObject *GetHandleObject(Int_t index, const char *caller) const;
+
+    std::vector<TObject *>      fHistos;              ///< Copies of the histograms, same order as the handle table
+  };
+
   /**
    * @class iterator
    * @brief stl-iterator for the histogram manager
@@ -481,7 +614,7 @@ public:
 	 * @param[in] xmax max. value in x-direction
 	 * @param[in] opt Further options
 	 */
-  void CreateTProfile(const char *name, const char *title, int nbinsX, double xmin, double xmax, Option_t *opt = "");
+  TProfile* CreateTProfile(const char *name, const char *title, int nbinsX, double xmin, double xmax, Option_t *opt = "");
 
   /**
    * @brief Create a new TProfile within the container.
@@ -494,7 +627,7 @@ public:
    * @param[in] xbins binning in x-direction
    * @param[in] opt Further options
    */
-  void CreateTProfile(const char *name, const char *title, int nbinsX, const double *xbins, Option_t *opt = "");
+  TProfile* CreateTProfile(const char *name, const char *title, int nbinsX, const double *xbins, Option_t *opt = "");
 
   /**
    * @brief Create a new TProfile within the container.
@@ -506,7 +639,7 @@ public:
    * @param[in] xbins binning in x-direction
    * @param[in] opt Further options
    */
-  void CreateTProfile(const char *name, const char *title, const TArrayD &xbins, Option_t *opt = "");
+  TProfile* CreateTProfile(const char *name, const char *title, const TArrayD &xbins, Option_t *opt = "");
 
   /**
    * @brief Create a new TProfile within the container.
@@ -518,7 +651,7 @@ public:
    * @param[in] xbins User binning
    * @param[in] opt Further options
    */
-  void CreateTProfile(const char *name, const char *title, const TBinning &xbins, Option_t *opt = "");
+  TProfile* CreateTProfile(const char *name, const char *title, const TBinning &xbins, Option_t *opt = "");
 
   /**
    * @brief Set a new group into the container into the parent group
@@ -634,6 +767,157 @@ public:
 	 */
   void FillProfile(const char *name, double x, double y, double weight = 1.);
 
+  /**
+   * @brief Get the handle of a 1D histogram.
+   *
+   * Intended to be used with the histogram returned by the Create method.
+   * The histogram has to be inside the container.
+   * @param[in] hist Histogram inside the container
+   * @return Handle of the histogram
+   */
+  TH1Handle GetHandle(TH1 *hist) { return TH1Handle(RegisterHandle(hist, "GetHandle")); }
+
+  /**
+   * @brief Get the handle of a 2D histogram.
+   * @param[in] hist Histogram inside the container
+   * @return Handle of the histogram
+   */
+  TH2Handle GetHandle(TH2 *hist) { return TH2Handle(RegisterHandle(hist, "GetHandle")); }
+
+  /**
+   * @brief Get the handle of a 3D histogram.
+   * @param[in] hist Histogram inside the container
+   * @return Handle of the histogram
+   */
+  TH3Handle GetHandle(TH3 *hist) { return TH3Handle(RegisterHandle(hist, "GetHandle")); }
+
+  /**
+   * @brief Get the handle of a THnSparse.
+   * @param[in] hist Histogram inside the container
+   * @return Handle of the histogram
+   */
+  THnSparseHandle GetHandle(THnSparse *hist) { return THnSparseHandle(RegisterHandle(hist, "GetHandle")); }
+
+  /**
+   * @brief Get the handle of a profile histogram.
+   * @param[in] hist Histogram inside the container
+   * @return Handle of the histogram
+   */
+  TProfileHandle GetHandle(TProfile *hist) { return TProfileHandle(RegisterHandle(hist, "GetHandle")); }
+
+  /**
+   * @brief Get the handle of a 1D histogram by name.
+   *
+   * The histogram name also contains the parent group(s)
+   * according to the common group notation.
+   * @param[in] name Name of the histogram
+   * @return Handle of the histogram
+   */
+  TH1Handle GetHandleTH1(const char *name);
+
+  /**
+   * @brief Get the handle of a 2D histogram by name.
+   * @param[in] name Name of the histogram
+   * @return Handle of the histogram
+   */
+  TH2Handle GetHandleTH2(const char *name);
+
+  /**
+   * @brief Get the handle of a 3D histogram by name.
+   * @param[in] name Name of the histogram
+   * @return Handle of the histogram
+   */
+  TH3Handle GetHandleTH3(const char *name);
+
+  /**
+   * @brief Get the handle of a THnSparse by name.
+   * @param[in] name Name of the histogram
+   * @return Handle of the histogram
+   */
+  THnSparseHandle GetHandleTHnSparse(const char *name);
+
+  /**
+   * @brief Get the handle of a profile histogram by name.
+   * @param[in] name Name of the profile histogram
+   * @return Handle of the histogram
+   */
+  TProfileHandle GetHandleTProfile(const char *name);
+
+  /**
+   * @brief Fill a 1D histogram via its handle.
+   * @param[in] handle Handle of the histogram
+   * @param[in] x x-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTH1(const TH1Handle &handle, double x, double weight = 1.);
+
+  /**
+   * @brief Fill a 2D histogram via its handle.
+   * @param[in] handle Handle of the histogram
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTH2(const TH2Handle &handle, double x, double y, double weight = 1.);
+
+  /**
+   * @brief Fill a 3D histogram via its handle.
+   * @param[in] handle Handle of the histogram
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] z z-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTH3(const TH3Handle &handle, double x, double y, double z, double weight = 1.);
+
+  /**
+   * @brief Fill a THnSparse via its handle.
+   * @param[in] handle Handle of the histogram
+   * @param[in] x coordinates of the data
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillTHnSparse(const THnSparseHandle &handle, const double *x, double weight = 1.);
+
+  /**
+   * @brief Fill a profile histogram via its handle.
+   * @param[in] handle Handle of the profile histogram
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void FillProfile(const TProfileHandle &handle, double x, double y, double weight = 1.);
+
+  /**
+   * @brief Create the shards for filling from several threads.
+   *
+   * Each shard contains empty copies of all histograms with a handle,
+   * so all handles have to be requested before. Existing shards have
+   * to be merged before.
+   * @param[in] nshards Number of shards (usually one per thread)
+   */
+  void CreateShards(Int_t nshards);
+
+  /**
+   * @brief Get the number of shards.
+   * @return Number of shards (0 if the shards are not created)
+   */
+  Int_t GetNumberOfShards() const { return fShards.size(); }
+
+  /**
+   * @brief Get a shard.
+   * @param[in] ishard Index of the shard
+   * @return The shard
+   */
+  Shard *GetShard(Int_t ishard) const { return fShards[ishard]; }
+
+  /**
+   * @brief Add the content of the shards to the histograms of the container.
+   *
+   * The shards are added in their order and deleted afterwards. Must not be
+   * called while shards are filled.
+   */
+  void MergeShards();
+
   /**
    * @brief Create forward iterator starting at the beginning of the
    * container
@@ -719,8 +1003,26 @@ private:
 	 */
 	TString histname(const TString &path) const;
 
+	/**
+	 * @brief Add a histogram to the handle table.
+	 * @param[in] hist Histogram inside the container
+	 * @param[in] caller Name of the calling method for error messages
+	 * @return Position of the histogram in the handle table
+	 */
+	Int_t RegisterHandle(TObject *hist, const char *caller);
+
+	/**
+	 * @brief Get the histogram of a handle, fatal error for invalid handles
+	 * @param[in] index Position of the histogram in the handle table
+	 * @param[in] caller Name of the calling method for error messages
+	 * @return Histogram at the position of the handle
+	 */
+	TObject *GetHandleObject(Int_t index, const char *caller) const;
+
 	THashList *fHistos;                   ///< List of histograms
 	bool fIsOwner;                        ///< Set the ownership
+	std::vector<TObject *> fHandles;      //!<! Histograms with a handle, at the position of the handle
+	std::vector<Shard *> fShards;         //!<! Shards for filling from several threads
 
   /// \cond CLASSIMP
 	ClassDef(THistManager, 1);  // Container for histograms
@@ -762,6 +1064,7 @@ namespace TestTHistManager {
  * - Build histrogram in groups
  * - Simple fill
  * - Fill histograms in groups
+ * - Fill histograms via handles and shards
  */
 class THistManagerTestSuite {
 public:
@@ -845,6 +1148,22 @@ public:
    * @return 0 if test is passed, 1 if it failed
    */
   int TestFillGroupedHistograms();
+
+  /**
+   * Purpose of the test: Check whether histograms are filled correctly via handles, and via shards
+   * Relies on: TestFillSimpleHistograms, TestFillGroupedHistograms
+   *
+   * Creating histograms of all types in a group, with 1 bin per dimension. Handles are
+   * obtained from the histograms returned by the Create methods, and by name for the
+   * profile. Each histogram is filled 100 times via the handle, and 2 shards are filled
+   * 50 times each and merged.
+   *
+   * Test passed:
+   * - All histograms need to have in its 1 bin the bin content 200 (1 for the profile)
+   * - Handles obtained twice for the same histogram are identical
+   * @return 0 if test is passed, 1 if it failed
+   */
+  int TestFillHandles();
 };
 
 /**
@@ -882,5 +1201,12 @@ int TestRunFillSimple();
  */
 int TestRunFillGrouped();
 
+/**
+ * Run the test for filling histograms via handles and shards. See @ref THistManagerTestSuite
+ * for details.
+ * @return 0 if test is passed, 1 if failed
+ */
+int TestRunFillHandles();
+
 }
 #endif
@@ -143,6 +143,7 @@ AliUEHist::AliUEHist(const char* reqHist, const char* binning) :
     useAliTHn = 0;
   if (TString(reqHist).Contains("Double"))
     useAliTHn = 2;
+  Bool_t useBlockStorage = TString(reqHist).Contains("Blocks"); // AliTHn with the bins allocated in blocks on first fill
   
   // selection depending on requested histogram
   Int_t axis = -1; // 0 = pT,lead, 1 = phi,lead
@@ -271,6 +272,9 @@ AliUEHist::AliUEHist(const char* reqHist, const char* binning) :
     else
       fTrackHist[i] = new AliCFContainer(Form("fTrackHist_%d", i), title, nSteps, nTrackVars, iTrackBin);
     
+    if (useBlockStorage && axis >= 2 && useAliTHn > 0)
+      ((AliTHnBase*) fTrackHist[i])->SetBlockSize();
+    
     for (Int_t j=0; j<nTrackVars; j++)
     {
       fTrackHist[i]->SetBinLimits(j, trackBins[j]);
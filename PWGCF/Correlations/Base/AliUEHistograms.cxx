@@ -26,6 +26,7 @@
 
 #include "AliCFContainer.h"
 #include "AliBasicParticle.h"
+#include "AliDPhiStarPairCut.h"
 #include "AliVParticle.h"
 #include "AliAODTrack.h"
 
@@ -86,7 +87,8 @@ AliUEHistograms::AliUEHistograms(const char* name, const char* histograms, const
   fTwoTrackCutMinRadius(0.8),
   fCheckEventNumberInCorrelation(kFALSE),
   fRunNumber(0),
-  fMergeCount(1)
+  fMergeCount(1),
+  fDPhiStarCut(0)
 {
   // Constructor
   //
@@ -95,6 +97,7 @@ AliUEHistograms::AliUEHistograms(const char* name, const char* histograms, const
   //    2 = SumpT
   //    3 = NumberDensityPhi
   //    4 = NumberDensityPhiCentrality (other multiplicity for Pb)
+  //    B = AliTHn with the bins allocated in blocks on first fill (4, 5, 6 only)
   
   AliLog::SetClassDebugLevel("AliCFContainer", -1);
   AliLog::SetClassDebugLevel("AliCFGridSparse", -3);
@@ -162,6 +165,9 @@ AliUEHistograms::AliUEHistograms(const char* name, const char* histograms, const
     else if (histogramsStr.Contains("D"))
       configStr += "Double";
     
+    if (histogramsStr.Contains("B"))
+      configStr += "Blocks";
+    
     fNumberDensityPhi = new AliUEHist(configStr, binningStr);
   }
   
@@ -267,7 +273,8 @@ AliUEHistograms::AliUEHistograms(const AliUEHistograms &c) :
   fTwoTrackCutMinRadius(0.8),
   fCheckEventNumberInCorrelation(kFALSE),
   fRunNumber(0),
-  fMergeCount(1)
+  fMergeCount(1),
+  fDPhiStarCut(0)
 {
   //
   // AliUEHistograms copy constructor
@@ -285,6 +292,8 @@ AliUEHistograms::~AliUEHistograms()
   // Destructor
   
   DeleteContainers();
+
+  delete fDPhiStarCut;
 }
 
 void AliUEHistograms::DeleteContainers()
@@ -711,6 +720,15 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       }
     }
     
+    // two-track cut: kinematics and curvature terms of the tracks are computed once per call
+    if (twoTrackEfficiencyCut)
+    {
+      if (!fDPhiStarCut)
+        fDPhiStarCut = new AliDPhiStarPairCut;
+      fDPhiStarCut->SetRadii(fTwoTrackCutMinRadius);
+      fDPhiStarCut->SetTracks(particles, mixed, bSign, eta.GetArray());
+    }
+    
     for (Int_t i=0; i<particles->GetEntriesFast(); i++)
     {
       AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
@@ -738,6 +756,11 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  continue;
 	}
 	
+      // pairs with this trigger particle which need the scan of the radii of the two-track cut
+      const UChar_t* closePair = 0;
+      if (twoTrackEfficiencyCut)
+        closePair = fDPhiStarCut->SelectClosePairs(i, twoTrackEfficiencyCutValue * 2.5 * 3, twoTrackEfficiencyCutValue * 3);
+	
       for (Int_t j=0; j<jMax; j++)
       {
         if (!mixed && i == j)
@@ -915,58 +938,30 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  }
 	}
 
-	if (twoTrackEfficiencyCut)
+	if (twoTrackEfficiencyCut && closePair[j])
 	{
 	  // the variables & cuthave been developed by the HBT group 
 	  // see e.g. https://indico.cern.ch/materialDisplay.py?contribId=36&sessionId=6&materialId=slides&confId=142700
+	  // the pair has |deta| < twoTrackEfficiencyCutValue * 2.5 * 3 and dphistar close to 0 at the min or max radius (or changing sign in between),
+	  // see AliDPhiStarPairCut for the scan of the radii (same result as GetDPhiStar for each radius)
 
-	  Float_t phi1 = triggerParticle->Phi();
 	  Float_t pt1 = triggerParticle->Pt();
-	  Float_t charge1 = triggerParticle->Charge();
-	    
-	  Float_t phi2 = particle->Phi();
 	  Float_t pt2 = particle->Pt();
-	  Float_t charge2 = particle->Charge();
 	      
 	  Float_t deta = triggerEta - eta[j];
 	      
-	  // optimization
-	  if (TMath::Abs(deta) < twoTrackEfficiencyCutValue * 2.5 * 3)
-	  {
-	    // check first boundaries to see if is worth to loop and find the minimum
-	    Float_t dphistar1 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fTwoTrackCutMinRadius, bSign);
-	    Float_t dphistar2 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, 2.5, bSign);
-	    
-	    const Float_t kLimit = twoTrackEfficiencyCutValue * 3;
-
-	    Float_t dphistarminabs = 1e5;
-	    Float_t dphistarmin = 1e5;
-	    if (TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0)
-	    {
-	      for (Double_t rad=fTwoTrackCutMinRadius; rad<2.51; rad+=0.01) 
-	      {
-		Float_t dphistar = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, rad, bSign);
-
-		Float_t dphistarabs = TMath::Abs(dphistar);
-		
-		if (dphistarabs < dphistarminabs)
-		{
-		  dphistarmin = dphistar;
-		  dphistarminabs = dphistarabs;
-		}
-	      }
+	  Float_t dphistarmin = fDPhiStarCut->GetDPhiStarMin(i, j);
+	  Float_t dphistarminabs = TMath::Abs(dphistarmin);
 	      
-	      fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
+	  fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
 	      
-	      if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
-	      {
-// 		Printf("Removed track pair %d %d with %f %f %f %f %f %f %f %f %f", i, j, deta, dphistarminabs, phi1, pt1, charge1, phi2, pt2, charge2, bSign);
-		continue;
-	      }
-
-    	      fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
-	    }
+	  if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
+	  {
+// 	    Printf("Removed track pair %d %d with %f %f %f %f %f", i, j, deta, dphistarminabs, pt1, pt2, bSign);
+	    continue;
 	  }
+
+	  fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
 	}
         
         Double_t vars[6];
@@ -14,6 +14,7 @@
 #include "THn.h" // in cxx file causes .../THn.h:257: error: conflicting declaration ‘typedef class THnT<float> THnF’
 
 class AliVParticle;
+class AliDPhiStarPairCut;
 
 class TList;
 class TSeqCollection;
@@ -182,6 +183,8 @@ protected:
   
   Int_t fMergeCount;		// counts how many objects have been merged together
   
+  AliDPhiStarPairCut* fDPhiStarCut; //! kinematics and curvature terms of the tracks for the two-track cut (created in FillCorrelations)
+  
   ClassDef(AliUEHistograms, 33)  // underlying event histogram container
 };
 
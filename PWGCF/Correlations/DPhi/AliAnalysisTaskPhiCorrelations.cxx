@@ -195,6 +195,7 @@ fRemoveWeakDecaysInMC(kFALSE),
 fFillYieldRapidity(kFALSE),
 fFillCorrelationsRapidity(kFALSE),
 fUseDoublePrecision(kFALSE),
+fUseBlockStorage(kFALSE),
 fUseNewCentralityFramework(kFALSE),
 fFillpT(kFALSE),
 fJetBranchName("clustersAOD_ANTIKT04_B1_Filter00768_Cut00150_Skip00"),
@@ -314,6 +315,8 @@ void  AliAnalysisTaskPhiCorrelations::CreateOutputObjects()
     histType += "C";
   if (fUseDoublePrecision)
     histType += "D";
+  if (fUseBlockStorage)
+    histType += "B";
   fHistos = new AliUEHistograms("AliUEHistogramsSame", histType, fCustomBinning);
   fHistosMixed = new AliUEHistograms("AliUEHistogramsMixed", histType, fCustomBinning);
 
@@ -150,6 +150,7 @@ public:
   void   SetFillYieldRapidity(Bool_t flag) { fFillYieldRapidity = flag; }
   void   SetFillCorrelationsRapidity(Bool_t flag) { fFillCorrelationsRapidity = flag; }
   void   SetUseDoublePrecision(Bool_t flag) { fUseDoublePrecision = flag; }
+  void   SetUseBlockStorage(Bool_t flag) { fUseBlockStorage = flag; }
   void   SetUseNewCentralityFramework(Bool_t flag) { fUseNewCentralityFramework = flag; }
 
   AliHelperPID* GetHelperPID() { return fHelperPID; }
@@ -321,6 +322,7 @@ private:
   Bool_t fFillYieldRapidity;     // fill a control histogram centrality vs pT vs y
   Bool_t fFillCorrelationsRapidity; // fills correlation histograms with rapidity instead of pseudorapidity (default: kFALSE)
   Bool_t fUseDoublePrecision;    // use double precision for AliTHn
+  Bool_t fUseBlockStorage;       // allocate the bins of AliTHn in blocks on first fill (for large, mostly empty containers)
   Bool_t fUseNewCentralityFramework; // use the AliMultSelection framework
 
   Bool_t fFillpT;                // fill sum pT instead of number density
@@ -342,7 +344,7 @@ private:
   Bool_t                      fUsePtBinnedEventPool; // uses event pool in pt bins
   Bool_t                      fCheckEventNumberInMixedEvent; // check event number before correlation in mixed event
 
-  ClassDef(AliAnalysisTaskPhiCorrelations, 62); // Analysis task for delta phi correlations
+  ClassDef(AliAnalysisTaskPhiCorrelations, 63); // Analysis task for delta phi correlations
 };
 
 #endif
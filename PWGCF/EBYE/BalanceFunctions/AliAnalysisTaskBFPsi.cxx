@@ -743,6 +743,12 @@ void AliAnalysisTaskBFPsi::UserCreateOutputObjects() {
     }
   }
 
+  // CalculateBalance on several threads (AliBalancePsi::SetNThreads)
+  if(fBalance->GetNThreads() > 1 ||
+     (fRunShuffling && fShuffledBalance->GetNThreads() > 1) ||
+     (fRunMixing && fMixedBalance->GetNThreads() > 1))
+    ROOT::EnableThreadSafety();
+
   if(fRunEbyE) {
     if(!fBalanceEbyE->GetHistBF()) {
       AliInfo("Histograms (EbyE) not yet initialized! --> Will be done now");
@@ -4789,6 +4795,10 @@ void  AliAnalysisTaskBFPsi::FinishTaskOutput(){
     }
   }
 
+  // histograms filled by the threads of CalculateBalance (AliBalancePsi::SetNThreads)
+  fBalance->MergeShards();
+  if(fRunShuffling) fShuffledBalance->MergeShards();
+  if(fRunMixing && fMixedBalance) fMixedBalance->MergeShards();
 }
 
 //________________________________________________________________________
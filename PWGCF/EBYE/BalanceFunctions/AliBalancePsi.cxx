@@ -33,12 +33,17 @@
 #include <TString.h>
 #include <TSpline.h>
 #include <TRandom3.h>
+#include <TParticle.h>
+#include <TList.h>
+#include <TROOT.h>
+#include <thread>
 
 #include "AliVParticle.h"
 #include "AliMCParticle.h"
 #include "AliESDtrack.h"
 #include "AliAODTrack.h"
 #include "AliTHn.h"
+#include "AliDPhiStarPairCut.h"
 #include "AliAnalysisTaskTriggeredBF.h"
 
 #include "AliBalancePsi.h"
@@ -48,6 +53,52 @@ using std::cerr;
 
 ClassImp(AliBalancePsi)
 
+namespace {
+  //invariant mass of the sum of two four-vectors, as TLorentzVector::M()
+  inline Double_t GetInvMass(Double_t px1, Double_t py1, Double_t pz1, Double_t e1,
+			     Double_t px2, Double_t py2, Double_t pz2, Double_t e2) {
+    Double_t px = px1 + px2;
+    Double_t py = py1 + py2;
+    Double_t pz = pz1 + pz2;
+    Double_t e = e1 + e2;
+    Double_t mm = e*e - (px*px + py*py + pz*pz);
+    Double_t m = TMath::Sqrt(TMath::Abs(mm));
+    return (mm < 0.0) ? -m : m;
+  }
+
+  //empty copies and merging of the histograms of the threads
+  //the AliTHn copies are built from the binning only (no copy of the contents),
+  //in the block storage mode and with sumw2, so that filling them from a thread
+  //allocates only blocks and does not print messages
+  AliTHn* CloneEmpty(AliTHn* hist) {
+    const Int_t nVars = hist->GetNVar();
+    std::vector<Int_t> nBins(nVars);
+    for (Int_t j = 0; j < nVars; j++)
+      nBins[j] = hist->GetNBins(j);
+    AliTHn* clone = new AliTHn(hist->GetName(), hist->GetTitle(), hist->GetNStep(), nVars, nBins.data());
+    for (Int_t j = 0; j < nVars; j++) {
+      std::vector<Double_t> limits(nBins[j] + 1);
+      hist->GetBinLimits(j, limits.data());
+      clone->SetBinLimits(j, limits.data());
+      clone->SetVarTitle(j, hist->GetVarTitle(j));
+    }
+    clone->SetBlockSize();
+    clone->Sumw2();
+    return clone;
+  }
+  template <class T> T* CloneEmpty(T* hist) {
+    T* clone = (T*) hist->Clone();
+    clone->SetDirectory(0);
+    clone->Reset();
+    return clone;
+  }
+  void AddShard(AliTHn* hist, AliTHn* shard) {
+    TList list;
+    list.Add(shard);
+    hist->Merge(&list);
+  }
+}
+
 //____________________________________________________________________//
 AliBalancePsi::AliBalancePsi() :
   TObject(), 
@@ -97,8 +148,14 @@ AliBalancePsi::AliBalancePsi() :
   fVertexBinning(kFALSE),
   fCustomBinning(""),
   fBinningString(""),
-  fEventClass("EventPlane"){
+  fEventClass("EventPlane"),
+  fNThreads(1),
+  fPackedFirst(0),
+  fPackedSecond(0),
+  fPairBuffers(),
+  fShards(){
   // Default constructor
+  for (Int_t i = 0; i < kNMasses; i++) fMasses[i] = 0.;
 }
 
 //____________________________________________________________________//
@@ -150,8 +207,14 @@ AliBalancePsi::AliBalancePsi(const AliBalancePsi& balance):
   fVertexBinning(balance.fVertexBinning),
   fCustomBinning(balance.fCustomBinning),
   fBinningString(balance.fBinningString),
-  fEventClass("EventPlane"){
+  fEventClass("EventPlane"),
+  fNThreads(balance.fNThreads),
+  fPackedFirst(0),
+  fPackedSecond(0),
+  fPairBuffers(),
+  fShards(){
   //copy constructor
+  for (Int_t i = 0; i < kNMasses; i++) fMasses[i] = 0.;
 }
 
 //____________________________________________________________________//
@@ -182,7 +245,13 @@ AliBalancePsi::~AliBalancePsi() {
   delete fHistResonancesPhi;
   delete fHistQbefore;
   delete fHistQafter;
-    
+
+  for (UInt_t i = 0; i < fShards.size(); i++)
+    DeleteShard(fShards[i]);
+  for (UInt_t i = 0; i < fPairBuffers.size(); i++)
+    delete fPairBuffers[i];
+  delete fPackedFirst;
+  delete fPackedSecond;
 }
 
 //____________________________________________________________________//
@@ -439,6 +508,8 @@ void AliBalancePsi::CalculateBalance(Double_t gReactionPlane,
 				     Double_t kMultorCent,
 				     Double_t vertexZ) { 
   // Calculates the balance function
+  // The particles are copied once in contiguous arrays and the pairs are
+  // filled by FillPairs, on fNThreads threads for events with enough pairs
   fAnalyzedEvents++;
     
   // Initialize histograms if not done yet
@@ -448,81 +519,162 @@ void AliBalancePsi::CalculateBalance(Double_t gReactionPlane,
     InitHistograms();
   }
 
-  Double_t trackVariablesSingle[kTrackVariablesSingle];
-  Double_t trackVariablesPair[kTrackVariablesPair];
-
   if (!particles){
     AliWarning("particles TObjArray is NULL pointer --> return");
     return;
   }
-  
+
+  //masses of the resonance cuts (looked up before any thread is started)
+  if(fResonancesCut || fResonancePhiCut) {
+    TParticle pPion, pProton, pRho0, pK0s, pLambda, pKaon;
+    pPion.SetPdgCode(211); //pion
+    pRho0.SetPdgCode(113); //rho0
+    pK0s.SetPdgCode(310); //K0s
+    pProton.SetPdgCode(2212); //proton
+    pLambda.SetPdgCode(3122); //Lambda
+    pKaon.SetPdgCode(321); //kaon
+    fMasses[kMassPion] = pPion.GetMass();
+    fMasses[kMassProton] = pProton.GetMass();
+    fMasses[kMassKaon] = pKaon.GetMass();
+    fMasses[kMassRho0] = pRho0.GetMass();
+    fMasses[kMassK0s] = pK0s.GetMass();
+    fMasses[kMassLambda] = pLambda.GetMass();
+  }
+
+  // Eta() is extremely time consuming, therefore cache it (and the rest) for the pair loops here:
+  if (!fPackedFirst) fPackedFirst = new PackedParticles;
+  PackParticles(particles, *fPackedFirst);
+  if (particlesMixed) {
+    if (!fPackedSecond) fPackedSecond = new PackedParticles;
+    PackParticles(particlesMixed, *fPackedSecond);
+  }
+  const PackedParticles& second = (particlesMixed) ? *fPackedSecond : *fPackedFirst;
+
   // define end of particle loops
   Int_t iMax = particles->GetEntriesFast();
-  Int_t jMax = iMax;
-  if (particlesMixed)
-    jMax = particlesMixed->GetEntriesFast();
-
-  // Eta() is extremely time consuming, therefore cache it for the inner loop here:
-  TObjArray* particlesSecond = (particlesMixed) ? particlesMixed : particles;
-
-  TArrayF secondEta(jMax);
-  TArrayF secondPhi(jMax);
-  TArrayF secondPt(jMax);
-  TArrayS secondCharge(jMax);
-  TArrayD secondCorrection(jMax);
-  TArrayI secondLabel(jMax);
-  TArrayI secondMotherLabel(jMax);
-  TArrayI secondTrigOrAssoc(jMax);
-
-  for (Int_t i=0; i<jMax; i++){  
-    secondTrigOrAssoc[i] = (Int_t)((AliBFBasicParticle*) particlesSecond->At(i))->GetTrigOrAssoc();
-    secondEta[i] = ((AliVParticle*) particlesSecond->At(i))->Eta();
-    secondPhi[i] = ((AliVParticle*) particlesSecond->At(i))->Phi();
-    secondPt[i]  = ((AliVParticle*) particlesSecond->At(i))->Pt();
-    secondCharge[i]  = (Short_t)((AliVParticle*) particlesSecond->At(i))->Charge();
-    secondCorrection[i]  = (Double_t)((AliBFBasicParticle*) particlesSecond->At(i))->Correction();   //==========================correction
-    if (fSameLabelMCCut) secondLabel[i]  = (Int_t)((AliBFBasicParticle*) particlesSecond->At(i))->GetLabel(); 
-    if (fResonancesLabelCut) secondMotherLabel[i] = (Int_t)((AliBFBasicParticle*) particlesSecond->At(i))->GetMotherLabel();
+  Int_t jMax = second.fEta.size();
+
+  // the threads pay off only for events with enough pairs
+  const Long64_t kMinPairsPerThread = 10000;
+  Int_t nThreads = fNThreads;
+  if ((Long64_t) iMax * jMax < nThreads * kMinPairsPerThread)
+    nThreads = (Int_t) ((Long64_t) iMax * jMax / kMinPairsPerThread);
+  if (nThreads < 1)
+    nThreads = 1;
+
+  while ((Int_t) fPairBuffers.size() < nThreads) {
+    PairBuffers* buffers = new PairBuffers;
+    buffers->fDPhiStarCut->SetRadii(0.8);          // scan from 0.8 to 2.5 m in steps of 1 cm
+    buffers->fDPhiStarCut->SetControlRadius(1.65); // for QA: dphistar in the middle of the TPC
+    fPairBuffers.push_back(buffers);
   }
-  
-  //TLorenzVector implementation for resonances
-  TLorentzVector vectorMother, vectorDaughter[2];
-  TParticle pPion, pProton, pRho0, pK0s, pLambda, pKaon, pPhi;
-  pPion.SetPdgCode(211); //pion
-  pRho0.SetPdgCode(113); //rho0
-  pK0s.SetPdgCode(310); //K0s
-  pProton.SetPdgCode(2212); //proton
-  pLambda.SetPdgCode(3122); //Lambda
-  pKaon.SetPdgCode(321); //kaon
-  pPhi.SetPdgCode(333); //phi
+  if (fHBTCut) {
+    for (Int_t iThread = 0; iThread < nThreads; iThread++)
+      fPairBuffers[iThread]->fDPhiStarCut->SetTracks(particles, particlesMixed, bSign, second.fEta.data());
+  }
+
+  Histograms hist;
+  GetHistograms(hist);
+
+  if (nThreads == 1) {
+    FillPairs(0, iMax, gReactionPlane, particlesMixed != 0, kMultorCent, vertexZ, hist, *fPairBuffers[0]);
+    return;
+  }
+
+  // contiguous ranges of trigger particles: the 1st one is filled by this thread
+  // in the histograms of this object, the others in the shards (see MergeShards)
+  // (ROOT::EnableThreadSafety() is called by the task, see AliAnalysisTaskBFPsi::UserCreateOutputObjects)
+  while ((Int_t) fShards.size() < nThreads - 1)
+    fShards.push_back(CreateShard());
+
+  auto fillRange = [&](Int_t iThread) {
+    Int_t iFirst = (Long64_t) iMax * iThread / nThreads;
+    Int_t iLast = (Long64_t) iMax * (iThread + 1) / nThreads;
+    Histograms& histThread = (iThread == 0) ? hist : *fShards[iThread - 1];
+    FillPairs(iFirst, iLast, gReactionPlane, particlesMixed != 0, kMultorCent, vertexZ, histThread, *fPairBuffers[iThread]);
+  };
+  std::vector<std::thread> threads;
+  for (Int_t iThread = 1; iThread < nThreads; iThread++) threads.emplace_back(fillRange, iThread);
+  fillRange(0);
+  for (auto &thread : threads) thread.join();
+}
+
+//____________________________________________________________________//
+void AliBalancePsi::FillPairs(Int_t iFirst, Int_t iLast, Double_t gReactionPlane, Bool_t mixed,
+			      Double_t kMultorCent, Double_t vertexZ,
+			      Histograms& hist, PairBuffers& buffers) {
+  // Fills the trigger particles iFirst..iLast-1 of fPackedFirst and their pairs in hist
+  // For each trigger particle, delta eta, delta phi, the selections which do not fill
+  // QA histograms and the resonance masses are computed for all 2nd particles in loops
+  // without branches, then the pairs are cut and filled in the same order as before
+  const PackedParticles& first = *fPackedFirst;
+  const PackedParticles& second = (mixed) ? *fPackedSecond : *fPackedFirst;
+  const Int_t jMax = second.fEta.size();
+
+  Double_t trackVariablesSingle[kTrackVariablesSingle];
+  Double_t trackVariablesPair[kTrackVariablesPair];
+
   Double_t gWidthForRho0 = 0.01;
   Double_t gWidthForK0s = 0.01;
   Double_t gWidthForLambda = 0.006;
   //Double_t gWidthForPhi = 0.031;
-  Double_t gWidthForPhiPdg = 0.004266;
+  //Double_t gWidthForPhiPdg = 0.004266;
   //Double_t gWidthForPhiData = 0.0012;
   Double_t gWidthForPhiData = 0.003333;
   Double_t massForPhiData = 1.018;
   Double_t nSigmaRejection = 3.0;
+  Float_t m0 = 0.510e-3;
+
+  const Bool_t momentumOrdering = fMomentumOrdering;
+  const Bool_t phiCut = fResonancePhiCut && !mixed;
+
+  buffers.fDEta.resize(jMax);
+  buffers.fDPhi.resize(jMax);
+  buffers.fSelected.resize(jMax);
+  if (fResonancesCut) {
+    buffers.fMassPiPi.resize(jMax);
+    buffers.fMassPiP.resize(jMax);
+    buffers.fMassPPi.resize(jMax);
+  }
+  if (phiCut) {
+    buffers.fMassKK.resize(jMax);
+    buffers.fPtKK.resize(jMax);
+  }
+  Double_t* dEta = buffers.fDEta.data();
+  Double_t* dPhi = buffers.fDPhi.data();
+  UChar_t* selected = buffers.fSelected.data();
+  Double_t* massPiPi = buffers.fMassPiPi.data();
+  Double_t* massPiP = buffers.fMassPiP.data();
+  Double_t* massPPi = buffers.fMassPPi.data();
+  Double_t* massKK = buffers.fMassKK.data();
+  Double_t* ptKK = buffers.fPtKK.data();
+
+  const Float_t* secondEta = second.fEta.data();
+  const Float_t* secondPhi = second.fPhi.data();
+  const Float_t* secondPt = second.fPt.data();
+  const Short_t* secondCharge = second.fCharge.data();
+  const Double_t* secondCorrection = second.fCorrection.data();
+  const Int_t* secondLabel = second.fLabel.data();
+  const Int_t* secondMotherLabel = second.fMotherLabel.data();
+  const Int_t* secondTrigOrAssoc = second.fTrigOrAssoc.data();
+  const Double_t* secondPx = second.fPx.data();
+  const Double_t* secondPy = second.fPy.data();
+  const Double_t* secondPz = second.fPz.data();
+  const Double_t* secondEPion = second.fEPion.data();
+  const Double_t* secondEProton = second.fEProton.data();
+  const Double_t* secondEKaon = second.fEKaon.data();
 
   // 1st particle loop
-  for (Int_t i = 0; i < iMax; i++) {
-    //AliVParticle* firstParticle = (AliVParticle*) particles->At(i);    
-    AliBFBasicParticle* firstParticle = (AliBFBasicParticle*) particles->At(i); //==========================correction
-    
+  for (Int_t i = iFirst; i < iLast; i++) {
     // some optimization
-    Float_t firstEta = firstParticle->Eta();
-    Float_t firstPhi = firstParticle->Phi();
-    Float_t firstPt  = firstParticle->Pt();
-    Float_t firstCorrection  = firstParticle->Correction();//==========================correction
-    Int_t firstLabel = 0;
-    Int_t firstMotherLabel = 0;
-    Int_t firstTrigOrAssoc = 0;
-    if (fSameLabelMCCut) firstLabel = firstParticle->GetLabel();
-    if (fResonancesLabelCut) firstMotherLabel = firstParticle->GetMotherLabel();
+    Float_t firstEta = first.fEta[i];
+    Float_t firstPhi = first.fPhi[i];
+    Float_t firstPt  = first.fPt[i];
+    Float_t firstCorrection  = first.fCorrection[i];//==========================correction
+    Int_t firstLabel = first.fLabel[i];
+    Int_t firstMotherLabel = first.fMotherLabel[i];
     
-    firstTrigOrAssoc = firstParticle->GetTrigOrAssoc();
-    if (firstTrigOrAssoc == 1)
+    if (first.fTrigOrAssoc[i] == 1)
     continue;
 
     // Event plane (determine psi bin)
@@ -547,9 +699,9 @@ void AliBalancePsi::CalculateBalance(Double_t gReactionPlane,
     else 
       gPsiMinusPhiBin = 3.0;
     
-    fHistPsiMinusPhi->Fill(gPsiMinusPhiBin,gPsiMinusPhi);
+    hist.fHistPsiMinusPhi->Fill(gPsiMinusPhiBin,gPsiMinusPhi);
 
-    Short_t  charge1 = (Short_t) firstParticle->Charge();
+    Short_t  charge1 = first.fCharge[i];
     
     trackVariablesSingle[0]    =  gPsiMinusPhiBin;
     trackVariablesSingle[1]    =  firstPt;
@@ -558,39 +710,56 @@ void AliBalancePsi::CalculateBalance(Double_t gReactionPlane,
 
     
     //fill single particle histograms
-    if(charge1 > 0)      fHistP->Fill(trackVariablesSingle,0,firstCorrection); //==========================correction
-    else if(charge1 < 0) fHistN->Fill(trackVariablesSingle,0,firstCorrection);  //==========================correction
+    if(charge1 > 0)      hist.fHistP->Fill(trackVariablesSingle,0,firstCorrection); //==========================correction
+    else if(charge1 < 0) hist.fHistN->Fill(trackVariablesSingle,0,firstCorrection);  //==========================correction
+
+    // delta eta, delta phi and selections of all 2nd particles (no branches, can be vectorized)
+    for(Int_t j = 0; j < jMax; j++) {
+      dEta[j] = firstEta - secondEta[j];  // delta eta
+      Double_t dphi = firstPhi - secondPhi[j];  // delta phi between -pi/2 and 3pi/2
+      dphi = (dphi > TMath::Pi()) ? dphi - 2.*TMath::Pi() : dphi;
+      dphi = (dphi < -TMath::Pi()) ? dphi + 2.*TMath::Pi() : dphi;
+      dphi = (dphi < -TMath::Pi()/2.) ? dphi + 2.*TMath::Pi() : dphi;
+      dPhi[j] = dphi;
+      // associated particles only, pT,Assoc < pT,Trig (if momentum ordering is switched ON)
+      selected[j] = (UChar_t) ((secondTrigOrAssoc[j] != 0) & !(momentumOrdering & (firstPt < secondPt[j])));
+    }
+    if(!mixed) selected[i] = 0; // no auto correlations (only for non mixing)
+
+    //invariant masses of the resonance cuts, as with TLorentzVector::SetPtEtaPhiM
+    if(fResonancesCut) {
+      const Double_t px1 = first.fPx[i], py1 = first.fPy[i], pz1 = first.fPz[i];
+      const Double_t ePion1 = first.fEPion[i], eProton1 = first.fEProton[i];
+      for(Int_t j = 0; j < jMax; j++) {
+	massPiPi[j] = GetInvMass(px1, py1, pz1, ePion1, secondPx[j], secondPy[j], secondPz[j], secondEPion[j]);
+	massPiP[j] = GetInvMass(px1, py1, pz1, ePion1, secondPx[j], secondPy[j], secondPz[j], secondEProton[j]);
+	massPPi[j] = GetInvMass(px1, py1, pz1, eProton1, secondPx[j], secondPy[j], secondPz[j], secondEPion[j]);
+      }
+    }
+    if(phiCut) {
+      const Double_t px1 = first.fPx[i], py1 = first.fPy[i], pz1 = first.fPz[i], eKaon1 = first.fEKaon[i];
+      for(Int_t j = 0; j < jMax; j++) {
+	Double_t px = px1 + secondPx[j];
+	Double_t py = py1 + secondPy[j];
+	massKK[j] = GetInvMass(px1, py1, pz1, eKaon1, secondPx[j], secondPy[j], secondPz[j], secondEKaon[j]);
+	ptKK[j] = TMath::Sqrt(px*px + py*py);
+      }
+    }
+
+    // pairs which need the scan of the radii for the two-track cut
+    const UChar_t* closePair = (fHBTCut) ? buffers.fDPhiStarCut->SelectClosePairs(i, fHBTCutValue * 2.5 * 3, fHBTCutValue * 3) : 0;
     
     // 2nd particle loop
     for(Int_t j = 0; j < jMax; j++) {   
 
-      if(!particlesMixed && j == i) continue; // no auto correlations (only for non mixing)
-
-      if (secondTrigOrAssoc[j] == 0)
+      if (!selected[j])
       continue;
 
-      // pT,Assoc < pT,Trig (if momentum ordering is switched ON)
-      if(fMomentumOrdering){
-	if(firstPt < secondPt[j]) 
-	  continue;
-      }
-
       Short_t charge2 = secondCharge[j];
       
       trackVariablesPair[0]    =  trackVariablesSingle[0];
-      trackVariablesPair[1]    =  firstEta - secondEta[j];  // delta eta
-      trackVariablesPair[2]    =  firstPhi - secondPhi[j];  // delta phi
-      //if (trackVariablesPair[2] > 180.)   // delta phi between -180 and 180 
-      //trackVariablesPair[2] -= 360.;
-      //if (trackVariablesPair[2] <  - 180.) 
-      //trackVariablesPair[2] += 360.;
-      if (trackVariablesPair[2] > TMath::Pi()) // delta phi between -pi and pi 
-	trackVariablesPair[2] -= 2.*TMath::Pi();
-      if (trackVariablesPair[2] <  - TMath::Pi()) 
-	trackVariablesPair[2] += 2.*TMath::Pi();
-      if (trackVariablesPair[2] <  - TMath::Pi()/2.) 
-      trackVariablesPair[2] += 2.*TMath::Pi();
-      
+      trackVariablesPair[1]    =  dEta[j];      // delta eta
+      trackVariablesPair[2]    =  dPhi[j];      // delta phi
       trackVariablesPair[3]    =  firstPt;      // pt trigger
       trackVariablesPair[4]    =  secondPt[j];  // pt
       trackVariablesPair[5]    =  vertexZ;      // z of the primary vertex
@@ -602,59 +771,42 @@ void AliBalancePsi::CalculateBalance(Double_t gReactionPlane,
 	if (charge1 * charge2 < 0) {        
 
 	  //rho0
-	  vectorDaughter[0].SetPtEtaPhiM(firstPt,firstEta,firstPhi,pPion.GetMass());
-	  vectorDaughter[1].SetPtEtaPhiM(secondPt[j],secondEta[j],secondPhi[j],pPion.GetMass());
-	  vectorMother = vectorDaughter[0] + vectorDaughter[1];
-	  fHistResonancesBefore->Fill(trackVariablesPair[1],trackVariablesPair[2],vectorMother.M());
-	  if(TMath::Abs(vectorMother.M() - pRho0.GetMass()) <= nSigmaRejection*gWidthForRho0)
+	  hist.fHistResonancesBefore->Fill(trackVariablesPair[1],trackVariablesPair[2],massPiPi[j]);
+	  if(TMath::Abs(massPiPi[j] - fMasses[kMassRho0]) <= nSigmaRejection*gWidthForRho0)
 	    continue;
-	  fHistResonancesRho->Fill(trackVariablesPair[1],trackVariablesPair[2],vectorMother.M());
+	  hist.fHistResonancesRho->Fill(trackVariablesPair[1],trackVariablesPair[2],massPiPi[j]);
 	  
 	  //K0s
-	  if(TMath::Abs(vectorMother.M() - pK0s.GetMass()) <= nSigmaRejection*gWidthForK0s)
+	  if(TMath::Abs(massPiPi[j] - fMasses[kMassK0s]) <= nSigmaRejection*gWidthForK0s)
 	    continue;
-	  fHistResonancesK0->Fill(trackVariablesPair[1],trackVariablesPair[2],vectorMother.M());
+	  hist.fHistResonancesK0->Fill(trackVariablesPair[1],trackVariablesPair[2],massPiPi[j]);
 	  
 	  
 	  //Lambda
-	  vectorDaughter[0].SetPtEtaPhiM(firstPt,firstEta,firstPhi,pPion.GetMass());
-	  vectorDaughter[1].SetPtEtaPhiM(secondPt[j],secondEta[j],secondPhi[j],pProton.GetMass());
-	  vectorMother = vectorDaughter[0] + vectorDaughter[1];
-	  if(TMath::Abs(vectorMother.M() - pLambda.GetMass()) <= nSigmaRejection*gWidthForLambda)
+	  if(TMath::Abs(massPiP[j] - fMasses[kMassLambda]) <= nSigmaRejection*gWidthForLambda)
 	    continue;
 	  
-	  vectorDaughter[0].SetPtEtaPhiM(firstPt,firstEta,firstPhi,pProton.GetMass());
-	  vectorDaughter[1].SetPtEtaPhiM(secondPt[j],secondEta[j],secondPhi[j],pPion.GetMass());
-	  vectorMother = vectorDaughter[0] + vectorDaughter[1];
-	  if(TMath::Abs(vectorMother.M() - pLambda.GetMass()) <= nSigmaRejection*gWidthForLambda)
+	  if(TMath::Abs(massPPi[j] - fMasses[kMassLambda]) <= nSigmaRejection*gWidthForLambda)
 	    continue;
-	  fHistResonancesLambda->Fill(trackVariablesPair[1],trackVariablesPair[2],vectorMother.M());
+	  hist.fHistResonancesLambda->Fill(trackVariablesPair[1],trackVariablesPair[2],massPPi[j]);
 	
 	}//unlike-sign only
       }//resonance cut
         
-      if(fResonancePhiCut) {
-        if (!particlesMixed) {
+      if(phiCut) {
 	//phi        
-	vectorDaughter[0].SetPtEtaPhiM(firstPt,firstEta,firstPhi,pKaon.GetMass());
-	vectorDaughter[1].SetPtEtaPhiM(secondPt[j],secondEta[j],secondPhi[j],pKaon.GetMass());
-	vectorMother = vectorDaughter[0] + vectorDaughter[1];
 	  if (charge1 * charge2 > 0)
-	    fHistResonancesPhiBeforeLS->Fill(vectorMother.Pt(),vectorMother.M(),trackVariablesSingle[0]);
+	    hist.fHistResonancesPhiBeforeLS->Fill(ptKK[j],massKK[j],trackVariablesSingle[0]);
 	  else if (charge1 * charge2 < 0) {
-	    //if(TMath::Abs(vectorMother.M() - pPhi.GetMass()) <= nSigmaRejection*gWidthForPhiPdg)
-	    //continue;          
-	    fHistResonancesPhiBeforeUS->Fill(vectorMother.Pt(),vectorMother.M(),trackVariablesSingle[0]);
-	    //if (((vectorMother.M() - pPhi.GetMass()) < fNSigmaRejectionMin*gWidthForPhiData) || ((vectorMother.M() - pPhi.GetMass()) >= fNSigmaRejectionMax*gWidthForPhiData))
-	    if (((vectorMother.M() - massForPhiData) < fNSigmaRejectionMin*gWidthForPhiData) || ((vectorMother.M() - massForPhiData) >= fNSigmaRejectionMax*gWidthForPhiData))
+	    hist.fHistResonancesPhiBeforeUS->Fill(ptKK[j],massKK[j],trackVariablesSingle[0]);
+	    if (((massKK[j] - massForPhiData) < fNSigmaRejectionMin*gWidthForPhiData) || ((massKK[j] - massForPhiData) >= fNSigmaRejectionMax*gWidthForPhiData))
 	    continue;
-	    fHistResonancesPhi->Fill(vectorMother.Pt(),vectorMother.M(),trackVariablesSingle[0]);
+	    hist.fHistResonancesPhi->Fill(ptKK[j],massKK[j],trackVariablesSingle[0]);
 	  }
-        }
       }
  
       if (fResonancesLabelCut) {
-        if (!particlesMixed) {
+        if (!mixed) {
 	  if (charge1 * charge2 < 0) {
 		if (firstMotherLabel!=-1 && secondMotherLabel[j]!=-1 && firstMotherLabel == secondMotherLabel[j])
 		continue;
@@ -668,113 +820,62 @@ void AliBalancePsi::CalculateBalance(Double_t gReactionPlane,
 	//if( dphi < 3 || deta < 0.01 ){   // VERSION 1
 	//  continue;
 	
-	Double_t deta = firstEta - secondEta[j];
+	Double_t deta = dEta[j];
 	Double_t dphi = firstPhi - secondPhi[j];
 	if(dphi > TMath::Pi())
 	  dphi = secondPhi[j] - firstPhi;
 
 	// for QA: get dphistar in the middle of the TPC R = 1.65
-	Float_t  dphistarMiddle = GetDPhiStar(firstPhi, firstPt, charge1, secondPhi[j], secondPt[j], charge2, 1.65, bSign);
+	Float_t  dphistarMiddle = buffers.fDPhiStarCut->GetDPhiStarControl(i, j);
 
 	// VERSION 2 (Taken from DPhiCorrelations)
 	// the variables & cuthave been developed by the HBT group 
 	// see e.g. https://indico.cern.ch/materialDisplay.py?contribId=36&sessionId=6&materialId=slides&confId=142700
-	fHistHBTbefore->Fill(deta,dphi);
-	fHistPhiStarHBTbefore->Fill(deta,dphistarMiddle);
+	hist.fHistHBTbefore->Fill(deta,dphi);
+	hist.fHistPhiStarHBTbefore->Fill(deta,dphistarMiddle);
 	
-	// optimization
-	if (TMath::Abs(deta) < fHBTCutValue * 2.5 * 3) //fHBTCutValue = 0.02 [default for dphicorrelations]
-	  {
-	    // phi in rad
-	    //Float_t phi1rad = firstPhi*TMath::DegToRad();
-	    //Float_t phi2rad = secondPhi[j]*TMath::DegToRad();
-	    Float_t phi1rad = firstPhi;
-	    Float_t phi2rad = secondPhi[j];
-	    
-	    // check first boundaries to see if is worth to loop and find the minimum
-	    Float_t dphistar1 = GetDPhiStar(phi1rad, firstPt, charge1, phi2rad, secondPt[j], charge2, 0.8, bSign);
-	    Float_t dphistar2 = GetDPhiStar(phi1rad, firstPt, charge1, phi2rad, secondPt[j], charge2, 2.5, bSign);
-	    
-	    const Float_t kLimit = fHBTCutValue * 3;
-
-	    // Printf("typical values: deta =%f dphistar1 0.8= %f,  dphistar2 2.5 =%f, kLimit =%f ", deta, dphistar1,  dphistar2, kLimit ); 
-	    
-	    Float_t dphistarminabs = 1e5;
-	    //Float_t dphistarmin = 1e5;
-	    
-	    if (TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0 ) {
-	      for (Double_t rad=0.8; rad<2.51; rad+=0.01) {
-		Float_t dphistar = GetDPhiStar(phi1rad, firstPt, charge1, phi2rad, secondPt[j], charge2, rad, bSign);
-		//Printf("inside loop r = %f, dphistar = %f", rad,  dphistar); 
-			    
-		Float_t dphistarabs = TMath::Abs(dphistar);
-		
-		if (dphistarabs < dphistarminabs) {
-		  //dphistarmin = dphistar;
-		  dphistarminabs = dphistarabs;
-		}
-	      }
-	      
-	      if (dphistarminabs < fHBTCutValue && TMath::Abs(deta) < fHBTCutValue) {
-		//AliInfo(Form("HBT: Removed track pair %d %d with [[%f %f]] %f %f %f | %f %f %d %f %f %d %f", i, j, deta, dphi, dphistarminabs, dphistar1, dphistar2, phi1rad, pt1, charge1, phi2rad, pt2, charge2, bSign));
-		continue;
-	      }
-	    }
+	// |deta| < fHBTCutValue * 2.5 * 3 and dphistar close to 0 at 0.8 or 2.5 m (or changing sign in between):
+	// find the minimum of |dphistar| between 0.8 and 2.5 m
+	if (closePair[j]) {
+	  Float_t dphistarminabs = TMath::Abs(buffers.fDPhiStarCut->GetDPhiStarMin(i, j));
+	  if (dphistarminabs < fHBTCutValue && TMath::Abs(deta) < fHBTCutValue) {
+	    continue;
 	  }
-	fHistHBTafter->Fill(deta,dphi);
-	fHistPhiStarHBTafter->Fill(deta,dphistarMiddle);
+	}
+	hist.fHistHBTafter->Fill(deta,dphi);
+	hist.fHistPhiStarHBTafter->Fill(deta,dphistarMiddle);
       }//HBT cut
 
-      if (!particlesMixed && fSameLabelMCCut){
+      if (!mixed && fSameLabelMCCut){
 
 	if (charge1 * charge2 > 0) {
-	  Double_t deta = firstEta - secondEta[j];
+	  Double_t deta = dEta[j];
 	  Double_t dphi = firstPhi - secondPhi[j];
 	  
-	  fHistSameLabelMCCutBefore->Fill(deta,dphi);
+	  hist.fHistSameLabelMCCutBefore->Fill(deta,dphi);
 	  
 	  if (firstLabel == secondLabel[j]) {
-	    //Printf("label1 = %d, second %d", firstLabel, secondLabel[j]); 
 	    continue;
 	  }
-	  fHistSameLabelMCCutAfter->Fill(deta,dphi);
+	  hist.fHistSameLabelMCCutAfter->Fill(deta,dphi);
 	}
       }
       
       // conversions
       if(fConversionCut) {
 	if (charge1 * charge2 < 0) {
-	  Double_t deta = firstEta - secondEta[j];
+	  Double_t deta = dEta[j];
 	  Double_t dphi = firstPhi - secondPhi[j];
 	  
-	  Float_t m0 = 0.510e-3;
-	  Float_t tantheta1 = 1e10;
-	  
-	  // phi in rad
-	  //Float_t phi1rad = firstPhi*TMath::DegToRad();
-	  //Float_t phi2rad = secondPhi[j]*TMath::DegToRad();
-	  Float_t phi1rad = firstPhi;
-	  Float_t phi2rad = secondPhi[j];
-	  
-	  if (firstEta < -1e-10 || firstEta > 1e-10)
-	    tantheta1 = 2 * TMath::Exp(-firstEta) / ( 1 - TMath::Exp(-2*firstEta));
-	  
-	  Float_t tantheta2 = 1e10;
-	  if (secondEta[j] < -1e-10 || secondEta[j] > 1e-10)
-	    tantheta2 = 2 * TMath::Exp(-secondEta[j]) / ( 1 - TMath::Exp(-2*secondEta[j]));
-	  
-	  Float_t e1squ = m0 * m0 + firstPt * firstPt * (1.0 + 1.0 / tantheta1 / tantheta1);
-	  Float_t e2squ = m0 * m0 + secondPt[j] * secondPt[j] * (1.0 + 1.0 / tantheta2 / tantheta2);
-	  
-	  Float_t masssqu = 2 * m0 * m0 + 2 * ( TMath::Sqrt(e1squ * e2squ) - ( firstPt * secondPt[j] * ( TMath::Cos(phi1rad - phi2rad) + 1.0 / tantheta1 / tantheta2 ) ) );
+	  // tan(theta) and energy^2 of the tracks with the electron mass, see PackParticles
+	  Float_t masssqu = 2 * m0 * m0 + 2 * ( TMath::Sqrt(first.fESquare[i] * second.fESquare[j]) - ( firstPt * secondPt[j] * ( TMath::Cos(firstPhi - secondPhi[j]) + 1.0 / first.fTanTheta[i] / second.fTanTheta[j] ) ) );
 
-	  fHistConversionbefore->Fill(deta,dphi,masssqu);
+	  hist.fHistConversionbefore->Fill(deta,dphi,masssqu);
 	  
 	  if (masssqu < fInvMassCutConversion*fInvMassCutConversion){
-	    //AliInfo(Form("Conversion: Removed track pair %d %d with [[%f %f] %f %f] %d %d <- %f %f  %f %f   %f %f ", i, j, deta, dphi, masssqu, charge1, charge2,eta1,eta2,phi1,phi2,pt1,pt2));
 	    continue;
 	  }
-	  fHistConversionafter->Fill(deta,dphi,masssqu);
+	  hist.fHistConversionafter->Fill(deta,dphi,masssqu);
 	}
       }//conversion cut
 
@@ -784,23 +885,234 @@ void AliBalancePsi::CalculateBalance(Double_t gReactionPlane,
 	//Double_t ptMin        = 0.1; //const for the time being (should be changeable later on)
 	Double_t ptDifference = TMath::Abs( firstPt - secondPt[j]);
 
-	fHistQbefore->Fill(trackVariablesPair[1],trackVariablesPair[2],ptDifference);
+	hist.fHistQbefore->Fill(trackVariablesPair[1],trackVariablesPair[2],ptDifference);
 	if(ptDifference < fDeltaPtMin) continue;
-	fHistQafter->Fill(trackVariablesPair[1],trackVariablesPair[2],ptDifference);
+	hist.fHistQafter->Fill(trackVariablesPair[1],trackVariablesPair[2],ptDifference);
 
       }
 
-      if( charge1 > 0 && charge2 < 0)  fHistPN->Fill(trackVariablesPair,0,firstCorrection*secondCorrection[j]); //==========================correction
-      else if( charge1 < 0 && charge2 > 0)  fHistNP->Fill(trackVariablesPair,0,firstCorrection*secondCorrection[j]);//==========================correction
-      else if( charge1 > 0 && charge2 > 0)  fHistPP->Fill(trackVariablesPair,0,firstCorrection*secondCorrection[j]);//==========================correction
-      else if( charge1 < 0 && charge2 < 0)  fHistNN->Fill(trackVariablesPair,0,firstCorrection*secondCorrection[j]);//==========================correction
+      if( charge1 > 0 && charge2 < 0)  hist.fHistPN->Fill(trackVariablesPair,0,firstCorrection*secondCorrection[j]); //==========================correction
+      else if( charge1 < 0 && charge2 > 0)  hist.fHistNP->Fill(trackVariablesPair,0,firstCorrection*secondCorrection[j]);//==========================correction
+      else if( charge1 > 0 && charge2 > 0)  hist.fHistPP->Fill(trackVariablesPair,0,firstCorrection*secondCorrection[j]);//==========================correction
+      else if( charge1 < 0 && charge2 < 0)  hist.fHistNN->Fill(trackVariablesPair,0,firstCorrection*secondCorrection[j]);//==========================correction
       else {
 	//AliWarning(Form("Wrong charge combination: charge1 = %d and charge2 = %d",charge,charge2));
 	continue;
       }
     }//end of 2nd particle loop
   }//end of 1st particle loop
-}  
+}
+
+//____________________________________________________________________//
+void AliBalancePsi::PackParticles(TObjArray* particles, PackedParticles& packed) {
+  // Copies the particles (AliBFBasicParticle) in the arrays of packed, in the same order
+  // The momenta and the terms of the resonance and conversion cuts are computed only if the cuts are on
+  Int_t n = particles->GetEntriesFast();
+  packed.fEta.resize(n);
+  packed.fPhi.resize(n);
+  packed.fPt.resize(n);
+  packed.fCharge.resize(n);
+  packed.fCorrection.resize(n);
+  packed.fLabel.resize(n);
+  packed.fMotherLabel.resize(n);
+  packed.fTrigOrAssoc.resize(n);
+
+  for (Int_t i=0; i<n; i++){  
+    AliBFBasicParticle* particle = (AliBFBasicParticle*) particles->At(i);
+    packed.fTrigOrAssoc[i] = (Int_t)particle->GetTrigOrAssoc();
+    packed.fEta[i] = particle->Eta();
+    packed.fPhi[i] = particle->Phi();
+    packed.fPt[i]  = particle->Pt();
+    packed.fCharge[i]  = (Short_t)particle->Charge();
+    packed.fCorrection[i]  = (Double_t)particle->Correction();   //==========================correction
+    packed.fLabel[i] = (fSameLabelMCCut) ? (Int_t)particle->GetLabel() : 0;
+    packed.fMotherLabel[i] = (fResonancesLabelCut) ? (Int_t)particle->GetMotherLabel() : 0;
+  }
+
+  //momenta and energies as in TLorentzVector::SetPtEtaPhiM
+  if(fResonancesCut || fResonancePhiCut) {
+    packed.fPx.resize(n);
+    packed.fPy.resize(n);
+    packed.fPz.resize(n);
+    packed.fEPion.resize(n);
+    packed.fEProton.resize(n);
+    packed.fEKaon.resize(n);
+    for (Int_t i=0; i<n; i++){
+      Double_t pt = TMath::Abs((Double_t) packed.fPt[i]);
+      Double_t px = pt*TMath::Cos(packed.fPhi[i]);
+      Double_t py = pt*TMath::Sin(packed.fPhi[i]);
+      Double_t pz = pt*TMath::SinH(packed.fEta[i]);
+      packed.fPx[i] = px;
+      packed.fPy[i] = py;
+      packed.fPz[i] = pz;
+      packed.fEPion[i] = TMath::Sqrt(px*px+py*py+pz*pz+fMasses[kMassPion]*fMasses[kMassPion]);
+      packed.fEProton[i] = TMath::Sqrt(px*px+py*py+pz*pz+fMasses[kMassProton]*fMasses[kMassProton]);
+      packed.fEKaon[i] = TMath::Sqrt(px*px+py*py+pz*pz+fMasses[kMassKaon]*fMasses[kMassKaon]);
+    }
+  }
+
+  //tan(theta) and energy^2 with the electron mass of the conversion cut
+  if(fConversionCut) {
+    Float_t m0 = 0.510e-3;
+    packed.fTanTheta.resize(n);
+    packed.fESquare.resize(n);
+    for (Int_t i=0; i<n; i++){
+      Float_t eta = packed.fEta[i];
+      Float_t pt = packed.fPt[i];
+      Float_t tantheta = 1e10;
+      if (eta < -1e-10 || eta > 1e-10)
+	tantheta = 2 * TMath::Exp(-eta) / ( 1 - TMath::Exp(-2*eta));
+      packed.fTanTheta[i] = tantheta;
+      packed.fESquare[i] = m0 * m0 + pt * pt * (1.0 + 1.0 / tantheta / tantheta);
+    }
+  }
+}
+
+//____________________________________________________________________//
+void AliBalancePsi::GetHistograms(Histograms& hist) {
+  // Histograms of this object
+  hist.fHistP = fHistP;
+  hist.fHistN = fHistN;
+  hist.fHistPN = fHistPN;
+  hist.fHistNP = fHistNP;
+  hist.fHistPP = fHistPP;
+  hist.fHistNN = fHistNN;
+  hist.fHistHBTbefore = fHistHBTbefore;
+  hist.fHistHBTafter = fHistHBTafter;
+  hist.fHistPhiStarHBTbefore = fHistPhiStarHBTbefore;
+  hist.fHistPhiStarHBTafter = fHistPhiStarHBTafter;
+  hist.fHistSameLabelMCCutBefore = fHistSameLabelMCCutBefore;
+  hist.fHistSameLabelMCCutAfter = fHistSameLabelMCCutAfter;
+  hist.fHistConversionbefore = fHistConversionbefore;
+  hist.fHistConversionafter = fHistConversionafter;
+  hist.fHistPsiMinusPhi = fHistPsiMinusPhi;
+  hist.fHistResonancesBefore = fHistResonancesBefore;
+  hist.fHistResonancesPhiBeforeUS = fHistResonancesPhiBeforeUS;
+  hist.fHistResonancesPhiBeforeLS = fHistResonancesPhiBeforeLS;
+  hist.fHistResonancesRho = fHistResonancesRho;
+  hist.fHistResonancesK0 = fHistResonancesK0;
+  hist.fHistResonancesLambda = fHistResonancesLambda;
+  hist.fHistResonancesPhi = fHistResonancesPhi;
+  hist.fHistQbefore = fHistQbefore;
+  hist.fHistQafter = fHistQafter;
+}
+
+//____________________________________________________________________//
+AliBalancePsi::Histograms* AliBalancePsi::CreateShard() {
+  // Empty copies of the histograms of this object, filled by one thread
+  // Called on the main thread, before the threads are started
+  Histograms* shard = new Histograms;
+  shard->fHistP = CloneEmpty(fHistP);
+  shard->fHistN = CloneEmpty(fHistN);
+  shard->fHistPN = CloneEmpty(fHistPN);
+  shard->fHistNP = CloneEmpty(fHistNP);
+  shard->fHistPP = CloneEmpty(fHistPP);
+  shard->fHistNN = CloneEmpty(fHistNN);
+  shard->fHistHBTbefore = CloneEmpty(fHistHBTbefore);
+  shard->fHistHBTafter = CloneEmpty(fHistHBTafter);
+  shard->fHistPhiStarHBTbefore = CloneEmpty(fHistPhiStarHBTbefore);
+  shard->fHistPhiStarHBTafter = CloneEmpty(fHistPhiStarHBTafter);
+  shard->fHistSameLabelMCCutBefore = CloneEmpty(fHistSameLabelMCCutBefore);
+  shard->fHistSameLabelMCCutAfter = CloneEmpty(fHistSameLabelMCCutAfter);
+  shard->fHistConversionbefore = CloneEmpty(fHistConversionbefore);
+  shard->fHistConversionafter = CloneEmpty(fHistConversionafter);
+  shard->fHistPsiMinusPhi = CloneEmpty(fHistPsiMinusPhi);
+  shard->fHistResonancesBefore = CloneEmpty(fHistResonancesBefore);
+  shard->fHistResonancesPhiBeforeUS = CloneEmpty(fHistResonancesPhiBeforeUS);
+  shard->fHistResonancesPhiBeforeLS = CloneEmpty(fHistResonancesPhiBeforeLS);
+  shard->fHistResonancesRho = CloneEmpty(fHistResonancesRho);
+  shard->fHistResonancesK0 = CloneEmpty(fHistResonancesK0);
+  shard->fHistResonancesLambda = CloneEmpty(fHistResonancesLambda);
+  shard->fHistResonancesPhi = CloneEmpty(fHistResonancesPhi);
+  shard->fHistQbefore = CloneEmpty(fHistQbefore);
+  shard->fHistQafter = CloneEmpty(fHistQafter);
+  return shard;
+}
+
+//____________________________________________________________________//
+void AliBalancePsi::DeleteShard(Histograms* shard) {
+  // Deletes the histograms of a shard and the shard
+  delete shard->fHistP;
+  delete shard->fHistN;
+  delete shard->fHistPN;
+  delete shard->fHistNP;
+  delete shard->fHistPP;
+  delete shard->fHistNN;
+  delete shard->fHistHBTbefore;
+  delete shard->fHistHBTafter;
+  delete shard->fHistPhiStarHBTbefore;
+  delete shard->fHistPhiStarHBTafter;
+  delete shard->fHistSameLabelMCCutBefore;
+  delete shard->fHistSameLabelMCCutAfter;
+  delete shard->fHistConversionbefore;
+  delete shard->fHistConversionafter;
+  delete shard->fHistPsiMinusPhi;
+  delete shard->fHistResonancesBefore;
+  delete shard->fHistResonancesPhiBeforeUS;
+  delete shard->fHistResonancesPhiBeforeLS;
+  delete shard->fHistResonancesRho;
+  delete shard->fHistResonancesK0;
+  delete shard->fHistResonancesLambda;
+  delete shard->fHistResonancesPhi;
+  delete shard->fHistQbefore;
+  delete shard->fHistQafter;
+  delete shard;
+}
+
+//____________________________________________________________________//
+void AliBalancePsi::MergeShards() {
+  // Adds the histograms filled by the threads to the histograms of this object
+  // (in the order of the threads) and deletes them
+  for (UInt_t iShard = 0; iShard < fShards.size(); iShard++) {
+    Histograms* shard = fShards[iShard];
+    AddShard(fHistP, shard->fHistP);
+    AddShard(fHistN, shard->fHistN);
+    AddShard(fHistPN, shard->fHistPN);
+    AddShard(fHistNP, shard->fHistNP);
+    AddShard(fHistPP, shard->fHistPP);
+    AddShard(fHistNN, shard->fHistNN);
+    fHistHBTbefore->Add(shard->fHistHBTbefore);
+    fHistHBTafter->Add(shard->fHistHBTafter);
+    fHistPhiStarHBTbefore->Add(shard->fHistPhiStarHBTbefore);
+    fHistPhiStarHBTafter->Add(shard->fHistPhiStarHBTafter);
+    fHistSameLabelMCCutBefore->Add(shard->fHistSameLabelMCCutBefore);
+    fHistSameLabelMCCutAfter->Add(shard->fHistSameLabelMCCutAfter);
+    fHistConversionbefore->Add(shard->fHistConversionbefore);
+    fHistConversionafter->Add(shard->fHistConversionafter);
+    fHistPsiMinusPhi->Add(shard->fHistPsiMinusPhi);
+    fHistResonancesBefore->Add(shard->fHistResonancesBefore);
+    fHistResonancesPhiBeforeUS->Add(shard->fHistResonancesPhiBeforeUS);
+    fHistResonancesPhiBeforeLS->Add(shard->fHistResonancesPhiBeforeLS);
+    fHistResonancesRho->Add(shard->fHistResonancesRho);
+    fHistResonancesK0->Add(shard->fHistResonancesK0);
+    fHistResonancesLambda->Add(shard->fHistResonancesLambda);
+    fHistResonancesPhi->Add(shard->fHistResonancesPhi);
+    fHistQbefore->Add(shard->fHistQbefore);
+    fHistQafter->Add(shard->fHistQafter);
+    DeleteShard(shard);
+  }
+  fShards.clear();
+}
+
+//____________________________________________________________________//
+AliBalancePsi::PairBuffers::PairBuffers() :
+  fDEta(),
+  fDPhi(),
+  fSelected(),
+  fMassPiPi(),
+  fMassPiP(),
+  fMassPPi(),
+  fMassKK(),
+  fPtKK(),
+  fDPhiStarCut(new AliDPhiStarPairCut) {
+  // Constructor
+}
+
+//____________________________________________________________________//
+AliBalancePsi::PairBuffers::~PairBuffers() {
+  // Destructor
+  delete fDPhiStarCut;
+}
 
 //____________________________________________________________________//
 TH1D *AliBalancePsi::GetBalanceFunctionHistogram(Int_t iVariableSingle,
@@ -2838,31 +3150,6 @@ Bool_t AliBalancePsi::GetMomentsAnalytical(Int_t fVariable, TH1D* gHist, Bool_t
 }
 
 
-//____________________________________________________________________//
-Float_t AliBalancePsi::GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign) { 
-  //
-  // calculates dphistar
-  //
-  Float_t dphistar = phi1 - phi2 - charge1 * bSign * TMath::ASin(0.075 * radius / pt1) + charge2 * bSign * TMath::ASin(0.075 * radius / pt2);
-  
-  static const Double_t kPi = TMath::Pi();
-  
-  // circularity
-//   if (dphistar > 2 * kPi)
-//     dphistar -= 2 * kPi;
-//   if (dphistar < -2 * kPi)
-//     dphistar += 2 * kPi;
-  
-  if (dphistar > kPi)
-    dphistar = kPi * 2 - dphistar;
-  if (dphistar < -kPi)
-    dphistar = -kPi * 2 - dphistar;
-  if (dphistar > kPi) // might look funny but is needed
-    dphistar = kPi * 2 - dphistar;
-  
-  return dphistar;
-}
-
 //____________________________________________________________________//
 Double_t* AliBalancePsi::GetBinning(const char* configuration, const char* tag, Int_t& nBins)
 {
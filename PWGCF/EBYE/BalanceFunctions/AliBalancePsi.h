@@ -21,6 +21,8 @@
 
 using std::vector;
 
+class AliDPhiStarPairCut;
+
 #define ANALYSIS_TYPES	7
 #define MAXIMUM_NUMBER_OF_STEPS	1024
 #define MAXIMUM_STEPS_IN_PSI 360
@@ -241,13 +243,79 @@ class AliBalancePsi : public TObject {
   void UseMomentumDifferenceCut(Double_t gDeltaPtCutMin) {
     fQCut = kTRUE; fDeltaPtMin = gDeltaPtCutMin;}
 
+  // CalculateBalance on several threads: the trigger particles of an event are split
+  // in nThreads ranges, the 1st range fills the histograms of this object and the others
+  // per-thread copies, which are added to the histograms of this object by MergeShards
+  // (to be called at the end of the task, e.g. in FinishTaskOutput)
+  // The task has to call ROOT::EnableThreadSafety() at setup (see AliAnalysisTaskBFPsi::UserCreateOutputObjects)
+  void SetNThreads(Int_t nThreads = 1) {fNThreads = nThreads;}
+  Int_t GetNThreads() const {return fNThreads;}
+  void MergeShards();
+
   // related to customized binning of output AliTHn
   Bool_t    IsUseVertexBinning() { return fVertexBinning; }
   TString   GetBinningString()   { return fBinningString; }
   Double_t* GetBinning(const char* configuration, const char* tag, Int_t& nBins);
 
  private:
-  Float_t   GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign); 
+  // particles of an event in contiguous arrays, filled once per call of CalculateBalance
+  struct PackedParticles {
+    vector<Float_t> fEta;
+    vector<Float_t> fPhi;
+    vector<Float_t> fPt;
+    vector<Short_t> fCharge;
+    vector<Double_t> fCorrection;
+    vector<Int_t> fLabel;
+    vector<Int_t> fMotherLabel;
+    vector<Int_t> fTrigOrAssoc;
+    vector<Double_t> fPx;        // momentum as in TLorentzVector::SetPtEtaPhiM (resonance cuts only)
+    vector<Double_t> fPy;
+    vector<Double_t> fPz;
+    vector<Double_t> fEPion;     // energy with the pion mass
+    vector<Double_t> fEProton;   // energy with the proton mass
+    vector<Double_t> fEKaon;     // energy with the kaon mass
+    vector<Float_t> fTanTheta;   // conversion cut only
+    vector<Float_t> fESquare;    // energy^2 with the electron mass (conversion cut only)
+  };
+
+  // histograms filled by CalculateBalance: the ones of this object or the copies of one thread
+  struct Histograms {
+    AliTHn *fHistP, *fHistN, *fHistPN, *fHistNP, *fHistPP, *fHistNN;
+    TH2D *fHistHBTbefore, *fHistHBTafter, *fHistPhiStarHBTbefore, *fHistPhiStarHBTafter;
+    TH2D *fHistSameLabelMCCutBefore, *fHistSameLabelMCCutAfter;
+    TH3D *fHistConversionbefore, *fHistConversionafter;
+    TH2D *fHistPsiMinusPhi;
+    TH3D *fHistResonancesBefore, *fHistResonancesPhiBeforeUS, *fHistResonancesPhiBeforeLS;
+    TH3D *fHistResonancesRho, *fHistResonancesK0, *fHistResonancesLambda, *fHistResonancesPhi;
+    TH3D *fHistQbefore, *fHistQafter;
+  };
+
+  // buffers of the pair loop of one thread
+  struct PairBuffers {
+    PairBuffers();
+    ~PairBuffers();
+    vector<Double_t> fDEta;       // delta eta of the trigger with all second particles
+    vector<Double_t> fDPhi;       // delta phi
+    vector<UChar_t> fSelected;    // 1 if the pair passes the trigger/associated, auto-correlation and momentum ordering selections
+    vector<Double_t> fMassPiPi;   // invariant mass pion-pion
+    vector<Double_t> fMassPiP;    // invariant mass pion-proton
+    vector<Double_t> fMassPPi;    // invariant mass proton-pion
+    vector<Double_t> fMassKK;     // invariant mass kaon-kaon
+    vector<Double_t> fPtKK;       // pt of the kaon-kaon pair
+    AliDPhiStarPairCut* fDPhiStarCut; // two-track cut
+   private:
+    PairBuffers(const PairBuffers&);
+    PairBuffers& operator=(const PairBuffers&);
+  };
+
+  enum { kMassPion, kMassProton, kMassKaon, kMassRho0, kMassK0s, kMassLambda, kNMasses };
+
+  void PackParticles(TObjArray* particles, PackedParticles& packed);
+  void GetHistograms(Histograms& hist);
+  Histograms* CreateShard();
+  void DeleteShard(Histograms* shard);
+  void FillPairs(Int_t iFirst, Int_t iLast, Double_t gReactionPlane, Bool_t mixed, Double_t kMultorCent, Double_t vertexZ,
+		 Histograms& hist, PairBuffers& buffers);
 
   Bool_t fShuffle; //shuffled balance function object
   TString fAnalysisLevel; //ESD, AOD or MC
@@ -307,9 +375,16 @@ class AliBalancePsi : public TObject {
 
   TString fEventClass;
 
+  Int_t fNThreads; // number of threads of CalculateBalance (1: no threads)
+  PackedParticles* fPackedFirst;  //! particles of the 1st particle loop
+  PackedParticles* fPackedSecond; //! particles of the 2nd particle loop (mixed event), 0 if the same as fPackedFirst
+  vector<PairBuffers*> fPairBuffers; //! buffers of the pair loop, one per thread
+  vector<Histograms*> fShards;   //! histograms filled by the threads 1..fNThreads-1
+  Double_t fMasses[kNMasses];    //! masses of the resonance cuts
+
   AliBalancePsi & operator=(const AliBalancePsi & ) {return *this;}
 
-  ClassDef(AliBalancePsi, 5)
+  ClassDef(AliBalancePsi, 6)
 };
 
 #endif
@@ -34,6 +34,15 @@ void AliFemtoCorrFctn::AddMixedPair(AliFemtoPair*)
   cout << "AliFemtoCorrFctn::AddMixedPair -- Not implemented\n";
 }
 
+void AliFemtoCorrFctn::AddRealPairs(const AliFemtoPairBatch&)
+{
+  cout << "AliFemtoCorrFctn::AddRealPairs -- Not implemented\n";
+}
+void AliFemtoCorrFctn::AddMixedPairs(const AliFemtoPairBatch&)
+{
+  cout << "AliFemtoCorrFctn::AddMixedPairs -- Not implemented\n";
+}
+
 void AliFemtoCorrFctn::AddFirstParticle(AliFemtoParticle*, bool)
 {
   cout << "AliFemtoCorrFctn::AddFirstParticle -- Not implemented\n";
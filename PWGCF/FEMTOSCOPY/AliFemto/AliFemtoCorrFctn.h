@@ -14,6 +14,8 @@
 
 #include <TCollection.h>
 
+class AliFemtoPairBatch;
+
 
 /// \class AliFemtoCorrFctn
 /// \brief The pure-virtual base class for correlation functions
@@ -44,6 +46,16 @@ public:
   /// Not Implemented - Add background pair
   virtual void AddMixedPair(AliFemtoPair* aPir);
 
+  /// Return true if the correlation function only needs the pair variables
+  /// computed by AliFemtoPairBatch. The analysis then passes the pairs
+  /// (which passed its pair cut) block by block to AddRealPairs and
+  /// AddMixedPairs instead of one by one to AddRealPair and AddMixedPair
+  virtual bool AcceptsPairBatches() const;
+  /// Not Implemented - Add block of signal pairs
+  virtual void AddRealPairs(const AliFemtoPairBatch &batch);
+  /// Not Implemented - Add block of background pairs
+  virtual void AddMixedPairs(const AliFemtoPairBatch &batch);
+
   /// Not Implemented - Add pair with optional
   virtual void AddFirstParticle(AliFemtoParticle *particle, bool mixing);
   virtual void AddSecondParticle(AliFemtoParticle *particle);
@@ -97,6 +109,11 @@ inline void AliFemtoCorrFctn::SetPairSelectionCut(AliFemtoPairCut* cut)
   fPairCut = cut;
 }
 
+inline bool AliFemtoCorrFctn::AcceptsPairBatches() const
+{
+  return false;
+}
+
 inline void AliFemtoCorrFctn::EventBegin(const AliFemtoEvent* /* event */)
 { // no-op
 }
@@ -0,0 +1,72 @@
+///
+/// \file AliFemtoPairBatch.cxx
+///
+
+#include "AliFemtoPairBatch.h"
+
+#include <cmath>
+
+AliFemtoPairBatch::AliFemtoPairBatch():
+  fColumns1(nullptr),
+  fColumns2(nullptr),
+  fSize(0)
+{ /* no-op */
+}
+
+void AliFemtoPairBatch::Reset(const AliFemtoParticleColumns *columns1,
+                              const AliFemtoParticleColumns *columns2)
+{
+  fColumns1 = columns1;
+  fColumns2 = columns2;
+  fSize = 0;
+}
+
+void AliFemtoPairBatch::Compute()
+{
+  const double *px1 = fColumns1->Px(), *py1 = fColumns1->Py(),
+               *pz1 = fColumns1->Pz(), *pE1 = fColumns1->E(),
+               *mass1_sqrd = fColumns1->Mass2(),
+               *px2 = fColumns2->Px(), *py2 = fColumns2->Py(),
+               *pz2 = fColumns2->Pz(), *pE2 = fColumns2->E(),
+               *mass2_sqrd = fColumns2->Mass2();
+
+  // gather the two tracks of each pair first, then one branch-free loop
+  // over the block for the kinematics
+  double x1[kMaxSize], y1[kMaxSize], z1[kMaxSize], e1[kMaxSize], m1[kMaxSize],
+         x2[kMaxSize], y2[kMaxSize], z2[kMaxSize], e2[kMaxSize], m2[kMaxSize];
+
+  for (UInt_t i = 0; i < fSize; i++) {
+    const UInt_t i1 = fIndex1[i],
+                 i2 = fIndex2[i];
+    x1[i] = px1[i1]; y1[i] = py1[i1]; z1[i] = pz1[i1]; e1[i] = pE1[i1]; m1[i] = mass1_sqrd[i1];
+    x2[i] = px2[i2]; y2[i] = py2[i2]; z2[i] = pz2[i2]; e2[i] = pE2[i2]; m2[i] = mass2_sqrd[i2];
+  }
+
+  for (UInt_t i = 0; i < fSize; i++) {
+    const double
+      dx = x1[i] - x2[i],
+      dy = y1[i] - y2[i],
+      dz = z1[i] - z2[i],
+      dE = e1[i] - e2[i],
+      tPx = x1[i] + x2[i],
+      tPy = y1[i] + y2[i],
+      tPz = z1[i] + z2[i],
+      tPE = e1[i] + e2[i];
+
+    // AliFemtoPair::QInv : -(p1-p2).m()
+    const double tDiffM2 = dE*dE - (dx*dx + dy*dy + dz*dz);
+    fQInv[i] = tDiffM2 < 0 ? ::sqrt(-tDiffM2) : -::sqrt(tDiffM2);
+
+    // AliFemtoPair::KT : 0.5 * (p1+p2).Perp()
+    const double tPtrans = tPx*tPx + tPy*tPy;
+    fKT[i] = ::sqrt(tPtrans) * .5;
+
+    // AliFemtoPair::CalcNonIdPar
+    const double tMtrans = tPE*tPE - tPz*tPz;
+    const double tPinv = ::sqrt(tMtrans - tPtrans);
+    const double tQinvL = dE*dE - dx*dx - dy*dy - dz*dz;
+    double tQ = (m1[i] - m2[i])/tPinv;
+    tQ = ::sqrt( tQ*tQ - tQinvL);
+    fKStar[i] = tQ/2;
+  }
+}
@@ -0,0 +1,132 @@
+///
+/// \file AliFemtoPairBatch.h
+///
+
+#ifndef ALIFEMTOPAIRBATCH_H
+#define ALIFEMTOPAIRBATCH_H
+
+#include "AliFemtoParticleColumns.h"
+
+/// \class AliFemtoPairBatch
+/// \brief A block of pairs passing the pair cut, with their kinematics
+///
+/// The pairs are stored as indices into two AliFemtoParticleColumns
+/// (the same columns for identical particles). Compute() evaluates
+/// q_inv, k_T and k* for all the pairs of the block in one loop over the
+/// columns, with the same formulas as AliFemtoPair::QInv, AliFemtoPair::KT
+/// and AliFemtoPair::KStar, so the values are identical.
+///
+/// Correlation functions which only need these variables can opt in
+/// with AliFemtoCorrFctn::AcceptsPairBatches, they then receive the
+/// pairs block by block (see AliFemtoSimpleAnalysis::MakePairs).
+///
+class AliFemtoPairBatch {
+public:
+  enum { kMaxSize = 256 };
+
+  AliFemtoPairBatch();
+
+  /// Start a new block of pairs made of particles from columns1 and columns2
+  void Reset(const AliFemtoParticleColumns *columns1, const AliFemtoParticleColumns *columns2);
+  /// Forget the pairs, keep the columns
+  void Clear();
+
+  /// Add the pair (track1 = columns1[index1], track2 = columns2[index2]).
+  /// Returns true when the block is full
+  bool Add(UInt_t index1, UInt_t index2);
+
+  /// Calculate the kinematics of all pairs in the block
+  void Compute();
+
+  UInt_t Size() const;
+
+  const UInt_t* Index1() const;
+  const UInt_t* Index2() const;
+  const double* QInv() const;    ///< as AliFemtoPair::QInv (= -m of p1-p2)
+  const double* KT() const;      ///< as AliFemtoPair::KT
+  const double* KStar() const;   ///< as AliFemtoPair::KStar
+
+  AliFemtoParticle* Track1(UInt_t i) const;
+  AliFemtoParticle* Track2(UInt_t i) const;
+
+  const AliFemtoParticleColumns* Columns1() const;
+  const AliFemtoParticleColumns* Columns2() const;
+
+private:
+  AliFemtoPairBatch(const AliFemtoPairBatch&);
+  AliFemtoPairBatch& operator=(const AliFemtoPairBatch&);
+
+  const AliFemtoParticleColumns *fColumns1;  ///< particles of track 1 (not owned)
+  const AliFemtoParticleColumns *fColumns2;  ///< particles of track 2 (not owned)
+  UInt_t fSize;                              ///< number of pairs in the block
+
+  UInt_t fIndex1[kMaxSize];                  ///< index of track 1 in fColumns1
+  UInt_t fIndex2[kMaxSize];                  ///< index of track 2 in fColumns2
+  double fQInv[kMaxSize];                    ///< q_inv of the pairs
+  double fKT[kMaxSize];                      ///< k_T of the pairs
+  double fKStar[kMaxSize];                   ///< k* of the pairs
+};
+
+inline void AliFemtoPairBatch::Clear()
+{
+  fSize = 0;
+}
+
+inline bool AliFemtoPairBatch::Add(UInt_t index1, UInt_t index2)
+{
+  fIndex1[fSize] = index1;
+  fIndex2[fSize] = index2;
+  return ++fSize == kMaxSize;
+}
+
+inline UInt_t AliFemtoPairBatch::Size() const
+{
+  return fSize;
+}
+
+inline const UInt_t* AliFemtoPairBatch::Index1() const
+{
+  return fIndex1;
+}
+
+inline const UInt_t* AliFemtoPairBatch::Index2() const
+{
+  return fIndex2;
+}
+
+inline const double* AliFemtoPairBatch::QInv() const
+{
+  return fQInv;
+}
+
+inline const double* AliFemtoPairBatch::KT() const
+{
+  return fKT;
+}
+
+inline const double* AliFemtoPairBatch::KStar() const
+{
+  return fKStar;
+}
+
+inline AliFemtoParticle* AliFemtoPairBatch::Track1(UInt_t i) const
+{
+  return fColumns1->Particle(fIndex1[i]);
+}
+
+inline AliFemtoParticle* AliFemtoPairBatch::Track2(UInt_t i) const
+{
+  return fColumns2->Particle(fIndex2[i]);
+}
+
+inline const AliFemtoParticleColumns* AliFemtoPairBatch::Columns1() const
+{
+  return fColumns1;
+}
+
+inline const AliFemtoParticleColumns* AliFemtoPairBatch::Columns2() const
+{
+  return fColumns2;
+}
+
+#endif
@@ -0,0 +1,54 @@
+///
+/// \file AliFemtoParticleColumns.cxx
+///
+
+#include "AliFemtoParticleColumns.h"
+
+#include <algorithm>
+
+AliFemtoParticleColumns::AliFemtoParticleColumns():
+  fPx(),
+  fPy(),
+  fPz(),
+  fE(),
+  fMass2(),
+  fParticles()
+{ /* no-op */
+}
+
+void AliFemtoParticleColumns::Fill(const AliFemtoParticleCollection *collection)
+{
+  Clear();
+  if (collection == nullptr) {
+    return;
+  }
+
+  const size_t n = collection->size();
+  fPx.reserve(n);
+  fPy.reserve(n);
+  fPz.reserve(n);
+  fE.reserve(n);
+  fMass2.reserve(n);
+  fParticles.reserve(n);
+
+  for (const auto &particle : *collection) {
+    const AliFemtoLorentzVector &p = particle->FourMomentum();
+    fPx.push_back(p.x());
+    fPy.push_back(p.y());
+    fPz.push_back(p.z());
+    fE.push_back(p.e());
+    // same clamping as AliFemtoPair::CalcNonIdPar
+    fMass2.push_back(std::max(0.0, p.m2()));
+    fParticles.push_back(particle);
+  }
+}
+
+void AliFemtoParticleColumns::Clear()
+{
+  fPx.clear();
+  fPy.clear();
+  fPz.clear();
+  fE.clear();
+  fMass2.clear();
+  fParticles.clear();
+}
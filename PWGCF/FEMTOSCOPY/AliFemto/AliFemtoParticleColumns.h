@@ -0,0 +1,86 @@
+///
+/// \file AliFemtoParticleColumns.h
+///
+
+#ifndef ALIFEMTOPARTICLECOLUMNS_H
+#define ALIFEMTOPARTICLECOLUMNS_H
+
+#include "AliFemtoParticleCollection.h"
+
+#include <vector>
+
+/// \class AliFemtoParticleColumns
+/// \brief Contiguous (structure-of-arrays) copy of the kinematics of a
+///        particle collection
+///
+/// The four-momentum components of the particles are stored in one array
+/// each, in the order of the AliFemtoParticleCollection, together with the
+/// pointers to the particles. The columns are built once per pico event
+/// (see AliFemtoPicoEvent::FirstParticleColumns) and reused each time the
+/// event is mixed, so the pair loops run over plain arrays instead of
+/// following the list nodes and the particle pointers.
+///
+class AliFemtoParticleColumns {
+public:
+  AliFemtoParticleColumns();
+
+  /// Copy the kinematics of all particles of the collection
+  void Fill(const AliFemtoParticleCollection *collection);
+  void Clear();
+
+  UInt_t Size() const;
+
+  const double* Px() const;
+  const double* Py() const;
+  const double* Pz() const;
+  const double* E() const;
+  /// Squared mass of the four-momenta, negative values set to 0
+  const double* Mass2() const;
+
+  AliFemtoParticle* Particle(UInt_t i) const;
+
+private:
+  std::vector<double> fPx;                     ///< x component of momentum
+  std::vector<double> fPy;                     ///< y component of momentum
+  std::vector<double> fPz;                     ///< z component of momentum
+  std::vector<double> fE;                      ///< energy
+  std::vector<double> fMass2;                  ///< squared mass, >= 0
+  std::vector<AliFemtoParticle*> fParticles;   ///< particles, in the order of the collection (not owned)
+};
+
+inline UInt_t AliFemtoParticleColumns::Size() const
+{
+  return fParticles.size();
+}
+
+inline const double* AliFemtoParticleColumns::Px() const
+{
+  return fPx.data();
+}
+
+inline const double* AliFemtoParticleColumns::Py() const
+{
+  return fPy.data();
+}
+
+inline const double* AliFemtoParticleColumns::Pz() const
+{
+  return fPz.data();
+}
+
+inline const double* AliFemtoParticleColumns::E() const
+{
+  return fE.data();
+}
+
+inline const double* AliFemtoParticleColumns::Mass2() const
+{
+  return fMass2.data();
+}
+
+inline AliFemtoParticle* AliFemtoParticleColumns::Particle(UInt_t i) const
+{
+  return fParticles[i];
+}
+
+#endif
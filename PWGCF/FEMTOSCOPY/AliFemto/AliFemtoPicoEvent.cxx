@@ -67,7 +67,12 @@
 AliFemtoPicoEvent::AliFemtoPicoEvent() :
   fFirstParticleCollection(0),
   fSecondParticleCollection(0),
-  fThirdParticleCollection(0)
+  fThirdParticleCollection(0),
+  fFirstParticleColumns(0),
+  fSecondParticleColumns(0),
+  fGeneration(0),
+  fFirstColumnsGeneration(0),
+  fSecondColumnsGeneration(0)
 {
   // Default constructor
   fFirstParticleCollection = new AliFemtoParticleCollection;
@@ -78,7 +83,12 @@ AliFemtoPicoEvent::AliFemtoPicoEvent() :
 AliFemtoPicoEvent::AliFemtoPicoEvent(const AliFemtoPicoEvent& aPicoEvent) :
   fFirstParticleCollection(0),
   fSecondParticleCollection(0),
-  fThirdParticleCollection(0)
+  fThirdParticleCollection(0),
+  fFirstParticleColumns(0),
+  fSecondParticleColumns(0),
+  fGeneration(0),
+  fFirstColumnsGeneration(0),
+  fSecondColumnsGeneration(0)
 {
   // Copy constructor
   AliFemtoParticleIterator iter;
@@ -135,6 +145,9 @@ AliFemtoPicoEvent::~AliFemtoPicoEvent(){
     delete fThirdParticleCollection;
     fThirdParticleCollection = 0;
   }
+
+  delete fFirstParticleColumns;
+  delete fSecondParticleColumns;
 }
 //_________________
 AliFemtoPicoEvent& AliFemtoPicoEvent::operator=(const AliFemtoPicoEvent& aPicoEvent) 
@@ -174,6 +187,13 @@ AliFemtoPicoEvent& AliFemtoPicoEvent::operator=(const AliFemtoPicoEvent& aPicoEv
     fThirdParticleCollection = 0;
   }
 
+  // the columns are rebuilt from the new collections on request
+  delete fFirstParticleColumns;
+  fFirstParticleColumns = 0;
+  delete fSecondParticleColumns;
+  fSecondParticleColumns = 0;
+  CollectionsChanged();
+
   fFirstParticleCollection = new AliFemtoParticleCollection;
   if (aPicoEvent.fFirstParticleCollection) {
     for (iter=aPicoEvent.fFirstParticleCollection->begin();iter!=aPicoEvent.fFirstParticleCollection->end();iter++){
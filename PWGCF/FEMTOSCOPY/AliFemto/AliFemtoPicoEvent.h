@@ -43,6 +43,7 @@
 #define ALIFEMTOPICOEVENT_H
 
 #include "AliFemtoParticleCollection.h"
+#include "AliFemtoParticleColumns.h"
 
 class AliFemtoPicoEvent{
 public:
@@ -58,14 +59,46 @@ public:
   AliFemtoParticleCollection* SecondParticleCollection();
   AliFemtoParticleCollection* ThirdParticleCollection();
 
+  /* columnar copies of the collections, built on first request and kept
+     while the event sits in the mixing buffer, until CollectionsChanged() */
+  const AliFemtoParticleColumns* FirstParticleColumns();
+  const AliFemtoParticleColumns* SecondParticleColumns();
+
+  /* to be called after modifying the collections once their columns were
+     requested, the columns are then rebuilt on the next request */
+  void CollectionsChanged();
+
 private:
   AliFemtoParticleCollection* fFirstParticleCollection;  // Collection of particles of type 1
   AliFemtoParticleCollection* fSecondParticleCollection; // Collection of particles of type 2
   AliFemtoParticleCollection* fThirdParticleCollection;  // Collection of particles of type 3
+
+  AliFemtoParticleColumns* fFirstParticleColumns;        // Columns of the particles of type 1
+  AliFemtoParticleColumns* fSecondParticleColumns;       // Columns of the particles of type 2
+  UInt_t fGeneration;                                    // Incremented by CollectionsChanged()
+  UInt_t fFirstColumnsGeneration;                        // Generation of the collections in fFirstParticleColumns
+  UInt_t fSecondColumnsGeneration;                       // Generation of the collections in fSecondParticleColumns
 };
 
 inline AliFemtoParticleCollection* AliFemtoPicoEvent::FirstParticleCollection(){return fFirstParticleCollection;}
 inline AliFemtoParticleCollection* AliFemtoPicoEvent::SecondParticleCollection(){return fSecondParticleCollection;}
 inline AliFemtoParticleCollection* AliFemtoPicoEvent::ThirdParticleCollection(){return fThirdParticleCollection;}
+inline void AliFemtoPicoEvent::CollectionsChanged(){fGeneration++;}
+inline const AliFemtoParticleColumns* AliFemtoPicoEvent::FirstParticleColumns(){
+  if (!fFirstParticleColumns || fFirstColumnsGeneration != fGeneration) {
+    if (!fFirstParticleColumns) fFirstParticleColumns = new AliFemtoParticleColumns;
+    fFirstParticleColumns->Fill(fFirstParticleCollection);
+    fFirstColumnsGeneration = fGeneration;
+  }
+  return fFirstParticleColumns;
+}
+inline const AliFemtoParticleColumns* AliFemtoPicoEvent::SecondParticleColumns(){
+  if (!fSecondParticleColumns || fSecondColumnsGeneration != fGeneration) {
+    if (!fSecondParticleColumns) fSecondParticleColumns = new AliFemtoParticleColumns;
+    fSecondParticleColumns->Fill(fSecondParticleCollection);
+    fSecondColumnsGeneration = fGeneration;
+  }
+  return fSecondParticleColumns;
+}
 
 #endif
@@ -3,6 +3,7 @@
 ///
 
 #include "AliFemtoQinvCorrFctn.h"
+#include "AliFemtoPairBatch.h"
 // #include <cstdio>
 
 #ifdef __ROOT__
@@ -245,6 +246,28 @@ void AliFemtoQinvCorrFctn::AddMixedPair(AliFemtoPair* pair)
   }
 }
 
+//____________________________
+void AliFemtoQinvCorrFctn::AddRealPairs(const AliFemtoPairBatch &batch)
+{
+  // add block of true pairs, same histograms as AddRealPair
+  const double *qinv = batch.QInv(),
+               *kt = batch.KT();
+  for (UInt_t i = 0; i < batch.Size(); i++) {
+    fNumerator->Fill(fabs(qinv[i]));
+    fkTMonitor->Fill(kt[i]);
+  }
+}
+
+//____________________________
+void AliFemtoQinvCorrFctn::AddMixedPairs(const AliFemtoPairBatch &batch)
+{
+  // add block of mixed (background) pairs, same histogram as AddMixedPair
+  const double *qinv = batch.QInv();
+  for (UInt_t i = 0; i < batch.Size(); i++) {
+    fDenominator->Fill(fabs(qinv[i]));
+  }
+}
+
 void AliFemtoQinvCorrFctn::Write()
 {
   // Write out neccessary objects
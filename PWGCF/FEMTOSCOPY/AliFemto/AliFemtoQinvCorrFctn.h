@@ -66,6 +66,12 @@ public:
   virtual void AddRealPair(AliFemtoPair* aPair);
   virtual void AddMixedPair(AliFemtoPair* aPair);
 
+  /// Pairs are accepted in blocks unless a pair cut, the (Δη, Δϕ*)
+  /// histograms or the pair kinematics ntuple are used
+  virtual bool AcceptsPairBatches() const;
+  virtual void AddRealPairs(const AliFemtoPairBatch &batch);
+  virtual void AddMixedPairs(const AliFemtoPairBatch &batch);
+
   virtual void Finish();
 
   void CalculateDetaDphis(Bool_t, Double_t);
@@ -112,5 +118,8 @@ inline void AliFemtoQinvCorrFctn::CalculateDetaDphis(Bool_t dedpsc, Double_t rad
 inline void AliFemtoQinvCorrFctn::CalculatePairKinematics(Bool_t pk)
   { fPairKinematics = pk; }
 
+inline bool AliFemtoQinvCorrFctn::AcceptsPairBatches() const
+  { return !fPairCut && !fDetaDphiscal && !fPairKinematics; }
+
 
 #endif
@@ -9,10 +9,13 @@
 #include "AliFemtoXiCut.h"
 #include "AliFemtoXiTrackCut.h"
 #include "AliFemtoPicoEvent.h"
+#include "AliFemtoPairBatch.h"
 
 #include <string>
 #include <iostream>
 #include <iterator>
+#include <utility>
+#include <vector>
 
 #ifdef __ROOT__
   /// \cond CLASSIMP
@@ -183,7 +186,8 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis():
   fMinSizePartCollection(0),
   fVerbose(kTRUE),
   fPerformSharedDaughterCut(kFALSE),
-  fEnablePairMonitors(kFALSE)
+  fEnablePairMonitors(kFALSE),
+  fUsePairBatches(kTRUE)
 {
   // Default constructor
   fCorrFctnCollection = new AliFemtoCorrFctnCollection;
@@ -205,7 +209,8 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis(const AliFemtoSimpleAnalysis& a):
   fMinSizePartCollection(a.fMinSizePartCollection),
   fVerbose(a.fVerbose),
   fPerformSharedDaughterCut(a.fPerformSharedDaughterCut),
-  fEnablePairMonitors(a.fEnablePairMonitors)
+  fEnablePairMonitors(a.fEnablePairMonitors),
+  fUsePairBatches(a.fUsePairBatches)
 {
   /// Copy constructor
 
@@ -402,6 +407,7 @@ AliFemtoSimpleAnalysis& AliFemtoSimpleAnalysis::operator=(const AliFemtoSimpleAn
   fVerbose = aAna.fVerbose;
   fPerformSharedDaughterCut = aAna.fPerformSharedDaughterCut;
   fEnablePairMonitors = aAna.fEnablePairMonitors;
+  fUsePairBatches = aAna.fUsePairBatches;
 
   return *this;
 }
@@ -535,7 +541,14 @@ void AliFemtoSimpleAnalysis::ProcessEvent(const AliFemtoEvent* hbtEvent)
     collection2 = nullptr;
   }
 
-  MakePairs("real", collection1, collection2, EnablePairMonitors());
+  // Columnar copies of the collections are only needed (and built) if a
+  // correlation function takes pairs in blocks. Those of the current event
+  // stay with it in the mixing buffer.
+  const bool use_batches = NeedsPairBatches();
+
+  MakePairs("real", collection1, collection2, EnablePairMonitors(),
+            use_batches ? fPicoEvent->FirstParticleColumns() : nullptr,
+            use_batches && collection2 ? fPicoEvent->SecondParticleColumns() : nullptr);
 
   if (fVerbose) {
     cout << "AliFemtoSimpleAnalysis::ProcessEvent() - reals done ";
@@ -546,15 +559,21 @@ void AliFemtoSimpleAnalysis::ProcessEvent(const AliFemtoEvent* hbtEvent)
 
     // If identical - only mix the first particle collections
     if (AnalyzeIdenticalParticles()) {
-      MakePairs("mixed", collection1, storedEvent->FirstParticleCollection());
+      MakePairs("mixed", collection1, storedEvent->FirstParticleCollection(), kFALSE,
+                use_batches ? fPicoEvent->FirstParticleColumns() : nullptr,
+                use_batches ? storedEvent->FirstParticleColumns() : nullptr);
 
     // If non-identical - mix both combinations of first and second particles
     } else {
         MakePairs("mixed", collection1,
-                           storedEvent->SecondParticleCollection());
+                           storedEvent->SecondParticleCollection(), kFALSE,
+                  use_batches ? fPicoEvent->FirstParticleColumns() : nullptr,
+                  use_batches ? storedEvent->SecondParticleColumns() : nullptr);
 
         MakePairs("mixed", storedEvent->FirstParticleCollection(),
-                           collection2);
+                           collection2, kFALSE,
+                  use_batches ? storedEvent->FirstParticleColumns() : nullptr,
+                  use_batches ? fPicoEvent->SecondParticleColumns() : nullptr);
     }
   }
 
@@ -579,7 +598,9 @@ void AliFemtoSimpleAnalysis::ProcessEvent(const AliFemtoEvent* hbtEvent)
 void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
                                        AliFemtoParticleCollection *partCollection1,
                                        AliFemtoParticleCollection *partCollection2,
-                                       Bool_t enablePairMonitors)
+                                       Bool_t enablePairMonitors,
+                                       const AliFemtoParticleColumns *columns1,
+                                       const AliFemtoParticleColumns *columns2)
 {
 /// Build pairs, check pair cuts, and call CFs' AddRealPair() or
 /// AddMixedPair() methods. If no second particle collection is
@@ -593,6 +614,13 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
   }
   //  int swpart = ((long int) partCollection1) % 2;
 
+  if (columns1 != nullptr && (partCollection2 == nullptr || columns2 != nullptr)) {
+    MakePairBatches(these_are_real_pairs, columns1,
+                    partCollection2 ? columns2 : nullptr,
+                    enablePairMonitors);
+    return;
+  }
+
   // Used to swap particle 1 & 2 in identical-particle analysis
   // to avoid any implicit ordering in the event collection
   // "Seed" this here.
@@ -680,6 +708,117 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
   delete tPair;
 }
 //_________________________
+void AliFemtoSimpleAnalysis::MakePairBatches(bool these_are_real_pairs,
+                                             const AliFemtoParticleColumns *columns1,
+                                             const AliFemtoParticleColumns *columns2,
+                                             Bool_t enablePairMonitors)
+{
+  // Same seed of the swapping of identical particles as in MakePairs
+  bool swpart = fNeventsProcessed % 2;
+
+  const bool single_collection = (columns2 == nullptr);
+  if (single_collection) {
+    columns2 = columns1;
+  }
+
+  // Split the correlation functions between the ones taking single pairs
+  // and the ones taking blocks of pairs
+  std::vector<AliFemtoCorrFctn*> pair_cfs,
+                                 batch_cfs;
+  for (auto &cf : *fCorrFctnCollection) {
+    if (cf->AcceptsPairBatches()) {
+      batch_cfs.push_back(cf);
+    } else {
+      pair_cfs.push_back(cf);
+    }
+  }
+
+  AliFemtoPairBatch batch;
+  batch.Reset(columns1, columns2);
+
+  auto flush_batch = [&] () {
+    if (batch.Size() == 0) {
+      return;
+    }
+    batch.Compute();
+    for (auto &cf : batch_cfs) {
+      if (these_are_real_pairs)
+        cf->AddRealPairs(batch);
+      else
+        cf->AddMixedPairs(batch);
+    }
+    batch.Clear();
+  };
+
+  // Create the pair outside the loop - only allocate once
+  AliFemtoPair* tPair = new AliFemtoPair;
+
+  const UInt_t n1 = columns1->Size(),
+               n2 = columns2->Size();
+
+  for (UInt_t i = 0; i < n1; i++) {
+
+    if (!single_collection) {
+      tPair->SetTrack1(columns1->Particle(i));
+    }
+
+    for (UInt_t j = single_collection ? i + 1 : 0; j < n2; j++) {
+      UInt_t index1 = i,
+             index2 = j;
+
+      // Swap between first and second particles to avoid biased ordering
+      if (single_collection) {
+        if (swpart) {
+          std::swap(index1, index2);
+        }
+        swpart = !swpart;
+        tPair->SetTrack1(columns1->Particle(index1));
+      }
+      tPair->SetTrack2(columns2->Particle(index2));
+
+      // check if the pair passes the cut
+      bool tmpPassPair = fPairCut->Pass(tPair);
+
+      // This is a condition for speed reasons
+      if (enablePairMonitors) {
+        fPairCut->FillCutMonitor(tPair, tmpPassPair);
+      }
+
+      if (!tmpPassPair) {
+        continue;
+      }
+
+      for (auto &tCorrFctn : pair_cfs) {
+        if (these_are_real_pairs)
+          tCorrFctn->AddRealPair(tPair);
+        else
+          tCorrFctn->AddMixedPair(tPair);
+      }
+
+      if (!batch_cfs.empty() && batch.Add(index1, index2)) {
+        flush_batch();
+      }
+    }
+  }
+
+  flush_batch();
+
+  delete tPair;
+}
+//_________________________
+bool AliFemtoSimpleAnalysis::NeedsPairBatches() const
+{
+  if (!fUsePairBatches) {
+    return false;
+  }
+  for (auto &cf : *fCorrFctnCollection) {
+    if (cf->AcceptsPairBatches()) {
+      return true;
+    }
+  }
+  return false;
+}
+//_________________________
 void AliFemtoSimpleAnalysis::EventBegin(const AliFemtoEvent* ev)
 {
   /// Perform initialization operations at the beginning of the event processing
@@ -18,6 +18,7 @@
 
 class AliFemtoPicoEventCollectionVectorHideAway;
 class AliFemtoPicoEvent;
+class AliFemtoParticleColumns;
 
 ///
 /// \class AliFemtoSimpleAnalysis
@@ -99,6 +100,11 @@ public:
   void SetEnablePairMonitors(Bool_t aEnable);
   Bool_t EnablePairMonitors();
 
+  /// Pass pairs in blocks (AliFemtoPairBatch) to the correlation functions
+  /// accepting them, see AliFemtoCorrFctn::AcceptsPairBatches (default: true)
+  void SetUsePairBatches(Bool_t aUse);
+  Bool_t UsePairBatches() const;
+
   unsigned int NumEventsToMix() const;
   void SetNumEventsToMix(const unsigned int& NumberOfEventsToMix);
   AliFemtoPicoEvent* CurrentPicoEvent();
@@ -154,10 +160,28 @@ protected:
   ///
   /// \param type Either the string "real" or "mixed", specifying which method
   ///             to call (AddRealPair or AddMixedPair)
+  ///
+  /// If the columnar copies of the collections are given, the pairs are
+  /// built with MakePairBatches
   void MakePairs(const char* type,
                  AliFemtoParticleCollection* ParticlesPassingCut1,
                  AliFemtoParticleCollection* ParticlesPssingCut2=NULL,
-                 Bool_t enablePairMonitors=kFALSE);
+                 Bool_t enablePairMonitors=kFALSE,
+                 const AliFemtoParticleColumns* columns1=NULL,
+                 const AliFemtoParticleColumns* columns2=NULL);
+
+  /// Same pairs, in the same order, as MakePairs, looping over the
+  /// particle columns. Pairs passing the pair cut are given one by one
+  /// to the correlation functions which do not accept pair batches, and
+  /// are collected in blocks, with their kinematics computed together,
+  /// for the ones which do. If columns2 is NULL, make pairs within columns1.
+  void MakePairBatches(bool these_are_real_pairs,
+                       const AliFemtoParticleColumns* columns1,
+                       const AliFemtoParticleColumns* columns2,
+                       Bool_t enablePairMonitors);
+
+  /// True if pair batches are enabled and one correlation function accepts them
+  bool NeedsPairBatches() const;
 
   AliFemtoPicoEventCollectionVectorHideAway* fPicoEventCollectionVectorHideAway; //!<! Mixing Buffer used for Analyses which wrap this one
 
@@ -177,6 +201,7 @@ protected:
   Bool_t fVerbose;
   Bool_t fPerformSharedDaughterCut;
   Bool_t fEnablePairMonitors;
+  Bool_t fUsePairBatches;                            ///< give blocks of pairs to the correlation functions accepting them
 
 #ifdef __ROOT__
   /// \cond CLASSIMP
@@ -242,6 +267,11 @@ inline bool AliFemtoSimpleAnalysis::EnablePairMonitors()
   return fEnablePairMonitors;
 }
 
+inline Bool_t AliFemtoSimpleAnalysis::UsePairBatches() const
+{
+  return fUsePairBatches;
+}
+
 // Sets
 inline void AliFemtoSimpleAnalysis::SetPairCut(AliFemtoPairCut* x)
 {
@@ -305,4 +335,9 @@ inline void AliFemtoSimpleAnalysis::SetEnablePairMonitors(Bool_t aEnable)
   fEnablePairMonitors = aEnable;
 }
 
+inline void AliFemtoSimpleAnalysis::SetUsePairBatches(Bool_t aUse)
+{
+  fUsePairBatches = aUse;
+}
+
 #endif
@@ -47,7 +47,8 @@ AliFemtoDreamCollConfig::AliFemtoDreamCollConfig()
       fDeltaEtaMax(0.f),
       fDeltaPhiMax(0.f),
       fDoDeltaEtaDeltaPhiCut(false),
-      fCoutVariables(false) {
+      fCoutVariables(false),
+      fPairingThreads(1) {
   //should not be used, since we need a name to deal with root objects
 }
 
@@ -92,7 +93,8 @@ AliFemtoDreamCollConfig::AliFemtoDreamCollConfig(
       fDeltaEtaMax(config.fDeltaEtaMax),
       fDeltaPhiMax(config.fDeltaPhiMax),
       fDoDeltaEtaDeltaPhiCut(config.fDoDeltaEtaDeltaPhiCut),
-      fCoutVariables(config.fCoutVariables) {
+      fCoutVariables(config.fCoutVariables),
+      fPairingThreads(config.fPairingThreads) {
 }
 
 AliFemtoDreamCollConfig::AliFemtoDreamCollConfig(const char *name,
@@ -137,7 +139,8 @@ AliFemtoDreamCollConfig::AliFemtoDreamCollConfig(const char *name,
       fDeltaEtaMax(0.f),
       fDeltaPhiMax(0.f),
       fDoDeltaEtaDeltaPhiCut(false),
-      fCoutVariables(QACouts) {
+      fCoutVariables(QACouts),
+      fPairingThreads(1) {
 }
 AliFemtoDreamCollConfig& AliFemtoDreamCollConfig::operator=(
     const AliFemtoDreamCollConfig& config) {
@@ -182,6 +185,7 @@ AliFemtoDreamCollConfig& AliFemtoDreamCollConfig::operator=(
     this->fDeltaPhiMax = config.fDeltaPhiMax;
     this->fDoDeltaEtaDeltaPhiCut = config.fDoDeltaEtaDeltaPhiCut;
     this->fCoutVariables = config.fCoutVariables;
+    this->fPairingThreads = config.fPairingThreads;
   }
   return *this;
 }
@@ -278,6 +278,15 @@ class AliFemtoDreamCollConfig : public TNamed {
   bool GetDoDeltaEtaDeltaPhiCut() const {
     return fDoDeltaEtaDeltaPhiCut;
   }
+  //Number of threads sharing the same and mixed event pairing of an event.
+  //Each pair of species is handled by one thread, which fills the
+  //histograms of that pair only, hence the output does not change. 1 = serial.
+  void SetPairingThreads(int nThreads) {
+    fPairingThreads = nThreads;
+  }
+  int GetPairingThreads() const {
+    return fPairingThreads;
+  }
  private:
   bool fMultBinning;            //
   bool fCentBinning;            //
@@ -318,7 +327,8 @@ class AliFemtoDreamCollConfig : public TNamed {
   float fDeltaPhiMax;           //
   bool fDoDeltaEtaDeltaPhiCut;  //
   bool fCoutVariables;
-  ClassDef(AliFemtoDreamCollConfig,17);
+  int fPairingThreads;          //
+  ClassDef(AliFemtoDreamCollConfig,18);
 };
 
 #endif /* ALIFEMTODREAMCOLLCONFIG_H_ */
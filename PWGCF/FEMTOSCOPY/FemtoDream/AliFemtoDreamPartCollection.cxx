@@ -14,7 +14,8 @@ AliFemtoDreamPartCollection::AliFemtoDreamPartCollection()
       fNSpecies(0),
       fZVtxMultBuffer(),
       fValuesZVtxBins(),
-      fValuesMultBins() {
+      fValuesMultBins(),
+      fPairingThreads(1) {
 
 }
 
@@ -24,7 +25,8 @@ AliFemtoDreamPartCollection::AliFemtoDreamPartCollection(
       fNSpecies(coll.fNSpecies),
       fZVtxMultBuffer(coll.fZVtxMultBuffer),
       fValuesZVtxBins(coll.fValuesZVtxBins),
-      fValuesMultBins(coll.fValuesMultBins) {
+      fValuesMultBins(coll.fValuesMultBins),
+      fPairingThreads(coll.fPairingThreads) {
 
 }
 AliFemtoDreamPartCollection::AliFemtoDreamPartCollection(
@@ -36,7 +38,8 @@ AliFemtoDreamPartCollection::AliFemtoDreamPartCollection(
           std::vector<AliFemtoDreamZVtxMultContainer>(
               conf->GetNMultBins(), AliFemtoDreamZVtxMultContainer(conf))),
       fValuesZVtxBins(conf->GetZVtxBins()),
-      fValuesMultBins(conf->GetMultBins()) {
+      fValuesMultBins(conf->GetMultBins()),
+      fPairingThreads(conf->GetPairingThreads()) {
 }
 
 AliFemtoDreamPartCollection& AliFemtoDreamPartCollection::operator=(
@@ -47,6 +50,7 @@ AliFemtoDreamPartCollection& AliFemtoDreamPartCollection::operator=(
     this->fZVtxMultBuffer = coll.fZVtxMultBuffer;
     this->fValuesZVtxBins = coll.fValuesZVtxBins;
     this->fValuesMultBins = coll.fValuesMultBins;
+    this->fPairingThreads = coll.fPairingThreads;
   }
 
   return *this;
@@ -70,8 +74,13 @@ void AliFemtoDreamPartCollection::SetEvent(
     itZVtx += bins[0];
     auto itMult = itZVtx->begin();
     itMult += bins[1];
-    itMult->PairParticlesSE(Particles, fHigherMath, bins[1], cent);
-    itMult->PairParticlesME(Particles, fHigherMath, bins[1], cent);
+    if (fPairingThreads > 1) {
+      itMult->PairParticles(Particles, fHigherMath, bins[1], cent,
+                            fPairingThreads);
+    } else {
+      itMult->PairParticlesSE(Particles, fHigherMath, bins[1], cent);
+      itMult->PairParticlesME(Particles, fHigherMath, bins[1], cent);
+    }
     itMult->SetEvent(Particles);
   }
   return;
@@ -96,8 +105,13 @@ void AliFemtoDreamPartCollection::SetEvent(
     itZVtx += bins[0];
     auto itMult = itZVtx->begin();
     itMult += bins[1];
-    itMult->PairParticlesSE(Particles, fHigherMath, bins[1], cent);
-    itMult->PairParticlesME(Particles, fHigherMath, bins[1], cent);
+    if (fPairingThreads > 1) {
+      itMult->PairParticles(Particles, fHigherMath, bins[1], cent,
+                            fPairingThreads);
+    } else {
+      itMult->PairParticlesSE(Particles, fHigherMath, bins[1], cent);
+      itMult->PairParticlesME(Particles, fHigherMath, bins[1], cent);
+    }
     itMult->SetEvent(Particles);
   }
   return;
@@ -51,7 +51,8 @@ class AliFemtoDreamPartCollection {
   std::vector<std::vector<AliFemtoDreamZVtxMultContainer>> fZVtxMultBuffer;
   std::vector<float> fValuesZVtxBins;
   std::vector<int> fValuesMultBins;
-  ClassDef(AliFemtoDreamPartCollection,2);
+  int fPairingThreads;
+  ClassDef(AliFemtoDreamPartCollection,3);
 };
 
 #endif /* ALIFEMTODREAMPARTCOLLECTION_H_ */
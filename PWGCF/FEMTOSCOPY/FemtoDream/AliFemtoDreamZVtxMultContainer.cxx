@@ -10,6 +10,12 @@
 #include "TLorentzVector.h"
 #include "TDatabasePDG.h"
 #include "TVector2.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+//below this number of pairs per thread an event is paired serially
+static const unsigned long minPairsPerThread = 2000;
 
 ClassImp(AliFemtoDreamPartContainer)
 AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer()
@@ -59,121 +65,219 @@ void AliFemtoDreamZVtxMultContainer::SetEvent(
 void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
+  std::vector<double> Masses = GetPDGMasses();
   int HistCounter = 0;
   //First loop over all the different Species
-  auto itPDGPar1 = fPDGParticleSpecies.begin();
-  for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
-      ++itSpec1) {
-    auto itPDGPar2 = fPDGParticleSpecies.begin();
-    itPDGPar2 += itSpec1 - Particles.begin();
-    for (auto itSpec2 = itSpec1; itSpec2 != Particles.end(); ++itSpec2) {
-      HigherMath->FillPairCounterSE(HistCounter, itSpec1->size(),
-                                    itSpec2->size());
+  for (unsigned int iSpec1 = 0; iSpec1 < Particles.size(); ++iSpec1) {
+    for (unsigned int iSpec2 = iSpec1; iSpec2 < Particles.size(); ++iSpec2) {
+      HigherMath->FillPairCounterSE(HistCounter, Particles[iSpec1].size(),
+                                    Particles[iSpec2].size());
       //Now loop over the actual Particles and correlate them
-      for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
-          ++itPart1) {
-        AliFemtoDreamBasePart part1 = *itPart1;
-        std::vector<AliFemtoDreamBasePart>::iterator itPart2;
-        if (itSpec1 == itSpec2) {
-          itPart2 = itPart1 + 1;
-        } else {
-          itPart2 = itSpec2->begin();
-        }
-        while (itPart2 != itSpec2->end()) {
-          AliFemtoDreamBasePart part2 = *itPart2;
-          TLorentzVector PartOne, PartTwo;
-          PartOne.SetXYZM(
-              itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
-              itPart1->GetMomentum().Z(),
-              TDatabasePDG::Instance()->GetParticle(*itPDGPar1)->Mass());
-          PartTwo.SetXYZM(
-              itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
-              itPart2->GetMomentum().Z(),
-              TDatabasePDG::Instance()->GetParticle(*itPDGPar2)->Mass());
-          float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
-          if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
-                                               RelativeK, true, false)) {
-            ++itPart2;
-            continue;
-          }
-          RelativeK = HigherMath->FillSameEvent(HistCounter, iMult, cent,
-                                                part1,
-                                                *itPDGPar1,
-                                                part2,
-                                                *itPDGPar2);
-          HigherMath->MassQA(HistCounter, RelativeK, *itPart1, *itPart2);
-          HigherMath->SEDetaDPhiPlots(HistCounter, *itPart1, *itPDGPar1,
-                                      *itPart2, *itPDGPar2, RelativeK, false);
-          HigherMath->SEMomentumResolution(HistCounter, &(*itPart1), *itPDGPar1,
-                                           &(*itPart2), *itPDGPar2, RelativeK);
-          ++itPart2;
-        }
-      }
+      PairSpeciesSE(Particles[iSpec1], Particles[iSpec2], iSpec1 == iSpec2,
+                    HistCounter, fPDGParticleSpecies[iSpec1], Masses[iSpec1],
+                    fPDGParticleSpecies[iSpec2], Masses[iSpec2], HigherMath,
+                    iMult, cent);
       ++HistCounter;
-      itPDGPar2++;
     }
-    itPDGPar1++;
   }
 }
 
 void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
+  std::vector<double> Masses = GetPDGMasses();
   int HistCounter = 0;
-  auto itPDGPar1 = fPDGParticleSpecies.begin();
   //First loop over all the different Species
-  for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
-      ++itSpec1) {
+  for (unsigned int iSpec1 = 0; iSpec1 < Particles.size(); ++iSpec1) {
     //We dont want to correlate the particles twice. Mixed Event Dist. of
     //Particle1 + Particle2 == Particle2 + Particle 1
-    int SkipPart = itSpec1 - Particles.begin();
-    auto itPDGPar2 = fPDGParticleSpecies.begin() + SkipPart;
-    for (auto itSpec2 = fPartContainer.begin() + SkipPart;
-        itSpec2 != fPartContainer.end(); ++itSpec2) {
-      if (itSpec1->size() > 0) {
+    for (unsigned int iSpec2 = iSpec1; iSpec2 < fPartContainer.size();
+        ++iSpec2) {
+      AliFemtoDreamPartContainer &container = fPartContainer[iSpec2];
+      if (Particles[iSpec1].size() > 0) {
         HigherMath->FillEffectiveMixingDepth(HistCounter,
-                                             (int) itSpec2->GetMixingDepth());
+                                             (int) container.GetMixingDepth());
       }
-      for (int iDepth = 0; iDepth < (int) itSpec2->GetMixingDepth(); ++iDepth) {
-        std::vector<AliFemtoDreamBasePart> ParticlesOfEvent = itSpec2->GetEvent(
-            iDepth);
-        HigherMath->FillPairCounterME(HistCounter, itSpec1->size(),
+      for (int iDepth = 0; iDepth < (int) container.GetMixingDepth(); ++iDepth) {
+        std::vector<AliFemtoDreamBasePart> &ParticlesOfEvent = container
+            .GetEvent(iDepth);
+        HigherMath->FillPairCounterME(HistCounter, Particles[iSpec1].size(),
                                       ParticlesOfEvent.size());
-        for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
-            ++itPart1) {
-          for (auto itPart2 = ParticlesOfEvent.begin();
-              itPart2 != ParticlesOfEvent.end(); ++itPart2) {
-
-            TLorentzVector PartOne, PartTwo;
-            PartOne.SetXYZM(
-                itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
-                itPart1->GetMomentum().Z(),
-                TDatabasePDG::Instance()->GetParticle(*itPDGPar1)->Mass());
-            PartTwo.SetXYZM(
-                itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
-                itPart2->GetMomentum().Z(),
-                TDatabasePDG::Instance()->GetParticle(*itPDGPar2)->Mass());
-            float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
-            if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
-                                                 RelativeK, false, false)) {
-              continue;
-            }
-            RelativeK = HigherMath->FillMixedEvent(
-                HistCounter, iMult, cent, *itPart1, *itPDGPar1,
-                *itPart2, *itPDGPar2,
-                AliFemtoDreamCollConfig::kNone);
+        PairSpeciesME(Particles[iSpec1], ParticlesOfEvent, HistCounter,
+                      fPDGParticleSpecies[iSpec1], Masses[iSpec1],
+                      fPDGParticleSpecies[iSpec2], Masses[iSpec2], HigherMath,
+                      iMult, cent);
+      }
+      ++HistCounter;
+    }
+  }
+}
 
-            HigherMath->MEDetaDPhiPlots(HistCounter, *itPart1, *itPDGPar1,
-                                        *itPart2, *itPDGPar2, RelativeK, false);
-            HigherMath->MEMomentumResolution(HistCounter, &(*itPart1),
-                                             *itPDGPar1, &(*itPart2),
-                                             *itPDGPar2, RelativeK);
-          }
-        }
+void AliFemtoDreamZVtxMultContainer::PairParticles(
+    std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+    AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent,
+    int nThreads) {
+  //Same and mixed event pairing of one event shared by up to nThreads
+  //threads. The histograms are booked per pair of species, and each pair of
+  //species is paired by one thread from the first to the last particle, so
+  //every histogram is filled with the same values in the same order as in
+  //PairParticlesSE and PairParticlesME. The most expensive pairs of species
+  //are handed out first; small events are paired by the calling thread.
+  struct SpeciesPair {
+    unsigned int iSpec1;
+    unsigned int iSpec2;
+    int HistCounter;
+    unsigned long nPairs;
+  };
+  std::vector<SpeciesPair> SpeciesPairs;
+  unsigned long nPairsTotal = 0;
+  int HistCounter = 0;
+  for (unsigned int iSpec1 = 0; iSpec1 < Particles.size(); ++iSpec1) {
+    for (unsigned int iSpec2 = iSpec1; iSpec2 < Particles.size(); ++iSpec2) {
+      unsigned long nPairs = Particles[iSpec1].size() * Particles[iSpec2].size();
+      AliFemtoDreamPartContainer &container = fPartContainer[iSpec2];
+      for (int iDepth = 0; iDepth < (int) container.GetMixingDepth(); ++iDepth) {
+        nPairs += Particles[iSpec1].size() * container.GetEvent(iDepth).size();
       }
+      SpeciesPairs.push_back( { iSpec1, iSpec2, HistCounter, nPairs });
+      nPairsTotal += nPairs;
       ++HistCounter;
-      ++itPDGPar2;
     }
-    ++itPDGPar1;
+  }
+  if (nThreads > (int) SpeciesPairs.size()) {
+    nThreads = SpeciesPairs.size();
+  }
+  if (nThreads < 2 || nPairsTotal < nThreads * minPairsPerThread) {
+    PairParticlesSE(Particles, HigherMath, iMult, cent);
+    PairParticlesME(Particles, HigherMath, iMult, cent);
+    return;
+  }
+  std::stable_sort(SpeciesPairs.begin(), SpeciesPairs.end(),
+                   [](const SpeciesPair &a, const SpeciesPair &b) {
+                     return a.nPairs > b.nPairs;
+                   });
+  //the PDG database must not be initialised from several threads
+  std::vector<double> Masses = GetPDGMasses();
+  std::atomic<unsigned int> NextPair(0);
+  auto pairSpecies = [&]() {
+    for (unsigned int iPair = NextPair++; iPair < SpeciesPairs.size(); iPair =
+        NextPair++) {
+      const SpeciesPair &pair = SpeciesPairs[iPair];
+      PairSpecies(Particles, pair.iSpec1, pair.iSpec2, pair.HistCounter,
+                  Masses, HigherMath, iMult, cent);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int iThread = 1; iThread < nThreads; ++iThread) {
+    threads.emplace_back(pairSpecies);
+  }
+  pairSpecies();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+std::vector<double> AliFemtoDreamZVtxMultContainer::GetPDGMasses() const {
+  std::vector<double> Masses;
+  for (auto itPDG : fPDGParticleSpecies) {
+    Masses.push_back(TDatabasePDG::Instance()->GetParticle(itPDG)->Mass());
+  }
+  return Masses;
+}
+
+void AliFemtoDreamZVtxMultContainer::PairSpecies(
+    std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+    unsigned int iSpec1, unsigned int iSpec2, int HistCounter,
+    std::vector<double> &Masses, AliFemtoDreamHigherPairMath *HigherMath,
+    int iMult, float cent) {
+  //Same and mixed event pairs of one pair of species, see PairParticlesSE
+  //and PairParticlesME
+  HigherMath->FillPairCounterSE(HistCounter, Particles[iSpec1].size(),
+                                Particles[iSpec2].size());
+  PairSpeciesSE(Particles[iSpec1], Particles[iSpec2], iSpec1 == iSpec2,
+                HistCounter, fPDGParticleSpecies[iSpec1], Masses[iSpec1],
+                fPDGParticleSpecies[iSpec2], Masses[iSpec2], HigherMath, iMult,
+                cent);
+  AliFemtoDreamPartContainer &container = fPartContainer[iSpec2];
+  if (Particles[iSpec1].size() > 0) {
+    HigherMath->FillEffectiveMixingDepth(HistCounter,
+                                         (int) container.GetMixingDepth());
+  }
+  for (int iDepth = 0; iDepth < (int) container.GetMixingDepth(); ++iDepth) {
+    std::vector<AliFemtoDreamBasePart> &ParticlesOfEvent = container.GetEvent(
+        iDepth);
+    HigherMath->FillPairCounterME(HistCounter, Particles[iSpec1].size(),
+                                  ParticlesOfEvent.size());
+    PairSpeciesME(Particles[iSpec1], ParticlesOfEvent, HistCounter,
+                  fPDGParticleSpecies[iSpec1], Masses[iSpec1],
+                  fPDGParticleSpecies[iSpec2], Masses[iSpec2], HigherMath,
+                  iMult, cent);
+  }
+}
+
+void AliFemtoDreamZVtxMultContainer::PairSpeciesSE(
+    std::vector<AliFemtoDreamBasePart> &Part1,
+    std::vector<AliFemtoDreamBasePart> &Part2, bool SameSpecies,
+    int HistCounter, int PDGPart1, double MassPart1, int PDGPart2,
+    double MassPart2, AliFemtoDreamHigherPairMath *HigherMath, int iMult,
+    float cent) {
+  for (auto itPart1 = Part1.begin(); itPart1 != Part1.end(); ++itPart1) {
+    std::vector<AliFemtoDreamBasePart>::iterator itPart2;
+    if (SameSpecies) {
+      itPart2 = itPart1 + 1;
+    } else {
+      itPart2 = Part2.begin();
+    }
+    while (itPart2 != Part2.end()) {
+      TLorentzVector PartOne, PartTwo;
+      PartOne.SetXYZM(itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
+                      itPart1->GetMomentum().Z(), MassPart1);
+      PartTwo.SetXYZM(itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
+                      itPart2->GetMomentum().Z(), MassPart2);
+      float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
+      if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
+                                           RelativeK, true, false)) {
+        ++itPart2;
+        continue;
+      }
+      RelativeK = HigherMath->FillSameEvent(HistCounter, iMult, cent, *itPart1,
+                                            PDGPart1, *itPart2, PDGPart2);
+      HigherMath->MassQA(HistCounter, RelativeK, *itPart1, *itPart2);
+      HigherMath->SEDetaDPhiPlots(HistCounter, *itPart1, PDGPart1, *itPart2,
+                                  PDGPart2, RelativeK, false);
+      HigherMath->SEMomentumResolution(HistCounter, &(*itPart1), PDGPart1,
+                                       &(*itPart2), PDGPart2, RelativeK);
+      ++itPart2;
+    }
+  }
+}
+
+void AliFemtoDreamZVtxMultContainer::PairSpeciesME(
+    std::vector<AliFemtoDreamBasePart> &Part1,
+    std::vector<AliFemtoDreamBasePart> &Part2, int HistCounter, int PDGPart1,
+    double MassPart1, int PDGPart2, double MassPart2,
+    AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
+  for (auto itPart1 = Part1.begin(); itPart1 != Part1.end(); ++itPart1) {
+    for (auto itPart2 = Part2.begin(); itPart2 != Part2.end(); ++itPart2) {
+      TLorentzVector PartOne, PartTwo;
+      PartOne.SetXYZM(itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
+                      itPart1->GetMomentum().Z(), MassPart1);
+      PartTwo.SetXYZM(itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
+                      itPart2->GetMomentum().Z(), MassPart2);
+      float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
+      if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
+                                           RelativeK, false, false)) {
+        continue;
+      }
+      RelativeK = HigherMath->FillMixedEvent(HistCounter, iMult, cent,
+                                             *itPart1, PDGPart1, *itPart2,
+                                             PDGPart2,
+                                             AliFemtoDreamCollConfig::kNone);
+
+      HigherMath->MEDetaDPhiPlots(HistCounter, *itPart1, PDGPart1, *itPart2,
+                                  PDGPart2, RelativeK, false);
+      HigherMath->MEMomentumResolution(HistCounter, &(*itPart1), PDGPart1,
+                                       &(*itPart2), PDGPart2, RelativeK);
+    }
   }
 }
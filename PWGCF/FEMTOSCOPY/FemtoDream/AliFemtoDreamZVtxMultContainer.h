@@ -28,6 +28,9 @@ class AliFemtoDreamZVtxMultContainer {
   void PairParticlesME(
       std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
       AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent);
+  void PairParticles(std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+                     AliFemtoDreamHigherPairMath *HigherMath, int iMult,
+                     float cent, int nThreads);
   void DeltaEtaDeltaPhi(int Hist, AliFemtoDreamBasePart &part1,
                         AliFemtoDreamBasePart &part2, bool SEorME,
                         AliFemtoDreamCorrHists *ResultsHist, float relk);
@@ -41,6 +44,24 @@ class AliFemtoDreamZVtxMultContainer {
   }
   ;
  private:
+  std::vector<double> GetPDGMasses() const;
+  void PairSpecies(std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
+                   unsigned int iSpec1, unsigned int iSpec2, int HistCounter,
+                   std::vector<double> &Masses,
+                   AliFemtoDreamHigherPairMath *HigherMath, int iMult,
+                   float cent);
+  void PairSpeciesSE(std::vector<AliFemtoDreamBasePart> &Part1,
+                     std::vector<AliFemtoDreamBasePart> &Part2, bool SameSpecies,
+                     int HistCounter, int PDGPart1, double MassPart1,
+                     int PDGPart2, double MassPart2,
+                     AliFemtoDreamHigherPairMath *HigherMath, int iMult,
+                     float cent);
+  void PairSpeciesME(std::vector<AliFemtoDreamBasePart> &Part1,
+                     std::vector<AliFemtoDreamBasePart> &Part2,
+                     int HistCounter, int PDGPart1, double MassPart1,
+                     int PDGPart2, double MassPart2,
+                     AliFemtoDreamHigherPairMath *HigherMath, int iMult,
+                     float cent);
   std::vector<AliFemtoDreamPartContainer> fPartContainer;
   std::vector<int> fPDGParticleSpecies;
   std::vector<unsigned int> fWhichPairs;
@@ -620,11 +620,16 @@ Bool_t AliAnalysisTaskGFWFlow::FillFCs(AliGFW::CorrConfig corconf, Double_t cent
   if(DisableOverlap)
     binDisableOLFrom = fPtAxis->FindBin(fRFpTMax); //To stay in the right bin*/
   Bool_t NeedToDisable=kFALSE;
+  //All pT bins are calculated at once, the common terms only once per event
+  vector<std::complex<Double_t> > dnxVals, vals;
+  Int_t nPtVals = fGFW->CalculatePtDif(corconf,dnxVals,kTRUE,NeedToDisable);
+  fGFW->CalculatePtDif(corconf,vals,kFALSE,NeedToDisable);
   for(Int_t i=1;i<=fPtAxis->GetNbins();i++) {
     //if(DisableOverlap) NeedToDisable=(i>=binDisableOLFrom);
-    dnx = fGFW->Calculate(corconf,i-1,kTRUE,NeedToDisable).Re();
+    if(i>nPtVals) break;
+    dnx = dnxVals[i-1].real();
     if(dnx==0) continue;
-    val = fGFW->Calculate(corconf,i-1,kFALSE,NeedToDisable).Re()/dnx;
+    val = vals[i-1].real()/dnx;
     if(TMath::Abs(val)<1)
       fFC->FillProfile(Form("%s_pt_%i",corconf.Head.Data(),i),cent,val,dnx,rndmn);
   };
@@ -3,7 +3,17 @@
 need to add flags to have control over what is added, e.g. what happens, when I have several overlapping regions of different types: reference, pT-diff unID and pT-diff. ID?
 */
 AliGFW::AliGFW():
-  fInitialized(kFALSE)
+  fInitialized(kFALSE),
+  fNodes(),
+  fNodeIndex(),
+  fPlans(),
+  fStringPlans(),
+  fNodeValues(),
+  fNodeOffset(),
+  fNodeStamp(),
+  fEventStamp(0),
+  fValuesValid(kFALSE),
+  fNPtMax(1)
 {
 };
 
@@ -74,13 +84,13 @@ Int_t AliGFW::CreateRegions() {
   //for(auto pitr = fRegions.begin(); pitr!=fRegions.end(); pitr++) pitr->PrintStructure();
   Int_t nRegions=0;
   for(auto pItr=fRegions.begin(); pItr!=fRegions.end(); pItr++) {
-    AliGFWCumulant *lCumulant = new AliGFWCumulant();
+    fCumulants.push_back(AliGFWCumulant());
+    AliGFWCumulant *lCumulant = &fCumulants.back();
     if(pItr->NparVec.size()) {
       lCumulant->CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
     } else {
       lCumulant->CreateComplexVectorArray(pItr->Nhar, pItr->Npar, pItr->NpT);
     };
-    fCumulants.push_back(*lCumulant);
     ++nRegions;
   };
   if(nRegions) fInitialized=kTRUE;
@@ -89,6 +99,7 @@ Int_t AliGFW::CreateRegions() {
 void AliGFW::Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t mask) {
   if(!fInitialized) CreateRegions();
   if(!fInitialized) return;
+  fValuesValid=kFALSE;
   for(Int_t i=0;i<(Int_t)fRegions.size();++i) {
     if(fRegions.at(i).EtaMin<eta && fRegions.at(i).EtaMax>eta && (fRegions.at(i).BitMask&mask))
       fCumulants.at(i).FillArray(eta,ptin,phi,weight);
@@ -128,6 +139,7 @@ void AliGFW::Clear() {
   for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs();
   fCalculatedNames.clear();
   fCalculatedQs.clear();
+  fValuesValid=kFALSE;
 };
 TComplex AliGFW::Calculate(TString config, Bool_t SetHarmsToZero) {
   if(config.EqualTo("")) {
@@ -136,30 +148,32 @@ TComplex AliGFW::Calculate(TString config, Bool_t SetHarmsToZero) {
   };
   TString tmp;
   Ssiz_t sz1=0;
-  TComplex ret(1,0);
+  std::complex<Double_t> ret(1,0);
   while(config.Tokenize(tmp,sz1,"}")) {
     if(SetHarmsToZero) SetHarmonicsToZero(tmp);
-    /*Int_t ind=FindCalculated(tmp);
-    if(ind>=0) {
-      ret*=fCalculatedQs.at(ind);
-      continue;
-    };*/
-    TComplex val=CalculateSingle(tmp);
-    ret*=val;
-    fCalculatedQs.push_back(val);
-    fCalculatedNames.push_back(tmp);
+    //Each string is parsed and compiled only once:
+    auto lPlan = fStringPlans.find(tmp);
+    if(lPlan==fStringPlans.end()) {
+      Int_t poi, ref, ptbin;
+      vector<Int_t> hars;
+      Int_t node = -1;
+      if(ParseSingle(tmp,poi,ref,hars,ptbin)) node = CompileCorr(poi,ref,poi,hars);
+      lPlan = fStringPlans.insert(std::make_pair(tmp,std::make_pair(node,ptbin))).first;
+    };
+    if(lPlan->second.first<0) return TComplex(0,0);
+    ret*=EvaluateNode(lPlan->second.first,lPlan->second.second);
   };
-  return ret;
+  return TComplex(ret.real(),ret.imag());
 };
-TComplex AliGFW::CalculateSingle(TString config) {
+Bool_t AliGFW::ParseSingle(TString config, Int_t &poi, Int_t &ref, vector<Int_t> &hars, Int_t &ptbin) {
   //First remove all ; and ,:
   config.ReplaceAll(","," ");
   config.ReplaceAll(";"," ");
   //Then make sure we don't have any double-spaces:
   while(config.Index("  ")>-1) config.ReplaceAll("  "," ");
   vector<Int_t> regs;
-  vector<Int_t> hars;
-  Int_t ptbin=0;
+  hars.clear();
+  ptbin=0;
   Ssiz_t sz1=0;
   Ssiz_t szend=0;
   TString ts, ts2;
@@ -172,7 +186,7 @@ TComplex AliGFW::CalculateSingle(TString config) {
   if(sz1<0) sz1=0;
   if(!config.Tokenize(ts,szend,"{")) {
     printf("Could not find harmonics!\n");
-    return TComplex(0,0);
+    return kFALSE;
   };
   //Fetch regions
   while(ts.Tokenize(ts2,sz1," ")) {
@@ -185,10 +199,16 @@ TComplex AliGFW::CalculateSingle(TString config) {
     };
     regs.push_back(ind);
   };
+  if(regs.size()==0) return kFALSE;
   //Fetch harmonics
   while(config.Tokenize(ts,szend," ")) hars.push_back(ts.Atoi());
-  if(regs.size()==1) return Calculate(regs.at(0),hars);
-  return Calculate(regs.at(0),regs.at(1),hars,ptbin);
+  if(hars.size()==0) return kFALSE;
+  poi = regs.at(0);
+  if(regs.size()==1) { //Integrated case, same as Calculate(poi,hars)
+    ref = poi;
+    ptbin = 0;
+  } else ref = regs.at(1);
+  return kTRUE;
 };
 AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Bool_t ptdif) {
   //First remove all ; and ,:
@@ -245,6 +265,7 @@ AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Boo
   };
   ReturnConfig.Head = head;
   ReturnConfig.pTDif = ptdif;
+  ReturnConfig.Index = CompilePlan(ReturnConfig);
   return ReturnConfig;
 };
 
@@ -256,6 +277,14 @@ TComplex AliGFW::Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin
 };
 TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
   if(corconf.Regs.size()==0) return TComplex(0,0);
+  if(corconf.Index>=0 && corconf.Index<(Int_t)fPlans.size()) {
+    const CorrPlan &plan = fPlans.at(corconf.Index);
+    if(!fCumulants.at(plan.Poi).IsPtBinFilled(ptbin)) return TComplex(0,0);
+    std::complex<Double_t> retval = EvaluateNode(plan.Root[SetHarmsToZero?1:0][DisableOverlap?1:0],ptbin);
+    if(plan.Root2[SetHarmsToZero?1:0]>=0) retval*=EvaluateNode(plan.Root2[SetHarmsToZero?1:0],0);
+    return TComplex(retval.real(),retval.imag());
+  };
+  //Not compiled, recursion evaluated on the fly:
   Int_t poi = corconf.Regs.at(0);
   Int_t ref = (corconf.Regs.size()>1)?corconf.Regs.at(1):corconf.Regs.at(0);
   AliGFWCumulant *qref = &fCumulants.at(ref);
@@ -276,6 +305,163 @@ TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZer
   return retval;
 };
 
+Int_t AliGFW::CalculatePtDif(const CorrConfig &corconf, vector<std::complex<Double_t> > &values, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
+  values.clear();
+  if(corconf.Regs.size()==0) return 0;
+  Int_t nPt = fRegions.at(corconf.Regs.at(0)).NpT;
+  values.assign(nPt,std::complex<Double_t>(0.,0.));
+  if(corconf.Index<0 || corconf.Index>=(Int_t)fPlans.size()) { //Not compiled, one pT bin at a time
+    for(Int_t pt=0;pt<nPt;pt++) {
+      TComplex val = Calculate(corconf,pt,SetHarmsToZero,DisableOverlap);
+      values[pt] = std::complex<Double_t>(val.Re(),val.Im());
+    };
+    return nPt;
+  };
+  const CorrPlan &plan = fPlans.at(corconf.Index);
+  Int_t root = plan.Root[SetHarmsToZero?1:0][DisableOverlap?1:0];
+  Int_t root2 = plan.Root2[SetHarmsToZero?1:0];
+  if(root<0) return nPt;
+  const std::complex<Double_t> *val = EvaluateNode(root);
+  Int_t step = fNodes[root].PtDif?1:0;
+  std::complex<Double_t> val2 = (root2>=0)?EvaluateNode(root2,0):std::complex<Double_t>(1.,0.);
+  AliGFWCumulant *qpoi = &fCumulants.at(plan.Poi);
+  for(Int_t pt=0;pt<nPt;pt++) {
+    if(!qpoi->IsPtBinFilled(pt)) continue;
+    values[pt] = val[pt*step];
+    if(root2>=0) values[pt]*=val2;
+  };
+  return nPt;
+};
+Int_t AliGFW::AddNode(const CorrNode &node, const vector<Int_t> &key) {
+  fNodes.push_back(node);
+  fNodeIndex[key] = (Int_t)fNodes.size()-1;
+  return (Int_t)fNodes.size()-1;
+};
+Int_t AliGFW::CompileLeaf(Int_t reg, Int_t har, Int_t pow, Bool_t usePtBin) {
+  usePtBin = usePtBin && fRegions.at(reg).NpT>1; //with one pT bin, the Q-vector is always taken from bin 0
+  vector<Int_t> key = {-1, reg, har, pow, usePtBin?1:0};
+  auto lFound = fNodeIndex.find(key);
+  if(lFound!=fNodeIndex.end()) return lFound->second;
+  CorrNode node;
+  node.Reg = reg;
+  node.Har = har;
+  node.Pow = pow;
+  node.UsePtBin = usePtBin;
+  node.PtDif = usePtBin;
+  return AddNode(node,key);
+};
+Int_t AliGFW::CompileCorr(Int_t poi, Int_t ref, Int_t ol, vector<Int_t> hars, vector<Int_t> pows) {
+  //Same terms as RecursiveCorr; ol<0 means no overlap. Terms already compiled (by any correlator) are reused
+  if(hars.size()==0) {
+    printf("AliGFW::CompileCorr: no harmonics given!\n");
+    return -1;
+  };
+  if(pows.size()==0) //if powers are not initialized, initialize them to 1
+    for(Int_t i=0; i<(Int_t)hars.size(); i++)
+      pows.push_back(1);
+  if(hars.size()<2) return CompileLeaf(poi,hars.at(0),pows.at(0),kTRUE);
+  vector<Int_t> key = {-2, poi, ref, ol};
+  key.insert(key.end(),hars.begin(),hars.end());
+  key.insert(key.end(),pows.begin(),pows.end());
+  auto lFound = fNodeIndex.find(key);
+  if(lFound!=fNodeIndex.end()) return lFound->second;
+  CorrNode node;
+  if(hars.size()<3) { //TwoRec
+    node.Left = CompileLeaf(poi,hars.at(0),pows.at(0),kTRUE);
+    node.Right = CompileLeaf(ref,hars.at(1),pows.at(1),kTRUE);
+    if(ol>=0) node.Sub.push_back(CompileLeaf(ol,hars.at(0)+hars.at(1),pows.at(0)+pows.at(1),kTRUE));
+  } else {
+    Int_t harlast=hars.at(hars.size()-1);
+    Int_t powlast=pows.at(pows.size()-1);
+    hars.erase(hars.end()-1);
+    pows.erase(pows.end()-1);
+    node.Left = CompileCorr(poi,ref,ol,hars,pows);
+    node.Right = CompileLeaf(ref,harlast,powlast,kFALSE);
+    for(Int_t i=0;i<(Int_t)hars.size();i++) {
+      vector<Int_t> lhars = hars;
+      vector<Int_t> lpows = pows;
+      lhars.at(i)+=harlast;
+      lpows.at(i)+=powlast;
+      node.Sub.push_back(CompileCorr(poi,ref,ol,lhars,lpows));
+    };
+  };
+  node.PtDif = fNodes.at(node.Left).PtDif || fNodes.at(node.Right).PtDif;
+  for(Int_t i=0;i<(Int_t)node.Sub.size();i++) node.PtDif = node.PtDif || fNodes.at(node.Sub.at(i)).PtDif;
+  return AddNode(node,key);
+};
+Int_t AliGFW::CompilePlan(const CorrConfig &corconf) {
+  if(corconf.Regs.size()==0) return -1;
+  CorrPlan plan;
+  plan.Poi = corconf.Regs.at(0);
+  Int_t ref = (corconf.Regs.size()>1)?corconf.Regs.at(1):corconf.Regs.at(0);
+  vector<Int_t> zeros(corconf.Hars.size(),0);
+  for(Int_t z=0;z<2;z++)
+    for(Int_t d=0;d<2;d++)
+      plan.Root[z][d] = CompileCorr(plan.Poi, ref, d?-1:plan.Poi, z?zeros:corconf.Hars);
+  if(corconf.Regs2.size()) {
+    Int_t poi2 = corconf.Regs2.at(0);
+    Int_t ref2 = (corconf.Regs2.size()>1)?corconf.Regs2.at(1):corconf.Regs2.at(0);
+    vector<Int_t> zeros2(corconf.Hars2.size(),0);
+    for(Int_t z=0;z<2;z++)
+      plan.Root2[z] = CompileCorr(poi2, ref2, poi2, z?zeros2:corconf.Hars2);
+  };
+  //Same correlator requested again: reuse the plan
+  for(Int_t i=0;i<(Int_t)fPlans.size();i++) {
+    const CorrPlan &lPlan = fPlans.at(i);
+    if(lPlan.Poi==plan.Poi && lPlan.Root2[0]==plan.Root2[0] && lPlan.Root2[1]==plan.Root2[1]
+       && lPlan.Root[0][0]==plan.Root[0][0] && lPlan.Root[0][1]==plan.Root[0][1]
+       && lPlan.Root[1][0]==plan.Root[1][0] && lPlan.Root[1][1]==plan.Root[1][1]) return i;
+  };
+  fPlans.push_back(plan);
+  return (Int_t)fPlans.size()-1;
+};
+void AliGFW::PrepareNodeValues() {
+  //(Re)allocate the cache of node values after new nodes have been compiled
+  fNPtMax=1;
+  for(Int_t i=0;i<(Int_t)fRegions.size();i++) if(fRegions.at(i).NpT>fNPtMax) fNPtMax=fRegions.at(i).NpT;
+  fNodeOffset.resize(fNodes.size());
+  Int_t offset=0;
+  for(Int_t i=0;i<(Int_t)fNodes.size();i++) {
+    fNodeOffset[i] = offset;
+    offset += fNodes[i].PtDif?fNPtMax:1;
+  };
+  fNodeValues.assign(offset,std::complex<Double_t>(0.,0.));
+  fNodeStamp.assign(fNodes.size(),0);
+  fValuesValid=kFALSE;
+};
+const std::complex<Double_t> *AliGFW::EvaluateNode(Int_t ind) {
+  //Values of the node for all pT bins (one value if the node does not depend on pT), computed once per event
+  if(fNodeStamp.size()!=fNodes.size()) PrepareNodeValues();
+  if(!fValuesValid) {
+    if(++fEventStamp==0) { //wrapped around, forget all stamps
+      std::fill(fNodeStamp.begin(),fNodeStamp.end(),0);
+      fEventStamp=1;
+    };
+    fValuesValid=kTRUE;
+  };
+  std::complex<Double_t> *val = &fNodeValues[fNodeOffset[ind]];
+  if(fNodeStamp[ind]==fEventStamp) return val;
+  const CorrNode &node = fNodes[ind];
+  Int_t nPt = node.PtDif?fNPtMax:1;
+  if(node.Reg>=0) {
+    const AliGFWCumulant &lCumulant = fCumulants.at(node.Reg);
+    for(Int_t pt=0;pt<nPt;pt++) val[pt] = lCumulant.Q(node.Har,node.Pow,node.UsePtBin?pt:0);
+  } else {
+    const std::complex<Double_t> *lLeft = EvaluateNode(node.Left);
+    const std::complex<Double_t> *lRight = EvaluateNode(node.Right);
+    Int_t lStep = fNodes[node.Left].PtDif?1:0;
+    Int_t rStep = fNodes[node.Right].PtDif?1:0;
+    for(Int_t pt=0;pt<nPt;pt++) val[pt] = lLeft[pt*lStep]*lRight[pt*rStep];
+    for(Int_t i=0;i<(Int_t)node.Sub.size();i++) {
+      const std::complex<Double_t> *lSub = EvaluateNode(node.Sub[i]);
+      Int_t sStep = fNodes[node.Sub[i]].PtDif?1:0;
+      for(Int_t pt=0;pt<nPt;pt++) val[pt] -= lSub[pt*sStep];
+    };
+  };
+  fNodeStamp[ind]=fEventStamp;
+  return val;
+};
+
 TComplex AliGFW::Calculate(Int_t poi, vector<Int_t> hars) {
   AliGFWCumulant *qpoi = &fCumulants.at(poi);
   return RecursiveCorr(qpoi, qpoi, qpoi, 0, hars);
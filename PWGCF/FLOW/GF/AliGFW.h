@@ -4,6 +4,8 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <complex>
+#include <map>
 #include "TString.h"
 #include "TObjArray.h"
 using std::vector;
@@ -40,6 +42,21 @@ class AliGFW {
     vector<Int_t> Hars2 {};
     Bool_t pTDif=kFALSE;
     TString Head="";
+    Int_t Index=-1; //Index of the compiled plan (set by GetCorrelatorConfig, -1 = not compiled)
+  };
+  //One term of the recursion: either a Q-vector (Reg>=0) or Left*Right-sum(Sub)
+  struct CorrNode {
+    Int_t Reg=-1, Har=0, Pow=0;
+    Bool_t UsePtBin=kFALSE; //Q-vector taken in the requested pT bin (otherwise in bin 0)
+    Int_t Left=-1, Right=-1;
+    vector<Int_t> Sub {};
+    Bool_t PtDif=kFALSE; //value depends on the pT bin
+  };
+  //Compiled correlator: roots of [SetHarmsToZero][DisableOverlap] for the 1st part and [SetHarmsToZero] for the 2nd part
+  struct CorrPlan {
+    Int_t Poi=-1;
+    Int_t Root[2][2] = {{-1,-1},{-1,-1}};
+    Int_t Root2[2] = {-1,-1};
   };
   AliGFW();
   ~AliGFW();
@@ -55,12 +72,33 @@ class AliGFW {
   TComplex Calculate(TString config, Bool_t SetHarmsToZero=kFALSE);
   CorrConfig GetCorrelatorConfig(TString config, TString head = "", Bool_t ptdif=kFALSE);
   TComplex Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
+  //All pT bins of the POI region in one pass; returns number of pT bins
+  Int_t CalculatePtDif(const CorrConfig &corconf, vector<std::complex<Double_t> > &values, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
  private:
   Bool_t fInitialized;
   void SplitRegions();
   AliGFWCumulant fEmptyCumulant;
   TComplex TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant*, AliGFWCumulant*, AliGFWCumulant*);
   TComplex RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> hars, vector<Int_t> pows={}); //POI, Ref. flow, overlapping region
+  //Compiled correlators. Same recursion as RecursiveCorr, but each term is a node built once and shared
+  //between all the correlators; node values are cached for the current event, for all pT bins at once
+  vector<CorrNode> fNodes; //! terms of all compiled correlators
+  std::map<vector<Int_t>, Int_t> fNodeIndex; //! (regions, harmonics, powers) -> node
+  vector<CorrPlan> fPlans; //! compiled CorrConfigs
+  std::map<TString, std::pair<Int_t,Int_t> > fStringPlans; //! single correlator string -> (node, pT bin)
+  vector<std::complex<Double_t> > fNodeValues; //! values of the nodes, fNPtMax entries for pT-dependent nodes
+  vector<Int_t> fNodeOffset; //! offset of each node in fNodeValues
+  vector<UInt_t> fNodeStamp; //! event stamp of the cached value of each node
+  UInt_t fEventStamp; //! current event stamp
+  Bool_t fValuesValid; //! no Fill or Clear since the last evaluation
+  Int_t fNPtMax; //! max. number of pT bins of the regions
+  Int_t CompileLeaf(Int_t reg, Int_t har, Int_t pow, Bool_t usePtBin);
+  Int_t CompileCorr(Int_t poi, Int_t ref, Int_t ol, vector<Int_t> hars, vector<Int_t> pows={});
+  Int_t AddNode(const CorrNode &node, const vector<Int_t> &key);
+  Int_t CompilePlan(const CorrConfig &corconf);
+  void PrepareNodeValues();
+  const std::complex<Double_t> *EvaluateNode(Int_t ind);
+  std::complex<Double_t> EvaluateNode(Int_t ind, Int_t ptbin) { if(ind<0) return 0; const std::complex<Double_t> *val = EvaluateNode(ind); return fNodes[ind].PtDif?val[(ptbin<0||ptbin>=fNPtMax)?0:ptbin]:val[0]; };
   //Deprecated and not used (for now):
   void AddRegion(Region inreg) { fRegions.push_back(inreg); };
   Region GetRegion(Int_t index) { return fRegions.at(index); };
@@ -72,7 +110,7 @@ class AliGFW {
   TComplex Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin=0); //For differential, need POI and reference
   TComplex Calculate(Int_t poi, vector<Int_t> hars); //For integrated case
   //Process one string (= one region)
-  TComplex CalculateSingle(TString config);
+  Bool_t ParseSingle(TString config, Int_t &poi, Int_t &ref, vector<Int_t> &hars, Int_t &ptbin);
 
   Bool_t SetHarmonicsToZero(TString &instr);
 
@@ -1,13 +1,16 @@
 #include "AliGFWCumulant.h"
+#include <algorithm>
 
 AliGFWCumulant::AliGFWCumulant():
-  fQvector(0),
+  fQvector(),
+  fPowOffset(),
+  fPtStride(0),
   fUsed(kBlank),
   fNEntries(-1),
   fN(1),
   fPow(1),
   fPt(1),
-  fFilledPts(0),
+  fFilledPts(),
   fInitialized(kFALSE)
 {
 };
@@ -23,42 +26,31 @@ void AliGFWCumulant::FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t
   if(fPt==1) ptin=0; //If one bin, then just fill it straight; otherwise, if ptin is out-of-range, do not fill
   else if(ptin<0 || ptin>=fPt) return;
   fFilledPts[ptin] = kTRUE;
+  std::complex<Double_t> *lQ = &fQvector[ptin*fPtStride];
   for(Int_t lN = 0; lN<fN; lN++) {
     Double_t lSin = TMath::Sin(lN*phi); //No need to recalculate for each power
     Double_t lCos = TMath::Cos(lN*phi); //No need to recalculate for each power
-    for(Int_t lPow=0; lPow<PW(lN); lPow++) {
-      Double_t lPrefactor = TMath::Power(weight, lPow); //Dont calculate it twice; multiplication is cheaper that power
-      Double_t qsin = lPrefactor * lSin;
-      Double_t qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow](fQvector[ptin][lN][lPow].Re()+qcos,fQvector[ptin][lN][lPow].Im()+qsin);//+=TComplex(qcos,qsin);
+    Double_t lPrefactor = 1.; //weight^lPow, built up with multiplications instead of TMath::Power
+    std::complex<Double_t> *lQn = lQ+fPowOffset[lN];
+    for(Int_t lPow=0; lPow<fPowVec[lN]; lPow++) {
+      lQn[lPow] += std::complex<Double_t>(lPrefactor*lCos, lPrefactor*lSin);
+      lPrefactor *= weight;
     };
   };
   Inc();
 };
 void AliGFWCumulant::ResetQs() {
   if(!fNEntries) return; //If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
-  for(Int_t i=0; i<fPt; i++) {
-    fFilledPts[i] = kFALSE;
-    for(Int_t lN=0;lN<fN;lN++) {
-      for(Int_t lPow=0;lPow<PW(lN);lPow++) {
-  	       fQvector[i][lN][lPow](0.,0.);
-      };
-    };
-  };
+  std::fill(fQvector.begin(),fQvector.end(),std::complex<Double_t>(0.,0.));
+  std::fill(fFilledPts.begin(),fFilledPts.end(),kFALSE);
   fNEntries=0;
 };
 void AliGFWCumulant::DestroyComplexVectorArray() {
   if(!fInitialized) return;
-  for(Int_t l_n = 0; l_n<fN; l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      delete [] fQvector[i][l_n];
-    };
-  };
-  for(Int_t i=0;i<fPt;i++) {
-    delete [] fQvector[i];
-  };
-  delete [] fQvector;
-  delete [] fFilledPts;
+  fQvector.clear();
+  fPowOffset.clear();
+  fFilledPts.clear();
+  fPtStride=0;
   fInitialized=kFALSE;
   fNEntries=-1;
 };
@@ -74,23 +66,21 @@ void AliGFWCumulant::CreateComplexVectorArrayVarPower(Int_t N, vector<Int_t> Pow
   fN=N;
   fPow=0;
   fPt=Pt;
-  fFilledPts = new Bool_t[Pt];
   fPowVec = PowVec;
-  fQvector = new TComplex**[fPt];
-  for(Int_t i=0;i<fPt;i++) {
-    fQvector[i] = new TComplex*[fN];
-  };
+  //All Q-vectors of one pT bin are contiguous, pT bins follow each other
+  fPowOffset.assign(fN,0);
+  fPtStride=0;
   for(Int_t l_n=0;l_n<fN;l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      fQvector[i][l_n] = new TComplex[PW(l_n)];
-    };
+    fPowOffset[l_n] = fPtStride;
+    fPtStride += PW(l_n);
   };
+  fQvector.assign(fPt*fPtStride,std::complex<Double_t>(0.,0.));
+  fFilledPts.assign(fPt,kFALSE);
+  fNEntries=-1;
   ResetQs();
   fInitialized=kTRUE;
 };
 TComplex AliGFWCumulant::Vec(Int_t n, Int_t p, Int_t ptbin) {
-  if(!fInitialized) return 0;
-  if(ptbin>=fPt || ptbin<0) ptbin=0;
-  if(n>=0) return fQvector[ptbin][n][p];
-  return TComplex::Conjugate(fQvector[ptbin][-n][p]);
+  std::complex<Double_t> lQ = Q(n,p,ptbin);
+  return TComplex(lQ.real(),lQ.imag());
 };
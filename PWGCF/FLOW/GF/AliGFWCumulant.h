@@ -4,6 +4,8 @@
 #include "TNamed.h"
 #include "TMath.h"
 #include "TAxis.h"
+#include <vector>
+#include <complex>
 using std::vector;
 class AliGFWCumulant {
  public:
@@ -16,22 +18,30 @@ class AliGFWCumulant {
   void Inc() { fNEntries++; };
   Int_t GetN() { return fNEntries; };
   // protected:
-  TComplex ***fQvector;
+  vector<std::complex<Double_t> > fQvector; //! Q-vectors of all pT bins in one block, [pT bin][harmonic][power]
+  vector<Int_t> fPowOffset; //! Offset of each harmonic within one pT bin
+  Int_t fPtStride; //! Number of Q-vectors per pT bin
   UInt_t fUsed;
   Int_t fNEntries;
   //Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
   TComplex Vec(Int_t, Int_t, Int_t ptbin=0); //envelope class to summarize pt-dif. Q-vec getter
+  std::complex<Double_t> Q(Int_t n, Int_t p, Int_t ptbin=0) const { //same as Vec, without conversion to TComplex
+    if(!fInitialized) return 0;
+    if(ptbin>=fPt || ptbin<0) ptbin=0;
+    if(n>=0) return fQvector[ptbin*fPtStride+fPowOffset[n]+p];
+    return std::conj(fQvector[ptbin*fPtStride+fPowOffset[-n]+p]);
+  };
   Int_t fN; //! Harmonics
   Int_t fPow; //! Power
   vector<Int_t> fPowVec; //! Powers array
   Int_t fPt; //!fPt bins
-  Bool_t *fFilledPts;
+  vector<Bool_t> fFilledPts; //! pT bins filled in this event
   Bool_t fInitialized; //Arrays are initialized
   void CreateComplexVectorArray(Int_t N=1, Int_t P=1, Int_t Pt=1);
   void CreateComplexVectorArrayVarPower(Int_t N=1, vector<Int_t> Pvec={1}, Int_t Pt=1);
   Int_t PW(Int_t ind) { return fPowVec.at(ind); }; //No checks to speed up, be carefull!!!
   void DestroyComplexVectorArray();
-  Bool_t IsPtBinFilled(Int_t ptb) { if(!fFilledPts) return kFALSE; return fFilledPts[ptb]; };
+  Bool_t IsPtBinFilled(Int_t ptb) { if(ptb<0 || ptb>=(Int_t)fFilledPts.size()) return kFALSE; return fFilledPts[ptb]; };
 };
 
 #endif
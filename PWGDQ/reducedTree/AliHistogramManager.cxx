@@ -49,7 +49,9 @@ AliHistogramManager::AliHistogramManager() :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(0)
+  fNVars(0),
+  fFillPlans(),
+  fHistClassHandles()
 {
   //
   // Constructor
@@ -71,7 +73,9 @@ AliHistogramManager::AliHistogramManager(const Char_t* name, Int_t nvars) :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(nvars)
+  fNVars(nvars),
+  fFillPlans(),
+  fHistClassHandles()
 {
   //
   // Constructor
@@ -154,6 +158,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  InvalidateFillPlans();
   TString hname = name;
   
   Int_t dimension = 1;
@@ -296,6 +301,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  InvalidateFillPlans();
   TString hname = name;
   
   Int_t dimension = 1;
@@ -441,6 +447,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  InvalidateFillPlans();
   TString hname = name;
   
   TString titleStr(title);
@@ -494,6 +501,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  InvalidateFillPlans();
   TString hname = name;
   
   TString titleStr(title);
@@ -624,150 +632,161 @@ void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values
   //
   //  fill a class of histograms
   //
-  THashList* hList = (THashList*)fMainList.FindObject(className);
-  if(!hList) {
+  Int_t handle = GetHistClassHandle(className);
+  if(handle<0) {
     /*cout << "Warning in AliHistogramManager::FillHistClass(): Histogram list " << className << " not found!" << endl;
     cout << "         Histogram list not filled" << endl; */
     return;
   }
-  if(!hList) {
-    return;
+  FillHistClass(handle, values);
+}
+
+//__________________________________________________________________
+Int_t AliHistogramManager::GetHistClassHandle(const Char_t* className) {
+  //
+  //  get the handle of a histogram class, to be used with FillHistClass(Int_t, Float_t*)
+  //
+  TObject* hList = fMainList.FindObject(className);
+  if(!hList) return -1;
+  std::map<const TObject*, Int_t>::const_iterator it = fHistClassHandles.find(hList);
+  if(it!=fHistClassHandles.end()) return it->second;
+  Int_t handle = fMainList.IndexOf(hList);
+  fHistClassHandles[hList] = handle;
+  return handle;
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(Int_t handle, Float_t* values) {
+  //
+  //  fill a class of histograms using its fill plan
+  //
+  if(handle<0 || handle>=fMainList.GetEntries()) return;
+  if(handle>=(Int_t)fFillPlans.size() || !fFillPlans[handle].fBuilt) BuildFillPlan(handle);
+  
+  const std::vector<FillPlanEntry>& plan = fFillPlans[handle].fEntries;
+  Double_t fillValues[kMaxFillDimensions]={0.0};
+  for(std::vector<FillPlanEntry>::const_iterator e=plan.begin(); e!=plan.end(); ++e) {
+    const Int_t* v = e->fVars;
+    const Bool_t weighted = (e->fVarW>AliReducedVarManager::kNothing);
+    switch(e->fKind) {
+      case kFillTH1:
+        if(weighted) ((TH1F*)e->fHist)->Fill(values[v[0]],values[e->fVarW]);
+        else         ((TH1F*)e->fHist)->Fill(values[v[0]]);
+      break;
+      case kFillProfile:
+        if(weighted) ((TProfile*)e->fHist)->Fill(values[v[0]],values[v[1]],values[e->fVarW]);
+        else         ((TProfile*)e->fHist)->Fill(values[v[0]],values[v[1]]);
+      break;
+      case kFillTH2:
+        if(weighted) ((TH2F*)e->fHist)->Fill(values[v[0]],values[v[1]],values[e->fVarW]);
+        else         ((TH2F*)e->fHist)->Fill(values[v[0]],values[v[1]]);
+      break;
+      case kFillProfile2D:
+        if(weighted) ((TProfile2D*)e->fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[e->fVarW]);
+        else         ((TProfile2D*)e->fHist)->Fill(values[v[0]],values[v[1]],values[v[2]]);
+      break;
+      case kFillTH3:
+        if(weighted) ((TH3F*)e->fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[e->fVarW]);
+        else         ((TH3F*)e->fHist)->Fill(values[v[0]],values[v[1]],values[v[2]]);
+      break;
+      case kFillProfile3D:
+        if(weighted) ((TProfile3D*)e->fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[v[3]],values[e->fVarW]);
+        else         ((TProfile3D*)e->fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[v[3]]);
+      break;
+      case kFillTHn:
+        for(Int_t idim=0;idim<e->fNDim;++idim) fillValues[idim] = values[v[idim]];
+        if(weighted) ((THnBase*)e->fHist)->Fill(fillValues,values[e->fVarW]);
+        else         ((THnBase*)e->fHist)->Fill(fillValues);
+      break;
+      default:
+      break;
+    }
   }
-    
+}
+
+//__________________________________________________________________
+void AliHistogramManager::BuildFillPlan(Int_t handle) {
+  //
+  //  decode the histogram kinds and variables of a histogram class
+  //  The histograms with variables which are not used are skipped
+  //
+  if(handle>=(Int_t)fFillPlans.size()) fFillPlans.resize(fMainList.GetEntries());
+  FillPlan& plan = fFillPlans[handle];
+  plan.fEntries.clear();
+  plan.fBuilt = kTRUE;
+  THashList* hList = (THashList*)fMainList.At(handle);
+  if(!hList) return;
+  
   TIter next(hList);
   TObject* h=0x0;
-  Bool_t isProfile;
-  Bool_t isTHn;
-  Int_t thnDim=0;
-  Bool_t isSparse=kFALSE;
-  Double_t fillValues[20]={0.0};
-  Int_t uid = 0;
-  Int_t varX=-1, varY=-1, varZ=-1, varT=-1, varW=-1;
-  Int_t dimension=0;
   while((h=next())) {
-    Bool_t allVarsGood = kTRUE;
-    uid = h->GetUniqueID();
-    isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
-    isTHn = ((uid%100)>10 ? kTRUE : kFALSE);      
-    if(isTHn) thnDim = (uid%100)-10;        // the excess over 10 from the last 2 digits give the dimension of the THn
-    if(isTHn && ((TString)h->ClassName()).Contains("Sparse")) isSparse = kTRUE;
-    dimension = 0;
-    if(!isTHn) dimension = ((TH1*)h)->GetDimension();
-        
+    FillPlanEntry entry;
+    entry.fHist = h;
+    entry.fNDim = 0;
+    for(Int_t i=0;i<kMaxFillDimensions;++i) entry.fVars[i] = AliReducedVarManager::kNothing;
+    
+    Int_t uid = h->GetUniqueID();
+    Bool_t isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
+    Bool_t isTHn = ((uid%100)>10 ? kTRUE : kFALSE);
+    Int_t thnDim = (isTHn ? (uid%100)-10 : 0);        // the excess over 10 from the last 2 digits give the dimension of the THn
+    
     uid = (uid-(uid%100))/100;
-    varX = -1;
-    varY = -1;
-    varZ = -1;
-    varT = -1;
-    varW = -1;
+    Int_t varT = -1, varW = -1;
     if(uid>0) {
       varW = uid%(fNVars+1)-1;
       if(varW==0) varW=AliReducedVarManager::kNothing;
       uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
       if(uid>0) varT = uid - 1;
-      //cout << "Filling " << h->GetName() << " with varT " << varT << endl;
     }
-        
-    if(!isTHn) {
-      varX = ((TH1*)h)->GetXaxis()->GetUniqueID();
-      if(fUsedVars[varX]) {
-        switch(dimension) {
-          case 1:
-            if(isProfile) {
-              varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-              if(!fUsedVars[varY]) break;
-              if(varW>AliReducedVarManager::kNothing) { 
-                if(!fUsedVars[varW]) break;
-                ((TProfile*)h)->Fill(values[varX],values[varY],values[varW]);
-              }
-              else 
-                ((TProfile*)h)->Fill(values[varX],values[varY]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH1F*)h)->Fill(values[varX],values[varW]);
-              }
-              else
-                ((TH1F*)h)->Fill(values[varX]);
-            }
-          break;
-          case 2:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            if(isProfile) {
-              varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-              if(!fUsedVars[varZ]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ]);        
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH2F*)h)->Fill(values[varX],values[varY], values[varW]);
-              }
-              else
-                ((TH2F*)h)->Fill(values[varX],values[varY]);
-            }
-          break;
-          case 3:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-            if(!fUsedVars[varZ]) break;
-            if(isProfile) {
-              if(!fUsedVars[varT]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT],values[varW]);
-              }
-              else
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ]);
-            }
-          break;
-          default:
-          break;
-        }  // end switch
+    if(varW>AliReducedVarManager::kNothing && !fUsedVars[varW]) continue;
+    entry.fVarW = varW;
+    
+    if(isTHn) {
+      if(thnDim>kMaxFillDimensions) {
+        cout << "Warning in AliHistogramManager::BuildFillPlan(): " << h->GetName() << " has more than "
+             << kMaxFillDimensions << " dimensions, not filled" << endl;
+        continue;
       }
-    }  // end if(!isTHn)
-    else {
+      Bool_t allVarsGood = kTRUE;
       for(Int_t idim=0;idim<thnDim;++idim) {
-        if (isSparse) {
-          allVarsGood &= fUsedVars[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-        } else {
-          allVarsGood &= fUsedVars[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-        }
-      }
-      if(allVarsGood) {
-        if(varW>AliReducedVarManager::kNothing) {
-          if(fUsedVars[varW]) {
-            if (isSparse) ((THnSparseF*)h)->Fill(fillValues,values[varW]);
-            else          ((THnF*)h)->Fill(fillValues,values[varW]);
-          }
-        }
-        else {
-          if (isSparse) ((THnSparseF*)h)->Fill(fillValues);
-          else          ((THnF*)h)->Fill(fillValues);
-        }
+        entry.fVars[idim] = ((THnBase*)h)->GetAxis(idim)->GetUniqueID();
+        allVarsGood &= fUsedVars[entry.fVars[idim]];
       }
+      if(!allVarsGood) continue;
+      entry.fKind = kFillTHn;
+      entry.fNDim = thnDim;
+      plan.fEntries.push_back(entry);
+      continue;
     }
+    
+    TH1* h1 = (TH1*)h;
+    Int_t dimension = h1->GetDimension();
+    entry.fVars[0] = h1->GetXaxis()->GetUniqueID();
+    if(dimension>1 || isProfile) entry.fVars[1] = h1->GetYaxis()->GetUniqueID();
+    if(dimension>2 || (dimension==2 && isProfile)) entry.fVars[2] = h1->GetZaxis()->GetUniqueID();
+    if(dimension==3 && isProfile) entry.fVars[3] = varT;
+    switch(dimension) {
+      case 1: entry.fKind = (isProfile ? kFillProfile : kFillTH1); break;
+      case 2: entry.fKind = (isProfile ? kFillProfile2D : kFillTH2); break;
+      case 3: entry.fKind = (isProfile ? kFillProfile3D : kFillTH3); break;
+      default: continue;
+    }
+    Bool_t allVarsGood = kTRUE;
+    for(Int_t i=0;i<dimension+(isProfile ? 1 : 0);++i)
+      allVarsGood &= (entry.fVars[i]>=0 && fUsedVars[entry.fVars[i]]);
+    if(!allVarsGood) continue;
+    plan.fEntries.push_back(entry);
   }
 }
 
+//__________________________________________________________________
+void AliHistogramManager::InvalidateFillPlans() {
+  //
+  //  rebuild the fill plans at the next fill, after a histogram has been booked
+  //
+  for(std::vector<FillPlan>::iterator it=fFillPlans.begin(); it!=fFillPlans.end(); ++it) it->fBuilt = kFALSE;
+}
+
 //__________________________________________________________________
 void AliHistogramManager::WriteOutput(TFile* save) {
   //
@@ -8,6 +8,9 @@
 #ifndef ALIHISTOGRAMMANAGER_H
 #define ALIHISTOGRAMMANAGER_H
 
+#include <map>
+#include <vector>
+
 #include <TString.h>
 #include <TObject.h>
 #include <THn.h>
@@ -69,6 +72,10 @@ class AliHistogramManager : public TObject {
                         TAxis* axis);
   
   void FillHistClass(const Char_t* className, Float_t* values);
+  // Fill a class of histograms identified by the handle from GetHistClassHandle(), without any string lookup.
+  // The handle stays valid as long as the manager exists (histogram classes are only appended)
+  void FillHistClass(Int_t handle, Float_t* values);
+  Int_t GetHistClassHandle(const Char_t* className);   // -1 if the histogram class does not exist
   
   void SetUseDefaultVariableNames(Bool_t flag) {fUseDefaultVariableNames = flag;};
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -106,9 +113,33 @@ class AliHistogramManager : public TObject {
   TString fVariableUnits[AliReducedVarManager::kNVars];               //! variable units
   Int_t fNVars;                          // maximum number of variables
   
+  // Fill plan of a histogram class: the histogram kind and the variable indices decoded once from
+  // the unique IDs of the histograms and of their axes, so that FillHistClass() only indexes the values
+  enum FillKind {
+    kFillTH1=0, kFillProfile, kFillTH2, kFillProfile2D, kFillTH3, kFillProfile3D, kFillTHn
+  };
+  enum {
+    kMaxFillDimensions=20       // maximum number of dimensions of the THn histograms
+  };
+  struct FillPlanEntry {
+    TObject* fHist;                       // histogram
+    Int_t fKind;                          // FillKind
+    Int_t fNDim;                          // number of dimensions of the THn histograms
+    Int_t fVars[kMaxFillDimensions];      // variables of the x, y, z and t axes, or of the THn axes
+    Int_t fVarW;                          // weight variable, kNothing if not weighted
+  };
+  struct FillPlan {
+    Bool_t fBuilt;                        // plan built since the last booked histogram
+    std::vector<FillPlanEntry> fEntries;  // histograms of the class to be filled
+  };
+  std::vector<FillPlan> fFillPlans;                  //! fill plans, indexed by the histogram class handle
+  std::map<const TObject*, Int_t> fHistClassHandles; //! handles of the histogram classes looked up so far
+  
   void MakeAxisLabels(TAxis* ax, const Char_t* labels);
+  void BuildFillPlan(Int_t handle);
+  void InvalidateFillPlans();
   
-  ClassDef(AliHistogramManager, 4)
+  ClassDef(AliHistogramManager, 5)
 };
 
 #endif
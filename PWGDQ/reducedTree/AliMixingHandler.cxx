@@ -11,6 +11,7 @@
 #endif
 
 #include <iostream>
+#include <vector>
 using std::cout;
 using std::endl;
 using std::flush;
@@ -428,6 +429,11 @@ void AliMixingHandler::RunEventMixing(TClonesArray* leg1Pool, TClonesArray* leg2
   if(entries<2) return;
   
   TObjArray* histClassArr = fHistClassNames.Tokenize(";");
+  // look up the histogram classes once, the pair loops below fill them by handle
+  std::vector<Int_t> histClassHandles(histClassArr->GetEntries());
+  for(Int_t i=0; i<histClassArr->GetEntries(); ++i)
+    histClassHandles[i] = fHistos->GetHistClassHandle(histClassArr->At(i)->GetName());
+  delete histClassArr;
   
   TIter iterEv1Leg1Pool(leg1Pool);
   TIter iterEv1Leg2Pool(leg2Pool);
@@ -472,10 +478,10 @@ void AliMixingHandler::RunEventMixing(TClonesArray* leg1Pool, TClonesArray* leg2
                 if (fNParallelPairCuts>1) {
                   for (Int_t jbit=0; jbit<fNParallelPairCuts; jbit++) {
                     if (!((pairCutMask)&(ULong_t(1)<<jbit))) continue;
-                    fHistos->FillHistClass(histClassArr->At(ibit*3+jbit*3*fNParallelCuts+1)->GetName(), values);
+                    fHistos->FillHistClass(histClassHandles[ibit*3+jbit*3*fNParallelCuts+1], values);
                   }
                 } else {
-                  fHistos->FillHistClass(histClassArr->At(ibit*3+1)->GetName(), values);
+                  fHistos->FillHistClass(histClassHandles[ibit*3+1], values);
                 }
               }
               if(fMixingSetup==kMixCorrelation) {
@@ -484,12 +490,12 @@ void AliMixingHandler::RunEventMixing(TClonesArray* leg1Pool, TClonesArray* leg2
                   ULong_t pairCutMaskCorr = (reinterpret_cast<AliReducedPairInfo*>(ev1Leg1))->GetQualityFlags();
                   for (Int_t jbit=0; jbit<fNParallelPairCuts; jbit++) {
                     if (!((pairCutMaskCorr)&(ULong_t(1)<<jbit))) continue;
-                    if (fMixLikeSign) fHistos->FillHistClass(histClassArr->At(ibit*3+jbit*fNParallelCuts+pairType)->GetName(), values);
-                    else              fHistos->FillHistClass(histClassArr->At(ibit+jbit*fNParallelCuts)->GetName(), values);
+                    if (fMixLikeSign) fHistos->FillHistClass(histClassHandles[ibit*3+jbit*fNParallelCuts+pairType], values);
+                    else              fHistos->FillHistClass(histClassHandles[ibit+jbit*fNParallelCuts], values);
                   }
                 } else {
-                  if (fMixLikeSign) fHistos->FillHistClass(histClassArr->At(ibit*3+pairType)->GetName(), values);
-                  else              fHistos->FillHistClass(histClassArr->At(ibit)->GetName(), values);
+                  if (fMixLikeSign) fHistos->FillHistClass(histClassHandles[ibit*3+pairType], values);
+                  else              fHistos->FillHistClass(histClassHandles[ibit], values);
                 }
               }
             }
@@ -515,10 +521,10 @@ void AliMixingHandler::RunEventMixing(TClonesArray* leg1Pool, TClonesArray* leg2
         if (fNParallelPairCuts>1) {
           for (Int_t jbit=0; jbit<fNParallelPairCuts; jbit++) {
             if (!((pairCutMask)&(ULong_t(1)<<jbit))) continue;
-            fHistos->FillHistClass(histClassArr->At(ibit*3+jbit*3*fNParallelCuts+0)->GetName(), values);
+            fHistos->FillHistClass(histClassHandles[ibit*3+jbit*3*fNParallelCuts+0], values);
           }
         } else {
-          fHistos->FillHistClass(histClassArr->At(ibit*3+0)->GetName(), values);
+          fHistos->FillHistClass(histClassHandles[ibit*3+0], values);
         }
       }
     }
@@ -552,10 +558,10 @@ void AliMixingHandler::RunEventMixing(TClonesArray* leg1Pool, TClonesArray* leg2
         if (fNParallelPairCuts>1) {
           for (Int_t jbit=0; jbit<fNParallelPairCuts; jbit++) {
             if (!((pairCutMask)&(ULong_t(1)<<jbit))) continue;
-            fHistos->FillHistClass(histClassArr->At(ibit*3+jbit*3*fNParallelCuts+2)->GetName(), values);
+            fHistos->FillHistClass(histClassHandles[ibit*3+jbit*3*fNParallelCuts+2], values);
           }
         } else {
-          fHistos->FillHistClass(histClassArr->At(ibit*3+2)->GetName(), values);
+          fHistos->FillHistClass(histClassHandles[ibit*3+2], values);
         }
       }
     }
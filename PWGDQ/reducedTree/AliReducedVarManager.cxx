@@ -16,6 +16,7 @@ using std::endl;
 using std::flush;
 using std::ifstream;
 #include <fstream>
+#include <chrono>
 
 #include <TString.h>
 #include <TMath.h>
@@ -194,6 +195,36 @@ Bool_t                          AliReducedVarManager::fgOptionRecenterVZEROqVec
 Bool_t                          AliReducedVarManager::fgOptionRecenterTPCqVec = kFALSE;
 Bool_t                          AliReducedVarManager::fgOptionEventRes = kFALSE;
 
+Bool_t                          AliReducedVarManager::fgProducersCompiled = kFALSE;
+Bool_t                          AliReducedVarManager::fgProducerActive[AliReducedVarManager::kNProducers] = {kFALSE};
+Int_t                           AliReducedVarManager::fgProducerList[AliReducedVarManager::kNProducerStages][AliReducedVarManager::kNProducers] = {{0}};
+Int_t                           AliReducedVarManager::fgNProducers[AliReducedVarManager::kNProducerStages] = {0};
+Bool_t                          AliReducedVarManager::fgProducerTiming = kFALSE;
+Double_t                        AliReducedVarManager::fgProducerTime[AliReducedVarManager::kNProducers] = {0.};
+Long64_t                        AliReducedVarManager::fgProducerCalls[AliReducedVarManager::kNProducers] = {0};
+
+// Registry of the producers, in the order of the Producers enum: name, stage,
+// ranges [first,last) of the variables filled by the producer and producers it depends on
+const AliReducedVarManager::ProducerInfo AliReducedVarManager::fgkProducers[AliReducedVarManager::kNProducers] = {
+  {"CorrectedMultiplicity", kEventStage,     1, {{kCorrectedMultiplicity, kSPDFiredChips}}, 0, {0}},
+  {"VZEROChannel",          kEventStage,     2, {{kVZEROCurrentChannel, kVZEROChannelMultCalib}, {kVZEROChannelEta, kVZEROQvecX}}, 0, {0}},
+  {"VZEROQvector",          kEventStage,     4, {{kVZEROCurrentChannelMultCalib, kVZEROAemptyChannels}, {kVZEROChannelMultCalib, kVZEROChannelEta},
+                                                 {kVZEROQvecX, kVZEROflowV2TPC}, {kVZEROQaQcSP, kTPCQvecX}}, 0, {0}},
+  {"TPCEventPlaneTree",     kEventStage,     1, {{kTPCQvecXtree, kZDCnEnergyCh}}, 0, {0}},
+  {"TPCVZEROCorrelation",   kEventStage,     1, {{kTPCRPres, kTPCQvecXleft}}, 2, {kTPCEventPlaneTreeProducer, kVZEROQvectorProducer}},
+  {"EventPlaneFriend",      kEventStage,     2, {{kVZEROQvecX, kVZEROflowV2TPC}, {kVZEROQaQcSP, kTPCQvecXtree}}, 0, {0}},
+  {"VZEROFlowV2TPC",        kEventStage,     1, {{kVZEROflowV2TPC, kVZEROQaQcSP}}, 2, {kEventPlaneFriendProducer, kVZEROChannelProducer}},
+  {"PairEfficiency",        kBaseTrackStage, 1, {{kPairEff, kPairLegITSchi2}}, 0, {0}},
+  {"VZEROFlow",             kBaseTrackStage, 3, {{kVZEROFlowVn, kTPCFlowVn}, {kVZEROFlowSine, kTPCFlowSine}, {kVZEROuQ, kTPCuQ}}, 
+                                                 2, {kVZEROQvectorProducer, kEventPlaneFriendProducer}},
+  {"TPCFlow",               kBaseTrackStage, 3, {{kTPCFlowVn, kVZEROFlowSine}, {kTPCFlowSine, kVZEROuQ}, {kTPCuQ, kCandidateId}}, 
+                                                 3, {kTPCEventPlaneTreeProducer, kVZEROQvectorProducer, kEventPlaneFriendProducer}},
+  {"TPCnSigmaCorrection",   kTrackStage,     1, {{kTPCnSigCorrected, kTOFbeta}}, 0, {0}},
+  {"PairPolarization",      kPairStage,      1, {{kPairThetaCS, kPairQualityFlag}}, 0, {0}},
+  {"PairDecayLength",       kPairStage,      1, {{kPairLxy, kPseudoProperDecayTimeMC}}, 0, {0}},
+  {"PairPhiV",              kPairStage,      1, {{kPairPhiV, kPairDca}}, 0, {0}}
+};
+
 //__________________________________________________________________
 AliReducedVarManager::AliReducedVarManager() :
   TObject()
@@ -384,6 +415,8 @@ void AliReducedVarManager::SetVariableDependencies() {
     fgUsedVars[kNTracksTPCoutBeforeClean] = kTRUE;
     fgUsedVars[kVZEROTotalMultFromChannels] = kTRUE;
   }
+  
+  CompileProducers();
 }
 
 //__________________________________________________________________
@@ -675,100 +708,6 @@ void AliReducedVarManager::FillEventInfo(BASEEVENT* baseEvent, Float_t* values,
     if( ieta < 8 || ieta > 23 ) values[ kSPDntrackletsOuterEta ] += event->SPDntracklets(ieta);
   }
 
-  for( Int_t iEstimator = 0; iEstimator < kNMultiplicityEstimators; ++iEstimator){
-    Int_t estimator = kMultiplicity + iEstimator;
-    if( fgAvgMultVsVtxAndRun[iEstimator] ){
-      Int_t vtxBin = fgAvgMultVsVtxAndRun[iEstimator]->GetYaxis()->FindBin( values[kVtxZ] );
-      Int_t runBin = fgAvgMultVsVtxAndRun[iEstimator]->GetXaxis()->FindBin( values[kRunID] );
-      Double_t multRaw = values[ estimator ];
-      for( Int_t iCorrection = 0; iCorrection < kNCorrections; ++iCorrection  ){
-        for(Int_t iReference = 0 ; iReference <  kNReferenceMultiplicities; ++iReference ){
-          Int_t indexNotSmeared = GetCorrectedMultiplicity( estimator, iCorrection, iReference, kNoSmearing );
-          Int_t indexSmeared    = GetCorrectedMultiplicity( estimator, iCorrection, iReference, kPoissonSmearing );
-          Double_t multCorr        = multRaw;
-          Double_t multCorrSmeared = multRaw;
-    // apply vertex and gain loss correction simultaneously
-          if( iCorrection == kVertexCorrection2D  ){
-            Double_t localAvg = fgAvgMultVsVtxAndRun[iEstimator]->GetBinContent( runBin, vtxBin );
-            Double_t refMult  = fgRefMultVsVtxAndRun[iEstimator][iReference];
-            multCorr *=  localAvg ?  refMult / localAvg : 1.;
-            Double_t deltaM =  localAvg ?  multRaw * ( refMult/localAvg - 1) : 0.;
-            multCorrSmeared += (deltaM>0 ? 1. : -1.) * gRandom->Poisson(TMath::Abs(deltaM));
-          }
-          else{
-    // first apply vertex correction
-            Double_t localAvgVsVtx , refMultVsVtx  ;
-            switch( iCorrection ){
-              case kVertexCorrectionGlobal:
-              case kVertexCorrectionGlobalGainLoss:
-                localAvgVsVtx = fgAvgMultVsVtxGlobal[iEstimator]->GetBinContent( vtxBin );
-                refMultVsVtx  = fgRefMultVsVtxGlobal[iEstimator][iReference];
-                break;
-              case kVertexCorrectionRunwise:
-              case kVertexCorrectionRunwiseGainLoss:
-                localAvgVsVtx = fgAvgMultVsVtxRunwise[iEstimator]->GetBinContent( vtxBin );
-                refMultVsVtx  = fgRefMultVsVtxRunwise[iEstimator][iReference];
-                break;
-              default:
-                localAvgVsVtx = 0.;
-                refMultVsVtx  = 0.;
-                break;  
-            }
-            multCorr        *= localAvgVsVtx > 0. ? refMultVsVtx / localAvgVsVtx : 1.;
-            Double_t deltaM  = localAvgVsVtx > 0. ? multRaw  * ( refMultVsVtx/localAvgVsVtx - 1) : 0.;
-            multCorrSmeared += (deltaM>0 ? 1. : -1.) * gRandom->Poisson(TMath::Abs(deltaM));
-    // then apply gain loss correction
-            if( iCorrection == kVertexCorrectionGlobalGainLoss || 
-                iCorrection == kVertexCorrectionRunwiseGainLoss || 
-                iCorrection == kGainLossCorrection   ){
-              Double_t localAvgVsRun = fgAvgMultVsRun[iEstimator]->GetBinContent( runBin );
-              Double_t refMultVsRun  = fgRefMultVsRun[iEstimator][iReference];
-              multCorr        *= localAvgVsRun ? refMultVsRun / localAvgVsRun : 1.;
-              deltaM           = localAvgVsRun ? multCorrSmeared  * ( refMultVsRun/localAvgVsRun - 1) : 0;
-              multCorrSmeared += (deltaM>0 ? 1. : -1.) * gRandom->Poisson(TMath::Abs(deltaM));
-            }
-          }
-          values[ indexNotSmeared ] = multCorr;
-          values[ indexSmeared ]    = multCorrSmeared;
-          fgUsedVars [indexNotSmeared] = kTRUE;
-          fgUsedVars [indexSmeared] = kTRUE;
-        }
-      }
-    }
-    else if( ( estimator == kVZEROACTotalMult && fgAvgMultVsVtxAndRun[kVZEROATotalMult-kMultiplicity] && fgAvgMultVsVtxAndRun[kVZEROCTotalMult-kMultiplicity]  )  
-      || (estimator == kSPDnTracklets10EtaVtxCorr && fgAvgMultVsVtxAndRun[kSPDntrackletsEtaBin-kMultiplicity] ) ){
-      for( Int_t iCorrection = 0; iCorrection < kNCorrections; ++iCorrection  ){
-        for(Int_t iReference = 0 ; iReference <  kNReferenceMultiplicities; ++iReference ){
-          Int_t indexNotSmeared = GetCorrectedMultiplicity( estimator, iCorrection, iReference, kNoSmearing );
-          Int_t indexSmeared    = GetCorrectedMultiplicity( estimator, iCorrection, iReference, kPoissonSmearing );
-          values[indexNotSmeared] = 0.;
-          values[indexSmeared] = 0.;
-          if( estimator == kSPDnTracklets10EtaVtxCorr ){
-            for( Int_t ieta=6; ieta<26; ++ieta ) {
-              Int_t vtxBin = fgAvgMultVsVtxAndRun[kSPDntrackletsEtaBin+ieta-kMultiplicity]->GetYaxis()->FindBin( values[kVtxZ] );
-              if( fgAvgMultVsVtxGlobal[kSPDntrackletsEtaBin+ieta-kMultiplicity]->GetBinContent( vtxBin ) > .3 ){
-                Int_t indexBinNotSmeared = GetCorrectedMultiplicity( kSPDntrackletsEtaBin+ieta, iCorrection, iReference, kNoSmearing );
-                Int_t indexBinSmeared    = GetCorrectedMultiplicity( kSPDntrackletsEtaBin+ieta, iCorrection, iReference, kPoissonSmearing );
-                if( fgUsedVars[indexBinNotSmeared]) values[ indexNotSmeared ] += values[ indexBinNotSmeared ];
-                if( fgUsedVars[indexBinSmeared]) values[ indexSmeared ] += values[ indexBinSmeared ];
-              }
-            }
-          }
-          else{
-            Int_t indexAnotSmeared = GetCorrectedMultiplicity( kVZEROATotalMult, iCorrection, iReference, kNoSmearing );
-            Int_t indexCnotSmeared = GetCorrectedMultiplicity( kVZEROCTotalMult, iCorrection, iReference, kNoSmearing );
-
-            Int_t indexAsmeared = GetCorrectedMultiplicity( kVZEROATotalMult, iCorrection, iReference, kPoissonSmearing );
-            Int_t indexCsmeared = GetCorrectedMultiplicity( kVZEROCTotalMult, iCorrection, iReference, kPoissonSmearing );
-
-            values[ indexNotSmeared ] = values[ indexAnotSmeared ] + values[ indexCnotSmeared ];
-            values[ indexSmeared ]    = values[ indexAsmeared ]    + values[ indexCsmeared ];
-          }
-        }
-      }
-    }
-  }
-
   fgUsedVars[kNTracksITSoutVsSPDtracklets] = kTRUE;  
   fgUsedVars[kNTracksTPCoutVsSPDtracklets] = kTRUE;
   fgUsedVars[kNTracksTRDoutVsSPDtracklets] = kTRUE;
@@ -806,25 +745,6 @@ void AliReducedVarManager::FillEventInfo(BASEEVENT* baseEvent, Float_t* values,
   else
      fgUsedVars[kNTracksTPCoutVsVZEROTotalMult] = kFALSE;
   
-  values[kVZEROAemptyChannels] = 0;
-  values[kVZEROCemptyChannels] = 0;
-  for(Int_t ich=0;ich<64;++ich) fgUsedVars[kVZEROChannelMult+ich] = kTRUE; 
-  Float_t theta=0.0;
-  for(Int_t ich=0;ich<64;++ich) {
-    if(fgUsedVars[kVZEROChannelMult+ich]) {
-      values[kVZEROChannelMult+ich] = event->MultChannelVZERO(ich);
-      if(values[kVZEROChannelMult+ich]<fgkVZEROminMult) {
-        fgUsedVars[kVZEROChannelMult+ich] = kFALSE;   // will not be filled in histograms by the histogram manager
-        if(ich<32) values[kVZEROCemptyChannels] += 1;
-        else values[kVZEROAemptyChannels] += 1;
-      }
-    }
-    if(fgUsedVars[kVZEROChannelEta+ich]) {
-      if(ich<32) theta = TMath::ATan(fgkVZEROChannelRadii[ich]/(fgkVZEROCz-values[kVtxZ]));
-      else theta = TMath::Pi()-TMath::ATan(fgkVZEROChannelRadii[ich]/(fgkVZEROAz-values[kVtxZ]));
-      values[kVZEROChannelEta+ich] = -1.0*TMath::Log(TMath::Tan(theta/2.0));
-    }
-  }
   
   if(values[kVZEROTotalMultFromChannels]>0.0) 
      values[kNTracksTPCoutFromPileup] = values[kNTracksTPCoutBeforeClean] - (-3.2+TMath::Sqrt(3.2*3.2+4.0*1.6e-5*values[kVZEROTotalMultFromChannels]))/(2.0*1.6e-5);
@@ -840,348 +760,16 @@ void AliReducedVarManager::FillEventInfo(BASEEVENT* baseEvent, Float_t* values,
   if(fgUsedVars[kNTPCclustersFromPileupRelative] && values[kNTPCclusters]>0.0)
      values[kNTPCclustersFromPileupRelative] = values[kNTPCclustersFromPileup] / tpcClustersExpectationWOpileup;
   
-  if(fgUsedVars[kVZEROQvecX+0*6+1] || fgUsedVars[kVZEROQvecY+0*6+1] || fgUsedVars[kVZERORP+0*6+1]) {
-    Double_t qvecVZEROA[EVENTPLANE::fgkNMaxHarmonics][2] = {{0.0}};
-    Double_t qvecVZEROC[EVENTPLANE::fgkNMaxHarmonics][2] = {{0.0}};
-    if(fgOptionCalibrateVZEROqVec && fgAvgVZEROChannelMult[0]) {
-       Float_t calibVZEROMult[64] = {0.};
-       Float_t refMult=0;
-      for(Int_t ich=0;ich<64;++ich) fgUsedVars[kVZEROChannelMultCalib+ich] = kTRUE; 
-       
-      for(Int_t iCh=0; iCh<64; ++iCh) {
-         if(event->MultChannelVZERO(iCh)>=fgkVZEROminMult) {
-                         
-            Float_t avMult = fgAvgVZEROChannelMult[iCh]->GetBinContent(fgAvgVZEROChannelMult[iCh]->FindBin(event->Vertex(2), event->CentralitySPD()));
-            Int_t refCh = iCh-(iCh%8);
-            if(iCh==refCh)
-                refMult=fgAvgVZEROChannelMult[iCh]->GetBinContent(fgAvgVZEROChannelMult[iCh]->GetXaxis()->FindBin(0.0),fgAvgVZEROChannelMult[iCh]->GetYaxis()->FindBin(event->CentralitySPD()));
-            
-            calibVZEROMult[iCh] = event->MultChannelVZERO(iCh) / (avMult>1.0e-6 ? avMult : 1.0)*refMult;
-            values[kVZEROChannelMultCalib+iCh]=calibVZEROMult[iCh];
-            
-          //  cout<<"V0 channel"<<" "<<iCh<<" "<<"Reference Channel "<<refCh<<" "<<"Reference multiplicity"<<refMult<<"Avg mult"<<avMult<<" "<<values[kVZEROChannelMult+iCh]<<" "<<values[kVZEROChannelMultCalib+iCh]<<endl;
-            
-         }
-         else
-             fgUsedVars[kVZEROChannelMultCalib+iCh] = kFALSE; // will not be filled in histograms by the histogram manager
-      }
-      event->GetVZEROQvector(qvecVZEROA, EVENTPLANE::kVZEROA, calibVZEROMult);
-      event->GetVZEROQvector(qvecVZEROC, EVENTPLANE::kVZEROC, calibVZEROMult);
-      
-     
-    }
-    else {
-      event->GetVZEROQvector(qvecVZEROA, EVENTPLANE::kVZEROA);
-      event->GetVZEROQvector(qvecVZEROC, EVENTPLANE::kVZEROC);
-    }
-    if(fgOptionRecenterVZEROqVec && fgVZEROqVecRecentering[0]) {
-         Float_t recenterOffset = fgVZEROqVecRecentering[0]->GetBinContent(fgVZEROqVecRecentering[0]->FindBin(event->CentralitySPD(), event->Vertex(2)));
-         Float_t widthEqVZERO = fgVZEROqVecRecentering[0]->GetBinError(fgVZEROqVecRecentering[0]->FindBin(event->CentralitySPD(), event->Vertex(2)));
-
-         qvecVZEROA[1][0] -= recenterOffset;
-           if(widthEqVZERO >0.0)
-             qvecVZEROA[1][0] /=widthEqVZERO;
-           else
-             qvecVZEROA[1][0]=0;
-                
-        recenterOffset = fgVZEROqVecRecentering[1]->GetBinContent(fgVZEROqVecRecentering[1]->FindBin(event->CentralitySPD(), event->Vertex(2)));
-        widthEqVZERO = fgVZEROqVecRecentering[1]->GetBinError(fgVZEROqVecRecentering[1]->FindBin(event->CentralitySPD(), event->Vertex(2)));
-        qvecVZEROA[1][1] -= recenterOffset;
-           if(widthEqVZERO >0.0)
-              qvecVZEROA[1][1] /=widthEqVZERO;
-           else
-            qvecVZEROA[1][1]=0;
-          
-        recenterOffset = fgVZEROqVecRecentering[2]->GetBinContent(fgVZEROqVecRecentering[2]->FindBin(event->CentralitySPD(), event->Vertex(2)));
-        widthEqVZERO = fgVZEROqVecRecentering[2]->GetBinError(fgVZEROqVecRecentering[2]->FindBin(event->CentralitySPD(), event->Vertex(2)));
-        qvecVZEROC[1][0] -= recenterOffset;
-           if(widthEqVZERO >0.0)
-              qvecVZEROC[1][0] /=widthEqVZERO;
-           else
-              qvecVZEROC[1][0]=0;
-       
-        recenterOffset = fgVZEROqVecRecentering[3]->GetBinContent(fgVZEROqVecRecentering[3]->FindBin(event->CentralitySPD(), event->Vertex(2)));
-        widthEqVZERO = fgVZEROqVecRecentering[3]->GetBinError(fgVZEROqVecRecentering[3]->FindBin(event->CentralitySPD(), event->Vertex(2)));
-        qvecVZEROC[1][1] -= recenterOffset;
-           if(widthEqVZERO >0.0)
-              qvecVZEROC[1][1] /=widthEqVZERO;
-           else
-              qvecVZEROC[1][1]=0;
-     
-    }
-    for(Int_t ih=1; ih<2; ++ih) {
-       // VZERO event plane variables
-       values[kVZEROQvecX+0*6+ih] = qvecVZEROA[ih][0];
-       values[kVZEROQvecY+0*6+ih] = qvecVZEROA[ih][1];
-       values[kVZEROQvecX+1*6+ih] = qvecVZEROC[ih][0];
-       values[kVZEROQvecY+1*6+ih] = qvecVZEROC[ih][1];
-       values[kVZERORP+0*6+ih] = TMath::ATan2(qvecVZEROA[ih][1], qvecVZEROA[ih][0])/Double_t(ih+1);
-       values[kVZERORP+1*6+ih] = TMath::ATan2(qvecVZEROC[ih][1], qvecVZEROC[ih][0])/Double_t(ih+1);
-       values[kVZEROQvecX+2*6+ih] = qvecVZEROA[ih][0] + qvecVZEROC[ih][0];
-       values[kVZEROQvecY+2*6+ih] = qvecVZEROA[ih][1] + qvecVZEROC[ih][1];
-       values[kVZERORP   +2*6+ih] = TMath::ATan2(values[kVZEROQvecY+2*6+ih], values[kVZEROQvecX+2*6+ih])/Double_t(ih+1);
-     
-       if(fgUsedVars[kVZEROQaQcSP+ih]) {
-          values[kVZEROQaQcSP+ih] = TMath::Cos((ih+1)*(values[kVZERORP+0*6+ih]-values[kVZERORP+1*6+ih]));
-          values[kVZEROQaQcSP+ih] *= TMath::Sqrt(values[kVZEROQvecX+0*6+ih]*values[kVZEROQvecX+0*6+ih]+
-          values[kVZEROQvecY+0*6+ih]*values[kVZEROQvecY+0*6+ih]);
-          values[kVZEROQaQcSP+ih] *= TMath::Sqrt(values[kVZEROQvecX+1*6+ih]*values[kVZEROQvecX+1*6+ih]+
-          values[kVZEROQvecY+1*6+ih]*values[kVZEROQvecY+1*6+ih]);
-       }
-       values[kVZEROQaQcSPsine+ih] = TMath::Sin((ih+1)*(values[kVZERORP+0*6+ih]-values[kVZERORP+1*6+ih]));
-       values[kVZEROQaQcSPsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+0*6+ih]*values[kVZEROQvecX+0*6+ih]+
-       values[kVZEROQvecY+0*6+ih]*values[kVZEROQvecY+0*6+ih]);
-       values[kVZEROQaQcSPsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+1*6+ih]*values[kVZEROQvecX+1*6+ih]+
-       values[kVZEROQvecY+1*6+ih]*values[kVZEROQvecY+1*6+ih]);
-       values[kVZERORP   +2*6+ih] = TMath::ATan2(values[kVZEROQvecY+2*6+ih],values[kVZEROQvecX+2*6+ih])/Double_t(ih+1);
-       // cos (n*(psi_A-psi_C))
-       if(fgUsedVars[kVZERORPres + ih]) {
-          values[kVZERORPres + ih] = DeltaPhi(values[kVZERORP+0*6+ih], values[kVZERORP+1*6+ih]);
-          values[kVZERORPres + ih] = TMath::Cos(values[kVZERORPres + ih]*(ih+1));
-       }
-       // Qx,Qy correlations for VZERO
-       if(fgUsedVars[kVZEROXaXc+ih]) 
-          values[kVZEROXaXc+ih] = qvecVZEROA[ih][0]*qvecVZEROC[ih][0];
-       if(fgUsedVars[kVZEROXaYa+ih]) 
-          values[kVZEROXaYa+ih] = qvecVZEROA[ih][0]*qvecVZEROA[ih][1];
-       if(fgUsedVars[kVZEROXaYc+ih]) 
-          values[kVZEROXaYc+ih] = qvecVZEROA[ih][0]*qvecVZEROC[ih][1];
-       if(fgUsedVars[kVZEROYaXc+ih]) 
-          values[kVZEROYaXc+ih] = qvecVZEROA[ih][1]*qvecVZEROC[ih][0];
-       if(fgUsedVars[kVZEROYaYc+ih]) 
-          values[kVZEROYaYc+ih] = qvecVZEROA[ih][1]*qvecVZEROC[ih][1];
-       if(fgUsedVars[kVZEROXcYc+ih]) 
-          values[kVZEROXcYc+ih] = qvecVZEROC[ih][0]*qvecVZEROC[ih][1];
-       // Psi_A - Psi_C
-       if(fgUsedVars[kVZEROdeltaRPac+ih])
-          values[kVZEROdeltaRPac+ih] = DeltaPhi(values[kVZERORP+0*6+ih], values[kVZERORP+1*6+ih]);
-    }    // end loop over harmonics
-  }
-  
-  // Get the TPC event plane in case it was written in the trees 
-  for(Int_t ih=0; ih<3; ++ih) {
-     if(event->GetEventPlaneStatus(EVENTPLANE::kTPC,ih+1)!=EVENTPLANE::kUnset) {
-        values[kTPCQvecXtree+ih] = event->GetQx(EVENTPLANE::kTPC,ih+1);
-        values[kTPCQvecYtree+ih] = event->GetQy(EVENTPLANE::kTPC,ih+1);
-        values[kTPCRPtree+ih] = event->GetEventPlane(EVENTPLANE::kTPC,ih+1);
-        
-          //TPC Q vector recentering       
-          if(fgOptionRecenterTPCqVec && fgTPCqVecRecentering[0] && ih==1) {
-            Float_t recenterOffsetTPC = fgTPCqVecRecentering[0]->GetBinContent(fgTPCqVecRecentering[0]->FindBin(event->CentralityVZERO(), event->Vertex(2)));
-            Double_t widthEqTPC = fgTPCqVecRecentering[0]->GetBinError(fgTPCqVecRecentering[0]->FindBin(event->CentralityVZERO(), event->Vertex(2)));
-            values[kTPCQvecXtree+1] -= recenterOffsetTPC;
-
-                if(widthEqTPC >0.0)
-                   values[kTPCQvecXtree+1] /=widthEqTPC;
-                else
-                   values[kTPCQvecXtree+1]=0;
-                
-            recenterOffsetTPC = fgTPCqVecRecentering[1]->GetBinContent(fgTPCqVecRecentering[1]->FindBin(event->CentralityVZERO(), event->Vertex(2)));
-            widthEqTPC = fgTPCqVecRecentering[1]->GetBinError(fgTPCqVecRecentering[1]->FindBin(event->CentralityVZERO(), event->Vertex(2)));
-            values[kTPCQvecYtree+1] -= recenterOffsetTPC;
-                
-                if(widthEqTPC >0.0)
-                   values[kTPCQvecYtree+1] /=widthEqTPC;
-                else
-                   values[kTPCQvecYtree+1]=0;
-                 
-            values[kTPCRPtree+ih]=TMath::ATan2(values[kTPCQvecYtree+1],values[kTPCQvecXtree+1])/Double_t(ih+1);
-      
-        }
- 
-     }
-     if(event->GetEventPlaneStatus(EVENTPLANE::kTPCptWeights,ih+1)!=EVENTPLANE::kUnset) {
-        values[kTPCQvecXptWeightsTree+ih] = event->GetQx(EVENTPLANE::kTPCptWeights,ih+1);
-        values[kTPCQvecYptWeightsTree+ih] = event->GetQy(EVENTPLANE::kTPCptWeights,ih+1);
-        values[kTPCRPptWeightsTree+ih] = event->GetEventPlane(EVENTPLANE::kTPCptWeights,ih+1);
-     }
-     if(event->GetEventPlaneStatus(EVENTPLANE::kTPCpos,ih+1)!=EVENTPLANE::kUnset) {
-        values[kTPCQvecXposTree+ih] = event->GetQx(EVENTPLANE::kTPCpos,ih+1);
-        values[kTPCQvecYposTree+ih] = event->GetQy(EVENTPLANE::kTPCpos,ih+1);
-        values[kTPCRPposTree+ih] = event->GetEventPlane(EVENTPLANE::kTPCpos,ih+1);
-     }
-     if(event->GetEventPlaneStatus(EVENTPLANE::kTPCneg,ih+1)!=EVENTPLANE::kUnset) {
-        values[kTPCQvecXnegTree+ih] = event->GetQx(EVENTPLANE::kTPCneg,ih+1);
-        values[kTPCQvecYnegTree+ih] = event->GetQy(EVENTPLANE::kTPCneg,ih+1);
-        values[kTPCRPnegTree+ih] = event->GetEventPlane(EVENTPLANE::kTPCneg,ih+1);
-     }
-     
-      // TPC VZERO Q-vector correlations
-     if(fgUsedVars[kRPXtpcXvzeroa+ih]) 
-	values[kRPXtpcXvzeroa+ih] = values[kTPCQvecXtree+ih]*values[kVZEROQvecX+ih];
-     if(fgUsedVars[kRPXtpcXvzeroc+ih]) 
-	values[kRPXtpcXvzeroc+ih] = values[kTPCQvecXtree+ih]*values[kVZEROQvecX+6+ih];
-     if(fgUsedVars[kRPYtpcYvzeroa+ih]) 
-	values[kRPYtpcYvzeroa+ih] = values[kTPCQvecYtree+ih]*values[kVZEROQvecY+ih];
-     if(fgUsedVars[kRPYtpcYvzeroc+ih]) 
-	values[kRPYtpcYvzeroc+ih] = values[kTPCQvecYtree+ih]*values[kVZEROQvecY+6+ih];
-     if(fgUsedVars[kRPXtpcYvzeroa+ih]) 
-	values[kRPXtpcYvzeroa+ih] = values[kTPCQvecXtree+ih]*values[kVZEROQvecY+ih];
-     if(fgUsedVars[kRPXtpcYvzeroc+ih]) 
-	values[kRPXtpcYvzeroc+ih] = values[kTPCQvecXtree+ih]*values[kVZEROQvecY+6+ih];
-     if(fgUsedVars[kRPYtpcXvzeroa+ih]) 
-	values[kRPYtpcXvzeroa+ih] = values[kTPCQvecYtree+ih]*values[kVZEROQvecX+ih];
-     if(fgUsedVars[kRPYtpcXvzeroc+ih]) 
-	values[kRPYtpcXvzeroc+ih] = values[kTPCQvecYtree+ih]*values[kVZEROQvecX+6+ih];
-      // Psi_TPC - Psi_VZERO A/C      
-     if(fgUsedVars[kRPdeltaVZEROAtpc+ih]) 
-	values[kRPdeltaVZEROAtpc+ih] = DeltaPhi(values[kVZERORP+0*6+ih], values[kTPCRPtree+ih]);
-     if(fgUsedVars[kRPdeltaVZEROCtpc+ih])
-        values[kRPdeltaVZEROCtpc+ih] = DeltaPhi(values[kVZERORP+1*6+ih], values[kTPCRPtree+ih]);
-     
-     
-     // cos(n(EPtpc-EPvzero A/C))
-     for(Int_t iVZEROside=0; iVZEROside<2; ++iVZEROside) {
-          if(fgUsedVars[kTPCRPres+iVZEROside*6+ih]) {
-	  values[kTPCRPres+iVZEROside*6+ih] = DeltaPhi(values[kTPCRPtree+ih], values[kVZERORP+iVZEROside*6+ih]);
-          values[kTPCRPres+iVZEROside*6+ih] = TMath::Cos(values[kTPCRPres+iVZEROside*6+ih]*(ih+1));
-	}
-      }
-     // cout<<values[kCentVZERO]<<" "<<values[kCentSPD]<<" "<<values[kVtxZ]<<" "<<values[kTPCRPres+1*6+ih]<<" "<<values[kTPCRPres+0*6+ih]<<" "<<values[kVZERORPres+ih]<<endl;
-//      cout<<values[kTPCRPres+0*6+ih]<<endl;
-//      cout<<values[kTPCRPres+1*6+ih]<<endl;
-//      cout<<values[kVZERORPres+ih]<<endl;
-      //resolution of V0A, V0C or TPC as reference detector
-      if(fgOptionEventRes && (fgUsedVars[kVZEROARPres+ih]||fgUsedVars[kVZEROCRPres+ih]||fgUsedVars[kVZEROTPCRPres+ih])){
-         
-         if(values[kTPCRPres+1*6+ih]>1.0e-7 && values[kTPCRPres+0*6+ih]>1.0e-7 && values[kVZERORPres+ih]>1.0e-7){
-    
-          values[kVZEROARPres+ih] = TMath::Sqrt(values[kTPCRPres+1*6+ih]/(values[kVZERORPres + ih]*values[kTPCRPres+0*6+ih]));
-          values[kVZEROCRPres+ih] = TMath::Sqrt(values[kTPCRPres+0*6+ih]/(values[kVZERORPres + ih]*values[kTPCRPres+1*6+ih]));
-          values[kVZEROTPCRPres+ih] = TMath::Sqrt(values[kVZERORPres+ih]/(values[kTPCRPres+0*6 + ih]*values[kTPCRPres+1*6+ih]));
-        }
-        else{
-          values[kVZEROARPres+ih]=0;
-          values[kVZEROCRPres+ih]=0;
-          values[kVZEROTPCRPres+ih]=0;
-        }
-    }//end if fgOptionEventRes
-     
-  }// end loop over harmonics
-  
- 
-     
-    
-   
-  
-  if(eventF) {
-   for(Int_t ih=0; ih<6; ++ih) {
-     // VZERO event plane variables
-     values[kVZEROQvecX+2*6+ih] = 0.0;
-     values[kVZEROQvecY+2*6+ih] = 0.0;
-     values[kVZERORP   +2*6+ih] = 0.0;
-     for(Int_t iVZEROside=0; iVZEROside<2; ++iVZEROside) {
-       values[kVZEROQvecX+iVZEROside*6+ih] = eventF->Qx(EVENTPLANE::kVZEROA+iVZEROside, ih+1);
-       values[kVZEROQvecY+iVZEROside*6+ih] = eventF->Qy(EVENTPLANE::kVZEROA+iVZEROside, ih+1);
-       if(fgUsedVars[kVZERORP+iVZEROside*6+ih]) 
-        values[kVZERORP+iVZEROside*6+ih] = eventF->EventPlane(EVENTPLANE::kVZEROA+iVZEROside, ih+1);
-	if(fgUsedVars[kVZEROQvecX+2*6+ih])
-	  values[kVZEROQvecX+2*6+ih] += values[kVZEROQvecX+iVZEROside*6+ih];
-	if(fgUsedVars[kVZEROQvecY+2*6+ih])
-	  values[kVZEROQvecY+2*6+ih] += values[kVZEROQvecY+iVZEROside*6+ih];
-	// cos(n(EPtpc-EPvzero A/C))	
-        if(fgUsedVars[kTPCRPres+iVZEROside*6+ih]) {
-	  values[kTPCRPres+iVZEROside*6+ih] = DeltaPhi(eventF->EventPlane(EVENTPLANE::kTPC, ih+1), eventF->EventPlane(EVENTPLANE::kVZEROA+iVZEROside, ih+1));
-          values[kTPCRPres+iVZEROside*6+ih] = TMath::Cos(values[kTPCRPres+iVZEROside*6+ih]*(ih+1));
-	}
-      }
-      
-      if(fgUsedVars[kVZEROQaQcSP+ih]) {
-        values[kVZEROQaQcSP+ih] = TMath::Cos((ih+1)*(values[kVZERORP+0*6+ih]-values[kVZERORP+1*6+ih]));
-        values[kVZEROQaQcSP+ih] *= TMath::Sqrt(values[kVZEROQvecX+0*6+ih]*values[kVZEROQvecX+0*6+ih]+
-                                               values[kVZEROQvecY+0*6+ih]*values[kVZEROQvecY+0*6+ih]);
-        values[kVZEROQaQcSP+ih] *= TMath::Sqrt(values[kVZEROQvecX+1*6+ih]*values[kVZEROQvecX+1*6+ih]+
-                                               values[kVZEROQvecY+1*6+ih]*values[kVZEROQvecY+1*6+ih]);
-      }
-      values[kVZEROQaQcSPsine+ih] = TMath::Sin((ih+1)*(values[kVZERORP+0*6+ih]-values[kVZERORP+1*6+ih]));
-      values[kVZEROQaQcSPsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+0*6+ih]*values[kVZEROQvecX+0*6+ih]+
-                                             values[kVZEROQvecY+0*6+ih]*values[kVZEROQvecY+0*6+ih]);
-      values[kVZEROQaQcSPsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+1*6+ih]*values[kVZEROQvecX+1*6+ih]+
-                                             values[kVZEROQvecY+1*6+ih]*values[kVZEROQvecY+1*6+ih]);
-      values[kVZERORP   +2*6+ih] = TMath::ATan2(values[kVZEROQvecY+2*6+ih],values[kVZEROQvecX+2*6+ih])/Double_t(ih+1);
-      // cos (n*(psi_A-psi_C))
-      if(fgUsedVars[kVZERORPres + ih]) {
-	values[kVZERORPres + ih] = DeltaPhi(eventF->EventPlane(EVENTPLANE::kVZEROA, ih+1), 
-					    eventF->EventPlane(EVENTPLANE::kVZEROC, ih+1));
-        values[kVZERORPres + ih] = TMath::Cos(values[kVZERORPres + ih]*(ih+1));
-      }
-      // Qx,Qy correlations for VZERO
-      if(fgUsedVars[kVZEROXaXc+ih]) 
-	values[kVZEROXaXc+ih] = eventF->Qx(EVENTPLANE::kVZEROA, ih+1)*eventF->Qx(EVENTPLANE::kVZEROC, ih+1);
-      if(fgUsedVars[kVZEROXaYa+ih]) 
-	values[kVZEROXaYa+ih] = eventF->Qx(EVENTPLANE::kVZEROA, ih+1)*eventF->Qy(EVENTPLANE::kVZEROA, ih+1);
-      if(fgUsedVars[kVZEROXaYc+ih]) 
-	values[kVZEROXaYc+ih] = eventF->Qx(EVENTPLANE::kVZEROA, ih+1)*eventF->Qy(EVENTPLANE::kVZEROC, ih+1);
-      if(fgUsedVars[kVZEROYaXc+ih]) 
-	values[kVZEROYaXc+ih] = eventF->Qy(EVENTPLANE::kVZEROA, ih+1)*eventF->Qx(EVENTPLANE::kVZEROC, ih+1);
-      if(fgUsedVars[kVZEROYaYc+ih]) 
-	values[kVZEROYaYc+ih] = eventF->Qy(EVENTPLANE::kVZEROA, ih+1)*eventF->Qy(EVENTPLANE::kVZEROC, ih+1);
-      if(fgUsedVars[kVZEROXcYc+ih]) 
-	values[kVZEROXcYc+ih] = eventF->Qx(EVENTPLANE::kVZEROC, ih+1)*eventF->Qy(EVENTPLANE::kVZEROC, ih+1);
-      // Psi_A - Psi_C
-      if(fgUsedVars[kVZEROdeltaRPac+ih])
-        values[kVZEROdeltaRPac+ih] = DeltaPhi(eventF->EventPlane(EVENTPLANE::kVZEROA, ih+1), 
-	  				      eventF->EventPlane(EVENTPLANE::kVZEROC, ih+1));
-      
-      // TPC event plane
-      values[kTPCQvecX+ih] = eventF->Qx(EVENTPLANE::kTPC, ih+1);
-      values[kTPCQvecY+ih] = eventF->Qy(EVENTPLANE::kTPC, ih+1);
-      if(fgUsedVars[kTPCRP+ih]) 
-	values[kTPCRP+ih] = eventF->EventPlane(EVENTPLANE::kTPC, ih+1);
-      // TPC VZERO Q-vector correlations
-      if(fgUsedVars[kRPXtpcXvzeroa+ih]) 
-	values[kRPXtpcXvzeroa+ih] = values[kTPCQvecX+ih]*values[kVZEROQvecX+ih];
-      if(fgUsedVars[kRPXtpcXvzeroc+ih]) 
-	values[kRPXtpcXvzeroc+ih] = values[kTPCQvecX+ih]*values[kVZEROQvecX+6+ih];
-      if(fgUsedVars[kRPYtpcYvzeroa+ih]) 
-	values[kRPYtpcYvzeroa+ih] = values[kTPCQvecY+ih]*values[kVZEROQvecY+ih];
-      if(fgUsedVars[kRPYtpcYvzeroc+ih]) 
-	values[kRPYtpcYvzeroc+ih] = values[kTPCQvecY+ih]*values[kVZEROQvecY+6+ih];
-      if(fgUsedVars[kRPXtpcYvzeroa+ih]) 
-	values[kRPXtpcYvzeroa+ih] = values[kTPCQvecX+ih]*values[kVZEROQvecY+ih];
-      if(fgUsedVars[kRPXtpcYvzeroc+ih]) 
-	values[kRPXtpcYvzeroc+ih] = values[kTPCQvecX+ih]*values[kVZEROQvecY+6+ih];
-      if(fgUsedVars[kRPYtpcXvzeroa+ih]) 
-	values[kRPYtpcXvzeroa+ih] = values[kTPCQvecY+ih]*values[kVZEROQvecX+ih];
-      if(fgUsedVars[kRPYtpcXvzeroc+ih]) 
-	values[kRPYtpcXvzeroc+ih] = values[kTPCQvecY+ih]*values[kVZEROQvecX+6+ih];
-      // Psi_TPC - Psi_VZERO A/C      
-      if(fgUsedVars[kRPdeltaVZEROAtpc+ih]) 
-	values[kRPdeltaVZEROAtpc+ih] = DeltaPhi(values[kVZERORP+0*6+ih], values[kTPCRP+ih]);
-      if(fgUsedVars[kRPdeltaVZEROCtpc+ih])
-        values[kRPdeltaVZEROCtpc+ih] = DeltaPhi(values[kVZERORP+1*6+ih], values[kTPCRP+ih]);
-      // TPC event planes with sub-event method
-      values[kTPCQvecXleft+ih] = eventF->Qx(EVENTPLANE::kTPCneg, ih+1);
-      values[kTPCQvecYleft+ih] = eventF->Qy(EVENTPLANE::kTPCneg, ih+1);
-      if(fgUsedVars[kTPCRPleft+ih])
-	values[kTPCRPleft+ih] = eventF->EventPlane(EVENTPLANE::kTPCneg, ih+1);
-      values[kTPCQvecXright+ih] = eventF->Qx(EVENTPLANE::kTPCpos, ih+1);
-      values[kTPCQvecYright+ih] = eventF->Qy(EVENTPLANE::kTPCpos, ih+1);
-      if(fgUsedVars[kTPCRPright+ih])
-        values[kTPCRPright+ih] = eventF->EventPlane(EVENTPLANE::kTPCpos, ih+1); 
-      if(fgUsedVars[kTPCsubResCos+ih]) 
-	values[kTPCsubResCos+ih] = TMath::Cos(Double_t(ih+1)*(values[kTPCRPleft+ih]-values[kTPCRPright+ih]));
-    }  // end loop over harmonics
-    
-    // VZERO v2 using TPC event plane
-    Double_t vzeroChannelPhi[8] = {0.3927, 1.1781, 1.9635, 2.7489, -2.7489, -1.9635, -1.1781, -0.3927};
-    
-    for(Int_t ich=0; ich<64; ++ich) {
-      if(fgUsedVars[kVZEROflowV2TPC+ich])
-	values[kVZEROflowV2TPC+ich] = values[kVZEROChannelMult+ich]*
-                                      TMath::Cos(2.0*DeltaPhi(vzeroChannelPhi[ich%8],values[kTPCRP+1]));
-    } 
-  }  // end if (eventF)
-    
-  for(Int_t izdc=0;izdc<10;++izdc) values[kZDCnEnergyCh+izdc] = event->EnergyZDCnTree(izdc);
-  for(Int_t izdc=0;izdc<10;++izdc) values[kZDCpEnergyCh+izdc] = event->EnergyZDCpTree(izdc);
-  for(Int_t itzero=0;itzero<26;++itzero) values[kTZEROAmplitudeCh+itzero] = event->AmplitudeTZEROch(itzero);
-  for(Int_t itzero=0;itzero<3;++itzero) values[kTZEROTOF+itzero] = event->EventTZEROStartTimeTOFfirst(itzero);
-  for(Int_t itzero=0;itzero<3;++itzero) values[kTZEROTOFbest+itzero] = event->EventTZEROStartTimeTOFbest(itzero);
-  values[kTZEROzVtx] = event->VertexTZERO();
-  values[kTZEROstartTime] = event->EventTZEROStartTime();
-  values[kTZEROpileup] = event->IsPileupTZERO();
-  values[kTZEROsatellite] = event->IsSatteliteCollisionTZERO();  
+    
+  for(Int_t izdc=0;izdc<10;++izdc) values[kZDCnEnergyCh+izdc] = event->EnergyZDCnTree(izdc);
+  for(Int_t izdc=0;izdc<10;++izdc) values[kZDCpEnergyCh+izdc] = event->EnergyZDCpTree(izdc);
+  for(Int_t itzero=0;itzero<26;++itzero) values[kTZEROAmplitudeCh+itzero] = event->AmplitudeTZEROch(itzero);
+  for(Int_t itzero=0;itzero<3;++itzero) values[kTZEROTOF+itzero] = event->EventTZEROStartTimeTOFfirst(itzero);
+  for(Int_t itzero=0;itzero<3;++itzero) values[kTZEROTOFbest+itzero] = event->EventTZEROStartTimeTOFbest(itzero);
+  values[kTZEROzVtx] = event->VertexTZERO();
+  values[kTZEROstartTime] = event->EventTZEROStartTime();
+  values[kTZEROpileup] = event->IsPileupTZERO();
+  values[kTZEROsatellite] = event->IsSatteliteCollisionTZERO();  
 
   values[kMultEstimatorV0M]          = event->MultEstimatorV0M();
   values[kMultEstimatorV0A]          = event->MultEstimatorV0A();
@@ -1210,7 +798,9 @@ void AliReducedVarManager::FillEventInfo(BASEEVENT* baseEvent, Float_t* values,
   values[kMultEstimatorPercentileSPDTracklets] = event->MultEstimatorPercentileSPDTracklets();
   values[kMultEstimatorPercentileRefMult05]    = event->MultEstimatorPercentileRefMult05();
   values[kMultEstimatorPercentileRefMult08]    = event->MultEstimatorPercentileRefMult08();
-
+  
+  // variables filled by the active producers (VZERO and TPC event planes, corrected multiplicities)
+  RunEventProducers(event, values, eventF);
 }
 
 //_________________________________________________________________
@@ -1570,146 +1160,27 @@ void AliReducedVarManager::FillTrackInfo(BASETRACK* p, Float_t* values) {
   }
   values[kCharge] = p->Charge();
   
-  //pair efficiency variables
-  if((fgUsedVars[kPairEff] || fgUsedVars[kOneOverPairEff] || fgUsedVars[kOneOverPairEffSq]) && fgPairEffMap) {
-    Int_t binX = 0;
-    if (fgEffMapVarDependencyX!=kNothing) {
-      binX = fgPairEffMap->GetXaxis()->FindBin(values[fgEffMapVarDependencyX]);
-      if(binX==0) binX = 1;
-      if(binX==fgPairEffMap->GetXaxis()->GetNbins()+1) binX -= 1;
-    }
-    Int_t binY = 0;
-    if (fgEffMapVarDependencyY!=kNothing) {
-      binY = fgPairEffMap->GetYaxis()->FindBin(values[fgEffMapVarDependencyY]);
-      if(binY==0) binY = 1;
-      if(binY==fgPairEffMap->GetXaxis()->GetNbins()+1) binY -= 1;
-    }
-    Int_t binZ = 0;
-    if (fgEffMapVarDependencyZ!=kNothing) {
-      binZ = fgPairEffMap->GetZaxis()->FindBin(values[fgEffMapVarDependencyZ]);
-      if(binZ==0) binZ = 1;
-      if(binZ==fgPairEffMap->GetZaxis()->GetNbins()+1) binZ -= 1;
-    }
+  // pair efficiency and flow variables
+  RunTrackProducers(kBaseTrackStage, values);
 
-    Float_t                   pairEff = 1.;
-    if (binX && binY && binZ) pairEff = fgPairEffMap->GetBinContent(binX, binY, binZ);
-    else if (binX && binY)    pairEff = fgPairEffMap->GetBinContent(binX, binY);
-    else if (binX)            pairEff = fgPairEffMap->GetBinContent(binX);
+  if(p->IsA()!=TRACK::Class()) return;
+  TRACK* pinfo = (TRACK*)p;
 
-    Float_t               oneOverPairEff = 1.;
-    if (pairEff > 1.0e-6) oneOverPairEff = 1/pairEff;
+  values[kPtTPC]       = pinfo->PtTPC();
+  values[kTrackLength] = pinfo->TrackLength();
+  values[kChi2TPCConstrainedVsGlobal] = pinfo->Chi2TPCConstrainedVsGlobal();
+  values[kMassUsedForTracking] = pinfo->MassForTracking();
+  values[kPhiTPC]      = pinfo->PhiTPC();
+  values[kEtaTPC]      = pinfo->EtaTPC();
+  values[kPin]         = pinfo->Pin();
+  values[kDcaXY]       = pinfo->DCAxy();
+  values[kDcaZ]        = pinfo->DCAz();
+  values[kDcaXYTPC]    = pinfo->DCAxyTPC();
+  values[kDcaZTPC]     = pinfo->DCAzTPC();
 
-    values[kPairEff]          = pairEff;
-    values[kOneOverPairEff]   = oneOverPairEff;
-    values[kOneOverPairEffSq] = oneOverPairEff*oneOverPairEff;
-  }
-
-  // Fill VZERO flow variables
-  for(Int_t iVZEROside=0; iVZEROside<3; ++iVZEROside) {
-     for(Int_t ih=0; ih<6; ++ih) {
-        if(fgUsedVars[kVZEROFlowVn+iVZEROside*6+ih])
-           values[kVZEROFlowVn+iVZEROside*6+ih] = TMath::Cos((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
-        if(fgUsedVars[kVZEROFlowSine+iVZEROside*6+ih])
-           values[kVZEROFlowSine+iVZEROside*6+ih] = TMath::Sin((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
-        if(iVZEROside<2) {
-           if(fgUsedVars[kVZEROuQ+iVZEROside*6+ih]) {
-              values[kVZEROuQ+iVZEROside*6+ih] = TMath::Cos((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
-              values[kVZEROuQ+iVZEROside*6+ih] *= TMath::Sqrt(values[kVZEROQvecX+iVZEROside*6+ih]*values[kVZEROQvecX+iVZEROside*6+ih] +
-              values[kVZEROQvecY+iVZEROside*6+ih]*values[kVZEROQvecY+iVZEROside*6+ih]); 
-           }
-           if(fgUsedVars[kVZEROuQsine+iVZEROside*6+ih]) {
-              values[kVZEROuQsine+iVZEROside*6+ih] = TMath::Sin((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
-              values[kVZEROuQsine+iVZEROside*6+ih] *= TMath::Sqrt(values[kVZEROQvecX+iVZEROside*6+ih]*values[kVZEROQvecX+iVZEROside*6+ih] +
-              values[kVZEROQvecY+iVZEROside*6+ih]*values[kVZEROQvecY+iVZEROside*6+ih]); 
-           }	    
-        }
-     }  // end loop over harmonics
-  }  // end loop over VZERO sides
-  
-  // Fill TPC flow variables
-  // Subtract the q vector of the track or of the pair legs from the event q-vector 
-  Bool_t tpcEPUsed = kFALSE;
-  for(Int_t ih=0; ih<6; ++ih) {
-     if(fgUsedVars[kTPCFlowVn+ih]) {tpcEPUsed = kTRUE; break;}
-     if(fgUsedVars[kTPCFlowSine+ih]) {tpcEPUsed = kTRUE; break;}
-     if(fgUsedVars[kTPCuQ+ih]) {tpcEPUsed = kTRUE; break;}
-     if(fgUsedVars[kTPCuQsine+ih]) {tpcEPUsed = kTRUE; break;}
-  }
-
-  if(tpcEPUsed) {
-//      Float_t tpcEPsubtracted[6] = {0.0};
-//      Double_t qVec[6][2] = {{0.0}};
-//      for(Int_t ih=0; ih<6; ++ih) {qVec[ih][0]=values[kTPCQvecXtotal+ih]; qVec[ih][1]=values[kTPCQvecYtotal+ih];}
-//      EVENT* eventInfo = NULL;
-//      if(fgEvent->IsA()==EVENT::Class()) eventInfo = (EVENT*)fgEvent;
-//      if((p->IsA() == AliReducedTrackInfo::Class()) && eventInfo) {
-//         eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)p,qVec,EVENTPLANE::kTPC,-0.8,-0.5*fgkTPCQvecRapGap);
-//         eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)p,qVec,EVENTPLANE::kTPC,0.5*fgkTPCQvecRapGap,0.8);
-//      }
-
-     // TODO: Make sure the pair legs are properly subtracted from the TPC event plane calculation
-     //              For the moment this part of the code is commented out
-     /* else if((p->IsA() == AliReducedPairInfo::Class()) && eventInfo) {
-        cout<<"id  "<<((AliReducedPairInfo*)p)->LegId(1)<<endl;
-        eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(0)),qVec,EVENTPLANE::kTPC,-0.8,-0.5*fgkTPCQvecRapGap);
-        eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(0)),qVec,EVENTPLANE::kTPC,0.5*fgkTPCQvecRapGap,0.8);
-        eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(1)),qVec,EVENTPLANE::kTPC,-0.8,-0.5*fgkTPCQvecRapGap);
-        eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(1)),qVec,EVENTPLANE::kTPC,0.5*fgkTPCQvecRapGap,0.8);
-     }  */
-     // recalculate the TPC event plane
-//      for(Int_t ih=0; ih<6;++ih) 
-//         tpcEPsubtracted[ih] = TMath::ATan2(qVec[ih][1], qVec[ih][0])/Double_t(ih+1);
-//      for(Int_t ih=0; ih<6; ++ih) {
-//         // vn using Psi_n
-//         if(fgUsedVars[kTPCFlowVn+ih])
-//            values[kTPCFlowVn+ih] = TMath::Cos(DeltaPhi(values[kPhi],tpcEPsubtracted[ih])*(ih+1));
-//         if(fgUsedVars[kTPCFlowSine+ih]) 
-//            values[kTPCFlowSine+ih] = TMath::Sin(DeltaPhi(values[kPhi],tpcEPsubtracted[ih])*(ih+1));
-//         if(fgUsedVars[kTPCuQ+ih]) {
-//            values[kTPCuQ+ih] = TMath::Cos((values[kPhi]-tpcEPsubtracted[ih])*(ih+1));
-//            values[kTPCuQ+ih] *= TMath::Sqrt(qVec[ih][0]*qVec[ih][0] + qVec[ih][1]*qVec[ih][1]);
-//         }
-//         if(fgUsedVars[kTPCuQsine+ih]) {
-//            values[kTPCuQsine+ih] = TMath::Sin((values[kPhi]-tpcEPsubtracted[ih])*(ih+1));
-//            values[kTPCuQsine+ih] *= TMath::Sqrt(qVec[ih][0]*qVec[ih][0] + qVec[ih][1]*qVec[ih][1]);
-//         }
-//      }
-
-        for(Int_t ih=0; ih<6; ++ih) {
-        // vn using Psi_n
-        if(fgUsedVars[kTPCFlowVn+ih])
-           values[kTPCFlowVn+ih] = TMath::Cos(DeltaPhi(values[kPhi],values[kTPCRPtree+ih])*(ih+1));
-        if(fgUsedVars[kTPCFlowSine+ih]) 
-           values[kTPCFlowSine+ih] = TMath::Sin(DeltaPhi(values[kPhi],values[kTPCRPtree+ih])*(ih+1));
-        if(fgUsedVars[kTPCuQ+ih]) {
-           values[kTPCuQ+ih] = TMath::Cos((values[kPhi]-values[kTPCRPtree+ih])*(ih+1));
-           values[kTPCuQ+ih] *= TMath::Sqrt(values[kVZEROQvecX+ih]*values[kVZEROQvecX+ih] + values[kVZEROQvecY+ih]*values[kVZEROQvecY+ih]);
-        }
-        if(fgUsedVars[kTPCuQsine+ih]) {
-           values[kTPCuQsine+ih] = TMath::Sin((values[kPhi]-values[kTPCRPtree+ih])*(ih+1));
-           values[kTPCuQsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+ih]*values[kVZEROQvecX+ih] + values[kVZEROQvecY+ih]*values[kVZEROQvecY+ih]);
-        }
-     }
-  }
-
-  if(p->IsA()!=TRACK::Class()) return;
-  TRACK* pinfo = (TRACK*)p;
-
-  values[kPtTPC]       = pinfo->PtTPC();
-  values[kTrackLength] = pinfo->TrackLength();
-  values[kChi2TPCConstrainedVsGlobal] = pinfo->Chi2TPCConstrainedVsGlobal();
-  values[kMassUsedForTracking] = pinfo->MassForTracking();
-  values[kPhiTPC]      = pinfo->PhiTPC();
-  values[kEtaTPC]      = pinfo->EtaTPC();
-  values[kPin]         = pinfo->Pin();
-  values[kDcaXY]       = pinfo->DCAxy();
-  values[kDcaZ]        = pinfo->DCAz();
-  values[kDcaXYTPC]    = pinfo->DCAxyTPC();
-  values[kDcaZTPC]     = pinfo->DCAzTPC();
-
-  if(fgUsedVars[kITSncls]) values[kITSncls] = pinfo->ITSncls();
-  values[kITSsignal] = pinfo->ITSsignal();
-  values[kITSchi2] = pinfo->ITSchi2();
+  if(fgUsedVars[kITSncls]) values[kITSncls] = pinfo->ITSncls();
+  values[kITSsignal] = pinfo->ITSsignal();
+  values[kITSchi2] = pinfo->ITSchi2();
 
   if(fgUsedVars[kITSnclsShared]) values[kITSnclsShared] = pinfo->ITSnSharedCls();
   values[kTPCncls] = pinfo->TPCncls();
@@ -1770,71 +1241,8 @@ void AliReducedVarManager::FillTrackInfo(BASETRACK* p, Float_t* values) {
     values[kTOFnSig+specie] = pinfo->TOFnSig(specie);
     values[kBayes+specie]   = pinfo->GetBayesProb(specie);
   }
-  if(fgUsedVars[kTPCnSigCorrected+kElectron] && fgTPCelectronCentroidMap && fgTPCelectronWidthMap) {
-     Int_t binX = fgTPCelectronCentroidMap->GetXaxis()->FindBin(values[fgVarDependencyX]);
-     if(binX==0) binX = 1;
-     if(binX==fgTPCelectronCentroidMap->GetXaxis()->GetNbins()+1) binX -= 1;
-     Int_t binY = fgTPCelectronCentroidMap->GetYaxis()->FindBin(values[fgVarDependencyY]);
-     if(binY==0) binY=1;
-     if(binY==fgTPCelectronCentroidMap->GetYaxis()->GetNbins()+1) binY -= 1;
-     Float_t centroid = fgTPCelectronCentroidMap->GetBinContent(binX, binY);
-     Float_t width = fgTPCelectronWidthMap->GetBinContent(binX, binY);
-     if(TMath::Abs(width)<1.0e-6) width = 1.;
-     values[kTPCnSigCorrected+kElectron] = (values[kTPCnSig+kElectron] - centroid)/width;
-  }
-  
-  
-  if(fgUsedVars[kTPCnSigCorrected+kElectron] && fgTPCpidCalibCentroid[0] && fgTPCpidCalibWidth[0] && fgTPCpidCalibStatus[0]) {
-     Int_t bin[4];
-     for(Int_t i=0; i<4; i++) {
-        bin[i] = fgTPCpidCalibCentroid[0]->GetAxis(i)->FindBin(values[fgTPCpidCalibVars[i]]);
-        if(bin[i]==0) bin[i] = 1;
-        if(bin[i]==fgTPCpidCalibCentroid[0]->GetAxis(i)->GetNbins()+1) bin[i] -= 1;
-     }
-     Int_t status = fgTPCpidCalibStatus[0]->GetBinContent(bin);
-     if(status<0) {
-        values[kTPCnSigCorrected+kElectron] = -999.0;
-     }
-     else {
-        Float_t centroid = fgTPCpidCalibCentroid[0]->GetBinContent(bin);
-        Float_t width = fgTPCpidCalibWidth[0]->GetBinContent(bin);
-        values[kTPCnSigCorrected+kElectron] = (values[kTPCnSig+kElectron] - centroid)/width;
-     }
-  }
-  if(fgUsedVars[kTPCnSigCorrected+kPion] && fgTPCpidCalibCentroid[1] && fgTPCpidCalibWidth[1] && fgTPCpidCalibStatus[1]) {
-     Int_t bin[4];
-     for(Int_t i=0; i<4; i++) {
-        bin[i] = fgTPCpidCalibCentroid[1]->GetAxis(i)->FindBin(values[fgTPCpidCalibVars[i]]);
-        if(bin[i]==0) bin[i] = 1;
-        if(bin[i]==fgTPCpidCalibCentroid[1]->GetAxis(i)->GetNbins()+1) bin[i] -= 1;
-     }
-     Int_t status = fgTPCpidCalibStatus[1]->GetBinContent(bin);
-     if(status<0) {
-        values[kTPCnSigCorrected+kPion] = -999.0;
-     }
-     else {
-        Float_t centroid = fgTPCpidCalibCentroid[1]->GetBinContent(bin);
-        Float_t width = fgTPCpidCalibWidth[1]->GetBinContent(bin);
-        values[kTPCnSigCorrected+kPion] = (values[kTPCnSig+kPion] - centroid)/width;
-     }
-  }
-  if(fgUsedVars[kTPCnSigCorrected+kProton] && fgTPCpidCalibCentroid[2] && fgTPCpidCalibWidth[2] && fgTPCpidCalibStatus[2]) {
-     Int_t bin[4];
-     for(Int_t i=0; i<4; i++) {
-        bin[i] = fgTPCpidCalibCentroid[2]->GetAxis(i)->FindBin(values[fgTPCpidCalibVars[i]]);
-        if(bin[i]==0) bin[i] = 1;
-        if(bin[i]==fgTPCpidCalibCentroid[2]->GetAxis(i)->GetNbins()+1) bin[i] -= 1;
-     }
-     Int_t status = fgTPCpidCalibStatus[2]->GetBinContent(bin);
-     if(status<0) {
-        values[kTPCnSigCorrected+kProton] = -999.0;
-     }
-     else {
-        Float_t centroid = fgTPCpidCalibCentroid[2]->GetBinContent(bin);
-        Float_t width = fgTPCpidCalibWidth[2]->GetBinContent(bin);
-        values[kTPCnSigCorrected+kProton] = (values[kTPCnSig+kProton] - centroid)/width;
-     }        
-  }
+  // recalibrated TPC n-sigma
+  RunTrackProducers(kTrackStage, values);
 
   values[kTRDpidProbabilitiesLQ1D]   = pinfo->TRDpidLQ1D(0);
   values[kTRDpidProbabilitiesLQ1D+1] = pinfo->TRDpidLQ1D(1);
@@ -2114,12 +1522,8 @@ void AliReducedVarManager::FillPairInfo(BASETRACK* t1, BASETRACK* t2, Int_t type
 
   FillTrackInfo(&p, values);
   
-  // polarization variables
-  Bool_t usePolarization=kFALSE;
-  if(fgUsedVars[kPairThetaCS] || fgUsedVars[kPairThetaHE] || fgUsedVars[kPairPhiCS] || fgUsedVars[kPairPhiHE])
-    usePolarization = kTRUE;
-  if(usePolarization)
-    GetThetaPhiCM(t1, t2, values[kPairThetaHE], values[kPairPhiHE], values[kPairThetaCS], values[kPairPhiCS]);
+  // polarization, decay length and phiV variables
+  RunPairProducers(t1, t2, type, values);
   
   if(fgUsedVars[kDMA] && (t1->IsA()==TRACK::Class()) && (t2->IsA()==TRACK::Class())) {
      TRACK* ti1=(TRACK*)t1; TRACK* ti2=(TRACK*)t2;
@@ -2137,20 +1541,6 @@ void AliReducedVarManager::FillPairInfo(BASETRACK* t1, BASETRACK* t2, Int_t type
     values[kPairLegITSchi2+1] = ti2->ITSchi2();
   }
   
-  if((fgUsedVars[kPseudoProperDecayTime] || fgUsedVars[kPairLxy]) &&  
-     (t1->IsA()==TRACK::Class()) && (t2->IsA()==TRACK::Class()) && 
-     (fgEvent->IsA()==EVENT::Class())) {
-     TRACK* ti1=(TRACK*)t1; 
-     TRACK* ti2=(TRACK*)t2;
-     AliKFParticle pairKF = BuildKFcandidate(ti1,m1,ti2,m2);
-     Double_t errPseudoProperTime2;
-     EVENT* eventInfo = (EVENT*)fgEvent;
-     AliKFParticle primVtx = BuildKFvertex(eventInfo);
-     if(fgUsedVars[kPseudoProperDecayTime]) 
-        values[kPseudoProperDecayTime] = pairKF.GetPseudoProperDecayTime(primVtx, fgkPairMass[type], &errPseudoProperTime2);
-     if(fgUsedVars[kPairLxy]) values[kPairLxy] =  ( (pairKF.X() - primVtx.X())*p.Px() + (pairKF.Y() - primVtx.Y())*p.Py() )/p.Pt(); // = values[kPseudoProperDecayTime]*(p.Pt()/PAIR::fgkPairMass[type]);
-  }
-
   if ((fgUsedVars[kPairLegEMCALmatchedEnergy] || fgUsedVars[kPairLegEMCALmatchedEnergy+1]) &&
       (t1->IsA()==TRACK::Class()) && (t2->IsA()==TRACK::Class())) {
     TRACK* ti1=(TRACK*)t1;
@@ -2207,117 +1597,6 @@ void AliReducedVarManager::FillPairInfo(BASETRACK* t1, BASETRACK* t2, Int_t type
      if(fgUsedVars[kRapMCAbs]) values[kRapMCAbs] = TMath::Abs(pMC.Rapidity());
   }
 
-   if( fgUsedVars[kPairPhiV] ){
-    // implementation taken from AliDielectronPair.cxx
-    Double_t px1=-9999.,py1=-9999.,pz1=-9999.;
-    Double_t px2=-9999.,py2=-9999.,pz2=-9999.;
-
-    if (t1->Charge()*t2->Charge() > 0.) { // Like Sign
-      if(values[kL3Polarity]<0){ // inverted behaviour
-        if(t1->Charge()>0){
-          px1 = t1->Px();   py1 = t1->Py();   pz1 = t1->Pz();
-          px2 = t2->Px();   py2 = t2->Py();   pz2 = t2->Pz();
-        }else{
-          px1 = t2->Px();   py1 = t2->Py();   pz1 = t2->Pz();
-          px2 = t1->Px();   py2 = t1->Py();   pz2 = t1->Pz();
-        }
-      }else{
-        if(t1->Charge()>0){
-          px1 = t2->Px();   py1 = t2->Py();   pz1 = t2->Pz();
-          px2 = t1->Px();   py2 = t1->Py();   pz2 = t1->Pz();
-        }else{
-          px1 = t1->Px();   py1 = t1->Py();   pz1 = t1->Pz();
-          px2 = t2->Px();   py2 = t2->Py();   pz2 = t2->Pz();
-        }
-      }
-    }
-    else { // Unlike Sign
-      if(values[kL3Polarity]>0){ // regular behaviour
-        if(t1->Charge()>0){
-          px1 = t1->Px();
-          py1 = t1->Py();
-          pz1 = t1->Pz();
-
-          px2 = t2->Px();
-          py2 = t2->Py();
-          pz2 = t2->Pz();
-        }else{
-          px1 = t2->Px();
-          py1 = t2->Py();
-          pz1 = t2->Pz();
-
-          px2 = t1->Px();
-          py2 = t1->Py();
-          pz2 = t1->Pz();
-        }
-      }else{
-        if(t1->Charge()>0){
-          px1 = t2->Px();
-          py1 = t2->Py();
-          pz1 = t2->Pz();
-
-          px2 = t1->Px();
-          py2 = t1->Py();
-          pz2 = t1->Pz();
-        }else{
-          px1 = t1->Px();
-          py1 = t1->Py();
-          pz1 = t1->Pz();
-
-          px2 = t2->Px();
-          py2 = t2->Py();
-          pz2 = t2->Pz();
-        }
-      }
-    }
-
-    Double_t px = px1+px2;
-    Double_t py = py1+py2;
-    Double_t pz = pz1+pz2;
-    Double_t dppair = TMath::Sqrt(px*px+py*py+pz*pz);
-
-    //unit vector of (pep+pem)
-    Double_t pl = dppair;
-    Double_t ux = px/pl;
-    Double_t uy = py/pl;
-    Double_t uz = pz/pl;
-    Double_t ax = uy/TMath::Sqrt(ux*ux+uy*uy);
-    Double_t ay = -ux/TMath::Sqrt(ux*ux+uy*uy);
-
-    //momentum of e+ and e- in (ax,ay,az) axis. Note that az=0 by definition.
-    //Double_t ptep = iep->Px()*ax + iep->Py()*ay;
-    //Double_t ptem = iem->Px()*ax + iem->Py()*ay;
-
-    Double_t pxep = px1;
-    Double_t pyep = py1;
-    Double_t pzep = pz1;
-    Double_t pxem = px2;
-    Double_t pyem = py2;
-    Double_t pzem = pz2;
-
-    //vector product of pep X pem
-    Double_t vpx = pyep*pzem - pzep*pyem;
-    Double_t vpy = pzep*pxem - pxep*pzem;
-    Double_t vpz = pxep*pyem - pyep*pxem;
-    Double_t vp = sqrt(vpx*vpx+vpy*vpy+vpz*vpz);
-
-    //unit vector of pep X pem
-    Double_t vx = vpx/vp;
-    Double_t vy = vpy/vp;
-    Double_t vz = vpz/vp;
-
-    //The third axis defined by vector product (ux,uy,uz)X(vx,vy,vz)
-    Double_t wx = uy*vz - uz*vy;
-    Double_t wy = uz*vx - ux*vz;
-    // by construction, (wx,wy,wz) must be a unit vector.
-    // measure angle between (wx,wy,wz) and (ax,ay,0). The angle between them
-    // should be small if the pair is conversion
-    // this function then returns values close to pi!
-    Double_t cosPhiV = wx*ax + wy*ay;
-    Double_t phiv = TMath::ACos(cosPhiV);
-    values[kPairPhiV] = phiv;
-  }
-
   if( fgUsedVars[kPairOpeningAngle] ){
     TVector3 v1(t1->Px(), t1->Py(), t1->Pz());
     TVector3 v2(t2->Px(), t2->Py(), t2->Pz());
@@ -2738,6 +2017,1006 @@ void AliReducedVarManager::GetThetaPhiCM(BASETRACK* leg1, BASETRACK* leg2,
   }
 }
 
+//__________________________________________________________________
+void AliReducedVarManager::CompileProducers(Bool_t allProducers /*=kFALSE*/) {
+  //
+  // Compile the ordered lists of producers needed by the used variables.
+  // A producer is active if one of its variables is used or if an active producer depends on it.
+  // With allProducers all the producers are run, which is the behaviour before any variable is set as used.
+  //
+  for(Int_t ip=0; ip<kNProducers; ++ip) {
+    fgProducerActive[ip] = allProducers;
+    for(Int_t ir=0; ir<fgkProducers[ip].fNRanges && !fgProducerActive[ip]; ++ir) {
+      for(Int_t var=fgkProducers[ip].fRanges[ir][0]; var<fgkProducers[ip].fRanges[ir][1]; ++var) {
+        if(fgUsedVars[var]) {fgProducerActive[ip] = kTRUE; break;}
+      }
+    }
+  }
+  // producers depend only on producers placed before them in the registry, so a single backward pass
+  // activates all the dependencies
+  for(Int_t ip=kNProducers-1; ip>=0; --ip) {
+    if(!fgProducerActive[ip]) continue;
+    for(Int_t id=0; id<fgkProducers[ip].fNDependencies; ++id)
+      fgProducerActive[fgkProducers[ip].fDependencies[id]] = kTRUE;
+  }
+  for(Int_t is=0; is<kNProducerStages; ++is) fgNProducers[is] = 0;
+  for(Int_t ip=0; ip<kNProducers; ++ip) {
+    if(!fgProducerActive[ip]) continue;
+    Int_t stage = fgkProducers[ip].fStage;
+    fgProducerList[stage][fgNProducers[stage]++] = ip;
+  }
+  fgProducersCompiled = kTRUE;
+}
+
+//__________________________________________________________________
+Int_t AliReducedVarManager::GetVariableProducer(Int_t var) {
+  //
+  // Return the producer filling the variable var, -1 if the variable is filled directly
+  //
+  for(Int_t ip=0; ip<kNProducers; ++ip) {
+    for(Int_t ir=0; ir<fgkProducers[ip].fNRanges; ++ir)
+      if(var>=fgkProducers[ip].fRanges[ir][0] && var<fgkProducers[ip].fRanges[ir][1]) return ip;
+  }
+  return -1;
+}
+
+//__________________________________________________________________
+const Char_t* AliReducedVarManager::GetProducerName(Int_t producer) {
+  //
+  // Return the name of the producer
+  //
+  if(producer<0 || producer>=kNProducers) return "";
+  return fgkProducers[producer].fName;
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ResetProducerTiming() {
+  //
+  // Reset the time spent and the number of calls of the producers
+  //
+  for(Int_t ip=0; ip<kNProducers; ++ip) {
+    fgProducerTime[ip] = 0.;
+    fgProducerCalls[ip] = 0;
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::PrintProducers() {
+  //
+  // Print the active producers, in execution order, with the time spent in each of them
+  // (filled only if SetProducerTiming(kTRUE) was called)
+  //
+  if(!fgProducersCompiled) CompileProducers(kTRUE);
+  const Char_t* stageNames[kNProducerStages] = {"event", "base track", "track", "pair"};
+  cout << "AliReducedVarManager::PrintProducers() Active producers:" << endl;
+  for(Int_t is=0; is<kNProducerStages; ++is) {
+    cout << "  " << stageNames[is] << " stage: " << fgNProducers[is] << " producers" << endl;
+    for(Int_t i=0; i<fgNProducers[is]; ++i) {
+      Int_t ip = fgProducerList[is][i];
+      cout << "    " << fgkProducers[ip].fName;
+      if(fgProducerTiming) {
+        cout << "   calls: " << fgProducerCalls[ip] << "   time: " << fgProducerTime[ip] << " s";
+        if(fgProducerCalls[ip]>0) cout << "   (" << 1.0e+6*fgProducerTime[ip]/fgProducerCalls[ip] << " us/call)";
+      }
+      cout << endl;
+    }
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::RunEventProducers(EVENT* event, Float_t* values, EVENTPLANE* eventF) {
+  //
+  // Run the active event producers
+  //
+  if(!fgProducersCompiled) CompileProducers(kTRUE);
+  for(Int_t i=0; i<fgNProducers[kEventStage]; ++i) {
+    Int_t producer = fgProducerList[kEventStage][i];
+    std::chrono::steady_clock::time_point start;
+    if(fgProducerTiming) start = std::chrono::steady_clock::now();
+    switch(producer) {
+      case kCorrectedMultiplicityProducer: ProduceCorrectedMultiplicities(values); break;
+      case kVZEROChannelProducer:          ProduceVZEROChannels(event, values); break;
+      case kVZEROQvectorProducer:          ProduceVZEROQvectors(event, values); break;
+      case kTPCEventPlaneTreeProducer:     ProduceTPCEventPlaneTree(event, values); break;
+      case kTPCVZEROCorrelationProducer:   ProduceTPCVZEROCorrelations(values); break;
+      case kEventPlaneFriendProducer:      if(eventF) ProduceEventPlaneFriend(eventF, values); break;
+      case kVZEROFlowV2TPCProducer:        if(eventF) ProduceVZEROFlowV2TPC(values); break;
+      default: break;
+    }
+    if(fgProducerTiming) {
+      fgProducerTime[producer] += std::chrono::duration<Double_t>(std::chrono::steady_clock::now()-start).count();
+      fgProducerCalls[producer] += 1;
+    }
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::RunTrackProducers(Int_t stage, Float_t* values) {
+  //
+  // Run the active base track (all tracks and pairs) or track (AliReducedTrackInfo only) producers
+  //
+  if(!fgProducersCompiled) CompileProducers(kTRUE);
+  for(Int_t i=0; i<fgNProducers[stage]; ++i) {
+    Int_t producer = fgProducerList[stage][i];
+    std::chrono::steady_clock::time_point start;
+    if(fgProducerTiming) start = std::chrono::steady_clock::now();
+    switch(producer) {
+      case kPairEfficiencyProducer:      ProducePairEfficiency(values); break;
+      case kVZEROFlowProducer:           ProduceVZEROFlow(values); break;
+      case kTPCFlowProducer:             ProduceTPCFlow(values); break;
+      case kTPCnSigmaCorrectionProducer: ProduceTPCnSigmaCorrections(values); break;
+      default: break;
+    }
+    if(fgProducerTiming) {
+      fgProducerTime[producer] += std::chrono::duration<Double_t>(std::chrono::steady_clock::now()-start).count();
+      fgProducerCalls[producer] += 1;
+    }
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::RunPairProducers(BASETRACK* t1, BASETRACK* t2, Int_t type, Float_t* values) {
+  //
+  // Run the active pair producers
+  //
+  if(!fgProducersCompiled) CompileProducers(kTRUE);
+  for(Int_t i=0; i<fgNProducers[kPairStage]; ++i) {
+    Int_t producer = fgProducerList[kPairStage][i];
+    std::chrono::steady_clock::time_point start;
+    if(fgProducerTiming) start = std::chrono::steady_clock::now();
+    switch(producer) {
+      case kPairPolarizationProducer: ProducePairPolarization(t1, t2, values); break;
+      case kPairDecayLengthProducer:  ProducePairDecayLength(t1, t2, type, values); break;
+      case kPairPhiVProducer:         ProducePairPhiV(t1, t2, values); break;
+      default: break;
+    }
+    if(fgProducerTiming) {
+      fgProducerTime[producer] += std::chrono::duration<Double_t>(std::chrono::steady_clock::now()-start).count();
+      fgProducerCalls[producer] += 1;
+    }
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceCorrectedMultiplicities(Float_t* values) {
+  //
+  // Vertex and gain loss corrected multiplicities
+  //
+  for( Int_t iEstimator = 0; iEstimator < kNMultiplicityEstimators; ++iEstimator){
+    Int_t estimator = kMultiplicity + iEstimator;
+    if( fgAvgMultVsVtxAndRun[iEstimator] ){
+      Int_t vtxBin = fgAvgMultVsVtxAndRun[iEstimator]->GetYaxis()->FindBin( values[kVtxZ] );
+      Int_t runBin = fgAvgMultVsVtxAndRun[iEstimator]->GetXaxis()->FindBin( values[kRunID] );
+      Double_t multRaw = values[ estimator ];
+      for( Int_t iCorrection = 0; iCorrection < kNCorrections; ++iCorrection  ){
+        for(Int_t iReference = 0 ; iReference <  kNReferenceMultiplicities; ++iReference ){
+          Int_t indexNotSmeared = GetCorrectedMultiplicity( estimator, iCorrection, iReference, kNoSmearing );
+          Int_t indexSmeared    = GetCorrectedMultiplicity( estimator, iCorrection, iReference, kPoissonSmearing );
+          Double_t multCorr        = multRaw;
+          Double_t multCorrSmeared = multRaw;
+    // apply vertex and gain loss correction simultaneously
+          if( iCorrection == kVertexCorrection2D  ){
+            Double_t localAvg = fgAvgMultVsVtxAndRun[iEstimator]->GetBinContent( runBin, vtxBin );
+            Double_t refMult  = fgRefMultVsVtxAndRun[iEstimator][iReference];
+            multCorr *=  localAvg ?  refMult / localAvg : 1.;
+            Double_t deltaM =  localAvg ?  multRaw * ( refMult/localAvg - 1) : 0.;
+            multCorrSmeared += (deltaM>0 ? 1. : -1.) * gRandom->Poisson(TMath::Abs(deltaM));
+          }
+          else{
+    // first apply vertex correction
+            Double_t localAvgVsVtx , refMultVsVtx  ;
+            switch( iCorrection ){
+              case kVertexCorrectionGlobal:
+              case kVertexCorrectionGlobalGainLoss:
+                localAvgVsVtx = fgAvgMultVsVtxGlobal[iEstimator]->GetBinContent( vtxBin );
+                refMultVsVtx  = fgRefMultVsVtxGlobal[iEstimator][iReference];
+                break;
+              case kVertexCorrectionRunwise:
+              case kVertexCorrectionRunwiseGainLoss:
+                localAvgVsVtx = fgAvgMultVsVtxRunwise[iEstimator]->GetBinContent( vtxBin );
+                refMultVsVtx  = fgRefMultVsVtxRunwise[iEstimator][iReference];
+                break;
+              default:
+                localAvgVsVtx = 0.;
+                refMultVsVtx  = 0.;
+                break;  
+            }
+            multCorr        *= localAvgVsVtx > 0. ? refMultVsVtx / localAvgVsVtx : 1.;
+            Double_t deltaM  = localAvgVsVtx > 0. ? multRaw  * ( refMultVsVtx/localAvgVsVtx - 1) : 0.;
+            multCorrSmeared += (deltaM>0 ? 1. : -1.) * gRandom->Poisson(TMath::Abs(deltaM));
+    // then apply gain loss correction
+            if( iCorrection == kVertexCorrectionGlobalGainLoss || 
+                iCorrection == kVertexCorrectionRunwiseGainLoss || 
+                iCorrection == kGainLossCorrection   ){
+              Double_t localAvgVsRun = fgAvgMultVsRun[iEstimator]->GetBinContent( runBin );
+              Double_t refMultVsRun  = fgRefMultVsRun[iEstimator][iReference];
+              multCorr        *= localAvgVsRun ? refMultVsRun / localAvgVsRun : 1.;
+              deltaM           = localAvgVsRun ? multCorrSmeared  * ( refMultVsRun/localAvgVsRun - 1) : 0;
+              multCorrSmeared += (deltaM>0 ? 1. : -1.) * gRandom->Poisson(TMath::Abs(deltaM));
+            }
+          }
+          values[ indexNotSmeared ] = multCorr;
+          values[ indexSmeared ]    = multCorrSmeared;
+          fgUsedVars [indexNotSmeared] = kTRUE;
+          fgUsedVars [indexSmeared] = kTRUE;
+        }
+      }
+    }
+    else if( ( estimator == kVZEROACTotalMult && fgAvgMultVsVtxAndRun[kVZEROATotalMult-kMultiplicity] && fgAvgMultVsVtxAndRun[kVZEROCTotalMult-kMultiplicity]  )  
+      || (estimator == kSPDnTracklets10EtaVtxCorr && fgAvgMultVsVtxAndRun[kSPDntrackletsEtaBin-kMultiplicity] ) ){
+      for( Int_t iCorrection = 0; iCorrection < kNCorrections; ++iCorrection  ){
+        for(Int_t iReference = 0 ; iReference <  kNReferenceMultiplicities; ++iReference ){
+          Int_t indexNotSmeared = GetCorrectedMultiplicity( estimator, iCorrection, iReference, kNoSmearing );
+          Int_t indexSmeared    = GetCorrectedMultiplicity( estimator, iCorrection, iReference, kPoissonSmearing );
+          values[indexNotSmeared] = 0.;
+          values[indexSmeared] = 0.;
+          if( estimator == kSPDnTracklets10EtaVtxCorr ){
+            for( Int_t ieta=6; ieta<26; ++ieta ) {
+              Int_t vtxBin = fgAvgMultVsVtxAndRun[kSPDntrackletsEtaBin+ieta-kMultiplicity]->GetYaxis()->FindBin( values[kVtxZ] );
+              if( fgAvgMultVsVtxGlobal[kSPDntrackletsEtaBin+ieta-kMultiplicity]->GetBinContent( vtxBin ) > .3 ){
+                Int_t indexBinNotSmeared = GetCorrectedMultiplicity( kSPDntrackletsEtaBin+ieta, iCorrection, iReference, kNoSmearing );
+                Int_t indexBinSmeared    = GetCorrectedMultiplicity( kSPDntrackletsEtaBin+ieta, iCorrection, iReference, kPoissonSmearing );
+                if( fgUsedVars[indexBinNotSmeared]) values[ indexNotSmeared ] += values[ indexBinNotSmeared ];
+                if( fgUsedVars[indexBinSmeared]) values[ indexSmeared ] += values[ indexBinSmeared ];
+              }
+            }
+          }
+          else{
+            Int_t indexAnotSmeared = GetCorrectedMultiplicity( kVZEROATotalMult, iCorrection, iReference, kNoSmearing );
+            Int_t indexCnotSmeared = GetCorrectedMultiplicity( kVZEROCTotalMult, iCorrection, iReference, kNoSmearing );
+
+            Int_t indexAsmeared = GetCorrectedMultiplicity( kVZEROATotalMult, iCorrection, iReference, kPoissonSmearing );
+            Int_t indexCsmeared = GetCorrectedMultiplicity( kVZEROCTotalMult, iCorrection, iReference, kPoissonSmearing );
+
+            values[ indexNotSmeared ] = values[ indexAnotSmeared ] + values[ indexCnotSmeared ];
+            values[ indexSmeared ]    = values[ indexAsmeared ]    + values[ indexCsmeared ];
+          }
+        }
+      }
+    }
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceVZEROChannels(EVENT* event, Float_t* values) {
+  //
+  // VZERO channel multiplicities and pseudo-rapidities
+  //
+  values[kVZEROAemptyChannels] = 0;
+  values[kVZEROCemptyChannels] = 0;
+  for(Int_t ich=0;ich<64;++ich) fgUsedVars[kVZEROChannelMult+ich] = kTRUE; 
+  Float_t theta=0.0;
+  for(Int_t ich=0;ich<64;++ich) {
+    if(fgUsedVars[kVZEROChannelMult+ich]) {
+      values[kVZEROChannelMult+ich] = event->MultChannelVZERO(ich);
+      if(values[kVZEROChannelMult+ich]<fgkVZEROminMult) {
+        fgUsedVars[kVZEROChannelMult+ich] = kFALSE;   // will not be filled in histograms by the histogram manager
+        if(ich<32) values[kVZEROCemptyChannels] += 1;
+        else values[kVZEROAemptyChannels] += 1;
+      }
+    }
+    if(fgUsedVars[kVZEROChannelEta+ich]) {
+      if(ich<32) theta = TMath::ATan(fgkVZEROChannelRadii[ich]/(fgkVZEROCz-values[kVtxZ]));
+      else theta = TMath::Pi()-TMath::ATan(fgkVZEROChannelRadii[ich]/(fgkVZEROAz-values[kVtxZ]));
+      values[kVZEROChannelEta+ich] = -1.0*TMath::Log(TMath::Tan(theta/2.0));
+    }
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceVZEROQvectors(EVENT* event, Float_t* values) {
+  //
+  // VZERO Q-vectors from the channel multiplicities
+  //
+  if(fgUsedVars[kVZEROQvecX+0*6+1] || fgUsedVars[kVZEROQvecY+0*6+1] || fgUsedVars[kVZERORP+0*6+1]) {
+    Double_t qvecVZEROA[EVENTPLANE::fgkNMaxHarmonics][2] = {{0.0}};
+    Double_t qvecVZEROC[EVENTPLANE::fgkNMaxHarmonics][2] = {{0.0}};
+    if(fgOptionCalibrateVZEROqVec && fgAvgVZEROChannelMult[0]) {
+       Float_t calibVZEROMult[64] = {0.};
+       Float_t refMult=0;
+      for(Int_t ich=0;ich<64;++ich) fgUsedVars[kVZEROChannelMultCalib+ich] = kTRUE; 
+       
+      for(Int_t iCh=0; iCh<64; ++iCh) {
+         if(event->MultChannelVZERO(iCh)>=fgkVZEROminMult) {
+                         
+            Float_t avMult = fgAvgVZEROChannelMult[iCh]->GetBinContent(fgAvgVZEROChannelMult[iCh]->FindBin(event->Vertex(2), event->CentralitySPD()));
+            Int_t refCh = iCh-(iCh%8);
+            if(iCh==refCh)
+                refMult=fgAvgVZEROChannelMult[iCh]->GetBinContent(fgAvgVZEROChannelMult[iCh]->GetXaxis()->FindBin(0.0),fgAvgVZEROChannelMult[iCh]->GetYaxis()->FindBin(event->CentralitySPD()));
+            
+            calibVZEROMult[iCh] = event->MultChannelVZERO(iCh) / (avMult>1.0e-6 ? avMult : 1.0)*refMult;
+            values[kVZEROChannelMultCalib+iCh]=calibVZEROMult[iCh];
+            
+          //  cout<<"V0 channel"<<" "<<iCh<<" "<<"Reference Channel "<<refCh<<" "<<"Reference multiplicity"<<refMult<<"Avg mult"<<avMult<<" "<<values[kVZEROChannelMult+iCh]<<" "<<values[kVZEROChannelMultCalib+iCh]<<endl;
+            
+         }
+         else
+             fgUsedVars[kVZEROChannelMultCalib+iCh] = kFALSE; // will not be filled in histograms by the histogram manager
+      }
+      event->GetVZEROQvector(qvecVZEROA, EVENTPLANE::kVZEROA, calibVZEROMult);
+      event->GetVZEROQvector(qvecVZEROC, EVENTPLANE::kVZEROC, calibVZEROMult);
+      
+     
+    }
+    else {
+      event->GetVZEROQvector(qvecVZEROA, EVENTPLANE::kVZEROA);
+      event->GetVZEROQvector(qvecVZEROC, EVENTPLANE::kVZEROC);
+    }
+    if(fgOptionRecenterVZEROqVec && fgVZEROqVecRecentering[0]) {
+         Float_t recenterOffset = fgVZEROqVecRecentering[0]->GetBinContent(fgVZEROqVecRecentering[0]->FindBin(event->CentralitySPD(), event->Vertex(2)));
+         Float_t widthEqVZERO = fgVZEROqVecRecentering[0]->GetBinError(fgVZEROqVecRecentering[0]->FindBin(event->CentralitySPD(), event->Vertex(2)));
+
+         qvecVZEROA[1][0] -= recenterOffset;
+           if(widthEqVZERO >0.0)
+             qvecVZEROA[1][0] /=widthEqVZERO;
+           else
+             qvecVZEROA[1][0]=0;
+                
+        recenterOffset = fgVZEROqVecRecentering[1]->GetBinContent(fgVZEROqVecRecentering[1]->FindBin(event->CentralitySPD(), event->Vertex(2)));
+        widthEqVZERO = fgVZEROqVecRecentering[1]->GetBinError(fgVZEROqVecRecentering[1]->FindBin(event->CentralitySPD(), event->Vertex(2)));
+        qvecVZEROA[1][1] -= recenterOffset;
+           if(widthEqVZERO >0.0)
+              qvecVZEROA[1][1] /=widthEqVZERO;
+           else
+            qvecVZEROA[1][1]=0;
+          
+        recenterOffset = fgVZEROqVecRecentering[2]->GetBinContent(fgVZEROqVecRecentering[2]->FindBin(event->CentralitySPD(), event->Vertex(2)));
+        widthEqVZERO = fgVZEROqVecRecentering[2]->GetBinError(fgVZEROqVecRecentering[2]->FindBin(event->CentralitySPD(), event->Vertex(2)));
+        qvecVZEROC[1][0] -= recenterOffset;
+           if(widthEqVZERO >0.0)
+              qvecVZEROC[1][0] /=widthEqVZERO;
+           else
+              qvecVZEROC[1][0]=0;
+       
+        recenterOffset = fgVZEROqVecRecentering[3]->GetBinContent(fgVZEROqVecRecentering[3]->FindBin(event->CentralitySPD(), event->Vertex(2)));
+        widthEqVZERO = fgVZEROqVecRecentering[3]->GetBinError(fgVZEROqVecRecentering[3]->FindBin(event->CentralitySPD(), event->Vertex(2)));
+        qvecVZEROC[1][1] -= recenterOffset;
+           if(widthEqVZERO >0.0)
+              qvecVZEROC[1][1] /=widthEqVZERO;
+           else
+              qvecVZEROC[1][1]=0;
+     
+    }
+    for(Int_t ih=1; ih<2; ++ih) {
+       // VZERO event plane variables
+       values[kVZEROQvecX+0*6+ih] = qvecVZEROA[ih][0];
+       values[kVZEROQvecY+0*6+ih] = qvecVZEROA[ih][1];
+       values[kVZEROQvecX+1*6+ih] = qvecVZEROC[ih][0];
+       values[kVZEROQvecY+1*6+ih] = qvecVZEROC[ih][1];
+       values[kVZERORP+0*6+ih] = TMath::ATan2(qvecVZEROA[ih][1], qvecVZEROA[ih][0])/Double_t(ih+1);
+       values[kVZERORP+1*6+ih] = TMath::ATan2(qvecVZEROC[ih][1], qvecVZEROC[ih][0])/Double_t(ih+1);
+       values[kVZEROQvecX+2*6+ih] = qvecVZEROA[ih][0] + qvecVZEROC[ih][0];
+       values[kVZEROQvecY+2*6+ih] = qvecVZEROA[ih][1] + qvecVZEROC[ih][1];
+       values[kVZERORP   +2*6+ih] = TMath::ATan2(values[kVZEROQvecY+2*6+ih], values[kVZEROQvecX+2*6+ih])/Double_t(ih+1);
+     
+       if(fgUsedVars[kVZEROQaQcSP+ih]) {
+          values[kVZEROQaQcSP+ih] = TMath::Cos((ih+1)*(values[kVZERORP+0*6+ih]-values[kVZERORP+1*6+ih]));
+          values[kVZEROQaQcSP+ih] *= TMath::Sqrt(values[kVZEROQvecX+0*6+ih]*values[kVZEROQvecX+0*6+ih]+
+          values[kVZEROQvecY+0*6+ih]*values[kVZEROQvecY+0*6+ih]);
+          values[kVZEROQaQcSP+ih] *= TMath::Sqrt(values[kVZEROQvecX+1*6+ih]*values[kVZEROQvecX+1*6+ih]+
+          values[kVZEROQvecY+1*6+ih]*values[kVZEROQvecY+1*6+ih]);
+       }
+       values[kVZEROQaQcSPsine+ih] = TMath::Sin((ih+1)*(values[kVZERORP+0*6+ih]-values[kVZERORP+1*6+ih]));
+       values[kVZEROQaQcSPsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+0*6+ih]*values[kVZEROQvecX+0*6+ih]+
+       values[kVZEROQvecY+0*6+ih]*values[kVZEROQvecY+0*6+ih]);
+       values[kVZEROQaQcSPsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+1*6+ih]*values[kVZEROQvecX+1*6+ih]+
+       values[kVZEROQvecY+1*6+ih]*values[kVZEROQvecY+1*6+ih]);
+       values[kVZERORP   +2*6+ih] = TMath::ATan2(values[kVZEROQvecY+2*6+ih],values[kVZEROQvecX+2*6+ih])/Double_t(ih+1);
+       // cos (n*(psi_A-psi_C))
+       if(fgUsedVars[kVZERORPres + ih]) {
+          values[kVZERORPres + ih] = DeltaPhi(values[kVZERORP+0*6+ih], values[kVZERORP+1*6+ih]);
+          values[kVZERORPres + ih] = TMath::Cos(values[kVZERORPres + ih]*(ih+1));
+       }
+       // Qx,Qy correlations for VZERO
+       if(fgUsedVars[kVZEROXaXc+ih]) 
+          values[kVZEROXaXc+ih] = qvecVZEROA[ih][0]*qvecVZEROC[ih][0];
+       if(fgUsedVars[kVZEROXaYa+ih]) 
+          values[kVZEROXaYa+ih] = qvecVZEROA[ih][0]*qvecVZEROA[ih][1];
+       if(fgUsedVars[kVZEROXaYc+ih]) 
+          values[kVZEROXaYc+ih] = qvecVZEROA[ih][0]*qvecVZEROC[ih][1];
+       if(fgUsedVars[kVZEROYaXc+ih]) 
+          values[kVZEROYaXc+ih] = qvecVZEROA[ih][1]*qvecVZEROC[ih][0];
+       if(fgUsedVars[kVZEROYaYc+ih]) 
+          values[kVZEROYaYc+ih] = qvecVZEROA[ih][1]*qvecVZEROC[ih][1];
+       if(fgUsedVars[kVZEROXcYc+ih]) 
+          values[kVZEROXcYc+ih] = qvecVZEROC[ih][0]*qvecVZEROC[ih][1];
+       // Psi_A - Psi_C
+       if(fgUsedVars[kVZEROdeltaRPac+ih])
+          values[kVZEROdeltaRPac+ih] = DeltaPhi(values[kVZERORP+0*6+ih], values[kVZERORP+1*6+ih]);
+    }    // end loop over harmonics
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceTPCEventPlaneTree(EVENT* event, Float_t* values) {
+  //
+  // TPC event plane variables stored in the trees
+  //
+  // Get the TPC event plane in case it was written in the trees 
+  for(Int_t ih=0; ih<3; ++ih) {
+     if(event->GetEventPlaneStatus(EVENTPLANE::kTPC,ih+1)!=EVENTPLANE::kUnset) {
+        values[kTPCQvecXtree+ih] = event->GetQx(EVENTPLANE::kTPC,ih+1);
+        values[kTPCQvecYtree+ih] = event->GetQy(EVENTPLANE::kTPC,ih+1);
+        values[kTPCRPtree+ih] = event->GetEventPlane(EVENTPLANE::kTPC,ih+1);
+        
+          //TPC Q vector recentering       
+          if(fgOptionRecenterTPCqVec && fgTPCqVecRecentering[0] && ih==1) {
+            Float_t recenterOffsetTPC = fgTPCqVecRecentering[0]->GetBinContent(fgTPCqVecRecentering[0]->FindBin(event->CentralityVZERO(), event->Vertex(2)));
+            Double_t widthEqTPC = fgTPCqVecRecentering[0]->GetBinError(fgTPCqVecRecentering[0]->FindBin(event->CentralityVZERO(), event->Vertex(2)));
+            values[kTPCQvecXtree+1] -= recenterOffsetTPC;
+
+                if(widthEqTPC >0.0)
+                   values[kTPCQvecXtree+1] /=widthEqTPC;
+                else
+                   values[kTPCQvecXtree+1]=0;
+                
+            recenterOffsetTPC = fgTPCqVecRecentering[1]->GetBinContent(fgTPCqVecRecentering[1]->FindBin(event->CentralityVZERO(), event->Vertex(2)));
+            widthEqTPC = fgTPCqVecRecentering[1]->GetBinError(fgTPCqVecRecentering[1]->FindBin(event->CentralityVZERO(), event->Vertex(2)));
+            values[kTPCQvecYtree+1] -= recenterOffsetTPC;
+                
+                if(widthEqTPC >0.0)
+                   values[kTPCQvecYtree+1] /=widthEqTPC;
+                else
+                   values[kTPCQvecYtree+1]=0;
+                 
+            values[kTPCRPtree+ih]=TMath::ATan2(values[kTPCQvecYtree+1],values[kTPCQvecXtree+1])/Double_t(ih+1);
+      
+        }
+ 
+     }
+     if(event->GetEventPlaneStatus(EVENTPLANE::kTPCptWeights,ih+1)!=EVENTPLANE::kUnset) {
+        values[kTPCQvecXptWeightsTree+ih] = event->GetQx(EVENTPLANE::kTPCptWeights,ih+1);
+        values[kTPCQvecYptWeightsTree+ih] = event->GetQy(EVENTPLANE::kTPCptWeights,ih+1);
+        values[kTPCRPptWeightsTree+ih] = event->GetEventPlane(EVENTPLANE::kTPCptWeights,ih+1);
+     }
+     if(event->GetEventPlaneStatus(EVENTPLANE::kTPCpos,ih+1)!=EVENTPLANE::kUnset) {
+        values[kTPCQvecXposTree+ih] = event->GetQx(EVENTPLANE::kTPCpos,ih+1);
+        values[kTPCQvecYposTree+ih] = event->GetQy(EVENTPLANE::kTPCpos,ih+1);
+        values[kTPCRPposTree+ih] = event->GetEventPlane(EVENTPLANE::kTPCpos,ih+1);
+     }
+     if(event->GetEventPlaneStatus(EVENTPLANE::kTPCneg,ih+1)!=EVENTPLANE::kUnset) {
+        values[kTPCQvecXnegTree+ih] = event->GetQx(EVENTPLANE::kTPCneg,ih+1);
+        values[kTPCQvecYnegTree+ih] = event->GetQy(EVENTPLANE::kTPCneg,ih+1);
+        values[kTPCRPnegTree+ih] = event->GetEventPlane(EVENTPLANE::kTPCneg,ih+1);
+     }
+  }  // end loop over harmonics
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceTPCVZEROCorrelations(Float_t* values) {
+  //
+  // Correlations and resolutions between the TPC event plane from the trees and the VZERO event planes
+  //
+  for(Int_t ih=0; ih<3; ++ih) {
+      // TPC VZERO Q-vector correlations
+     if(fgUsedVars[kRPXtpcXvzeroa+ih]) 
+	values[kRPXtpcXvzeroa+ih] = values[kTPCQvecXtree+ih]*values[kVZEROQvecX+ih];
+     if(fgUsedVars[kRPXtpcXvzeroc+ih]) 
+	values[kRPXtpcXvzeroc+ih] = values[kTPCQvecXtree+ih]*values[kVZEROQvecX+6+ih];
+     if(fgUsedVars[kRPYtpcYvzeroa+ih]) 
+	values[kRPYtpcYvzeroa+ih] = values[kTPCQvecYtree+ih]*values[kVZEROQvecY+ih];
+     if(fgUsedVars[kRPYtpcYvzeroc+ih]) 
+	values[kRPYtpcYvzeroc+ih] = values[kTPCQvecYtree+ih]*values[kVZEROQvecY+6+ih];
+     if(fgUsedVars[kRPXtpcYvzeroa+ih]) 
+	values[kRPXtpcYvzeroa+ih] = values[kTPCQvecXtree+ih]*values[kVZEROQvecY+ih];
+     if(fgUsedVars[kRPXtpcYvzeroc+ih]) 
+	values[kRPXtpcYvzeroc+ih] = values[kTPCQvecXtree+ih]*values[kVZEROQvecY+6+ih];
+     if(fgUsedVars[kRPYtpcXvzeroa+ih]) 
+	values[kRPYtpcXvzeroa+ih] = values[kTPCQvecYtree+ih]*values[kVZEROQvecX+ih];
+     if(fgUsedVars[kRPYtpcXvzeroc+ih]) 
+	values[kRPYtpcXvzeroc+ih] = values[kTPCQvecYtree+ih]*values[kVZEROQvecX+6+ih];
+      // Psi_TPC - Psi_VZERO A/C      
+     if(fgUsedVars[kRPdeltaVZEROAtpc+ih]) 
+	values[kRPdeltaVZEROAtpc+ih] = DeltaPhi(values[kVZERORP+0*6+ih], values[kTPCRPtree+ih]);
+     if(fgUsedVars[kRPdeltaVZEROCtpc+ih])
+        values[kRPdeltaVZEROCtpc+ih] = DeltaPhi(values[kVZERORP+1*6+ih], values[kTPCRPtree+ih]);
+     
+     
+     // cos(n(EPtpc-EPvzero A/C))
+     for(Int_t iVZEROside=0; iVZEROside<2; ++iVZEROside) {
+          if(fgUsedVars[kTPCRPres+iVZEROside*6+ih]) {
+	  values[kTPCRPres+iVZEROside*6+ih] = DeltaPhi(values[kTPCRPtree+ih], values[kVZERORP+iVZEROside*6+ih]);
+          values[kTPCRPres+iVZEROside*6+ih] = TMath::Cos(values[kTPCRPres+iVZEROside*6+ih]*(ih+1));
+	}
+      }
+     // cout<<values[kCentVZERO]<<" "<<values[kCentSPD]<<" "<<values[kVtxZ]<<" "<<values[kTPCRPres+1*6+ih]<<" "<<values[kTPCRPres+0*6+ih]<<" "<<values[kVZERORPres+ih]<<endl;
+//      cout<<values[kTPCRPres+0*6+ih]<<endl;
+//      cout<<values[kTPCRPres+1*6+ih]<<endl;
+//      cout<<values[kVZERORPres+ih]<<endl;
+      //resolution of V0A, V0C or TPC as reference detector
+      if(fgOptionEventRes && (fgUsedVars[kVZEROARPres+ih]||fgUsedVars[kVZEROCRPres+ih]||fgUsedVars[kVZEROTPCRPres+ih])){
+         
+         if(values[kTPCRPres+1*6+ih]>1.0e-7 && values[kTPCRPres+0*6+ih]>1.0e-7 && values[kVZERORPres+ih]>1.0e-7){
+    
+          values[kVZEROARPres+ih] = TMath::Sqrt(values[kTPCRPres+1*6+ih]/(values[kVZERORPres + ih]*values[kTPCRPres+0*6+ih]));
+          values[kVZEROCRPres+ih] = TMath::Sqrt(values[kTPCRPres+0*6+ih]/(values[kVZERORPres + ih]*values[kTPCRPres+1*6+ih]));
+          values[kVZEROTPCRPres+ih] = TMath::Sqrt(values[kVZERORPres+ih]/(values[kTPCRPres+0*6 + ih]*values[kTPCRPres+1*6+ih]));
+        }
+        else{
+          values[kVZEROARPres+ih]=0;
+          values[kVZEROCRPres+ih]=0;
+          values[kVZEROTPCRPres+ih]=0;
+        }
+    }//end if fgOptionEventRes
+     
+  }// end loop over harmonics
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceEventPlaneFriend(EVENTPLANE* eventF, Float_t* values) {
+  //
+  // Event plane variables from the event plane friend object
+  //
+   for(Int_t ih=0; ih<6; ++ih) {
+     // VZERO event plane variables
+     values[kVZEROQvecX+2*6+ih] = 0.0;
+     values[kVZEROQvecY+2*6+ih] = 0.0;
+     values[kVZERORP   +2*6+ih] = 0.0;
+     for(Int_t iVZEROside=0; iVZEROside<2; ++iVZEROside) {
+       values[kVZEROQvecX+iVZEROside*6+ih] = eventF->Qx(EVENTPLANE::kVZEROA+iVZEROside, ih+1);
+       values[kVZEROQvecY+iVZEROside*6+ih] = eventF->Qy(EVENTPLANE::kVZEROA+iVZEROside, ih+1);
+       if(fgUsedVars[kVZERORP+iVZEROside*6+ih]) 
+        values[kVZERORP+iVZEROside*6+ih] = eventF->EventPlane(EVENTPLANE::kVZEROA+iVZEROside, ih+1);
+	if(fgUsedVars[kVZEROQvecX+2*6+ih])
+	  values[kVZEROQvecX+2*6+ih] += values[kVZEROQvecX+iVZEROside*6+ih];
+	if(fgUsedVars[kVZEROQvecY+2*6+ih])
+	  values[kVZEROQvecY+2*6+ih] += values[kVZEROQvecY+iVZEROside*6+ih];
+	// cos(n(EPtpc-EPvzero A/C))	
+        if(fgUsedVars[kTPCRPres+iVZEROside*6+ih]) {
+	  values[kTPCRPres+iVZEROside*6+ih] = DeltaPhi(eventF->EventPlane(EVENTPLANE::kTPC, ih+1), eventF->EventPlane(EVENTPLANE::kVZEROA+iVZEROside, ih+1));
+          values[kTPCRPres+iVZEROside*6+ih] = TMath::Cos(values[kTPCRPres+iVZEROside*6+ih]*(ih+1));
+	}
+      }
+      
+      if(fgUsedVars[kVZEROQaQcSP+ih]) {
+        values[kVZEROQaQcSP+ih] = TMath::Cos((ih+1)*(values[kVZERORP+0*6+ih]-values[kVZERORP+1*6+ih]));
+        values[kVZEROQaQcSP+ih] *= TMath::Sqrt(values[kVZEROQvecX+0*6+ih]*values[kVZEROQvecX+0*6+ih]+
+                                               values[kVZEROQvecY+0*6+ih]*values[kVZEROQvecY+0*6+ih]);
+        values[kVZEROQaQcSP+ih] *= TMath::Sqrt(values[kVZEROQvecX+1*6+ih]*values[kVZEROQvecX+1*6+ih]+
+                                               values[kVZEROQvecY+1*6+ih]*values[kVZEROQvecY+1*6+ih]);
+      }
+      values[kVZEROQaQcSPsine+ih] = TMath::Sin((ih+1)*(values[kVZERORP+0*6+ih]-values[kVZERORP+1*6+ih]));
+      values[kVZEROQaQcSPsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+0*6+ih]*values[kVZEROQvecX+0*6+ih]+
+                                             values[kVZEROQvecY+0*6+ih]*values[kVZEROQvecY+0*6+ih]);
+      values[kVZEROQaQcSPsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+1*6+ih]*values[kVZEROQvecX+1*6+ih]+
+                                             values[kVZEROQvecY+1*6+ih]*values[kVZEROQvecY+1*6+ih]);
+      values[kVZERORP   +2*6+ih] = TMath::ATan2(values[kVZEROQvecY+2*6+ih],values[kVZEROQvecX+2*6+ih])/Double_t(ih+1);
+      // cos (n*(psi_A-psi_C))
+      if(fgUsedVars[kVZERORPres + ih]) {
+	values[kVZERORPres + ih] = DeltaPhi(eventF->EventPlane(EVENTPLANE::kVZEROA, ih+1), 
+					    eventF->EventPlane(EVENTPLANE::kVZEROC, ih+1));
+        values[kVZERORPres + ih] = TMath::Cos(values[kVZERORPres + ih]*(ih+1));
+      }
+      // Qx,Qy correlations for VZERO
+      if(fgUsedVars[kVZEROXaXc+ih]) 
+	values[kVZEROXaXc+ih] = eventF->Qx(EVENTPLANE::kVZEROA, ih+1)*eventF->Qx(EVENTPLANE::kVZEROC, ih+1);
+      if(fgUsedVars[kVZEROXaYa+ih]) 
+	values[kVZEROXaYa+ih] = eventF->Qx(EVENTPLANE::kVZEROA, ih+1)*eventF->Qy(EVENTPLANE::kVZEROA, ih+1);
+      if(fgUsedVars[kVZEROXaYc+ih]) 
+	values[kVZEROXaYc+ih] = eventF->Qx(EVENTPLANE::kVZEROA, ih+1)*eventF->Qy(EVENTPLANE::kVZEROC, ih+1);
+      if(fgUsedVars[kVZEROYaXc+ih]) 
+	values[kVZEROYaXc+ih] = eventF->Qy(EVENTPLANE::kVZEROA, ih+1)*eventF->Qx(EVENTPLANE::kVZEROC, ih+1);
+      if(fgUsedVars[kVZEROYaYc+ih]) 
+	values[kVZEROYaYc+ih] = eventF->Qy(EVENTPLANE::kVZEROA, ih+1)*eventF->Qy(EVENTPLANE::kVZEROC, ih+1);
+      if(fgUsedVars[kVZEROXcYc+ih]) 
+	values[kVZEROXcYc+ih] = eventF->Qx(EVENTPLANE::kVZEROC, ih+1)*eventF->Qy(EVENTPLANE::kVZEROC, ih+1);
+      // Psi_A - Psi_C
+      if(fgUsedVars[kVZEROdeltaRPac+ih])
+        values[kVZEROdeltaRPac+ih] = DeltaPhi(eventF->EventPlane(EVENTPLANE::kVZEROA, ih+1), 
+	  				      eventF->EventPlane(EVENTPLANE::kVZEROC, ih+1));
+      
+      // TPC event plane
+      values[kTPCQvecX+ih] = eventF->Qx(EVENTPLANE::kTPC, ih+1);
+      values[kTPCQvecY+ih] = eventF->Qy(EVENTPLANE::kTPC, ih+1);
+      if(fgUsedVars[kTPCRP+ih]) 
+	values[kTPCRP+ih] = eventF->EventPlane(EVENTPLANE::kTPC, ih+1);
+      // TPC VZERO Q-vector correlations
+      if(fgUsedVars[kRPXtpcXvzeroa+ih]) 
+	values[kRPXtpcXvzeroa+ih] = values[kTPCQvecX+ih]*values[kVZEROQvecX+ih];
+      if(fgUsedVars[kRPXtpcXvzeroc+ih]) 
+	values[kRPXtpcXvzeroc+ih] = values[kTPCQvecX+ih]*values[kVZEROQvecX+6+ih];
+      if(fgUsedVars[kRPYtpcYvzeroa+ih]) 
+	values[kRPYtpcYvzeroa+ih] = values[kTPCQvecY+ih]*values[kVZEROQvecY+ih];
+      if(fgUsedVars[kRPYtpcYvzeroc+ih]) 
+	values[kRPYtpcYvzeroc+ih] = values[kTPCQvecY+ih]*values[kVZEROQvecY+6+ih];
+      if(fgUsedVars[kRPXtpcYvzeroa+ih]) 
+	values[kRPXtpcYvzeroa+ih] = values[kTPCQvecX+ih]*values[kVZEROQvecY+ih];
+      if(fgUsedVars[kRPXtpcYvzeroc+ih]) 
+	values[kRPXtpcYvzeroc+ih] = values[kTPCQvecX+ih]*values[kVZEROQvecY+6+ih];
+      if(fgUsedVars[kRPYtpcXvzeroa+ih]) 
+	values[kRPYtpcXvzeroa+ih] = values[kTPCQvecY+ih]*values[kVZEROQvecX+ih];
+      if(fgUsedVars[kRPYtpcXvzeroc+ih]) 
+	values[kRPYtpcXvzeroc+ih] = values[kTPCQvecY+ih]*values[kVZEROQvecX+6+ih];
+      // Psi_TPC - Psi_VZERO A/C      
+      if(fgUsedVars[kRPdeltaVZEROAtpc+ih]) 
+	values[kRPdeltaVZEROAtpc+ih] = DeltaPhi(values[kVZERORP+0*6+ih], values[kTPCRP+ih]);
+      if(fgUsedVars[kRPdeltaVZEROCtpc+ih])
+        values[kRPdeltaVZEROCtpc+ih] = DeltaPhi(values[kVZERORP+1*6+ih], values[kTPCRP+ih]);
+      // TPC event planes with sub-event method
+      values[kTPCQvecXleft+ih] = eventF->Qx(EVENTPLANE::kTPCneg, ih+1);
+      values[kTPCQvecYleft+ih] = eventF->Qy(EVENTPLANE::kTPCneg, ih+1);
+      if(fgUsedVars[kTPCRPleft+ih])
+	values[kTPCRPleft+ih] = eventF->EventPlane(EVENTPLANE::kTPCneg, ih+1);
+      values[kTPCQvecXright+ih] = eventF->Qx(EVENTPLANE::kTPCpos, ih+1);
+      values[kTPCQvecYright+ih] = eventF->Qy(EVENTPLANE::kTPCpos, ih+1);
+      if(fgUsedVars[kTPCRPright+ih])
+        values[kTPCRPright+ih] = eventF->EventPlane(EVENTPLANE::kTPCpos, ih+1); 
+      if(fgUsedVars[kTPCsubResCos+ih]) 
+	values[kTPCsubResCos+ih] = TMath::Cos(Double_t(ih+1)*(values[kTPCRPleft+ih]-values[kTPCRPright+ih]));
+    }  // end loop over harmonics
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceVZEROFlowV2TPC(Float_t* values) {
+  //
+  // VZERO v2 using the TPC event plane from the event plane friend object
+  //
+  Double_t vzeroChannelPhi[8] = {0.3927, 1.1781, 1.9635, 2.7489, -2.7489, -1.9635, -1.1781, -0.3927};
+  
+  for(Int_t ich=0; ich<64; ++ich) {
+    if(fgUsedVars[kVZEROflowV2TPC+ich])
+	values[kVZEROflowV2TPC+ich] = values[kVZEROChannelMult+ich]*
+                                    TMath::Cos(2.0*DeltaPhi(vzeroChannelPhi[ich%8],values[kTPCRP+1]));
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProducePairEfficiency(Float_t* values) {
+  //
+  // Pair efficiency variables
+  //
+  if((fgUsedVars[kPairEff] || fgUsedVars[kOneOverPairEff] || fgUsedVars[kOneOverPairEffSq]) && fgPairEffMap) {
+    Int_t binX = 0;
+    if (fgEffMapVarDependencyX!=kNothing) {
+      binX = fgPairEffMap->GetXaxis()->FindBin(values[fgEffMapVarDependencyX]);
+      if(binX==0) binX = 1;
+      if(binX==fgPairEffMap->GetXaxis()->GetNbins()+1) binX -= 1;
+    }
+    Int_t binY = 0;
+    if (fgEffMapVarDependencyY!=kNothing) {
+      binY = fgPairEffMap->GetYaxis()->FindBin(values[fgEffMapVarDependencyY]);
+      if(binY==0) binY = 1;
+      if(binY==fgPairEffMap->GetXaxis()->GetNbins()+1) binY -= 1;
+    }
+    Int_t binZ = 0;
+    if (fgEffMapVarDependencyZ!=kNothing) {
+      binZ = fgPairEffMap->GetZaxis()->FindBin(values[fgEffMapVarDependencyZ]);
+      if(binZ==0) binZ = 1;
+      if(binZ==fgPairEffMap->GetZaxis()->GetNbins()+1) binZ -= 1;
+    }
+
+    Float_t                   pairEff = 1.;
+    if (binX && binY && binZ) pairEff = fgPairEffMap->GetBinContent(binX, binY, binZ);
+    else if (binX && binY)    pairEff = fgPairEffMap->GetBinContent(binX, binY);
+    else if (binX)            pairEff = fgPairEffMap->GetBinContent(binX);
+
+    Float_t               oneOverPairEff = 1.;
+    if (pairEff > 1.0e-6) oneOverPairEff = 1/pairEff;
+
+    values[kPairEff]          = pairEff;
+    values[kOneOverPairEff]   = oneOverPairEff;
+    values[kOneOverPairEffSq] = oneOverPairEff*oneOverPairEff;
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceVZEROFlow(Float_t* values) {
+  //
+  // Flow variables with respect to the VZERO event planes
+  //
+  for(Int_t iVZEROside=0; iVZEROside<3; ++iVZEROside) {
+     for(Int_t ih=0; ih<6; ++ih) {
+        if(fgUsedVars[kVZEROFlowVn+iVZEROside*6+ih])
+           values[kVZEROFlowVn+iVZEROside*6+ih] = TMath::Cos((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
+        if(fgUsedVars[kVZEROFlowSine+iVZEROside*6+ih])
+           values[kVZEROFlowSine+iVZEROside*6+ih] = TMath::Sin((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
+        if(iVZEROside<2) {
+           if(fgUsedVars[kVZEROuQ+iVZEROside*6+ih]) {
+              values[kVZEROuQ+iVZEROside*6+ih] = TMath::Cos((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
+              values[kVZEROuQ+iVZEROside*6+ih] *= TMath::Sqrt(values[kVZEROQvecX+iVZEROside*6+ih]*values[kVZEROQvecX+iVZEROside*6+ih] +
+              values[kVZEROQvecY+iVZEROside*6+ih]*values[kVZEROQvecY+iVZEROside*6+ih]); 
+           }
+           if(fgUsedVars[kVZEROuQsine+iVZEROside*6+ih]) {
+              values[kVZEROuQsine+iVZEROside*6+ih] = TMath::Sin((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
+              values[kVZEROuQsine+iVZEROside*6+ih] *= TMath::Sqrt(values[kVZEROQvecX+iVZEROside*6+ih]*values[kVZEROQvecX+iVZEROside*6+ih] +
+              values[kVZEROQvecY+iVZEROside*6+ih]*values[kVZEROQvecY+iVZEROside*6+ih]); 
+           }	    
+        }
+     }  // end loop over harmonics
+  }  // end loop over VZERO sides
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceTPCFlow(Float_t* values) {
+  //
+  // Flow variables with respect to the TPC event plane
+  //
+  // Subtract the q vector of the track or of the pair legs from the event q-vector 
+  Bool_t tpcEPUsed = kFALSE;
+  for(Int_t ih=0; ih<6; ++ih) {
+     if(fgUsedVars[kTPCFlowVn+ih]) {tpcEPUsed = kTRUE; break;}
+     if(fgUsedVars[kTPCFlowSine+ih]) {tpcEPUsed = kTRUE; break;}
+     if(fgUsedVars[kTPCuQ+ih]) {tpcEPUsed = kTRUE; break;}
+     if(fgUsedVars[kTPCuQsine+ih]) {tpcEPUsed = kTRUE; break;}
+  }
+
+  if(tpcEPUsed) {
+//      Float_t tpcEPsubtracted[6] = {0.0};
+//      Double_t qVec[6][2] = {{0.0}};
+//      for(Int_t ih=0; ih<6; ++ih) {qVec[ih][0]=values[kTPCQvecXtotal+ih]; qVec[ih][1]=values[kTPCQvecYtotal+ih];}
+//      EVENT* eventInfo = NULL;
+//      if(fgEvent->IsA()==EVENT::Class()) eventInfo = (EVENT*)fgEvent;
+//      if((p->IsA() == AliReducedTrackInfo::Class()) && eventInfo) {
+//         eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)p,qVec,EVENTPLANE::kTPC,-0.8,-0.5*fgkTPCQvecRapGap);
+//         eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)p,qVec,EVENTPLANE::kTPC,0.5*fgkTPCQvecRapGap,0.8);
+//      }
+
+     // TODO: Make sure the pair legs are properly subtracted from the TPC event plane calculation
+     //              For the moment this part of the code is commented out
+     /* else if((p->IsA() == AliReducedPairInfo::Class()) && eventInfo) {
+        cout<<"id  "<<((AliReducedPairInfo*)p)->LegId(1)<<endl;
+        eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(0)),qVec,EVENTPLANE::kTPC,-0.8,-0.5*fgkTPCQvecRapGap);
+        eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(0)),qVec,EVENTPLANE::kTPC,0.5*fgkTPCQvecRapGap,0.8);
+        eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(1)),qVec,EVENTPLANE::kTPC,-0.8,-0.5*fgkTPCQvecRapGap);
+        eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(1)),qVec,EVENTPLANE::kTPC,0.5*fgkTPCQvecRapGap,0.8);
+     }  */
+     // recalculate the TPC event plane
+//      for(Int_t ih=0; ih<6;++ih) 
+//         tpcEPsubtracted[ih] = TMath::ATan2(qVec[ih][1], qVec[ih][0])/Double_t(ih+1);
+//      for(Int_t ih=0; ih<6; ++ih) {
+//         // vn using Psi_n
+//         if(fgUsedVars[kTPCFlowVn+ih])
+//            values[kTPCFlowVn+ih] = TMath::Cos(DeltaPhi(values[kPhi],tpcEPsubtracted[ih])*(ih+1));
+//         if(fgUsedVars[kTPCFlowSine+ih]) 
+//            values[kTPCFlowSine+ih] = TMath::Sin(DeltaPhi(values[kPhi],tpcEPsubtracted[ih])*(ih+1));
+//         if(fgUsedVars[kTPCuQ+ih]) {
+//            values[kTPCuQ+ih] = TMath::Cos((values[kPhi]-tpcEPsubtracted[ih])*(ih+1));
+//            values[kTPCuQ+ih] *= TMath::Sqrt(qVec[ih][0]*qVec[ih][0] + qVec[ih][1]*qVec[ih][1]);
+//         }
+//         if(fgUsedVars[kTPCuQsine+ih]) {
+//            values[kTPCuQsine+ih] = TMath::Sin((values[kPhi]-tpcEPsubtracted[ih])*(ih+1));
+//            values[kTPCuQsine+ih] *= TMath::Sqrt(qVec[ih][0]*qVec[ih][0] + qVec[ih][1]*qVec[ih][1]);
+//         }
+//      }
+
+        for(Int_t ih=0; ih<6; ++ih) {
+        // vn using Psi_n
+        if(fgUsedVars[kTPCFlowVn+ih])
+           values[kTPCFlowVn+ih] = TMath::Cos(DeltaPhi(values[kPhi],values[kTPCRPtree+ih])*(ih+1));
+        if(fgUsedVars[kTPCFlowSine+ih]) 
+           values[kTPCFlowSine+ih] = TMath::Sin(DeltaPhi(values[kPhi],values[kTPCRPtree+ih])*(ih+1));
+        if(fgUsedVars[kTPCuQ+ih]) {
+           values[kTPCuQ+ih] = TMath::Cos((values[kPhi]-values[kTPCRPtree+ih])*(ih+1));
+           values[kTPCuQ+ih] *= TMath::Sqrt(values[kVZEROQvecX+ih]*values[kVZEROQvecX+ih] + values[kVZEROQvecY+ih]*values[kVZEROQvecY+ih]);
+        }
+        if(fgUsedVars[kTPCuQsine+ih]) {
+           values[kTPCuQsine+ih] = TMath::Sin((values[kPhi]-values[kTPCRPtree+ih])*(ih+1));
+           values[kTPCuQsine+ih] *= TMath::Sqrt(values[kVZEROQvecX+ih]*values[kVZEROQvecX+ih] + values[kVZEROQvecY+ih]*values[kVZEROQvecY+ih]);
+        }
+     }
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProduceTPCnSigmaCorrections(Float_t* values) {
+  //
+  // Recalibrated TPC n-sigma
+  //
+  if(fgUsedVars[kTPCnSigCorrected+kElectron] && fgTPCelectronCentroidMap && fgTPCelectronWidthMap) {
+     Int_t binX = fgTPCelectronCentroidMap->GetXaxis()->FindBin(values[fgVarDependencyX]);
+     if(binX==0) binX = 1;
+     if(binX==fgTPCelectronCentroidMap->GetXaxis()->GetNbins()+1) binX -= 1;
+     Int_t binY = fgTPCelectronCentroidMap->GetYaxis()->FindBin(values[fgVarDependencyY]);
+     if(binY==0) binY=1;
+     if(binY==fgTPCelectronCentroidMap->GetYaxis()->GetNbins()+1) binY -= 1;
+     Float_t centroid = fgTPCelectronCentroidMap->GetBinContent(binX, binY);
+     Float_t width = fgTPCelectronWidthMap->GetBinContent(binX, binY);
+     if(TMath::Abs(width)<1.0e-6) width = 1.;
+     values[kTPCnSigCorrected+kElectron] = (values[kTPCnSig+kElectron] - centroid)/width;
+  }
+  
+  
+  if(fgUsedVars[kTPCnSigCorrected+kElectron] && fgTPCpidCalibCentroid[0] && fgTPCpidCalibWidth[0] && fgTPCpidCalibStatus[0]) {
+     Int_t bin[4];
+     for(Int_t i=0; i<4; i++) {
+        bin[i] = fgTPCpidCalibCentroid[0]->GetAxis(i)->FindBin(values[fgTPCpidCalibVars[i]]);
+        if(bin[i]==0) bin[i] = 1;
+        if(bin[i]==fgTPCpidCalibCentroid[0]->GetAxis(i)->GetNbins()+1) bin[i] -= 1;
+     }
+     Int_t status = fgTPCpidCalibStatus[0]->GetBinContent(bin);
+     if(status<0) {
+        values[kTPCnSigCorrected+kElectron] = -999.0;
+     }
+     else {
+        Float_t centroid = fgTPCpidCalibCentroid[0]->GetBinContent(bin);
+        Float_t width = fgTPCpidCalibWidth[0]->GetBinContent(bin);
+        values[kTPCnSigCorrected+kElectron] = (values[kTPCnSig+kElectron] - centroid)/width;
+     }
+  }
+  if(fgUsedVars[kTPCnSigCorrected+kPion] && fgTPCpidCalibCentroid[1] && fgTPCpidCalibWidth[1] && fgTPCpidCalibStatus[1]) {
+     Int_t bin[4];
+     for(Int_t i=0; i<4; i++) {
+        bin[i] = fgTPCpidCalibCentroid[1]->GetAxis(i)->FindBin(values[fgTPCpidCalibVars[i]]);
+        if(bin[i]==0) bin[i] = 1;
+        if(bin[i]==fgTPCpidCalibCentroid[1]->GetAxis(i)->GetNbins()+1) bin[i] -= 1;
+     }
+     Int_t status = fgTPCpidCalibStatus[1]->GetBinContent(bin);
+     if(status<0) {
+        values[kTPCnSigCorrected+kPion] = -999.0;
+     }
+     else {
+        Float_t centroid = fgTPCpidCalibCentroid[1]->GetBinContent(bin);
+        Float_t width = fgTPCpidCalibWidth[1]->GetBinContent(bin);
+        values[kTPCnSigCorrected+kPion] = (values[kTPCnSig+kPion] - centroid)/width;
+     }
+  }
+  if(fgUsedVars[kTPCnSigCorrected+kProton] && fgTPCpidCalibCentroid[2] && fgTPCpidCalibWidth[2] && fgTPCpidCalibStatus[2]) {
+     Int_t bin[4];
+     for(Int_t i=0; i<4; i++) {
+        bin[i] = fgTPCpidCalibCentroid[2]->GetAxis(i)->FindBin(values[fgTPCpidCalibVars[i]]);
+        if(bin[i]==0) bin[i] = 1;
+        if(bin[i]==fgTPCpidCalibCentroid[2]->GetAxis(i)->GetNbins()+1) bin[i] -= 1;
+     }
+     Int_t status = fgTPCpidCalibStatus[2]->GetBinContent(bin);
+     if(status<0) {
+        values[kTPCnSigCorrected+kProton] = -999.0;
+     }
+     else {
+        Float_t centroid = fgTPCpidCalibCentroid[2]->GetBinContent(bin);
+        Float_t width = fgTPCpidCalibWidth[2]->GetBinContent(bin);
+        values[kTPCnSigCorrected+kProton] = (values[kTPCnSig+kProton] - centroid)/width;
+     }        
+  }
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProducePairPolarization(BASETRACK* t1, BASETRACK* t2, Float_t* values) {
+  //
+  // Polarization angles in the Collins-Soper and helicity frames
+  //
+  if(!(fgUsedVars[kPairThetaCS] || fgUsedVars[kPairThetaHE] || fgUsedVars[kPairPhiCS] || fgUsedVars[kPairPhiHE])) return;
+  GetThetaPhiCM(t1, t2, values[kPairThetaHE], values[kPairPhiHE], values[kPairThetaCS], values[kPairPhiCS]);
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProducePairDecayLength(BASETRACK* t1, BASETRACK* t2, Int_t type, Float_t* values) {
+  //
+  // KF pseudo-proper decay time and Lxy of the pair
+  //
+  if(!(fgUsedVars[kPseudoProperDecayTime] || fgUsedVars[kPairLxy])) return;
+  if(!fgEvent) return;
+  if((t1->IsA()!=TRACK::Class()) || (t2->IsA()!=TRACK::Class()) || (fgEvent->IsA()!=EVENT::Class())) return;
+  Float_t m1 = 0.0; Float_t m2 = 0.0;
+  GetLegMassAssumption(type,m1,m2);
+  PAIR p;
+  p.PxPyPz(t1->Px()+t2->Px(), t1->Py()+t2->Py(), t1->Pz()+t2->Pz());
+  TRACK* ti1=(TRACK*)t1; 
+  TRACK* ti2=(TRACK*)t2;
+  AliKFParticle pairKF = BuildKFcandidate(ti1,m1,ti2,m2);
+  Double_t errPseudoProperTime2;
+  EVENT* eventInfo = (EVENT*)fgEvent;
+  AliKFParticle primVtx = BuildKFvertex(eventInfo);
+  if(fgUsedVars[kPseudoProperDecayTime]) 
+     values[kPseudoProperDecayTime] = pairKF.GetPseudoProperDecayTime(primVtx, fgkPairMass[type], &errPseudoProperTime2);
+  if(fgUsedVars[kPairLxy]) values[kPairLxy] =  ( (pairKF.X() - primVtx.X())*p.Px() + (pairKF.Y() - primVtx.Y())*p.Py() )/p.Pt(); // = values[kPseudoProperDecayTime]*(p.Pt()/PAIR::fgkPairMass[type]);
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::ProducePairPhiV(BASETRACK* t1, BASETRACK* t2, Float_t* values) {
+  //
+  // Angle between the pair plane and the magnetic field
+  //
+  if(!fgUsedVars[kPairPhiV]) return;
+  // implementation taken from AliDielectronPair.cxx
+  Double_t px1=-9999.,py1=-9999.,pz1=-9999.;
+  Double_t px2=-9999.,py2=-9999.,pz2=-9999.;
+
+  if (t1->Charge()*t2->Charge() > 0.) { // Like Sign
+    if(values[kL3Polarity]<0){ // inverted behaviour
+      if(t1->Charge()>0){
+        px1 = t1->Px();   py1 = t1->Py();   pz1 = t1->Pz();
+        px2 = t2->Px();   py2 = t2->Py();   pz2 = t2->Pz();
+      }else{
+        px1 = t2->Px();   py1 = t2->Py();   pz1 = t2->Pz();
+        px2 = t1->Px();   py2 = t1->Py();   pz2 = t1->Pz();
+      }
+    }else{
+      if(t1->Charge()>0){
+        px1 = t2->Px();   py1 = t2->Py();   pz1 = t2->Pz();
+        px2 = t1->Px();   py2 = t1->Py();   pz2 = t1->Pz();
+      }else{
+        px1 = t1->Px();   py1 = t1->Py();   pz1 = t1->Pz();
+        px2 = t2->Px();   py2 = t2->Py();   pz2 = t2->Pz();
+      }
+    }
+  }
+  else { // Unlike Sign
+    if(values[kL3Polarity]>0){ // regular behaviour
+      if(t1->Charge()>0){
+        px1 = t1->Px();
+        py1 = t1->Py();
+        pz1 = t1->Pz();
+
+        px2 = t2->Px();
+        py2 = t2->Py();
+        pz2 = t2->Pz();
+      }else{
+        px1 = t2->Px();
+        py1 = t2->Py();
+        pz1 = t2->Pz();
+
+        px2 = t1->Px();
+        py2 = t1->Py();
+        pz2 = t1->Pz();
+      }
+    }else{
+      if(t1->Charge()>0){
+        px1 = t2->Px();
+        py1 = t2->Py();
+        pz1 = t2->Pz();
+
+        px2 = t1->Px();
+        py2 = t1->Py();
+        pz2 = t1->Pz();
+      }else{
+        px1 = t1->Px();
+        py1 = t1->Py();
+        pz1 = t1->Pz();
+
+        px2 = t2->Px();
+        py2 = t2->Py();
+        pz2 = t2->Pz();
+      }
+    }
+  }
+
+  Double_t px = px1+px2;
+  Double_t py = py1+py2;
+  Double_t pz = pz1+pz2;
+  Double_t dppair = TMath::Sqrt(px*px+py*py+pz*pz);
+
+  //unit vector of (pep+pem)
+  Double_t pl = dppair;
+  Double_t ux = px/pl;
+  Double_t uy = py/pl;
+  Double_t uz = pz/pl;
+  Double_t ax = uy/TMath::Sqrt(ux*ux+uy*uy);
+  Double_t ay = -ux/TMath::Sqrt(ux*ux+uy*uy);
+
+  //momentum of e+ and e- in (ax,ay,az) axis. Note that az=0 by definition.
+  //Double_t ptep = iep->Px()*ax + iep->Py()*ay;
+  //Double_t ptem = iem->Px()*ax + iem->Py()*ay;
+
+  Double_t pxep = px1;
+  Double_t pyep = py1;
+  Double_t pzep = pz1;
+  Double_t pxem = px2;
+  Double_t pyem = py2;
+  Double_t pzem = pz2;
+
+  //vector product of pep X pem
+  Double_t vpx = pyep*pzem - pzep*pyem;
+  Double_t vpy = pzep*pxem - pxep*pzem;
+  Double_t vpz = pxep*pyem - pyep*pxem;
+  Double_t vp = sqrt(vpx*vpx+vpy*vpy+vpz*vpz);
+
+  //unit vector of pep X pem
+  Double_t vx = vpx/vp;
+  Double_t vy = vpy/vp;
+  Double_t vz = vpz/vp;
+
+  //The third axis defined by vector product (ux,uy,uz)X(vx,vy,vz)
+  Double_t wx = uy*vz - uz*vy;
+  Double_t wy = uz*vx - ux*vz;
+  // by construction, (wx,wy,wz) must be a unit vector.
+  // measure angle between (wx,wy,wz) and (ax,ay,0). The angle between them
+  // should be small if the pair is conversion
+  // this function then returns values close to pi!
+  Double_t cosPhiV = wx*ax + wy*ay;
+  Double_t phiv = TMath::ACos(cosPhiV);
+  values[kPairPhiV] = phiv;
+}
+
 //__________________________________________________________________
 void AliReducedVarManager::PrintTrackFlags(TRACK* track) {
   //
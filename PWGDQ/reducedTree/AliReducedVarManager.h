@@ -191,6 +191,40 @@ class AliReducedVarManager : public TObject {
    kNSmearingMethods
   };
 
+  // Producers of the variables which are expensive or optional to calculate.
+  // Each producer fills a group of variables and is run only if at least one of its variables,
+  // or of the variables of a producer depending on it, is used (see CompileProducers()).
+  // The order is the execution order, each producer comes after the producers it depends on.
+  enum Producers {
+    // event producers, run at the end of FillEventInfo()
+    kCorrectedMultiplicityProducer=0,   // vertex and gain loss corrected multiplicities
+    kVZEROChannelProducer,              // VZERO channel multiplicities and pseudo-rapidities
+    kVZEROQvectorProducer,              // VZERO Q-vectors from the channel multiplicities (calibrated and recentered)
+    kTPCEventPlaneTreeProducer,         // TPC Q-vectors stored in the trees
+    kTPCVZEROCorrelationProducer,       // correlations and resolutions between the TPC (trees) and VZERO event planes
+    kEventPlaneFriendProducer,          // event plane variables from the event plane friend object
+    kVZEROFlowV2TPCProducer,            // VZERO channel v2 with respect to the TPC event plane (friend object)
+    // base track producers, run in FillTrackInfo() for tracks and pairs
+    kPairEfficiencyProducer,            // pair efficiency from the efficiency map
+    kVZEROFlowProducer,                 // flow variables with respect to the VZERO event planes
+    kTPCFlowProducer,                   // flow variables with respect to the TPC event planes
+    // track producers, run in FillTrackInfo() for AliReducedTrackInfo objects
+    kTPCnSigmaCorrectionProducer,       // recalibrated TPC n-sigma
+    // pair producers, run in FillPairInfo(track, track, type, values)
+    kPairPolarizationProducer,          // polarization angles in the Collins-Soper and helicity frames
+    kPairDecayLengthProducer,           // KF pseudo-proper decay time and Lxy
+    kPairPhiVProducer,                  // angle between the pair plane and the magnetic field
+    kNProducers
+  };
+  
+  enum ProducerStages {
+    kEventStage=0,
+    kBaseTrackStage,
+    kTrackStage,
+    kPairStage,
+    kNProducerStages
+  };
+
   
   static const Float_t fgkParticleMass[kNSpecies];
   static const Float_t fgkPairMass[AliReducedPairInfo::kNMaxCandidateTypes];
@@ -718,6 +752,14 @@ class AliReducedVarManager : public TObject {
   }
   static Bool_t GetUsedVar(Variables var) {return fgUsedVars[var];}
   
+  static void CompileProducers(Bool_t allProducers=kFALSE);
+  static Bool_t IsProducerActive(Int_t producer) {return (producer>=0 && producer<kNProducers ? fgProducerActive[producer] : kFALSE);}
+  static Int_t GetVariableProducer(Int_t var);
+  static const Char_t* GetProducerName(Int_t producer);
+  static void SetProducerTiming(Bool_t option) {fgProducerTiming = option;}
+  static void ResetProducerTiming();
+  static void PrintProducers();
+  
   static void FillEventInfo(Float_t* values);
   static void FillEventInfo(AliReducedBaseEvent* event, Float_t* values, AliReducedEventPlaneInfo* eventPlane=0x0);
   static void FillEventOnlineTriggers(AliReducedEventInfo* event, Float_t* values);
@@ -787,6 +829,41 @@ class AliReducedVarManager : public TObject {
                                                  //   when a variable is used
   static void SetVariableDependencies();       // toggle those variables on which other used variables might depend 
   
+  struct ProducerInfo {
+    const Char_t* fName;          // name of the producer
+    Int_t         fStage;         // stage in which the producer is run (ProducerStages)
+    Int_t         fNRanges;       // number of variable ranges filled by the producer
+    Int_t         fRanges[4][2];  // ranges [first,last) of the variables filled by the producer
+    Int_t         fNDependencies; // number of producers this producer depends on
+    Int_t         fDependencies[3];  // producers this producer depends on
+  };
+  static const ProducerInfo fgkProducers[kNProducers];          // registry of the producers
+  static Bool_t   fgProducersCompiled;                          // kTRUE after CompileProducers() was called
+  static Bool_t   fgProducerActive[kNProducers];                // producers needed by the used variables
+  static Int_t    fgProducerList[kNProducerStages][kNProducers];  // ordered list of active producers for each stage
+  static Int_t    fgNProducers[kNProducerStages];               // number of active producers for each stage
+  static Bool_t   fgProducerTiming;                             // measure the time spent in each producer
+  static Double_t fgProducerTime[kNProducers];                  // time spent in each producer (seconds)
+  static Long64_t fgProducerCalls[kNProducers];                 // number of calls of each producer
+  
+  static void RunEventProducers(AliReducedEventInfo* event, Float_t* values, AliReducedEventPlaneInfo* eventF);
+  static void RunTrackProducers(Int_t stage, Float_t* values);
+  static void RunPairProducers(AliReducedBaseTrack* t1, AliReducedBaseTrack* t2, Int_t type, Float_t* values);
+  static void ProduceCorrectedMultiplicities(Float_t* values);
+  static void ProduceVZEROChannels(AliReducedEventInfo* event, Float_t* values);
+  static void ProduceVZEROQvectors(AliReducedEventInfo* event, Float_t* values);
+  static void ProduceTPCEventPlaneTree(AliReducedEventInfo* event, Float_t* values);
+  static void ProduceTPCVZEROCorrelations(Float_t* values);
+  static void ProduceEventPlaneFriend(AliReducedEventPlaneInfo* eventF, Float_t* values);
+  static void ProduceVZEROFlowV2TPC(Float_t* values);
+  static void ProducePairEfficiency(Float_t* values);
+  static void ProduceVZEROFlow(Float_t* values);
+  static void ProduceTPCFlow(Float_t* values);
+  static void ProduceTPCnSigmaCorrections(Float_t* values);
+  static void ProducePairPolarization(AliReducedBaseTrack* t1, AliReducedBaseTrack* t2, Float_t* values);
+  static void ProducePairDecayLength(AliReducedBaseTrack* t1, AliReducedBaseTrack* t2, Int_t type, Float_t* values);
+  static void ProducePairPhiV(AliReducedBaseTrack* t1, AliReducedBaseTrack* t2, Float_t* values);
+  
 
   static Double_t DeltaPhi(Double_t phi1, Double_t phi2);  
   static void GetThetaPhiCM(AliReducedBaseTrack* leg1, AliReducedBaseTrack* leg2,
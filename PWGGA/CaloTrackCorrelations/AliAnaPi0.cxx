@@ -13,9 +13,13 @@
  * provided "as is" without express or implied warranty.                  *
  **************************************************************************/
 
+// --- C++ ---
+#include <cmath>
+
 // --- ROOT system ---
 #include "TH3.h"
 #include "TH2F.h"
+#include "TProfile.h"
 //#include "Riostream.h"
 #include "TCanvas.h"
 #include "TPad.h"
@@ -51,7 +55,8 @@ ClassImp(AliAnaPi0) ;
 /// Default Constructor. Initialized parameters with default values.
 //______________________________________________________
 AliAnaPi0::AliAnaPi0() : AliAnaCaloTrackCorrBaseClass(),
-fEventsList(0x0),
+fMixBuffer(),                fMixBufferFirst(),            fMixBufferN(),
+fMixPairMass(),              fMixPairPt(),                 fMixPairAsym(),
 fUseAngleCut(kFALSE),        fUseAngleEDepCut(kFALSE),     fAngleCut(0),                 fAngleMaxCut(0.),   fUseOneCellSeparation(kFALSE),
 fMultiCutAna(kFALSE),        fMultiCutAnaSim(kFALSE),      fMultiCutAnaAcc(kFALSE),
 fNPtCuts(0),                 fNAsymCuts(0),                fNCellNCuts(0),               fNPIDBits(0), fNAngleCutBins(0),
@@ -79,6 +84,7 @@ fhRePtNCellAsymCutsOpAngle(0x0),    fhMiPtNCellAsymCutsOpAngle(0x0),
 fhRePtAsym(0x0),             fhRePtAsymPi0(0x0),           fhRePtAsymEta(0x0),
 fhMiPtAsym(0x0),             fhMiPtAsymPi0(0x0),           fhMiPtAsymEta(0x0),
 fhEventBin(0),               fhEventMixBin(0),
+fhMixBufferDepth(0),         fhMixBufferMemory(0),
 fhCentrality(0x0),           fhCentralityNoPair(0x0),
 fhEventPlaneResolution(0x0),
 fhRealOpeningAngle(0x0),     fhRealCosOpeningAngle(0x0),   fhMixedOpeningAngle(0x0),     fhMixedCosOpeningAngle(0x0),
@@ -238,24 +244,7 @@ fhReSecondaryCellOutTimeWindow(0), fhMiSecondaryCellOutTimeWindow(0)
 //_____________________
 AliAnaPi0::~AliAnaPi0()
 {
-  // Remove event containers
-  
-  if(DoOwnMix() && fEventsList)
-  {
-    for(Int_t ic=0; ic<GetNCentrBin(); ic++)
-    {
-      for(Int_t iz=0; iz<GetNZvertBin(); iz++)
-      {
-        for(Int_t irp=0; irp<GetNRPBin(); irp++)
-        {
-          Int_t bin = GetEventMixBin(ic,iz,irp);
-          fEventsList[bin]->Delete() ;
-          delete fEventsList[bin] ;
-        }
-      }
-    }
-    delete[] fEventsList;
-  }
+  // The stored events for mixing are removed with fMixBuffer
 }
 
 //______________________________
@@ -830,21 +819,13 @@ TList * AliAnaPi0::GetCreateOutputObjects()
     
   //
   // Create mixed event containers
+  // Each bin keeps the last GetNMaxEvMix()-1 events with photons
   //
-  fEventsList = new TList*[GetNCentrBin()*GetNZvertBin()*GetNRPBin()] ;
-  
-  for(Int_t ic=0; ic<GetNCentrBin(); ic++)
-  {
-    for(Int_t iz=0; iz<GetNZvertBin(); iz++)
-    {
-      for(Int_t irp=0; irp<GetNRPBin(); irp++)
-      {
-        Int_t bin = GetEventMixBin(ic,iz,irp);
-        fEventsList[bin] = new TList() ;
-        fEventsList[bin]->SetOwner(kFALSE);
-      }
-    }
-  }
+  Int_t nMixBins = GetNCentrBin()*GetNZvertBin()*GetNRPBin();
+  Int_t mixDepth = TMath::Max(GetNMaxEvMix()-1, 0);
+  fMixBuffer.assign(nMixBins, std::vector<MixedEventPhotons>(mixDepth));
+  fMixBufferFirst.assign(nMixBins, -1);
+  fMixBufferN.assign(nMixBins, 0);
       
   fhRe1 = new TH2F*[GetNCentrBin()*fNPIDBits*fNAsymCuts] ;
   fhMi1 = new TH2F*[GetNCentrBin()*fNPIDBits*fNAsymCuts] ;
@@ -1304,6 +1285,20 @@ TList * AliAnaPi0::GetCreateOutputObjects()
                            GetNCentrBin()*GetNZvertBin()*GetNRPBin()+1) ;
     fhEventMixBin->SetXTitle("bin");
     outputContainer->Add(fhEventMixBin) ;
+    
+    fhMixBufferDepth=new TProfile("hMixBufferDepth","Number of stored events for mixing per bin(cen,vz,rp)",
+                                  GetNCentrBin()*GetNZvertBin()*GetNRPBin()+1,0,
+                                  GetNCentrBin()*GetNZvertBin()*GetNRPBin()+1) ;
+    fhMixBufferDepth->SetXTitle("bin");
+    fhMixBufferDepth->SetYTitle("stored events");
+    outputContainer->Add(fhMixBufferDepth) ;
+    
+    fhMixBufferMemory=new TProfile("hMixBufferMemory","Memory of the stored events for mixing per bin(cen,vz,rp)",
+                                   GetNCentrBin()*GetNZvertBin()*GetNRPBin()+1,0,
+                                   GetNCentrBin()*GetNZvertBin()*GetNRPBin()+1) ;
+    fhMixBufferMemory->SetXTitle("bin");
+    fhMixBufferMemory->SetYTitle("memory (kB)");
+    outputContainer->Add(fhMixBufferMemory) ;
   }
   
   if ( IsHighMultiplicityAnalysisOn() )
@@ -4597,20 +4592,28 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
     // Check that the bin exists, if not (bad determination of RP, centrality or vz bin) do nothing
     if(eventbin < 0) return ;
     
-    TList * evMixList=fEventsList[eventbin] ;
-    
-    if(!evMixList)
+    if(eventbin >= (Int_t)fMixBuffer.size())
     {
       AliWarning(Form("Mix event list not available, bin %d",eventbin));
       return;
     }
     
-    Int_t nMixed = evMixList->GetSize() ;
+    // Stored events, from the most recent to the oldest
+    std::vector<MixedEventPhotons> & evMixList = fMixBuffer[eventbin];
+    Int_t mixDepth = evMixList.size();
+    Int_t nMixed   = fMixBufferN[eventbin] ;
     for(Int_t ii=0; ii<nMixed; ii++)
     {
-      TClonesArray* ev2= (TClonesArray*) (evMixList->At(ii));
-      Int_t nPhot2=ev2->GetEntriesFast() ;
+      const MixedEventPhotons & ev2 = evMixList[(fMixBufferFirst[eventbin]-ii+mixDepth) % mixDepth];
+      Int_t nPhot2=ev2.GetN() ;
       Double_t m = -999;
+      
+      if ( (Int_t)fMixPairMass.size() < nPhot2 )
+      {
+        fMixPairMass.resize(nPhot2);
+        fMixPairPt  .resize(nPhot2);
+        fMixPairAsym.resize(nPhot2);
+      }
       AliDebug(1,Form("Mixed event %d photon entries %d, centrality bin %d",ii, nPhot2, GetEventCentralityBin()));
       
       fhEventMixBin->Fill(eventbin, GetEventWeight()) ;
@@ -4632,21 +4635,44 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
         fPhotonMom1.SetPxPyPzE(p1->Px(),p1->Py(),p1->Pz(),p1->E());
         module1 = GetModuleNumber(p1);
         
+        //---------------------------------
+        // Mass, pT and asymmetry of the pairs with all the mixed event photons,
+        // same operations as with TLorentzVector, in a loop without branches
+        // which can be vectorized (with -fno-math-errno for gcc)
+        //---------------------------------
+        {
+          const Double_t   px1 = fPhotonMom1.Px(), py1 = fPhotonMom1.Py(), pz1 = fPhotonMom1.Pz(), e1 = fPhotonMom1.E();
+          const Double_t * px2 = ev2.fPx.data();
+          const Double_t * py2 = ev2.fPy.data();
+          const Double_t * pz2 = ev2.fPz.data();
+          const Double_t * e2  = ev2.fE .data();
+          Double_t * pairMass  = fMixPairMass.data();
+          Double_t * pairPt    = fMixPairPt  .data();
+          Double_t * pairAsym  = fMixPairAsym.data();
+          for(Int_t i2 = 0; i2 < nPhot2; i2++)
+          {
+            Double_t px = px1+px2[i2];
+            Double_t py = py1+py2[i2];
+            Double_t pz = pz1+pz2[i2];
+            Double_t e  = e1 +e2 [i2];
+            Double_t mm = e*e - (px*px+py*py+pz*pz);
+            Double_t mabs = std::sqrt(std::fabs(mm));
+            pairMass[i2] = mm < 0. ? -mabs : mabs;
+            pairPt  [i2] = std::sqrt(px*px+py*py);
+            pairAsym[i2] = std::fabs(e1-e2[i2])/(e1+e2[i2]);
+          }
+        }
+        
         //---------------------------------
         // Second loop on other mixed event photons/clusters
         //---------------------------------
         for(Int_t i2 = 0; i2 < nPhot2; i2++)
         {
-          AliCaloTrackParticle * p2 = (AliCaloTrackParticle*) (ev2->At(i2)) ;
-          
-          // Select photons within a pT range
-          if ( p2->Pt() < GetMinPt() || p2->Pt()  > GetMaxPt() ) continue ;
-          
-          // Get kinematics of second cluster and calculate those of the pair
-          fPhotonMom2.SetPxPyPzE(p2->Px(),p2->Py(),p2->Pz(),p2->E());
-          m           = (fPhotonMom1+fPhotonMom2).M() ;
-          Double_t pt = (fPhotonMom1 + fPhotonMom2).Pt();
-          Double_t a  = TMath::Abs(p1->E()-p2->E())/(p1->E()+p2->E()) ;
+          // Get kinematics of second cluster and those of the pair
+          fPhotonMom2.SetPxPyPzE(ev2.fPx[i2],ev2.fPy[i2],ev2.fPz[i2],ev2.fE[i2]);
+          m           = fMixPairMass[i2] ;
+          Double_t pt = fMixPairPt  [i2] ;
+          Double_t a  = fMixPairAsym[i2] ;
           
           // Check if opening angle is too large or too small compared to what is expected
           Double_t angle   = fPhotonMom1.Angle(fPhotonMom2.Vect());
@@ -4664,7 +4690,7 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
 
 	  if(fUseOneCellSeparation)
 	  {
-	    Bool_t separation = CheckSeparation(p1->GetCellAbsIdMax() ,p2->GetCellAbsIdMax());
+	    Bool_t separation = CheckSeparation(p1->GetCellAbsIdMax() ,ev2.fCellAbsIdMax[i2]);
 	    if(!separation)
 	    {
 	      AliDebug(2,Form("Mix pair one cell separation required and Yes/No %d", separation));
@@ -4672,10 +4698,10 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
 	    }
 	  }
           
-          AliDebug(2,Form("Mixed Event: pT: fPhotonMom1 %2.2f, fPhotonMom2 %2.2f; Pair: pT %2.2f, mass %2.3f, a %2.3f",p1->Pt(), p2->Pt(), pt,m,a));
+          AliDebug(2,Form("Mixed Event: pT: fPhotonMom1 %2.2f, fPhotonMom2 %2.2f; Pair: pT %2.2f, mass %2.3f, a %2.3f",p1->Pt(), ev2.fPt[i2], pt,m,a));
           
           // In case we want only pairs in same (super) module, check their origin.
-          module2 = GetModuleNumber(p2);
+          module2 = ev2.fModule[i2];
                     
           //-------------------------------------------------------------------------------------------------
           // Fill module dependent histograms, put a cut on assymmetry on the first available cut in the array
@@ -4735,7 +4761,7 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
               Float_t phi2 = GetPhi(fPhotonMom2.Phi());
               Bool_t etaside = 0;
               if(   (p1->GetDetectorTag()==kEMCAL && fPhotonMom1.Eta() < 0) 
-                 || (p2->GetDetectorTag()==kEMCAL && fPhotonMom2.Eta() < 0)) etaside = 1;
+                 || (ev2.fDetectorTag[i2]==kEMCAL && fPhotonMom2.Eta() < 0)) etaside = 1;
               
               if      (    phi1 > DegToRad(260) && phi2 > DegToRad(260) && phi1 < DegToRad(280) && phi2 < DegToRad(280))  fhMiSameSectorDCALPHOSMod[0+etaside]->Fill(pt, m, GetEventWeight());
               else if (    phi1 > DegToRad(280) && phi2 > DegToRad(280) && phi1 < DegToRad(300) && phi2 < DegToRad(300))  fhMiSameSectorDCALPHOSMod[2+etaside]->Fill(pt, m, GetEventWeight());
@@ -4777,8 +4803,8 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
           // Check if one of the clusters comes from a conversion
           if(fCheckConversion)
           {
-            if     (p1->IsTagged() && p2->IsTagged()) fhMiConv2->Fill(pt, m, GetEventWeight());
-            else if(p1->IsTagged() || p2->IsTagged()) fhMiConv ->Fill(pt, m, GetEventWeight());
+            if     (p1->IsTagged() && ev2.fTagged[i2]) fhMiConv2->Fill(pt, m, GetEventWeight());
+            else if(p1->IsTagged() || ev2.fTagged[i2]) fhMiConv ->Fill(pt, m, GetEventWeight());
           }
           
           //
@@ -4787,7 +4813,7 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
           //
           for(Int_t ipid=0; ipid<fNPIDBits; ipid++)
           {
-            if((p1->IsPIDOK(ipid,AliCaloPID::kPhoton)) && (p2->IsPIDOK(ipid,AliCaloPID::kPhoton)))
+            if((p1->IsPIDOK(ipid,AliCaloPID::kPhoton)) && (ev2.fPIDBits[i2] & (1<<ipid)))
             {
               for(Int_t iasym=0; iasym < fNAsymCuts; iasym++)
               {
@@ -4802,12 +4828,12 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
                   
                   if(fFillBadDistHisto)
                   {
-                    if(p1->DistToBad()>0 && p2->DistToBad()>0)
+                    if(p1->DistToBad()>0 && ev2.fDistToBad[i2]>0)
                     {
                       fhMi2[index]->Fill(pt, m, GetEventWeight()) ;
                       if(fMakeInvPtPlots)fhMiInvPt2[index]->Fill(pt, m, 1./pt * GetEventWeight()) ;
                       
-                      if(p1->DistToBad()>1 && p2->DistToBad()>1)
+                      if(p1->DistToBad()>1 && ev2.fDistToBad[i2]>1)
                       {
                         fhMi3[index]->Fill(pt, m, GetEventWeight()) ;
                         if(fMakeInvPtPlots)fhMiInvPt3[index]->Fill(pt, m, 1./pt * GetEventWeight()) ;
@@ -4837,8 +4863,8 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
                 {
                   Int_t index = ((ipt*fNCellNCuts)+icell)*fNAsymCuts + iasym;
                   
-                  if(p1->Pt() >   fPtCuts[ipt]      && p2->Pt() > fPtCuts[ipt]      &&
-                     p1->Pt() <   fPtCutsMax[ipt]   && p2->Pt() < fPtCutsMax[ipt]   &&
+                  if(p1->Pt() >   fPtCuts[ipt]      && ev2.fPt[i2] > fPtCuts[ipt]      &&
+                     p1->Pt() <   fPtCutsMax[ipt]   && ev2.fPt[i2] < fPtCutsMax[ipt]   &&
                      a        <   fAsymCuts[iasym]                                  &&
                      ncell1   >=  fCellNCuts[icell] && ncell2   >= fCellNCuts[icell] 
                      )
@@ -4881,7 +4907,7 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
               Float_t e2   = fPhotonMom2.E();
               
               Float_t t1   = p1->GetTime();
-              Float_t t2   = p2->GetTime();
+              Float_t t2   = ev2.fTime[i2];
               
               Int_t nc1    = ncell1;
               Int_t nc2    = ncell2;
@@ -4909,7 +4935,7 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
                 e1   = fPhotonMom2.E();
                 e2   = fPhotonMom1.E();
                 
-                t1   = p2->GetTime();
+                t1   = ev2.fTime[i2];
                 t2   = p1->GetTime();
                 
                 nc1  = ncell2;
@@ -4970,10 +4996,10 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
           // Check cell time content in cluster
           if ( fFillSecondaryCellTiming )
           {
-            if      ( p1->GetFiducialArea() == 0 && p2->GetFiducialArea() == 0 )
+            if      ( p1->GetFiducialArea() == 0 && ev2.fFiducialArea[i2] == 0 )
               fhMiSecondaryCellInTimeWindow ->Fill(pt, m, GetEventWeight());
             
-            else if ( p1->GetFiducialArea() != 0 && p2->GetFiducialArea() != 0 )
+            else if ( p1->GetFiducialArea() != 0 && ev2.fFiducialArea[i2] != 0 )
               fhMiSecondaryCellOutTimeWindow->Fill(pt, m, GetEventWeight());
           }
                   
@@ -4985,26 +5011,9 @@ void AliAnaPi0::MakeAnalysisFillHistograms()
     // Add the current event to the list of events for mixing
     //--------------------------------------------------------
     
-    //TClonesArray *currentEvent = new TClonesArray(*GetInputAODBranch());
-    TClonesArray *currentEvent = new TClonesArray(*secondLoopInputData);
-    
-    // Add current event to buffer and Remove redundant events
-    if( currentEvent->GetEntriesFast() > 0 )
-    {
-      evMixList->AddFirst(currentEvent) ;
-      currentEvent=0 ; //Now list of particles belongs to buffer and it will be deleted with buffer
-      if( evMixList->GetSize() >= GetNMaxEvMix() )
-      {
-        TClonesArray * tmp = (TClonesArray*) (evMixList->Last()) ;
-        evMixList->RemoveLast() ;
-        delete tmp ;
-      }
-    }
-    else
-    { // empty event
-      delete currentEvent ;
-      currentEvent=0 ;
-    }
+    // Add current event to buffer, it replaces the oldest one, empty events are not kept
+    if( secondLoopInputData->GetEntriesFast() > 0 )
+      AddEventToMixBuffer(eventbin, secondLoopInputData);
   }// DoOwnMix
   
   AliDebug(1,"End fill histograms");
@@ -5064,3 +5073,88 @@ Bool_t AliAnaPi0::CheckSeparation(Int_t absID1,Int_t absID2)
   
   return (!neighbours);
 }
+
+//________________________________________________________________________
+/// Store the photons of the current event in the mixing buffer of its bin,
+/// in the slot of the oldest stored event, whose memory is reused.
+/// Only the photon variables used in the mixed pairs are kept.
+//________________________________________________________________________
+void AliAnaPi0::AddEventToMixBuffer(Int_t eventbin, TClonesArray * photons)
+{
+  std::vector<MixedEventPhotons> & evMixList = fMixBuffer[eventbin];
+  Int_t mixDepth = evMixList.size();
+  if ( mixDepth == 0 ) return ;
+  
+  fMixBufferFirst[eventbin] = (fMixBufferFirst[eventbin]+1) % mixDepth;
+  if ( fMixBufferN[eventbin] < mixDepth ) fMixBufferN[eventbin]++;
+  
+  MixedEventPhotons & ev = evMixList[fMixBufferFirst[eventbin]];
+  ev.Clear();
+  
+  for(Int_t i = 0; i < photons->GetEntriesFast(); i++)
+  {
+    AliCaloTrackParticle * p = (AliCaloTrackParticle*) (photons->At(i)) ;
+    
+    // Select photons within a pT range, as done when mixing
+    if ( p->Pt() < GetMinPt() || p->Pt()  > GetMaxPt() ) continue ;
+    
+    UInt_t pidBits = 0;
+    for(Int_t ipid = 0; ipid < fNPIDBits; ipid++)
+    {
+      if ( p->IsPIDOK(ipid,AliCaloPID::kPhoton) ) pidBits |= (1<<ipid);
+    }
+    
+    ev.fPx          .push_back(p->Px());
+    ev.fPy          .push_back(p->Py());
+    ev.fPz          .push_back(p->Pz());
+    ev.fE           .push_back(p->E());
+    ev.fPt          .push_back(p->Pt());
+    ev.fTime        .push_back(p->GetTime());
+    ev.fCellAbsIdMax.push_back(p->GetCellAbsIdMax());
+    ev.fModule      .push_back(GetModuleNumber(p));
+    ev.fDistToBad   .push_back(p->DistToBad());
+    ev.fFiducialArea.push_back(p->GetFiducialArea());
+    ev.fDetectorTag .push_back(p->GetDetectorTag());
+    ev.fPIDBits     .push_back(pidBits);
+    ev.fTagged      .push_back(p->IsTagged());
+  }
+  
+  // Buffer statistics
+  fhMixBufferDepth->Fill(eventbin, fMixBufferN[eventbin]);
+  
+  Long64_t memory = 0;
+  for(Int_t islot = 0; islot < mixDepth; islot++) memory += evMixList[islot].GetMemory();
+  fhMixBufferMemory->Fill(eventbin, memory/1024.);
+}
+
+//________________________________________________________________________
+/// Remove the photons of a stored event, keep the memory.
+//________________________________________________________________________
+void AliAnaPi0::MixedEventPhotons::Clear()
+{
+  fPx          .clear();
+  fPy          .clear();
+  fPz          .clear();
+  fE           .clear();
+  fPt          .clear();
+  fTime        .clear();
+  fCellAbsIdMax.clear();
+  fModule      .clear();
+  fDistToBad   .clear();
+  fFiducialArea.clear();
+  fDetectorTag .clear();
+  fPIDBits     .clear();
+  fTagged      .clear();
+}
+
+//________________________________________________________________________
+/// \return memory reserved for the photons of a stored event, in bytes.
+//________________________________________________________________________
+Long64_t AliAnaPi0::MixedEventPhotons::GetMemory() const
+{
+  return (fPx.capacity() + fPy.capacity() + fPz.capacity() + fE.capacity() + fPt.capacity()) * sizeof(Double_t) +
+         fTime.capacity() * sizeof(Float_t) +
+         (fCellAbsIdMax.capacity() + fModule.capacity() + fDistToBad.capacity() + fFiducialArea.capacity()) * sizeof(Int_t) +
+         (fDetectorTag.capacity() + fPIDBits.capacity()) * sizeof(UInt_t) +
+         fTagged.capacity() * sizeof(Char_t);
+}
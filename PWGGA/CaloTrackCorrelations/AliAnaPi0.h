@@ -24,11 +24,16 @@
 /// \author Gustavo Conesa Balbastre <Gustavo.Conesa.Balbastre@cern.ch>, LPSC-IN2P3-CNRS
 //_________________________________________________________________________
 
+// C++
+#include <vector>
+
 // Root
 class TList;
 class TH3F ;
 class TH2F ;
+class TProfile ;
 class TObjString;
+class TClonesArray;
 
 // Analysis
 #include "AliAnaCaloTrackCorrBaseClass.h"
@@ -186,8 +191,40 @@ class AliAnaPi0 : public AliAnaCaloTrackCorrBaseClass {
 
   private:
 
-  /// Containers for photons in stored events
-  TList ** fEventsList ;               //![GetNCentrBin()*GetNZvertBin()*GetNRPBin()]
+  /// \struct MixedEventPhotons
+  /// \brief Photons of one stored event for the mixing, one array per photon variable,
+  /// only the photons in the pT range of the analysis are kept.
+  struct MixedEventPhotons
+  {
+    std::vector<Double_t> fPx ;           ///<  Momentum x
+    std::vector<Double_t> fPy ;           ///<  Momentum y
+    std::vector<Double_t> fPz ;           ///<  Momentum z
+    std::vector<Double_t> fE ;            ///<  Energy
+    std::vector<Double_t> fPt ;           ///<  Transverse momentum
+    std::vector<Float_t>  fTime ;         ///<  Cluster time
+    std::vector<Int_t>    fCellAbsIdMax ; ///<  Highest energy cell
+    std::vector<Int_t>    fModule ;       ///<  (Super) module number
+    std::vector<Int_t>    fDistToBad ;    ///<  Distance to bad channel
+    std::vector<Int_t>    fFiducialArea ; ///<  Fiducial area (secondary cell timing)
+    std::vector<UInt_t>   fDetectorTag ;  ///<  Detector of the photon
+    std::vector<UInt_t>   fPIDBits ;      ///<  Bit ipid set if IsPIDOK(ipid,kPhoton)
+    std::vector<Char_t>   fTagged ;       ///<  Tagged as conversion
+
+    void     Clear() ;
+    Int_t    GetN()      const { return fPx.size() ; }
+    Long64_t GetMemory() const ;
+  } ;
+
+  void     AddEventToMixBuffer(Int_t eventbin, TClonesArray * photons) ;
+
+  /// Stored events for the mixing in each bin (cen,vz,rp), ring of GetNMaxEvMix()-1 events,
+  /// the memory of a slot is reused by the events replacing it.
+  std::vector< std::vector<MixedEventPhotons> > fMixBuffer ; //!<!
+  std::vector<Int_t>    fMixBufferFirst ;    //!<! Slot of the last stored event in each bin
+  std::vector<Int_t>    fMixBufferN ;        //!<! Number of stored events in each bin
+  std::vector<Double_t> fMixPairMass ;       //!<! Mass of the pairs of a photon with the photons of a mixed event
+  std::vector<Double_t> fMixPairPt ;         //!<! Pt of the pairs of a photon with the photons of a mixed event
+  std::vector<Double_t> fMixPairAsym ;       //!<! Asymmetry of the pairs of a photon with the photons of a mixed event
   
   Bool_t   fUseAngleCut ;              ///<  Select pairs depending on their opening angle
   Bool_t   fUseAngleEDepCut ;          ///<  Select pairs depending on their opening angle
@@ -369,6 +406,8 @@ class AliAnaPi0 : public AliAnaCaloTrackCorrBaseClass {
     
   TH1I *   fhEventBin;                 //!<! Number of real  pairs in a particular bin (cen,vz,rp)
   TH1I *   fhEventMixBin;              //!<! Number of mixed pairs in a particular bin (cen,vz,rp)
+  TProfile * fhMixBufferDepth;         //!<! Number of stored events for mixing in a particular bin (cen,vz,rp)
+  TProfile * fhMixBufferMemory;        //!<! Memory of the stored events for mixing in a particular bin (cen,vz,rp), kB
   TH1F *   fhCentrality;               //!<! Histogram with centrality bins with at least one pare
   TH1F *   fhCentralityNoPair;         //!<! Histogram with centrality bins with no pair
 
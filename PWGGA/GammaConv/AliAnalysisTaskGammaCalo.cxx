@@ -5050,72 +5050,94 @@ void AliAnalysisTaskGammaCalo::CalculatePi0Candidates(){
   // Conversion Gammas
   if(fClusterCandidates->GetEntries()>0){
 
-    for(Int_t firstGammaIndex=0;firstGammaIndex<fClusterCandidates->GetEntries();firstGammaIndex++){
-      AliAODConversionPhoton *gamma0=dynamic_cast<AliAODConversionPhoton*>(fClusterCandidates->At(firstGammaIndex));
+    // cuts and event quantities, looked up once for all the pairs
+    AliConvEventCuts *eventCuts         = (AliConvEventCuts*)fEventCutArray->At(fiCut);
+    AliCaloPhotonCuts *clusterCuts      = (AliCaloPhotonCuts*)fClusterCutArray->At(fiCut);
+    AliConversionMesonCuts *mesonCuts   = (AliConversionMesonCuts*)fMesonCutArray->At(fiCut);
+    Double_t etaShift                   = eventCuts->GetEtaShift();
+    Bool_t doSecondaryTrackMatching     = clusterCuts->GetDoSecondaryTrackMatching();
+    Bool_t checkMBHeader                = (fIsMC>0 && eventCuts->GetSignalRejection() == 4);
+    Bool_t needClusters                 = doSecondaryTrackMatching || (fDoMesonQA == 5 && fIsMC == 0);
+    TClonesArray * arrClustersProcess   = NULL;
+    if(needClusters) arrClustersProcess = dynamic_cast<TClonesArray*>(fInputEvent->FindListObject(Form("%sClustersBranch",fCorrTaskSetting.Data())));
+
+    // photons with their timing, MB header flag and cluster, filled once instead of for every pair
+    Int_t nPhotons = fClusterCandidates->GetEntries();
+    std::vector<AliAODConversionPhoton*> photons(nPhotons, (AliAODConversionPhoton*)NULL);
+    std::vector<Double_t> photonTOF(nPhotons, 0.);
+    std::vector<Bool_t> photonFromMBHeader(nPhotons, kFALSE);
+    std::vector<AliVCluster*> photonCluster(nPhotons, (AliVCluster*)NULL);
+    for(Int_t iPhoton=0;iPhoton<nPhotons;iPhoton++){
+      AliAODConversionPhoton *gamma=dynamic_cast<AliAODConversionPhoton*>(fClusterCandidates->At(iPhoton));
+      if (gamma==NULL) continue;
+      photons[iPhoton] = gamma;
+      if ( fDoInOutTimingCluster ) photonTOF[iPhoton] = fInputEvent->GetCaloCluster(gamma->GetCaloClusterRef())->GetTOF();
+      if ( checkMBHeader ) photonFromMBHeader[iPhoton] = (eventCuts->IsParticleFromBGEvent(gamma->GetCaloPhotonMCLabel(0), fMCEvent, fInputEvent) == 2);
+      if ( needClusters && gamma->GetIsCaloPhoton() > 0 ){
+        if(fInputEvent->IsA()==AliESDEvent::Class()){
+          if(arrClustersProcess) photonCluster[iPhoton] = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma->GetCaloClusterRef()));
+          else photonCluster[iPhoton] = fInputEvent->GetCaloCluster(gamma->GetCaloClusterRef());
+        } else if(fInputEvent->IsA()==AliAODEvent::Class()){
+          if(arrClustersProcess) photonCluster[iPhoton] = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma->GetCaloClusterRef()));
+          else photonCluster[iPhoton] = fInputEvent->GetCaloCluster(gamma->GetCaloClusterRef());
+        }
+      }
+    }
+    std::vector<AliAODConversionPhoton*> conversionPhotons;
+    if(doSecondaryTrackMatching){
+      for(Int_t ConversionIndex=0;ConversionIndex<fGammaCandidates->GetEntries();ConversionIndex++){
+        AliAODConversionPhoton *gammaConversion=dynamic_cast<AliAODConversionPhoton*>(fGammaCandidates->At(ConversionIndex));
+        if (gammaConversion) conversionPhotons.push_back(gammaConversion);
+      }
+    }
+
+    for(Int_t firstGammaIndex=0;firstGammaIndex<nPhotons;firstGammaIndex++){
+      AliAODConversionPhoton *gamma0=photons[firstGammaIndex];
       if (gamma0==NULL) continue;
       if ( fDoInOutTimingCluster ){
-        Double_t tof = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef())->GetTOF();
+        Double_t tof = photonTOF[firstGammaIndex];
         if ( tof < fMinTimingCluster || tof > fMaxTimingCluster ) continue;
       }
-      for(Int_t secondGammaIndex=firstGammaIndex+1;secondGammaIndex<fClusterCandidates->GetEntries();secondGammaIndex++){
-        AliAODConversionPhoton *gamma1=dynamic_cast<AliAODConversionPhoton*>(fClusterCandidates->At(secondGammaIndex));
+      for(Int_t secondGammaIndex=firstGammaIndex+1;secondGammaIndex<nPhotons;secondGammaIndex++){
+        AliAODConversionPhoton *gamma1=photons[secondGammaIndex];
         if (gamma1==NULL) continue;
         if ( fDoInOutTimingCluster ){
-          Double_t tof = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef())->GetTOF();
+          Double_t tof = photonTOF[secondGammaIndex];
           if ( tof > fMinTimingCluster && tof < fMaxTimingCluster ) continue;
         }
 
         Double_t tempPi0CandWeight       = fWeightJetJetMC;
         // Set the pi0 candidate jetjet weight to 1 in case both photons orignated from the minimum bias header
-        if (fIsMC>0 && ((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetSignalRejection() == 4){
-          if( ((AliConvEventCuts*)fEventCutArray->At(fiCut))->IsParticleFromBGEvent(gamma0->GetCaloPhotonMCLabel(0), fMCEvent, fInputEvent) == 2 &&
-              ((AliConvEventCuts*)fEventCutArray->At(fiCut))->IsParticleFromBGEvent(gamma1->GetCaloPhotonMCLabel(0), fMCEvent, fInputEvent) == 2)
-            tempPi0CandWeight = 1;
+        if (checkMBHeader && photonFromMBHeader[firstGammaIndex] && photonFromMBHeader[secondGammaIndex])
+          tempPi0CandWeight = 1;
+
+        // clusters of the pair, only if both photons are calo photons
+        AliVCluster* Cluster0 = NULL;
+        AliVCluster* Cluster1 = NULL;
+        if (gamma0->GetIsCaloPhoton() > 0 && gamma1->GetIsCaloPhoton() > 0){
+          Cluster0 = photonCluster[firstGammaIndex];
+          Cluster1 = photonCluster[secondGammaIndex];
         }
-        AliAODConversionMother *pi0cand = new AliAODConversionMother(gamma0,gamma1);
-        pi0cand->SetLabels(firstGammaIndex,secondGammaIndex);
 
-        if(((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->GetDoSecondaryTrackMatching()){
-          TClonesArray * arrClustersProcess = NULL;
-          arrClustersProcess = dynamic_cast<TClonesArray*>(fInputEvent->FindListObject(Form("%sClustersBranch",fCorrTaskSetting.Data())));
-          AliVCluster* Cluster0 = NULL;
-          AliVCluster* Cluster1 = NULL;
-          if (gamma0->GetIsCaloPhoton() > 0 && gamma1->GetIsCaloPhoton() > 0){
-            if(fInputEvent->IsA()==AliESDEvent::Class()){
-              if(arrClustersProcess){
-                Cluster0 = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma0->GetCaloClusterRef()));
-                Cluster1 = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma1->GetCaloClusterRef()));
-              }else{
-                Cluster0 = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef());
-                Cluster1 = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-              }
-            } else if(fInputEvent->IsA()==AliAODEvent::Class()){
-              if(arrClustersProcess){
-                Cluster0 = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma0->GetCaloClusterRef()));
-                Cluster1 = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma1->GetCaloClusterRef()));
-              } else{
-                Cluster0 = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef());
-                Cluster1 = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-              }
-            }
-          }
+        if(doSecondaryTrackMatching){
           Bool_t ClusterMatched = kFALSE;
-          for(Int_t ConversionIndex=0;ConversionIndex<fGammaCandidates->GetEntries();ConversionIndex++){
-            AliAODConversionPhoton *gammaConversion=dynamic_cast<AliAODConversionPhoton*>(fGammaCandidates->At(ConversionIndex));
-            if (gammaConversion==NULL) continue;
-            Bool_t matchedGamma0 =  ((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->MatchConvPhotonToCluster(gammaConversion, Cluster0, fInputEvent, tempPi0CandWeight);
-            Bool_t matchedGamma1 =  ((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->MatchConvPhotonToCluster(gammaConversion, Cluster1, fInputEvent, tempPi0CandWeight);
+          for(UInt_t ConversionIndex=0;ConversionIndex<conversionPhotons.size();ConversionIndex++){
+            AliAODConversionPhoton *gammaConversion=conversionPhotons[ConversionIndex];
+            Bool_t matchedGamma0 =  clusterCuts->MatchConvPhotonToCluster(gammaConversion, Cluster0, fInputEvent, tempPi0CandWeight);
+            Bool_t matchedGamma1 =  clusterCuts->MatchConvPhotonToCluster(gammaConversion, Cluster1, fInputEvent, tempPi0CandWeight);
             if(matchedGamma0 || matchedGamma1) {
               ClusterMatched = kTRUE;
             }
           }
-          if(arrClustersProcess){
-              delete Cluster0;
-              delete Cluster1;
-          }
           if(ClusterMatched) continue;
         }
-        if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->MesonIsSelected(pi0cand,kTRUE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift(),gamma0->GetLeadingCellID(),gamma1->GetLeadingCellID(), gamma0->GetIsCaloPhoton(), gamma1->GetIsCaloPhoton()))){
+
+        // the candidate lives on the stack, no allocation per pair
+        AliAODConversionMother pi0candidate(gamma0,gamma1);
+        AliAODConversionMother *pi0cand = &pi0candidate;
+        pi0cand->SetLabels(firstGammaIndex,secondGammaIndex);
+
+        if(mesonCuts->MesonIsSelected(pi0cand,kTRUE,etaShift,gamma0->GetLeadingCellID(),gamma1->GetLeadingCellID(), gamma0->GetIsCaloPhoton(), gamma1->GetIsCaloPhoton())){
           if(fLocalDebugFlag == 1) DebugMethodPrint1(pi0cand,gamma0,gamma1);
           if(!fDoJetAnalysis || (fDoJetAnalysis && !fDoLightOutput)) fHistoMotherInvMassPt[fiCut]->Fill(pi0cand->M(),pi0cand->Pt(), tempPi0CandWeight);
           if(fIsMC && fDoTrueSphericity){
@@ -5281,30 +5303,6 @@ void AliAnalysisTaskGammaCalo::CalculatePi0Candidates(){
           }
 
           if (fDoMesonQA == 5 && fIsMC == 0 && ((pi0cand->M() > 0.05 && pi0cand->M() < 0.17) || (pi0cand->Pt() > 15. && pi0cand->M() > 0.45 && pi0cand->M() < 0.65 ))){
-
-            TClonesArray * arrClustersProcess = NULL;
-            arrClustersProcess = dynamic_cast<TClonesArray*>(fInputEvent->FindListObject(Form("%sClustersBranch",fCorrTaskSetting.Data())));
-            AliVCluster* Cluster0 = NULL;
-            AliVCluster* Cluster1 = NULL;
-            if (gamma0->GetIsCaloPhoton() > 0 && gamma1->GetIsCaloPhoton() > 0){
-              if(fInputEvent->IsA()==AliESDEvent::Class()){
-                if(arrClustersProcess){
-                  Cluster0 = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma0->GetCaloClusterRef()));
-                  Cluster1 = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma1->GetCaloClusterRef()));
-                }else{
-                  Cluster0 = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef());
-                  Cluster1 = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-                }
-              } else if(fInputEvent->IsA()==AliAODEvent::Class()){
-                if(arrClustersProcess){
-                  Cluster0 = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma0->GetCaloClusterRef()));
-                  Cluster1 = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma1->GetCaloClusterRef()));
-                } else{
-                  Cluster0 = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef());
-                  Cluster1 = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-                }
-              }
-            }
             fInvMassTreeInvMass = pi0cand->M();
             fInvMassTreePt      = pi0cand->Pt();
             fClusterTimeProbe   = Cluster1->GetTOF();
@@ -5328,10 +5326,11 @@ void AliAnalysisTaskGammaCalo::CalculatePi0Candidates(){
             }
           }
         }
-        delete pi0cand;
-        pi0cand=0x0;
       }
     }
+    if(arrClustersProcess){
+      for(Int_t iPhoton=0;iPhoton<nPhotons;iPhoton++) delete photonCluster[iPhoton];
+    }
   }
 }
 //______________________________________________________________________
@@ -6625,12 +6624,13 @@ void AliAnalysisTaskGammaCalo::CalculateBackground(){
 
   if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->UseTrackMultiplicity()){
     for(Int_t nEventsInBG=0;nEventsInBG<fBGHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-      AliGammaConversionAODVector *previousEventV0s = fBGHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
+      AliGammaConversionPhotonVector *previousEventV0s = fBGHandler[fiCut]->GetBGPhotons(zbin,mbin,nEventsInBG);
       for(Int_t iCurrent=0;iCurrent<fClusterCandidates->GetEntries();iCurrent++){
         AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fClusterCandidates->At(iCurrent));
         for(UInt_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
-          AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-          AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
+          AliAODConversionPhoton &previousGoodV0 = (*previousEventV0s)[iPrevious];
+          AliAODConversionMother bgCandidate(&currentEventGoodV0,&previousGoodV0);
+          AliAODConversionMother *backgroundCandidate = &bgCandidate;
           backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
 
           // Set the BG candidate jetjet weight to 1 in case both photons orignated from the minimum bias header
@@ -6662,8 +6662,6 @@ void AliAnalysisTaskGammaCalo::CalculateBackground(){
               tBckInvMassPtAlphaTheta[fiCut]->Fill();
             }
           }
-          delete backgroundCandidate;
-          backgroundCandidate = 0x0;
         }
       }
     }
@@ -6676,7 +6674,7 @@ void AliAnalysisTaskGammaCalo::CalculateBackground(){
     Bool_t acceptedPtMax    = kFALSE;
 
     for(Int_t nEventsInBG=0;nEventsInBG <fBGHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-      AliGammaConversionAODVector *previousEventV0s = fBGHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
+      AliGammaConversionPhotonVector *previousEventV0s = fBGHandler[fiCut]->GetBGPhotons(zbin,mbin,nEventsInBG);
       if(previousEventV0s){
         acceptedPtMax = kFALSE;
         currentPtMax = 0; previousPtMax = 0;
@@ -6692,7 +6690,7 @@ void AliAnalysisTaskGammaCalo::CalculateBackground(){
         currentAvePhi /= currentAvePt;
         currentAvePt /= fClusterCandidates->GetEntries();
         for(UInt_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
-            AliAODConversionPhoton *previousV0 = (AliAODConversionPhoton*)(previousEventV0s->at(iPrevious));
+            AliAODConversionPhoton *previousV0 = &(*previousEventV0s)[iPrevious];
             previousAvePt += previousV0->GetPhotonPt();
             previousAveEta += previousV0->GetPhotonPt()*previousV0->GetPhotonEta();
             previousAvePhi += previousV0->GetPhotonPt()*previousV0->GetPhotonPhi();
@@ -6709,8 +6707,9 @@ void AliAnalysisTaskGammaCalo::CalculateBackground(){
           for(Int_t iCurrent=0;iCurrent<fClusterCandidates->GetEntries();iCurrent++){
             AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fClusterCandidates->At(iCurrent));
             for(UInt_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
-              AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-              AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
+              AliAODConversionPhoton &previousGoodV0 = (*previousEventV0s)[iPrevious];
+              AliAODConversionMother bgCandidate(&currentEventGoodV0,&previousGoodV0);
+              AliAODConversionMother *backgroundCandidate = &bgCandidate;
               backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
 
               // Set the BG candidate jetjet weight to 1 in case both photons orignated from the minimum bias header
@@ -6724,8 +6723,6 @@ void AliAnalysisTaskGammaCalo::CalculateBackground(){
                 ->MesonIsSelected(backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()),currentEventGoodV0.GetLeadingCellID(),previousGoodV0.GetLeadingCellID(), currentEventGoodV0.GetIsCaloPhoton(), previousGoodV0.GetIsCaloPhoton())){
                 fHistoMotherBackInvMassPt[fiCut]->Fill(backgroundCandidate->M(),backgroundCandidate->Pt(), tempBGCandidateWeight);
               }
-              delete backgroundCandidate;
-              backgroundCandidate = 0x0;
             }
           }
         }
@@ -6734,14 +6731,15 @@ void AliAnalysisTaskGammaCalo::CalculateBackground(){
   } else if( ((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->DoSectorMixing() ) {
     if(fClusterCandidates->GetEntries()>0){
       for(Int_t nEventsInBG=0;nEventsInBG <fBGHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-        AliGammaConversionAODVector *previousEventV0s = NULL;
-        previousEventV0s = fBGHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
+        AliGammaConversionPhotonVector *previousEventV0s = NULL;
+        previousEventV0s = fBGHandler[fiCut]->GetBGPhotons(zbin,mbin,nEventsInBG);
         if(previousEventV0s && previousEventV0s->size()>0){
               for(Int_t iCurrent=0;iCurrent<fClusterCandidates->GetEntries();iCurrent++){
                 AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fClusterCandidates->At(iCurrent));
                 for(UInt_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
-                  AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-                  AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
+                  AliAODConversionPhoton &previousGoodV0 = (*previousEventV0s)[iPrevious];
+                  AliAODConversionMother bgCandidate(&currentEventGoodV0,&previousGoodV0);
+                  AliAODConversionMother *backgroundCandidate = &bgCandidate;
                   backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
 
                   if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->MesonIsSelected(backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift(),currentEventGoodV0.GetLeadingCellID(),previousGoodV0.GetLeadingCellID(), currentEventGoodV0.GetIsCaloPhoton(), previousGoodV0.GetIsCaloPhoton()))){
@@ -6780,8 +6778,6 @@ void AliAnalysisTaskGammaCalo::CalculateBackground(){
                       tBckInvMassPtAlphaTheta[fiCut]->Fill();
                     }
                   }
-                  delete backgroundCandidate;
-                  backgroundCandidate = 0x0;
                 }
               }
         }
@@ -7237,6 +7233,16 @@ void AliAnalysisTaskGammaCalo::Terminate(const Option_t *)
 {
 
   //fOutputContainer->Print(); // Will crash on GRID
+
+  // memory of the photons buffered for the mixed event background, local running only
+  if(fLocalDebugFlag > 0 && fBGHandler && fMesonCutArray){
+    for(Int_t iCut = 0; iCut<fnCuts;iCut++){
+      AliConversionMesonCuts *mesonCuts = (AliConversionMesonCuts*)fMesonCutArray->At(iCut);
+      if(!mesonCuts || !mesonCuts->DoBGCalculation() || mesonCuts->BackgroundHandlerType() != 0) continue;
+      cout << "Cut " << mesonCuts->GetCutNumber() << ": ";
+      fBGHandler[iCut]->PrintBGPhotonMemory();
+    }
+  }
 }
 
 //________________________________________________________________________
@@ -4228,72 +4228,103 @@ void AliAnalysisTaskGammaCaloMix::CalculatePi0Candidates(){
   // Conversion Gammas
   if(fClusterCandidates->GetEntries()>0 && fClusterCandidates2->GetEntries()>0){
 
-    for(Int_t firstGammaIndex=0;firstGammaIndex<fClusterCandidates->GetEntries();firstGammaIndex++){
-      AliAODConversionPhoton *gamma0=dynamic_cast<AliAODConversionPhoton*>(fClusterCandidates->At(firstGammaIndex));
+    // cuts and event quantities, looked up once for all the pairs
+    AliConvEventCuts *eventCuts         = (AliConvEventCuts*)fEventCutArray->At(fiCut);
+    AliCaloPhotonCuts *clusterCuts      = (AliCaloPhotonCuts*)fClusterCutArray->At(fiCut);
+    AliCaloPhotonCuts *clusterCuts2     = (AliCaloPhotonCuts*)fClusterCutArray2->At(fiCut);
+    AliConversionMesonCuts *mesonCuts   = (AliConversionMesonCuts*)fMesonCutArray->At(fiCut);
+    Double_t etaShift                   = eventCuts->GetEtaShift();
+    Bool_t doSecondaryTrackMatching     = clusterCuts->GetDoSecondaryTrackMatching() || clusterCuts2->GetDoSecondaryTrackMatching();
+    Bool_t checkMBHeader                = (fIsMC>0 && eventCuts->GetSignalRejection() == 4);
+    Bool_t needClusters                 = doSecondaryTrackMatching || (fDoMesonQA == 5 && fIsMC == 0);
+    TClonesArray * arrClustersProcess   = NULL;
+    if(needClusters) arrClustersProcess = dynamic_cast<TClonesArray*>(fInputEvent->FindListObject(Form("%sClustersBranch",fCorrTaskSetting.Data())));
+
+    // photons of both lists with their timing, MB header flag and cluster, filled once instead of for every pair
+    TList *candidateLists[2] = {fClusterCandidates, fClusterCandidates2};
+    Int_t nPhotons[2];
+    std::vector<AliAODConversionPhoton*> photons[2];
+    std::vector<Double_t> photonTOF[2];
+    std::vector<Bool_t> photonFromMBHeader[2];
+    std::vector<AliVCluster*> photonCluster[2];
+    for(Int_t iList=0;iList<2;iList++){
+      nPhotons[iList] = candidateLists[iList]->GetEntries();
+      photons[iList].assign(nPhotons[iList], (AliAODConversionPhoton*)NULL);
+      photonTOF[iList].assign(nPhotons[iList], 0.);
+      photonFromMBHeader[iList].assign(nPhotons[iList], kFALSE);
+      photonCluster[iList].assign(nPhotons[iList], (AliVCluster*)NULL);
+      for(Int_t iPhoton=0;iPhoton<nPhotons[iList];iPhoton++){
+        AliAODConversionPhoton *gamma=dynamic_cast<AliAODConversionPhoton*>(candidateLists[iList]->At(iPhoton));
+        if (gamma==NULL) continue;
+        photons[iList][iPhoton] = gamma;
+        if ( fDoInOutTimingCluster ) photonTOF[iList][iPhoton] = fInputEvent->GetCaloCluster(gamma->GetCaloClusterRef())->GetTOF();
+        if ( checkMBHeader ) photonFromMBHeader[iList][iPhoton] = (eventCuts->IsParticleFromBGEvent(gamma->GetCaloPhotonMCLabel(0), fMCEvent, fInputEvent) == 2);
+        if ( needClusters && gamma->GetIsCaloPhoton() > 0 ){
+          if(fInputEvent->IsA()==AliESDEvent::Class()){
+            if(arrClustersProcess) photonCluster[iList][iPhoton] = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma->GetCaloClusterRef()));
+            else photonCluster[iList][iPhoton] = fInputEvent->GetCaloCluster(gamma->GetCaloClusterRef());
+          } else if(fInputEvent->IsA()==AliAODEvent::Class()){
+            if(arrClustersProcess) photonCluster[iList][iPhoton] = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma->GetCaloClusterRef()));
+            else photonCluster[iList][iPhoton] = fInputEvent->GetCaloCluster(gamma->GetCaloClusterRef());
+          }
+        }
+      }
+    }
+    std::vector<AliAODConversionPhoton*> conversionPhotons;
+    if(doSecondaryTrackMatching){
+      for(Int_t ConversionIndex=0;ConversionIndex<fGammaCandidates->GetEntries();ConversionIndex++){
+        AliAODConversionPhoton *gammaConversion=dynamic_cast<AliAODConversionPhoton*>(fGammaCandidates->At(ConversionIndex));
+        if (gammaConversion) conversionPhotons.push_back(gammaConversion);
+      }
+    }
+
+    for(Int_t firstGammaIndex=0;firstGammaIndex<nPhotons[0];firstGammaIndex++){
+      AliAODConversionPhoton *gamma0=photons[0][firstGammaIndex];
       if (gamma0==NULL) continue;
       if ( fDoInOutTimingCluster ){
-        Double_t tof = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef())->GetTOF();
+        Double_t tof = photonTOF[0][firstGammaIndex];
         if ( tof < fMinTimingCluster || tof > fMaxTimingCluster ) continue;
       }
-      for(Int_t secondGammaIndex=0;secondGammaIndex<fClusterCandidates2->GetEntries();secondGammaIndex++){
-        AliAODConversionPhoton *gamma1=dynamic_cast<AliAODConversionPhoton*>(fClusterCandidates2->At(secondGammaIndex));
+      for(Int_t secondGammaIndex=0;secondGammaIndex<nPhotons[1];secondGammaIndex++){
+        AliAODConversionPhoton *gamma1=photons[1][secondGammaIndex];
         if (gamma1==NULL) continue;
         if ( fDoInOutTimingCluster ){
-          Double_t tof = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef())->GetTOF();
+          Double_t tof = photonTOF[1][secondGammaIndex];
           if ( tof > fMinTimingCluster && tof < fMaxTimingCluster ) continue;
         }
 
         Double_t tempPi0CandWeight       = fWeightJetJetMC;
         // Set the pi0 candidate jetjet weight to 1 in case both photons orignated from the minimum bias header
-        if (fIsMC>0 && ((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetSignalRejection() == 4){
-          if( ((AliConvEventCuts*)fEventCutArray->At(fiCut))->IsParticleFromBGEvent(gamma0->GetCaloPhotonMCLabel(0), fMCEvent, fInputEvent) == 2 &&
-              ((AliConvEventCuts*)fEventCutArray->At(fiCut))->IsParticleFromBGEvent(gamma1->GetCaloPhotonMCLabel(0), fMCEvent, fInputEvent) == 2)
-            tempPi0CandWeight = 1;
+        if (checkMBHeader && photonFromMBHeader[0][firstGammaIndex] && photonFromMBHeader[1][secondGammaIndex])
+          tempPi0CandWeight = 1;
+
+        // clusters of the pair, only if both photons are calo photons
+        AliVCluster* Cluster0 = NULL;
+        AliVCluster* Cluster1 = NULL;
+        if (gamma0->GetIsCaloPhoton() > 0 && gamma1->GetIsCaloPhoton() > 0){
+          Cluster0 = photonCluster[0][firstGammaIndex];
+          Cluster1 = photonCluster[1][secondGammaIndex];
         }
-        AliAODConversionMother *pi0cand = new AliAODConversionMother(gamma0,gamma1);
-        pi0cand->SetLabels(firstGammaIndex,secondGammaIndex);
 
-        if(((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->GetDoSecondaryTrackMatching() || ((AliCaloPhotonCuts*)fClusterCutArray2->At(fiCut))->GetDoSecondaryTrackMatching()){
-          TClonesArray * arrClustersProcess = NULL;
-          arrClustersProcess = dynamic_cast<TClonesArray*>(fInputEvent->FindListObject(Form("%sClustersBranch",fCorrTaskSetting.Data())));
-          AliVCluster* Cluster0 = NULL;
-          AliVCluster* Cluster1 = NULL;
-          if (gamma0->GetIsCaloPhoton() > 0 && gamma1->GetIsCaloPhoton() > 0){
-            if(fInputEvent->IsA()==AliESDEvent::Class()){
-              if(arrClustersProcess){
-                Cluster0 = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma0->GetCaloClusterRef()));
-                Cluster1 = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma1->GetCaloClusterRef()));
-              }else{
-                Cluster0 = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef());
-                Cluster1 = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-              }
-            } else if(fInputEvent->IsA()==AliAODEvent::Class()){
-              if(arrClustersProcess){
-                Cluster0 = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma0->GetCaloClusterRef()));
-                Cluster1 = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma1->GetCaloClusterRef()));
-              } else{
-                Cluster0 = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef());
-                Cluster1 = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-              }
-            }
-          }
+        if(doSecondaryTrackMatching){
           Bool_t ClusterMatched = kFALSE;
-          for(Int_t ConversionIndex=0;ConversionIndex<fGammaCandidates->GetEntries();ConversionIndex++){
-            AliAODConversionPhoton *gammaConversion=dynamic_cast<AliAODConversionPhoton*>(fGammaCandidates->At(ConversionIndex));
-            if (gammaConversion==NULL) continue;
-            Bool_t matchedGamma0 =  (((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->MatchConvPhotonToCluster(gammaConversion, Cluster0, fInputEvent, tempPi0CandWeight)) || (((AliCaloPhotonCuts*)fClusterCutArray2->At(fiCut))->MatchConvPhotonToCluster(gammaConversion, Cluster0, fInputEvent, tempPi0CandWeight));
-            Bool_t matchedGamma1 =  (((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->MatchConvPhotonToCluster(gammaConversion, Cluster1, fInputEvent, tempPi0CandWeight)) || (((AliCaloPhotonCuts*)fClusterCutArray2->At(fiCut))->MatchConvPhotonToCluster(gammaConversion, Cluster1, fInputEvent, tempPi0CandWeight));
+          for(UInt_t ConversionIndex=0;ConversionIndex<conversionPhotons.size();ConversionIndex++){
+            AliAODConversionPhoton *gammaConversion=conversionPhotons[ConversionIndex];
+            Bool_t matchedGamma0 =  (clusterCuts->MatchConvPhotonToCluster(gammaConversion, Cluster0, fInputEvent, tempPi0CandWeight)) || (clusterCuts2->MatchConvPhotonToCluster(gammaConversion, Cluster0, fInputEvent, tempPi0CandWeight));
+            Bool_t matchedGamma1 =  (clusterCuts->MatchConvPhotonToCluster(gammaConversion, Cluster1, fInputEvent, tempPi0CandWeight)) || (clusterCuts2->MatchConvPhotonToCluster(gammaConversion, Cluster1, fInputEvent, tempPi0CandWeight));
             if(matchedGamma0 || matchedGamma1) {
               ClusterMatched = kTRUE;
             }
           }
-          if(arrClustersProcess){
-              delete Cluster0;
-              delete Cluster1;
-          }
           if(ClusterMatched) continue;
         }
-        if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->MesonIsSelected(pi0cand, kTRUE, ((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift(), gamma0->GetLeadingCellID(), gamma1->GetLeadingCellID(), gamma0->GetIsCaloPhoton(), gamma1->GetIsCaloPhoton()))){
+
+        // the candidate lives on the stack, no allocation per pair
+        AliAODConversionMother pi0candidate(gamma0,gamma1);
+        AliAODConversionMother *pi0cand = &pi0candidate;
+        pi0cand->SetLabels(firstGammaIndex,secondGammaIndex);
+
+        if(mesonCuts->MesonIsSelected(pi0cand, kTRUE, etaShift, gamma0->GetLeadingCellID(), gamma1->GetLeadingCellID(), gamma0->GetIsCaloPhoton(), gamma1->GetIsCaloPhoton())){
           if(fLocalDebugFlag == 1) DebugMethodPrint1(pi0cand,gamma0,gamma1);
           if(!fDoJetAnalysis || (fDoJetAnalysis && !fDoLightOutput)) fHistoMotherInvMassPt[fiCut]->Fill(pi0cand->M(),pi0cand->Pt(), tempPi0CandWeight);
           if(fIsMC && fDoTrueSphericity){
@@ -4459,30 +4490,6 @@ void AliAnalysisTaskGammaCaloMix::CalculatePi0Candidates(){
           }
 
           if (fDoMesonQA == 5 && fIsMC == 0 && ((pi0cand->M() > 0.05 && pi0cand->M() < 0.17) || (pi0cand->Pt() > 15. && pi0cand->M() > 0.45 && pi0cand->M() < 0.65 ))){
-
-            TClonesArray * arrClustersProcess = NULL;
-            arrClustersProcess = dynamic_cast<TClonesArray*>(fInputEvent->FindListObject(Form("%sClustersBranch",fCorrTaskSetting.Data())));
-            AliVCluster* Cluster0 = NULL;
-            AliVCluster* Cluster1 = NULL;
-            if (gamma0->GetIsCaloPhoton() > 0 && gamma1->GetIsCaloPhoton() > 0){
-              if(fInputEvent->IsA()==AliESDEvent::Class()){
-                if(arrClustersProcess){
-                  Cluster0 = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma0->GetCaloClusterRef()));
-                  Cluster1 = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersProcess->At(gamma1->GetCaloClusterRef()));
-                }else{
-                  Cluster0 = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef());
-                  Cluster1 = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-                }
-              } else if(fInputEvent->IsA()==AliAODEvent::Class()){
-                if(arrClustersProcess){
-                  Cluster0 = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma0->GetCaloClusterRef()));
-                  Cluster1 = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersProcess->At(gamma1->GetCaloClusterRef()));
-                } else{
-                  Cluster0 = fInputEvent->GetCaloCluster(gamma0->GetCaloClusterRef());
-                  Cluster1 = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-                }
-              }
-            }
             fInvMassTreeInvMass = pi0cand->M();
             fInvMassTreePt      = pi0cand->Pt();
             fClusterTimeProbe   = Cluster1->GetTOF();
@@ -4506,8 +4513,11 @@ void AliAnalysisTaskGammaCaloMix::CalculatePi0Candidates(){
             }
           }
         }
-        delete pi0cand;
-        pi0cand=0x0;
+      }
+    }
+    if(arrClustersProcess){
+      for(Int_t iList=0;iList<2;iList++){
+        for(Int_t iPhoton=0;iPhoton<nPhotons[iList];iPhoton++) delete photonCluster[iList][iPhoton];
       }
     }
   }
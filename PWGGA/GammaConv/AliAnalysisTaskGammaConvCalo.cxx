@@ -5129,30 +5129,48 @@ void AliAnalysisTaskGammaConvCalo::CalculatePi0Candidates(){
     arrClustersMesonCand = dynamic_cast<TClonesArray*>(fInputEvent->FindListObject(Form("%sClustersBranch",fCorrTaskSetting.Data())));
   // Conversion Gammas
   if(fGammaCandidates->GetEntries()>0){
+    // cuts looked up once for all the pairs
+    AliCaloPhotonCuts *clusterCuts      = (AliCaloPhotonCuts*)fClusterCutArray->At(fiCut);
+    AliConversionMesonCuts *mesonCuts   = (AliConversionMesonCuts*)fMesonCutArray->At(fiCut);
+    Double_t etaShift                   = ((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift();
+
+    // cluster photons and their clusters (for the track matching and the shower shape tree),
+    // filled once instead of for every conversion photon
+    Int_t nClusterPhotons = fClusterCandidates->GetEntries();
+    std::vector<AliAODConversionPhoton*> clusterPhotons(nClusterPhotons, (AliAODConversionPhoton*)NULL);
+    std::vector<AliVCluster*> photonCluster(nClusterPhotons, (AliVCluster*)NULL);
+    for(Int_t iPhoton=0;iPhoton<nClusterPhotons;iPhoton++){
+      AliAODConversionPhoton *gamma=dynamic_cast<AliAODConversionPhoton*>(fClusterCandidates->At(iPhoton));
+      if (gamma==NULL) continue;
+      clusterPhotons[iPhoton] = gamma;
+      if (gamma->GetIsCaloPhoton() > 0 || fDoInvMassShowerShapeTree){
+        if(fInputEvent->IsA()==AliESDEvent::Class()){
+          if(arrClustersMesonCand)
+            photonCluster[iPhoton] = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersMesonCand->At(gamma->GetCaloClusterRef()));
+          else
+            photonCluster[iPhoton] = fInputEvent->GetCaloCluster(gamma->GetCaloClusterRef());
+        } else if(fInputEvent->IsA()==AliAODEvent::Class()){
+          if(arrClustersMesonCand)
+            photonCluster[iPhoton] = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersMesonCand->At(gamma->GetCaloClusterRef()));
+          else
+            photonCluster[iPhoton] = fInputEvent->GetCaloCluster(gamma->GetCaloClusterRef());
+        }
+      }
+    }
+
     for(Int_t firstGammaIndex=0;firstGammaIndex<fGammaCandidates->GetEntries();firstGammaIndex++){
       AliAODConversionPhoton *gamma0=dynamic_cast<AliAODConversionPhoton*>(fGammaCandidates->At(firstGammaIndex));
       if (gamma0==NULL) continue;
 
-      for(Int_t secondGammaIndex=0;secondGammaIndex<fClusterCandidates->GetEntries();secondGammaIndex++){
+      for(Int_t secondGammaIndex=0;secondGammaIndex<nClusterPhotons;secondGammaIndex++){
         Bool_t matched = kFALSE;
-        AliAODConversionPhoton *gamma1=dynamic_cast<AliAODConversionPhoton*>(fClusterCandidates->At(secondGammaIndex));
+        AliAODConversionPhoton *gamma1=clusterPhotons[secondGammaIndex];
         if (gamma1==NULL) continue;
 
         if (gamma1->GetIsCaloPhoton() > 0){
-          AliVCluster* cluster = NULL;
-          if(fInputEvent->IsA()==AliESDEvent::Class()){
-            if(arrClustersMesonCand)
-              cluster = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersMesonCand->At(gamma1->GetCaloClusterRef()));
-            else
-              cluster = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-          } else if(fInputEvent->IsA()==AliAODEvent::Class()){
-            if(arrClustersMesonCand)
-              cluster = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersMesonCand->At(gamma1->GetCaloClusterRef()));
-            else
-              cluster = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-          }
+          AliVCluster* cluster = photonCluster[secondGammaIndex];
 
-          matched = ((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->MatchConvPhotonToCluster(gamma0,cluster, fInputEvent, fWeightJetJetMC);
+          matched = clusterCuts->MatchConvPhotonToCluster(gamma0,cluster, fInputEvent, fWeightJetJetMC);
           if(fDoConvGammaShowerShapeTree && matched){
             Float_t clusPos[3]={0,0,0};
             cluster->GetPosition(clusPos);
@@ -5164,17 +5182,18 @@ void AliAnalysisTaskGammaConvCalo::CalculatePi0Candidates(){
             tESDClusterEta = clusterVector.Eta();
             tESDClusterPhi = clusterVector.Phi();
             tESDClusterNCells = cluster->GetNCells();
-            tESDClusterMaxECell = ((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->FindLargestCellInCluster(cluster, fInputEvent);
-            tESDClusterNLM = ((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->GetNumberOfLocalMaxima(cluster, fInputEvent);
+            tESDClusterMaxECell = clusterCuts->FindLargestCellInCluster(cluster, fInputEvent);
+            tESDClusterNLM = clusterCuts->GetNumberOfLocalMaxima(cluster, fInputEvent);
             tESDGammaERM02[fiCut]->Fill();
           }
-          if(arrClustersMesonCand) delete cluster;
         }
 
-        AliAODConversionMother *pi0cand = new AliAODConversionMother(gamma0,gamma1);
+        // the candidate lives on the stack, no allocation per pair
+        AliAODConversionMother pi0candidate(gamma0,gamma1);
+        AliAODConversionMother *pi0cand = &pi0candidate;
         pi0cand->SetLabels(firstGammaIndex,secondGammaIndex);
 
-        if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->MesonIsSelected(pi0cand,kTRUE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()))){
+        if(mesonCuts->MesonIsSelected(pi0cand,kTRUE,etaShift)){
           if (matched){
             if(!fDoLightOutput) fHistoMotherMatchedInvMassPt[fiCut]->Fill(pi0cand->M(),pi0cand->Pt(),fWeightJetJetMC);
           }else {
@@ -5282,25 +5301,15 @@ void AliAnalysisTaskGammaConvCalo::CalculatePi0Candidates(){
           if(fDoInvMassShowerShapeTree){
             Double_t tempIM = pi0cand->M();
             if( (tempIM > 0.05 && tempIM < 0.2) || (tempIM > 0.4 && tempIM < 0.6) ){
-              AliVCluster* cluster = NULL;
-              if(fInputEvent->IsA()==AliESDEvent::Class()){
-                if(arrClustersMesonCand)
-                  cluster = new AliESDCaloCluster(*(AliESDCaloCluster*)arrClustersMesonCand->At(gamma1->GetCaloClusterRef()));
-                else
-                  cluster = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-              } else if(fInputEvent->IsA()==AliAODEvent::Class()){
-                if(arrClustersMesonCand)
-                  cluster = new AliAODCaloCluster(*(AliAODCaloCluster*)arrClustersMesonCand->At(gamma1->GetCaloClusterRef()));
-                else
-                  cluster = fInputEvent->GetCaloCluster(gamma1->GetCaloClusterRef());
-              }
-              if(cluster->E()>1.){
+              // cluster of the photon, prepared once per event above
+              AliVCluster* cluster = photonCluster[secondGammaIndex];
+              if(cluster && cluster->E()>1.){
                 tESDIMMesonInvMass = pi0cand->M();
                 tESDIMMesonPt = pi0cand->Pt();
                 tESDIMClusE = cluster->E();
                 tESDIMClusterM02 = cluster->GetM02();
                 tESDIMClusterM20 = cluster->GetM20();
-                tESDIMClusterLeadCellID = ((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->FindLargestCellInCluster(cluster,fInputEvent);
+                tESDIMClusterLeadCellID = clusterCuts->FindLargestCellInCluster(cluster,fInputEvent);
 
                 Double_t vertex[3] = {0};
                 InputEvent()->GetPrimaryVertex()->GetXYZ(vertex);
@@ -5354,17 +5363,17 @@ void AliAnalysisTaskGammaConvCalo::CalculatePi0Candidates(){
                 //get cluster classification
                 Bool_t isESD = kTRUE;
                 if(fInputEvent->IsA()==AliAODEvent::Class()) isESD = kFALSE;
-                if(fIsMC > 0) tESDIMClusterClassification = ((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->ClassifyClusterForTMEffi(cluster,fInputEvent,fMCEvent,isESD);
+                if(fIsMC > 0) tESDIMClusterClassification = clusterCuts->ClassifyClusterForTMEffi(cluster,fInputEvent,fMCEvent,isESD);
 
                 //determine dEta/dPhi of cluster to closest track
                 Int_t labelTrackMatch = -1;
                 AliVTrack* currTrack = 0x0;
-                if(((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->GetClosestMatchedTrackToCluster(fInputEvent,cluster,labelTrackMatch)){
+                if(clusterCuts->GetClosestMatchedTrackToCluster(fInputEvent,cluster,labelTrackMatch)){
                   currTrack  = dynamic_cast<AliVTrack*>(fInputEvent->GetTrack(labelTrackMatch));
                   if(currTrack){
                     Float_t tempEta = -99999;
                     Float_t tempPhi = -99999;
-                    ((AliCaloTrackMatcher*)((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->GetCaloTrackMatcherInstance())->GetTrackClusterMatchingResidual(currTrack->GetID(),cluster->GetID(),tempEta,tempPhi);
+                    ((AliCaloTrackMatcher*)clusterCuts->GetCaloTrackMatcherInstance())->GetTrackClusterMatchingResidual(currTrack->GetID(),cluster->GetID(),tempEta,tempPhi);
                     tESDIMClusMatchedTrackPt = currTrack->Pt();
                     tESDIMClusTrackDeltaEta = tempEta;
                     tESDIMClusTrackDeltaPhi = tempPhi;
@@ -5376,7 +5385,7 @@ void AliAnalysisTaskGammaConvCalo::CalculatePi0Candidates(){
                 }
 
                 //determine isolation in track Et
-                tESDIMClusterIsoSumTrackEt = ((AliCaloTrackMatcher*)((AliCaloPhotonCuts*)fClusterCutArray->At(fiCut))->GetCaloTrackMatcherInstance())->SumTrackEtAroundCluster(fInputEvent,cluster->GetID(),0.2);
+                tESDIMClusterIsoSumTrackEt = ((AliCaloTrackMatcher*)clusterCuts->GetCaloTrackMatcherInstance())->SumTrackEtAroundCluster(fInputEvent,cluster->GetID(),0.2);
                 //remove Et from matched track
                 if(currTrack){
                   TLorentzVector vecTrack;
@@ -5386,7 +5395,6 @@ void AliAnalysisTaskGammaConvCalo::CalculatePi0Candidates(){
 
                 tESDInvMassShowerShape[fiCut]->Fill();
               }
-              if(arrClustersMesonCand) delete cluster;
             }
           }
 
@@ -5468,10 +5476,11 @@ void AliAnalysisTaskGammaConvCalo::CalculatePi0Candidates(){
             }
           }
         }
-        delete pi0cand;
-        pi0cand=0x0;
       }
     }
+    if(arrClustersMesonCand){
+      for(Int_t iPhoton=0;iPhoton<nClusterPhotons;iPhoton++) delete photonCluster[iPhoton];
+    }
   }
 }
 //______________________________________________________________________
@@ -6526,29 +6535,24 @@ void AliAnalysisTaskGammaConvCalo::CalculateBackground(){
 
 
   AliGammaConversionAODBGHandler::GammaConversionVertex *bgEventVertex = NULL;
+  AliGammaConversionPhotonVector movedEventV0s;
   if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->UseTrackMultiplicity()){
     for(Int_t nEventsInBG=0;nEventsInBG<fBGClusHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-      AliGammaConversionAODVector *previousEventV0s = fBGClusHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
+      AliGammaConversionPhotonVector *previousEventV0s = fBGClusHandler[fiCut]->GetBGPhotons(zbin,mbin,nEventsInBG);
       if(fMoveParticleAccordingToVertex == kTRUE || ((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
         bgEventVertex = fBGClusHandler[fiCut]->GetBGEventVertex(zbin,mbin,nEventsInBG);
+        if(bgEventVertex){
+          MoveBGEventPhotons(*previousEventV0s,bgEventVertex,movedEventV0s);
+          previousEventV0s = &movedEventV0s;
+        }
       }
 
       for(Int_t iCurrent=0;iCurrent<fGammaCandidates->GetEntries();iCurrent++){
         AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fGammaCandidates->At(iCurrent));
         for(UInt_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
-          AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-          if(fMoveParticleAccordingToVertex == kTRUE){
-            if (bgEventVertex){
-              MoveParticleAccordingToVertex(&previousGoodV0,bgEventVertex);
-            }
-          }
-          if(((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
-            if (bgEventVertex){
-              RotateParticleAccordingToEP(&previousGoodV0,bgEventVertex->fEP,fEventPlaneAngle);
-            }
-          }
-
-          AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
+          AliAODConversionPhoton &previousGoodV0 = (*previousEventV0s)[iPrevious];
+          AliAODConversionMother bgCandidate(&currentEventGoodV0,&previousGoodV0);
+          AliAODConversionMother *backgroundCandidate = &bgCandidate;
           backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
           if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))
             ->MesonIsSelected(backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()))){
@@ -6560,8 +6564,6 @@ void AliAnalysisTaskGammaConvCalo::CalculateBackground(){
             }
            if(!fDoLightOutput || fDoECalibOutput)  fHistoMotherBackInvMassECalib[fiCut]->Fill(backgroundCandidate->M(),currentEventGoodV0.E(),fWeightJetJetMC);
           }
-          delete backgroundCandidate;
-          backgroundCandidate = 0x0;
         }
       }
     }
@@ -6756,29 +6758,22 @@ void AliAnalysisTaskGammaConvCalo::CalculateBackground(){
   } else {
     // mixing current conversion photons with previous clusters
     for(Int_t nEventsInBG=0;nEventsInBG <fBGClusHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-      AliGammaConversionAODVector *previousEventV0s = fBGClusHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
+      AliGammaConversionPhotonVector *previousEventV0s = fBGClusHandler[fiCut]->GetBGPhotons(zbin,mbin,nEventsInBG);
       if(previousEventV0s){
         if(fMoveParticleAccordingToVertex == kTRUE || ((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0 ){
           bgEventVertex = fBGClusHandler[fiCut]->GetBGEventVertex(zbin,mbin,nEventsInBG);
+          if(bgEventVertex){
+            MoveBGEventPhotons(*previousEventV0s,bgEventVertex,movedEventV0s);
+            previousEventV0s = &movedEventV0s;
+          }
         }
         for(Int_t iCurrent=0;iCurrent<fGammaCandidates->GetEntries();iCurrent++){
           AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fGammaCandidates->At(iCurrent));
           for(UInt_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
 
-            AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-
-            if(fMoveParticleAccordingToVertex == kTRUE){
-              if (bgEventVertex){
-                MoveParticleAccordingToVertex(&previousGoodV0,bgEventVertex);
-              }
-            }
-            if(((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
-              if (bgEventVertex){
-                RotateParticleAccordingToEP(&previousGoodV0,bgEventVertex->fEP,fEventPlaneAngle);
-              }
-            }
-
-            AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
+            AliAODConversionPhoton &previousGoodV0 = (*previousEventV0s)[iPrevious];
+            AliAODConversionMother bgCandidate(&currentEventGoodV0,&previousGoodV0);
+            AliAODConversionMother *backgroundCandidate = &bgCandidate;
             backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
             if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->MesonIsSelected(backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()))){
               fHistoMotherBackInvMassPt[fiCut]->Fill(backgroundCandidate->M(),backgroundCandidate->Pt(),fWeightJetJetMC);
@@ -6793,8 +6788,6 @@ void AliAnalysisTaskGammaConvCalo::CalculateBackground(){
                   fHistoBckHBTDeltaEPt[fiCut]->Fill(abs(currentEventGoodV0.E()-previousGoodV0.E()),backgroundCandidate->Pt());
               }
             }
-            delete backgroundCandidate;
-            backgroundCandidate = 0x0;
           }
         }
       }
@@ -6802,29 +6795,22 @@ void AliAnalysisTaskGammaConvCalo::CalculateBackground(){
     if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->DoConvCaloMixing())){
       // mixing current clusters with previous conversion photons
       for(Int_t nEventsInBG=0;nEventsInBG <fBGHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-        AliGammaConversionAODVector *previousEventV0s = fBGHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
+        AliGammaConversionPhotonVector *previousEventV0s = fBGHandler[fiCut]->GetBGPhotons(zbin,mbin,nEventsInBG);
         if(previousEventV0s){
           if(fMoveParticleAccordingToVertex == kTRUE || ((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0 ){
             bgEventVertex = fBGHandler[fiCut]->GetBGEventVertex(zbin,mbin,nEventsInBG);
+            if(bgEventVertex){
+              MoveBGEventPhotons(*previousEventV0s,bgEventVertex,movedEventV0s);
+              previousEventV0s = &movedEventV0s;
+            }
           }
           for(Int_t iCurrent=0;iCurrent<fClusterCandidates->GetEntries();iCurrent++){
             AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fClusterCandidates->At(iCurrent));
             for(UInt_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
 
-              AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-
-              if(fMoveParticleAccordingToVertex == kTRUE){
-                if (bgEventVertex){
-                  MoveParticleAccordingToVertex(&previousGoodV0,bgEventVertex);
-                }
-              }
-              if(((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
-                if (bgEventVertex){
-                  RotateParticleAccordingToEP(&previousGoodV0,bgEventVertex->fEP,fEventPlaneAngle);
-                }
-              }
-
-              AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
+              AliAODConversionPhoton &previousGoodV0 = (*previousEventV0s)[iPrevious];
+              AliAODConversionMother bgCandidate(&currentEventGoodV0,&previousGoodV0);
+              AliAODConversionMother *backgroundCandidate = &bgCandidate;
               backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
               if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->MesonIsSelected(backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()))){
                 fHistoMotherBackInvMassPt[fiCut]->Fill(backgroundCandidate->M(),backgroundCandidate->Pt(),fWeightJetJetMC);
@@ -6839,8 +6825,6 @@ void AliAnalysisTaskGammaConvCalo::CalculateBackground(){
                   fHistoBckHBTDeltaEPt[fiCut]->Fill(abs(currentEventGoodV0.E()-previousGoodV0.E()),backgroundCandidate->Pt());
                 }
               }
-              delete backgroundCandidate;
-              backgroundCandidate = 0x0;
             }
           }
         }
@@ -6961,6 +6945,22 @@ void AliAnalysisTaskGammaConvCalo::MoveParticleAccordingToVertex(AliAODConversio
   Double_t movedPlace[3] = {particle->GetConversionX() - dx,particle->GetConversionY() - dy,particle->GetConversionZ() - dz};
   particle->SetConversionPoint(movedPlace);
 }
+
+//________________________________________________________________________
+void AliAnalysisTaskGammaConvCalo::MoveBGEventPhotons(const AliGammaConversionPhotonVector &photons, const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex, AliGammaConversionPhotonVector &movedPhotons){
+  // copies of the photons of a BG event moved to the current vertex and rotated to the
+  // current event plane, done once per BG event instead of once per photon pair
+  movedPhotons.clear();
+  for(UInt_t i=0;i<photons.size();i++){
+    movedPhotons.push_back(photons[i]);
+    if(fMoveParticleAccordingToVertex == kTRUE){
+      MoveParticleAccordingToVertex(&movedPhotons.back(),vertex);
+    }
+    if(((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
+      RotateParticleAccordingToEP(&movedPhotons.back(),vertex->fEP,fEventPlaneAngle);
+    }
+  }
+}
 //________________________________________________________________________
 void AliAnalysisTaskGammaConvCalo::UpdateEventByEventData(){
   //see header file for documentation
@@ -7123,6 +7123,16 @@ void AliAnalysisTaskGammaConvCalo::Terminate(const Option_t *)
 {
 
   //fOutputContainer->Print(); // Will crash on GRID
+
+  // memory of the photons buffered for the mixed event background, local running only
+  if(fDebug > 0 && fBGHandler && fMesonCutArray){
+    for(Int_t iCut = 0; iCut<fnCuts;iCut++){
+      AliConversionMesonCuts *mesonCuts = (AliConversionMesonCuts*)fMesonCutArray->At(iCut);
+      if(!mesonCuts || !mesonCuts->DoBGCalculation() || mesonCuts->BackgroundHandlerType() != 0) continue;
+      cout << "Cut " << mesonCuts->GetCutNumber() << ": ";
+      fBGHandler[iCut]->PrintBGPhotonMemory();
+    }
+  }
 }
 
 //________________________________________________________________________
@@ -125,6 +125,9 @@ class AliAnalysisTaskGammaConvCalo : public AliAnalysisTaskSE {
                                                   Int_t pdgCode[] );
     void MoveParticleAccordingToVertex          ( AliAODConversionPhoton* particle,
                                                   const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex);
+    void MoveBGEventPhotons                     ( const AliGammaConversionPhotonVector &photons,
+                                                  const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex,
+                                                  AliGammaConversionPhotonVector &movedPhotons);
     void UpdateEventByEventData         ();
 
     // Additional functions for convenience
@@ -5187,26 +5187,25 @@ void AliAnalysisTaskGammaConvV1::CalculateBackground(){
 
   } else {
     AliGammaConversionAODBGHandler::GammaConversionVertex *bgEventVertex = NULL;
+    AliGammaConversionPhotonVector movedEventV0s;
 
     if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->UseTrackMultiplicity()){
       for(Int_t nEventsInBG=0;nEventsInBG<fBGHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-        AliGammaConversionAODVector *previousEventV0s = fBGHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
+        AliGammaConversionPhotonVector *previousEventV0s = fBGHandler[fiCut]->GetBGPhotons(zbin,mbin,nEventsInBG);
         if(fMoveParticleAccordingToVertex == kTRUE || ((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
           bgEventVertex = fBGHandler[fiCut]->GetBGEventVertex(zbin,mbin,nEventsInBG);
+          if(bgEventVertex){
+            MoveBGEventPhotons(*previousEventV0s,bgEventVertex,movedEventV0s);
+            previousEventV0s = &movedEventV0s;
+          }
         }
 
         for(Int_t iCurrent=0;iCurrent<fGammaCandidates->GetEntries();iCurrent++){
         AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fGammaCandidates->At(iCurrent));
         for(UInt_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
-          AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-          if(fMoveParticleAccordingToVertex == kTRUE){
-            MoveParticleAccordingToVertex(&previousGoodV0,bgEventVertex);
-          }
-          if(((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
-            RotateParticleAccordingToEP(&previousGoodV0,bgEventVertex->fEP,fEventPlaneAngle);
-          }
-
-          AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
+          AliAODConversionPhoton &previousGoodV0 = (*previousEventV0s)[iPrevious];
+          AliAODConversionMother bgCandidate(&currentEventGoodV0,&previousGoodV0);
+          AliAODConversionMother *backgroundCandidate = &bgCandidate;
           backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
           if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))
             ->MesonIsSelected(backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()))){
@@ -5218,33 +5217,27 @@ void AliAnalysisTaskGammaConvV1::CalculateBackground(){
               else sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill, fWeightJetJetMC);
             }
           }
-          delete backgroundCandidate;
-          backgroundCandidate = 0x0;
         }
         }
       }
     } else {
       for(Int_t nEventsInBG=0;nEventsInBG <fBGHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-        AliGammaConversionAODVector *previousEventV0s = fBGHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
+        AliGammaConversionPhotonVector *previousEventV0s = fBGHandler[fiCut]->GetBGPhotons(zbin,mbin,nEventsInBG);
         if(previousEventV0s){
         if(fMoveParticleAccordingToVertex == kTRUE || ((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
           bgEventVertex = fBGHandler[fiCut]->GetBGEventVertex(zbin,mbin,nEventsInBG);
+          if(bgEventVertex){
+            MoveBGEventPhotons(*previousEventV0s,bgEventVertex,movedEventV0s);
+            previousEventV0s = &movedEventV0s;
+          }
         }
         for(Int_t iCurrent=0;iCurrent<fGammaCandidates->GetEntries();iCurrent++){
           AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fGammaCandidates->At(iCurrent));
           for(UInt_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
 
-            AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-
-            if(fMoveParticleAccordingToVertex == kTRUE){
-              MoveParticleAccordingToVertex(&previousGoodV0,bgEventVertex);
-            }
-            if(((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
-              RotateParticleAccordingToEP(&previousGoodV0,bgEventVertex->fEP,fEventPlaneAngle);
-            }
-
-
-            AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
+            AliAODConversionPhoton &previousGoodV0 = (*previousEventV0s)[iPrevious];
+            AliAODConversionMother bgCandidate(&currentEventGoodV0,&previousGoodV0);
+            AliAODConversionMother *backgroundCandidate = &bgCandidate;
             backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
             if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))
               ->MesonIsSelected(backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()))){
@@ -5264,8 +5257,6 @@ void AliAnalysisTaskGammaConvV1::CalculateBackground(){
                 else sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill, fWeightJetJetMC);
               }
             }
-            delete backgroundCandidate;
-            backgroundCandidate = 0x0;
           }
         }
         }
@@ -5391,6 +5382,22 @@ void AliAnalysisTaskGammaConvV1::MoveParticleAccordingToVertex(AliAODConversionP
   particle->SetConversionPoint(movedPlace);
 }
 
+//________________________________________________________________________
+void AliAnalysisTaskGammaConvV1::MoveBGEventPhotons(const AliGammaConversionPhotonVector &photons, const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex, AliGammaConversionPhotonVector &movedPhotons){
+  // copies of the photons of a BG event moved to the current vertex and rotated to the
+  // current event plane, done once per BG event instead of once per photon pair
+  movedPhotons.clear();
+  for(UInt_t i=0;i<photons.size();i++){
+    movedPhotons.push_back(photons[i]);
+    if(fMoveParticleAccordingToVertex == kTRUE){
+      MoveParticleAccordingToVertex(&movedPhotons.back(),vertex);
+    }
+    if(((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
+      RotateParticleAccordingToEP(&movedPhotons.back(),vertex->fEP,fEventPlaneAngle);
+    }
+  }
+}
+
 //________________________________________________________________________
 void AliAnalysisTaskGammaConvV1::UpdateEventByEventData(){
   //see header file for documentation
@@ -5782,6 +5789,16 @@ void AliAnalysisTaskGammaConvV1::Terminate(const Option_t *)
 {
 
   //fOutputContainer->Print(); // Will crash on GRID
+
+  // memory of the photons buffered for the mixed event background, local running only
+  if(fDebug > 0 && fBGHandler && fMesonCutArray){
+    for(Int_t iCut = 0; iCut<fnCuts;iCut++){
+      AliConversionMesonCuts *mesonCuts = (AliConversionMesonCuts*)fMesonCutArray->At(iCut);
+      if(!mesonCuts || !mesonCuts->DoBGCalculation() || mesonCuts->BackgroundHandlerType() != 0) continue;
+      cout << "Cut " << mesonCuts->GetCutNumber() << ": ";
+      fBGHandler[iCut]->PrintBGPhotonMemory();
+    }
+  }
 }
 
 //________________________________________________________________________
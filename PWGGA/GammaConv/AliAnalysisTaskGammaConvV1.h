@@ -83,6 +83,7 @@ class AliAnalysisTaskGammaConvV1 : public AliAnalysisTaskSE {
     void FillPhotonCombinatorialMothersHistESD(TParticle *daughter,TParticle *mother);
     void FillPhotonCombinatorialMothersHistAOD(AliAODMCParticle *daughter, AliAODMCParticle* motherCombPart);
     void MoveParticleAccordingToVertex(AliAODConversionPhoton* particle,const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex);
+    void MoveBGEventPhotons(const AliGammaConversionPhotonVector &photons, const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex, AliGammaConversionPhotonVector &movedPhotons);
     void UpdateEventByEventData();
     void SetLogBinningXTH2(TH2* histoRebin);
     Int_t GetSourceClassification(Int_t daughter, Int_t pdgCode);
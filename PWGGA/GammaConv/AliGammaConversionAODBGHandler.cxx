@@ -45,6 +45,7 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler() :
 	fBinLimitsArrayZ(NULL),
 	fBinLimitsArrayMultiplicity(NULL),
 	fBGEvents(),
+	fBGPhotons(),
 	fBGEventsENeg(),
 	fBGEventsMeson(),
 	fBGEventsMCParticle()
@@ -68,6 +69,7 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler(Int_t binsZ,Int_t
 	fBinLimitsArrayZ(NULL),
 	fBinLimitsArrayMultiplicity(NULL),
 	fBGEvents(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
+	fBGPhotons(binsZ,AliGammaConversionPhotonMultipicityVector(binsMultiplicity,AliGammaConversionPhotonBGEventVector(nEvents))),
 	fBGEventsENeg(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
 	fBGEventsMeson(binsZ,AliGammaConversionMotherMultipicityVector(binsMultiplicity,AliGammaConversionMotherBGEventVector(nEvents))),
 	fBGEventsMCParticle(binsZ,AliGammaMCParticleMultipicityVector(binsMultiplicity,AliGammaMCParticleBGEventVector(nEvents)))
@@ -93,6 +95,7 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler(Int_t collisionSy
 	fBinLimitsArrayZ(NULL),
 	fBinLimitsArrayMultiplicity(NULL),
 	fBGEvents(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
+	fBGPhotons(binsZ,AliGammaConversionPhotonMultipicityVector(binsMultiplicity,AliGammaConversionPhotonBGEventVector(nEvents))),
 	fBGEventsENeg(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
 	fBGEventsMeson(binsZ,AliGammaConversionMotherMultipicityVector(binsMultiplicity,AliGammaConversionMotherBGEventVector(nEvents))),
 	fBGEventsMCParticle(binsZ,AliGammaMCParticleMultipicityVector(binsMultiplicity,AliGammaMCParticleBGEventVector(nEvents)))
@@ -398,11 +401,25 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler(const AliGammaCon
 	fBinLimitsArrayZ(original.fBinLimitsArrayZ),
 	fBinLimitsArrayMultiplicity(original.fBinLimitsArrayMultiplicity),
 	fBGEvents(original.fBGEvents),
+	fBGPhotons(original.fBGPhotons),
 	fBGEventsENeg(original.fBGEventsENeg),
 	fBGEventsMeson(original.fBGEventsMeson),
 	fBGEventsMCParticle(original.fBGEventsMCParticle)
 {
 	//copy constructor	
+	// the BG photons are copied, point to the copies
+	for(UInt_t z=0;z<fBGPhotons.size();z++){
+		for(UInt_t m=0;m<fBGPhotons[z].size();m++){
+			for(UInt_t event=0;event<fBGPhotons[z][m].size();event++){
+				AliGammaConversionPhotonVector &photons = fBGPhotons[z][m][event];
+				if(photons.empty()) continue;
+				fBGEvents[z][m][event].resize(photons.size());
+				for(UInt_t d=0;d<photons.size();d++){
+					fBGEvents[z][m][event][d] = &photons[d];
+				}
+			}
+		}
+	}
 }
 
 //_____________________________________________________________________________________________________________________________
@@ -655,15 +672,21 @@ void AliGammaConversionAODBGHandler::AddEvent(TList* const eventGammas,Double_t
 	//  cout<<"Checking the entries: Z="<<z<<", M="<<m<<", eventCounter="<<eventCounter<<endl;
 
 	//  cout<<"The size of this vector is: "<<fBGEvents[z][m][eventCounter].size()<<endl;
-    for(UInt_t d=0;d<fBGEvents[z][m][eventCounter].size();d++){
-		delete (AliAODConversionPhoton*)(fBGEvents[z][m][eventCounter][d]);
-	}
-	fBGEvents[z][m][eventCounter].clear();
+	// the photons are copied by value into the slot of the event, the memory
+	// of the slot is kept and reused by the next event going to it
+	AliGammaConversionPhotonVector &photons = fBGPhotons[z][m][eventCounter];
+	photons.clear();
+	photons.reserve(eventGammas->GetEntries());
 	
 	// add the gammas to the vector
 	for(Int_t i=0; i< eventGammas->GetEntries();i++){
 		//    AliKFParticle *t = new AliKFParticle(*(AliKFParticle*)(eventGammas->At(i)));
-		fBGEvents[z][m][eventCounter].push_back(new AliAODConversionPhoton(*(AliAODConversionPhoton*)(eventGammas->At(i))));
+		photons.push_back(*(AliAODConversionPhoton*)(eventGammas->At(i)));
+	}
+	// pointers for GetBGGoodV0s, set once all photons are in place
+	fBGEvents[z][m][eventCounter].resize(photons.size());
+	for(UInt_t d=0;d<photons.size();d++){
+		fBGEvents[z][m][eventCounter][d] = &photons[d];
 	}
 	fBGEventCounter[z][m]++;
 }
@@ -715,7 +738,7 @@ void AliGammaConversionAODBGHandler::AddMesonEvent(const std::vector<AliAODConve
   fBGEventVertex[z][m][eventCounter].fEP = epvalue;
 
   //first clear the vector
-  for(UInt_t d=0;d<fBGEvents[z][m][eventCounter].size();d++){
+  for(UInt_t d=0;d<fBGEventsMeson[z][m][eventCounter].size();d++){
     delete (AliAODConversionMother*)(fBGEventsMeson[z][m][eventCounter][d]);
   }
   fBGEventsMeson[z][m][eventCounter].clear();
@@ -838,3 +861,35 @@ void AliGammaConversionAODBGHandler::PrintBGArray(){
 		}
 	}
 }
+
+//_____________________________________________________________________________________________________________________________
+Long64_t AliGammaConversionAODBGHandler::GetBGPhotonMemory() const{
+	// memory reserved for the BG photons and their pointers
+	Long64_t memory = 0;
+	for(UInt_t z=0;z<fBGPhotons.size();z++){
+		for(UInt_t m=0;m<fBGPhotons[z].size();m++){
+			for(UInt_t event=0;event<fBGPhotons[z][m].size();event++){
+				memory += fBGPhotons[z][m][event].capacity()*sizeof(AliAODConversionPhoton);
+				memory += fBGEvents[z][m][event].capacity()*sizeof(AliAODConversionPhoton*);
+			}
+		}
+	}
+	return memory;
+}
+
+//_____________________________________________________________________________________________________________________________
+void AliGammaConversionAODBGHandler::PrintBGPhotonMemory() const{
+	//see headerfile for documentation
+	Long64_t nPhotons = 0;
+	Long64_t nReserved = 0;
+	for(UInt_t z=0;z<fBGPhotons.size();z++){
+		for(UInt_t m=0;m<fBGPhotons[z].size();m++){
+			for(UInt_t event=0;event<fBGPhotons[z][m].size();event++){
+				nPhotons += fBGPhotons[z][m][event].size();
+				nReserved += fBGPhotons[z][m][event].capacity();
+			}
+		}
+	}
+	cout<<"BG photons: "<<nPhotons<<" stored, "<<nReserved<<" reserved in "<<fNBinsZ<<" x "<<fNBinsMultiplicity<<" x "<<fNEvents<<" events, "
+	    <<GetBGPhotonMemory()/1024.<<" kB"<<endl;
+}
@@ -23,6 +23,7 @@
 #include "AliAODMCParticle.h"
 
 typedef std::vector<AliAODConversionPhoton*> AliGammaConversionAODVector;
+typedef std::vector<AliAODConversionPhoton> AliGammaConversionPhotonVector;
 typedef std::vector<AliAODConversionMother*> AliGammaConversionMotherAODVector;
 typedef std::vector<AliAODMCParticle*> AliAODMCParticleVector;
 
@@ -42,6 +43,10 @@ class AliGammaConversionAODBGHandler : public TObject {
 	typedef std::vector<AliGammaConversionBGEventVector> AliGammaConversionMultipicityVector;
 	typedef std::vector<AliGammaConversionMultipicityVector> AliGammaConversionBGVector;
 
+	typedef std::vector<AliGammaConversionPhotonVector> AliGammaConversionPhotonBGEventVector;
+	typedef std::vector<AliGammaConversionPhotonBGEventVector> AliGammaConversionPhotonMultipicityVector;
+	typedef std::vector<AliGammaConversionPhotonMultipicityVector> AliGammaConversionPhotonBGVector;
+
 	typedef std::vector<AliGammaConversionMotherAODVector> AliGammaConversionMotherBGEventVector;
 	typedef std::vector<AliGammaConversionMotherBGEventVector> AliGammaConversionMotherMultipicityVector;
 	typedef std::vector<AliGammaConversionMotherMultipicityVector> AliGammaConversionMotherBGVector;
@@ -76,6 +81,8 @@ class AliGammaConversionAODBGHandler : public TObject {
 
 	// Get BG photons
 	AliGammaConversionAODVector* GetBGGoodV0s(Int_t zbin, Int_t mbin, Int_t event);
+	// BG photons stored contiguously by value, same order as GetBGGoodV0s
+	AliGammaConversionPhotonVector* GetBGPhotons(Int_t zbin, Int_t mbin, Int_t event){return &fBGPhotons[zbin][mbin][event];}
         AliAODMCParticleVector* GetBGGoodV0sMC(Int_t zbin, Int_t mbin, Int_t event);
 	
 	// Get BG mesons
@@ -86,6 +93,10 @@ class AliGammaConversionAODBGHandler : public TObject {
 	
 	void PrintBGArray();
 
+	// memory reserved for the BG photons (bytes), bounded by the largest event seen in each slot
+	Long64_t GetBGPhotonMemory() const;
+	void PrintBGPhotonMemory() const;
+
 	GammaConversionVertex * GetBGEventVertex(Int_t zbin, Int_t mbin, Int_t event){return &fBGEventVertex[zbin][mbin][event];}
 
 	Double_t GetBGProb(Int_t z, Int_t m){return fBGProbability[z][m];}
@@ -105,10 +116,11 @@ class AliGammaConversionAODBGHandler : public TObject {
 		Double_t *							fBinLimitsArrayZ;				//! bin limits z array
 		Double_t *							fBinLimitsArrayMultiplicity;	//! bin limit multiplicity array
 		AliGammaConversionBGVector 			fBGEvents; 						// photon background events
+		AliGammaConversionPhotonBGVector 	fBGPhotons; 					//! photons of the background events, owned by value, memory reused between events
 		AliGammaConversionBGVector 			fBGEventsENeg; 					// electron background electron events
 		AliGammaConversionMotherBGVector                fBGEventsMeson; 				// neutral meson background events
 		AliAODMCParticleBGVector 	                fBGEventsMCParticle; 				// MC Particle background events
 		
-	ClassDef(AliGammaConversionAODBGHandler,8)
+	ClassDef(AliGammaConversionAODBGHandler,9)
 };
 #endif
@@ -63,7 +63,8 @@ fDstarTClArr(0),
 fCascadesTClArr(0),
 fLikeSign2ProngTClArr(0),
 fLikeSign3ProngTClArr(0),
-fHFUtilInfo(0)
+fHFUtilInfo(0),
+fNThreads(0)
 {
   // Default constructor
 }
@@ -83,7 +84,8 @@ fDstarTClArr(0),
 fCascadesTClArr(0),
 fLikeSign2ProngTClArr(0),
 fLikeSign3ProngTClArr(0),
-fHFUtilInfo(0)
+fHFUtilInfo(0),
+fNThreads(0)
 {
   // Standard constructor
 
@@ -116,6 +118,7 @@ void AliAnalysisTaskSEVertexingHF::Init()
   }
 
   fVHF = (AliAnalysisVertexingHF*)gROOT->ProcessLine("ConfigVertexingHF()");  
+  if(fNThreads>0) fVHF->SetNThreads(fNThreads);
   fVHF->PrintStatus();
 
 
@@ -151,6 +154,9 @@ void AliAnalysisTaskSEVertexingHF::UserCreateOutputObjects()
     return;
   }
 
+  // 3 prong candidates on several threads (AliAnalysisVertexingHF::SetNThreads)
+  if(fVHF->GetNThreads()>1) ROOT::EnableThreadSafety();
+
   fVerticesHFTClArr = new TClonesArray("AliAODVertex", 0);
   fVerticesHFTClArr->SetName("VerticesHF");
   AddAODBranch("TClonesArray", &fVerticesHFTClArr, filename);
@@ -38,6 +38,9 @@ class AliAnalysisTaskSEVertexingHF : public AliAnalysisTaskSE
   void SetDeltaAODFileName(const char* name) {fDeltaAODFileName=name;}
   const char* GetDeltaAODFileName() const {return fDeltaAODFileName.Data();}
   AliAnalysisVertexingHF *GetVertexingHF() const {return fVHF;}
+  /// threads for the 3 prong candidates, overrides the ConfigVertexingHF.C setting if >0
+  void SetNThreads(Int_t n) {fNThreads=n;}
+  Int_t GetNThreads() const {return fNThreads;}
   
  private:
 
@@ -57,9 +60,10 @@ class AliAnalysisTaskSEVertexingHF : public AliAnalysisTaskSE
   TClonesArray *fLikeSign2ProngTClArr; /// Array of LikeSign2Prong
   TClonesArray *fLikeSign3ProngTClArr; /// Array of LikeSign3Prong
   AliAODHFUtil *fHFUtilInfo;              /// VZERO branch (to be removed)
+  Int_t         fNThreads;             /// threads for the 3 prong candidates (see AliAnalysisVertexingHF::SetNThreads)
 
   /// \cond CLASSIMP     
-  ClassDef(AliAnalysisTaskSEVertexingHF,6); /// AliAnalysisTaskSE for the reconstruction of heavy-flavour decay candidates
+  ClassDef(AliAnalysisTaskSEVertexingHF,7); /// AliAnalysisTaskSE for the reconstruction of heavy-flavour decay candidates
   /// \endcond
 };
 
@@ -64,17 +64,33 @@
 #include "AliRDHFCutsDStartoKpipi.h"
 #include "AliAnalysisFilter.h"
 #include "AliAnalysisVertexingHF.h"
+#include "AliVertexingHFPairPrefilter.h"
 #include "AliMixedEvent.h"
 #include "AliESDv0.h"
 #include "AliAODv0.h"
 #include "AliCodeTimer.h"
 #include "AliMultSelection.h"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <thread>
 
 /// \cond CLASSIMP
 ClassImp(AliAnalysisVertexingHF);
 /// \endcond
 
+namespace {
+  // below this number of selected tracks the 3 prongs are done serially
+  const Int_t kMinTracksFor3ProngThreads=50;
+
+  // key of the triplet (i1,i2,i3) of the 2nd loop on positive (loop=0)
+  // or negative (loop=1) tracks
+  inline Long64_t TripletKey(Int_t nTrks, Int_t i1, Int_t i2, Int_t i3, Int_t loop)
+  {
+    return ((((Long64_t)i1*nTrks+i2)*nTrks+i3)<<1)|loop;
+  }
+}
+
 //----------------------------------------------------------------------------
 AliAnalysisVertexingHF::AliAnalysisVertexingHF():
 fInputAOD(kFALSE),
@@ -139,6 +155,9 @@ fFindVertexForDstar(kTRUE),
 fFindVertexForCascades(kTRUE),
 fV0TypeForCascadeVertex(0),
 fMassCutBeforeVertexing(kFALSE),
+fUsePairPrefilter(kTRUE),
+fNThreads(1),
+fThreadWorkers(0),
 fMassCalc2(0),
 fMassCalc3(0),
 fMassCalc4(0),
@@ -238,6 +257,9 @@ fFindVertexForDstar(source.fFindVertexForDstar),
 fFindVertexForCascades(source.fFindVertexForCascades),
 fV0TypeForCascadeVertex(source.fV0TypeForCascadeVertex),
 fMassCutBeforeVertexing(source.fMassCutBeforeVertexing),
+fUsePairPrefilter(source.fUsePairPrefilter),
+fNThreads(source.fNThreads),
+fThreadWorkers(0),
 fMassCalc2(source.fMassCalc2),
 fMassCalc3(source.fMassCalc3),
 fMassCalc4(source.fMassCalc4),
@@ -336,6 +358,8 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
   fFindVertexForCascades = source.fFindVertexForCascades;
   fV0TypeForCascadeVertex = source.fV0TypeForCascadeVertex;
   fMassCutBeforeVertexing = source.fMassCutBeforeVertexing;
+  fUsePairPrefilter = source.fUsePairPrefilter;
+  fNThreads = source.fNThreads;
   fMassCalc2 = source.fMassCalc2;
   fMassCalc3 = source.fMassCalc3;
   fMassCalc4 = source.fMassCalc4;
@@ -384,6 +408,7 @@ AliAnalysisVertexingHF::~AliAnalysisVertexingHF() {
   if(fMassCalc2) { delete fMassCalc2; fMassCalc2=0; }
   if(fMassCalc3) { delete fMassCalc3; fMassCalc3=0; }
   if(fMassCalc4) { delete fMassCalc4; fMassCalc4=0; }
+  if(fThreadWorkers) { delete fThreadWorkers; fThreadWorkers=0; }
 }
 //----------------------------------------------------------------------------
 TList *AliAnalysisVertexingHF::FillListOfCuts() {
@@ -661,6 +686,32 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
     Double_t minPtV0fromDp=fCutsDplustoK0spi->GetMinV0PtCut();
     if(minPtV0fromDp<minPtV0) minPtV0=minPtV0fromDp;
   }
+
+  // kinematic prefilter of the pairs and triplets: combinations which cannot
+  // fulfill any invariant mass selection, whatever the secondary vertex,
+  // are skipped before the DCA and the vertexing
+  AliVertexingHFPairPrefilter pairPrefilter;
+  Bool_t usePairPrefilter=kFALSE;
+  UChar_t *okThirdPos=0x0; // triplets (p1,n1,k) of the 2nd loop on positive tracks
+  UChar_t *okThirdNeg=0x0; // triplets (n1,p1,k) of the 2nd loop on negative tracks
+  if(fUsePairPrefilter && nSeleTrks>1 && SetupPairPrefilter(pairPrefilter)){
+    usePairPrefilter=kTRUE;
+    pairPrefilter.SetTracks(tracksAtVertex,nSeleTrks);
+    okThirdPos = new UChar_t[nSeleTrks];
+    okThirdNeg = new UChar_t[nSeleTrks];
+  }
+
+  // vertexing and selection of the 3 prong triplets on several threads:
+  // the candidates are then built in the loops below, in the usual order,
+  // and the triplets rejected by the threads are not vertexed again.
+  // These do not create TRefs, so the output is the same as without threads
+  Bool_t use3ProngThreads=kFALSE;
+  std::vector<Long64_t> selected3Prong;
+  if(fNThreads>1 && f3Prong && nSeleTrks>=kMinTracksFor3ProngThreads && Can3ProngRunInThreads()){
+    use3ProngThreads=kTRUE;
+    Select3ProngInThreads(event,seleTrksArray,tracksAtVertex,nSeleTrks,seleFlags,dcaMax,
+			  usePairPrefilter ? &pairPrefilter : 0x0,selected3Prong);
+  }
    
   // LOOP ON  POSITIVE  TRACKS
   for(iTrkP1=0; iTrkP1<nSeleTrks; iTrkP1++) {
@@ -868,6 +919,17 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
       }
 
+      // kinematic prefilter for the 2 prong candidates
+      Bool_t okPair2Prong=kTRUE;
+      if(usePairPrefilter) {
+	okPair2Prong=pairPrefilter.Select2Prong(iTrkP1,iTrkN1);
+	if(!okPair2Prong &&
+	   ((!f3Prong && !f4Prong) || (isLikeSign2Prong && !f3Prong))) {
+	  negtrack1=0;
+	  continue;
+	}
+      }
+
       // back to primary vertex
       //      postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
       //      negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
@@ -879,6 +941,23 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       dcap1n1 = postrack1->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
       if(dcap1n1>dcaMax) { negtrack1=0; continue; }
 
+      // kinematic prefilter for the 3 prong candidates: flag the third tracks
+      // of the two triplet loops, skip the pair if it has none
+      if(usePairPrefilter && f3Prong) {
+	pairPrefilter.Select3Prong(iTrkP1,iTrkN1,okThirdPos);
+	pairPrefilter.Select3Prong(iTrkN1,iTrkP1,okThirdNeg);
+	if(!okPair2Prong && !f4Prong) {
+	  Bool_t okTriplet=kFALSE;
+	  if(TESTBIT(seleFlags[iTrkP1],kBit3Prong) && TESTBIT(seleFlags[iTrkN1],kBit3Prong)) {
+	    for(Int_t iTrk3=0; iTrk3<nSeleTrks && !okTriplet; iTrk3++) {
+	      if(!TESTBIT(seleFlags[iTrk3],kBitDispl) || !TESTBIT(seleFlags[iTrk3],kBit3Prong)) continue;
+	      if((iTrk3>iTrkP1 && okThirdPos[iTrk3]) || (iTrk3>iTrkN1 && okThirdNeg[iTrk3])) okTriplet=kTRUE;
+	    }
+	  }
+	  if(!okTriplet) { negtrack1=0; continue; }
+	}
+      }
+
       // Vertexing
       twoTrackArray1->AddAt(postrack1,0);
       twoTrackArray1->AddAt(negtrack1,1);
@@ -1076,6 +1155,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	if(!TESTBIT(seleFlags[iTrkP1],kBit3Prong)) continue;
 	if(!TESTBIT(seleFlags[iTrkN1],kBit3Prong)) continue;
 
+	// kinematic prefilter (only 3 prongs are made from this triplet)
+	if(usePairPrefilter && !f4Prong && !okThirdPos[iTrkP2]) continue;
+
 	if(fMixEvent) {
 	  if(evtNumber[iTrkP1]==evtNumber[iTrkP2] ||
 	     evtNumber[iTrkN1]==evtNumber[iTrkP2] ||
@@ -1098,37 +1180,10 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	  }
 	}
 
-	if(fUseKaonPIDfor3Prong){
-	  if(!TESTBIT(seleFlags[iTrkN1],kBitKaonCompat)) continue;
-	}
-	Bool_t okForLcTopKpi=kTRUE;
+	Bool_t okForLcTopKpi=kTRUE,okForDsToKKpi=kTRUE;
 	Int_t pidLcStatus=3; // 3= OK as pKpi and Kpipi
-	if(fUsePIDforLc>0){
-	  if(!TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) &&
-	     !TESTBIT(seleFlags[iTrkP2],kBitProtonCompat) ){
-	    okForLcTopKpi=kFALSE;
-	    pidLcStatus=0;
-	  }
-	  if(okForLcTopKpi && fUsePIDforLc>1){
-	    okForLcTopKpi=kFALSE;
-	    pidLcStatus=0;
-	    if(TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) &&
-	       TESTBIT(seleFlags[iTrkP2],kBitPionCompat) ){
-	      okForLcTopKpi=kTRUE;
-	      pidLcStatus+=1; // 1= OK as pKpi
-	    }
-	    if(TESTBIT(seleFlags[iTrkP2],kBitProtonCompat) &&
-	       TESTBIT(seleFlags[iTrkP1],kBitPionCompat) ){
-	      okForLcTopKpi=kTRUE;
-	      pidLcStatus+=2; // 2= OK as piKp
-	    }
-	  }
-	}
-	Bool_t okForDsToKKpi=kTRUE;
-	if(fUseKaonPIDforDs){
-	  if(!TESTBIT(seleFlags[iTrkP1],kBitKaonCompat) &&
-	     !TESTBIT(seleFlags[iTrkP2],kBitKaonCompat) ) okForDsToKKpi=kFALSE;
-	}
+	if(!Check3ProngPID(seleFlags[iTrkN1],seleFlags[iTrkP1],seleFlags[iTrkP2],
+			   okForLcTopKpi,pidLcStatus,okForDsToKKpi)) continue;
 	// back to primary vertex
 	//	postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
 	//	postrack2->PropagateToDCA(fV1,fBzkG,kVeryBig);
@@ -1178,8 +1233,10 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	twoTrackArray2->AddAt(postrack2,0);
 	twoTrackArray2->AddAt(negtrack1,1);
 
-	// 3 prong candidates
-	if(f3Prong && massCutOK) {
+	// 3 prong candidates (if not rejected by the threads)
+	if(f3Prong && massCutOK &&
+	   (!use3ProngThreads || std::binary_search(selected3Prong.begin(),selected3Prong.end(),
+						    TripletKey(nSeleTrks,iTrkP1,iTrkN1,iTrkP2,0)))) {
 	  
 	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
 	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap2n1,dcap1p2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
@@ -1352,6 +1409,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	if(!TESTBIT(seleFlags[iTrkP1],kBit3Prong)) continue;
 	if(!TESTBIT(seleFlags[iTrkN1],kBit3Prong)) continue;
 
+	// kinematic prefilter (only 3 prongs are made in this loop)
+	if(usePairPrefilter && (!f3Prong || !okThirdNeg[iTrkN2])) continue;
+
 	if(fMixEvent) {
 	  if(evtNumber[iTrkP1]==evtNumber[iTrkN2] ||
 	     evtNumber[iTrkN1]==evtNumber[iTrkN2] ||
@@ -1369,37 +1429,10 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	  isLikeSign3Prong=kFALSE;
 	}
 
-	if(fUseKaonPIDfor3Prong){
-	  if(!TESTBIT(seleFlags[iTrkP1],kBitKaonCompat)) continue;
-	}
-	Bool_t okForLcTopKpi=kTRUE;
+	Bool_t okForLcTopKpi=kTRUE,okForDsToKKpi=kTRUE;
 	Int_t pidLcStatus=3; // 3= OK as pKpi and Kpipi
-	if(fUsePIDforLc>0){
-	  if(!TESTBIT(seleFlags[iTrkN1],kBitProtonCompat) &&
-	     !TESTBIT(seleFlags[iTrkN2],kBitProtonCompat) ){
-	    okForLcTopKpi=kFALSE;
-	    pidLcStatus=0;
-	  }
-	  if(okForLcTopKpi && fUsePIDforLc>1){
-	    okForLcTopKpi=kFALSE;
-	    pidLcStatus=0;
-	    if(TESTBIT(seleFlags[iTrkN1],kBitProtonCompat) &&
-	       TESTBIT(seleFlags[iTrkN2],kBitPionCompat) ){
-	      okForLcTopKpi=kTRUE;
-	      pidLcStatus+=1; // 1= OK as pKpi
-	    }
-	    if(TESTBIT(seleFlags[iTrkN2],kBitProtonCompat) &&
-	       TESTBIT(seleFlags[iTrkN1],kBitPionCompat) ){
-	      okForLcTopKpi=kTRUE;
-	      pidLcStatus+=2; // 2= OK as piKp
-	    }
-	  }
-	}
-	Bool_t okForDsToKKpi=kTRUE;
-	if(fUseKaonPIDforDs){
-	  if(!TESTBIT(seleFlags[iTrkN1],kBitKaonCompat) &&
-	     !TESTBIT(seleFlags[iTrkN2],kBitKaonCompat) ) okForDsToKKpi=kFALSE;
-	}
+	if(!Check3ProngPID(seleFlags[iTrkP1],seleFlags[iTrkN1],seleFlags[iTrkN2],
+			   okForLcTopKpi,pidLcStatus,okForDsToKKpi)) continue;
 
 	// back to primary vertex
 	// postrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
@@ -1439,7 +1472,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	twoTrackArray2->AddAt(postrack1,0);
 	twoTrackArray2->AddAt(negtrack2,1);
 
-	if(f3Prong) {
+	if(f3Prong &&
+	   (!use3ProngThreads || std::binary_search(selected3Prong.begin(),selected3Prong.end(),
+						    TripletKey(nSeleTrks,iTrkP1,iTrkN1,iTrkN2,1)))) {
 	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
 	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap1n2,dcan1n2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
 	  if(ok3Prong) {
@@ -1539,6 +1574,8 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   fourTrackArray->Delete();  delete fourTrackArray;
   delete [] seleFlags; seleFlags=NULL;
   if(evtNumber) {delete [] evtNumber; evtNumber=NULL;}
+  if(okThirdPos) {delete [] okThirdPos; okThirdPos=NULL;}
+  if(okThirdNeg) {delete [] okThirdNeg; okThirdNeg=NULL;}
   tracksAtVertex.Delete();
 
   if(fInputAOD) {
@@ -2417,10 +2454,13 @@ AliAODRecoDecayHF3Prong* AliAnalysisVertexingHF::Make3Prong(
 							    AliAODVertex *secVert,Double_t dispersion,
 							    const AliAODVertex *vertexp1n1, TObjArray *twoTrackArray2,
 							    Double_t dcap1n1,Double_t dcap2n1,Double_t dcap1p2,
-							    Bool_t useForLc, Bool_t useForDs, Bool_t &ok3Prong)
+							    Bool_t useForLc, Bool_t useForDs, Bool_t &ok3Prong,
+							    Bool_t selectOnly)
 {
   /// Make 3Prong candidates and check if they pass Dplus or Ds or Lambdac
   /// reconstruction cuts
+  /// With selectOnly, only the selection is done and no TRef is created
+  /// (threads of FindCandidates)
   // E.Bruna, F.Prino
   // AliCodeTimerAuto("",0);
 
@@ -2540,7 +2580,7 @@ AliAODRecoDecayHF3Prong* AliAnalysisVertexingHF::Make3Prong(
   }
 
   // Add TRefs to secondary vertex and daughter tracks only for candidates passing the filtering cuts
-  if(ok3Prong && fInputAOD){
+  if(ok3Prong && fInputAOD && !selectOnly){
     the3Prong->SetSecondaryVtx(secVert);
     AddDaughterRefs(secVert,(AliAODEvent*)event,threeTrackArray);
     Double_t dummyDisp;
@@ -2933,6 +2973,8 @@ void AliAnalysisVertexingHF::PrintStatus() const {
   }
   if(fRecoPrimVtxSkippingTrks) printf("RecoPrimVtxSkippingTrks\n");
   if(fRmTrksFromPrimVtx) printf("RmTrksFromPrimVtx\n");
+  if(fUsePairPrefilter) printf("Kinematic prefilter of pairs and triplets before vertexing\n");
+  if(fNThreads>1) printf("Selection of 3 prong candidates on %d threads\n",fNThreads);
   if(fD0toKpi) {
     printf("Reconstruct D0->Kpi candidates with cuts:\n");
     if(fCutsD0toKpi) fCutsD0toKpi->PrintAll();
@@ -3788,6 +3830,387 @@ void AliAnalysisVertexingHF::SetMasses(){
   fMassK=TDatabasePDG::Instance()->GetParticle(321)->Mass();
 }
 //-----------------------------------------------------------------------------
+Bool_t AliAnalysisVertexingHF::SetupPairPrefilter(AliVertexingHFPairPrefilter &prefilter) const {
+  /// Set the mass hypotheses of the kinematic prefilter, with the same
+  /// daughter masses, mass windows and pt cuts as the SelectInvMassAndPt*
+  /// functions; the mass windows are the union over the pt bins of the cuts.
+  /// Returns kFALSE if the prefilter cannot be used
+
+  if(fD0toKpi && !fCutsD0toKpi) return kFALSE;
+  if(fJPSItoEle && !fCutsJpsitoee) return kFALSE;
+  if(fDstar && !fCutsDStartoKpipi) return kFALSE;
+  if(f3Prong && (!fCutsDplustoKpipi || !fCutsDstoKKpi || !fCutsLctopKpi)) return kFALSE;
+
+  TDatabasePDG *pdgDB=TDatabasePDG::Instance();
+  Double_t massEle=pdgDB->GetParticle(11)->Mass();
+  Double_t massPi=pdgDB->GetParticle(211)->Mass();
+  Double_t massK=pdgDB->GetParticle(321)->Mass();
+  Double_t massP=pdgDB->GetParticle(2212)->Mass();
+  Double_t lolim2,hilim2,minPt;
+
+  prefilter.Clear2ProngHypotheses();
+  if(fD0toKpi){
+    minPt=fCutsD0toKpi->GetMinPtCandidate();
+    if(minPt<=0.1) minPt=0.;
+    lolim2=kVeryBig; hilim2=0.;
+    for(Int_t iPtBin=0; iPtBin<TMath::Max(1,fCutsD0toKpi->GetNPtBins()); iPtBin++){
+      Double_t mrange=fCutsD0toKpi->GetMassCut(iPtBin);
+      lolim2=TMath::Min(lolim2,(fMassDzero-mrange)*(fMassDzero-mrange));
+      hilim2=TMath::Max(hilim2,(fMassDzero+mrange)*(fMassDzero+mrange));
+    }
+    prefilter.Add2ProngHypothesis(massPi,massK,lolim2,hilim2,minPt);
+    prefilter.Add2ProngHypothesis(massK,massPi,lolim2,hilim2,minPt);
+  }
+  if(fJPSItoEle){
+    minPt=fCutsJpsitoee->GetMinPtCandidate();
+    if(minPt<=0.1) minPt=0.;
+    Double_t mrange=fCutsJpsitoee->GetMassCut();
+    prefilter.Add2ProngHypothesis(massEle,massEle,(fMassJpsi-mrange)*(fMassJpsi-mrange),
+				  (fMassJpsi+mrange)*(fMassJpsi+mrange),minPt);
+  }
+  if(fDstar){
+    // as in Make2Prong: the pair is checked with the pi and D0 masses
+    minPt=fCutsDStartoKpipi->GetMinPtCandidate();
+    if(minPt<=0.1) minPt=0.;
+    lolim2=kVeryBig; hilim2=0.;
+    for(Int_t iPtBin=0; iPtBin<TMath::Max(1,fCutsDStartoKpipi->GetNPtBins()); iPtBin++){
+      Double_t mrange=fCutsDStartoKpipi->GetMassCut(iPtBin);
+      lolim2=TMath::Min(lolim2,(fMassDstar-mrange)*(fMassDstar-mrange));
+      hilim2=TMath::Max(hilim2,(fMassDstar+mrange)*(fMassDstar+mrange));
+    }
+    prefilter.Add2ProngHypothesis(massPi,fMassDzero,lolim2,hilim2,minPt);
+  }
+
+  prefilter.Clear3ProngHypotheses();
+  if(f3Prong){
+    Double_t minPt3Prong = fMinPt3Prong>0.1 ? fMinPt3Prong : 0.;
+    // D+->Kpipi
+    lolim2=kVeryBig; hilim2=0.;
+    for(Int_t iPtBin=0; iPtBin<TMath::Max(1,fCutsDplustoKpipi->GetNPtBins()); iPtBin++){
+      Double_t mrange=fCutsDplustoKpipi->GetMassCut(iPtBin);
+      lolim2=TMath::Min(lolim2,(fMassDplus-mrange)*(fMassDplus-mrange));
+      hilim2=TMath::Max(hilim2,(fMassDplus+mrange)*(fMassDplus+mrange));
+    }
+    prefilter.Add3ProngHypothesis(massPi,massK,massPi,lolim2,hilim2,minPt3Prong);
+    // Ds+->KKpi (the KK mass cut is not applied by the prefilter)
+    lolim2=kVeryBig; hilim2=0.;
+    for(Int_t iPtBin=0; iPtBin<TMath::Max(1,fCutsDstoKKpi->GetNPtBins()); iPtBin++){
+      Double_t mrange=fCutsDstoKKpi->GetMassCut(iPtBin);
+      lolim2=TMath::Min(lolim2,(fMassDs-mrange)*(fMassDs-mrange));
+      hilim2=TMath::Max(hilim2,(fMassDs+mrange)*(fMassDs+mrange));
+    }
+    prefilter.Add3ProngHypothesis(massK,massK,massPi,lolim2,hilim2,minPt3Prong);
+    prefilter.Add3ProngHypothesis(massPi,massK,massK,lolim2,hilim2,minPt3Prong);
+    // Lc->pKpi, both hypotheses whatever the proton PID
+    lolim2=kVeryBig; hilim2=0.;
+    for(Int_t iPtBin=0; iPtBin<TMath::Max(1,fCutsLctopKpi->GetNPtBins()); iPtBin++){
+      Double_t mrange=fCutsLctopKpi->GetMassCut(iPtBin);
+      lolim2=TMath::Min(lolim2,(fMassLambdaC-mrange)*(fMassLambdaC-mrange));
+      hilim2=TMath::Max(hilim2,(fMassLambdaC+mrange)*(fMassLambdaC+mrange));
+    }
+    minPt=TMath::Max(minPt3Prong,(Double_t)fCutsLctopKpi->GetMinPtCandidate());
+    prefilter.Add3ProngHypothesis(massP,massK,massPi,lolim2,hilim2,minPt);
+    prefilter.Add3ProngHypothesis(massPi,massK,massP,lolim2,hilim2,minPt);
+  }
+
+  return kTRUE;
+}
+//-----------------------------------------------------------------------------
+Bool_t AliAnalysisVertexingHF::Check3ProngPID(UChar_t flagsOpp, UChar_t flags1, UChar_t flags2,
+					      Bool_t &okForLcTopKpi, Int_t &pidLcStatus,
+					      Bool_t &okForDsToKKpi) const {
+  /// PID compatibility of a triplet, from the selection flags of the track
+  /// with opposite charge and of the two tracks with the same charge.
+  /// Returns kFALSE if the triplet has to be skipped
+
+  if(fUseKaonPIDfor3Prong){
+    if(!TESTBIT(flagsOpp,kBitKaonCompat)) return kFALSE;
+  }
+  okForLcTopKpi=kTRUE;
+  pidLcStatus=3; // 3= OK as pKpi and Kpipi
+  if(fUsePIDforLc>0){
+    if(!TESTBIT(flags1,kBitProtonCompat) &&
+       !TESTBIT(flags2,kBitProtonCompat) ){
+      okForLcTopKpi=kFALSE;
+      pidLcStatus=0;
+    }
+    if(okForLcTopKpi && fUsePIDforLc>1){
+      okForLcTopKpi=kFALSE;
+      pidLcStatus=0;
+      if(TESTBIT(flags1,kBitProtonCompat) &&
+	 TESTBIT(flags2,kBitPionCompat) ){
+	okForLcTopKpi=kTRUE;
+	pidLcStatus+=1; // 1= OK as pKpi
+      }
+      if(TESTBIT(flags2,kBitProtonCompat) &&
+	 TESTBIT(flags1,kBitPionCompat) ){
+	okForLcTopKpi=kTRUE;
+	pidLcStatus+=2; // 2= OK as piKp
+      }
+    }
+  }
+  okForDsToKKpi=kTRUE;
+  if(fUseKaonPIDforDs){
+    if(!TESTBIT(flags1,kBitKaonCompat) &&
+       !TESTBIT(flags2,kBitKaonCompat) ) okForDsToKKpi=kFALSE;
+  }
+  return kTRUE;
+}
+//-----------------------------------------------------------------------------
+Bool_t AliAnalysisVertexingHF::Can3ProngRunInThreads() const {
+  /// The 3 prong selection can be done on threads only if it leaves
+  /// the tracks unchanged and does not use the KF vertexer
+  /// (static magnetic field)
+  if(fSecVtxWithKF || fRecoPrimVtxSkippingTrks || fRmTrksFromPrimVtx || fMixEvent) {
+    AliDebug(2,"3 prong candidates done serially with this configuration");
+    return kFALSE;
+  }
+  if(!fCutsDplustoKpipi || !fCutsDstoKKpi || !fCutsLctopKpi) return kFALSE;
+  return kTRUE;
+}
+//-----------------------------------------------------------------------------
+AliAnalysisVertexingHF* AliAnalysisVertexingHF::MakeThreadWorker() const {
+  /// Copy of this object for the 3 prong selection on a thread, with its own
+  /// vertexer, mass calculators and 3 prong cuts (the copy constructor shares
+  /// the pointers, the ones not needed by the selection are reset)
+
+  AliAnalysisVertexingHF *worker = new AliAnalysisVertexingHF(*this);
+  worker->fAODMapSize=0;
+  worker->fAODMap=0;
+  worker->fVertexerTracks=new AliVertexerTracks(fBzkG);
+  worker->fV1=0;
+  worker->fV1AOD=0;
+  worker->fTrackFilter=0;
+  worker->fTrackFilter2prongCentral=0;
+  worker->fTrackFilter3prongCentral=0;
+  worker->fTrackFilterSoftPi=0;
+  worker->fTrackFilterBachelor=0;
+  worker->fCutsD0toKpi=0;
+  worker->fCutsJpsitoee=0;
+  worker->fCutsDplustoK0spi=0;
+  worker->fCutsDplustoKpipi=new AliRDHFCutsDplustoKpipi(*fCutsDplustoKpipi);
+  worker->fCutsDstoK0sK=0;
+  worker->fCutsDstoKKpi=new AliRDHFCutsDstoKKpi(*fCutsDstoKKpi);
+  worker->fCutsLctopKpi=new AliRDHFCutsLctopKpi(*fCutsLctopKpi);
+  worker->fCutsLctoV0=0;
+  worker->fCutsD0toKpipipi=0;
+  worker->fCutsDStartoKpipi=0;
+  worker->fListOfCuts=0;
+  Double_t d02[2]={0.,0.};
+  Double_t d03[3]={0.,0.,0.};
+  Double_t d04[4]={0.,0.,0.,0.};
+  worker->fMassCalc2 = new AliAODRecoDecay(0x0,2,0,d02);
+  worker->fMassCalc3 = new AliAODRecoDecay(0x0,3,1,d03);
+  worker->fMassCalc4 = new AliAODRecoDecay(0x0,4,0,d04);
+  worker->fNThreads=1;
+  return worker;
+}
+//-----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::Select3ProngInThreads(AliVEvent *event,
+						   const TObjArray &seleTrksArray,
+						   const TObjArray &tracksAtVertex,
+						   Int_t nSeleTrks,
+						   const UChar_t *seleFlags,
+						   Float_t dcaMax,
+						   const AliVertexingHFPairPrefilter *prefilter,
+						   std::vector<Long64_t> &selected3Prong) {
+  /// Vertexing and selection of the 3 prong triplets on fNThreads threads.
+  /// The first positive tracks are distributed to the threads, each thread
+  /// works on its own copy of this object and of the selected tracks.
+  /// The keys of the triplets passing the 3 prong cuts are returned sorted,
+  /// independently of the number of threads
+
+  if(!fThreadWorkers) {
+    fThreadWorkers = new TObjArray(fNThreads);
+    fThreadWorkers->SetOwner();
+  }
+  while(fThreadWorkers->GetEntriesFast()<fNThreads) fThreadWorkers->AddLast(MakeThreadWorker());
+
+  // event settings of the copies
+  for(Int_t iThread=0; iThread<fNThreads; iThread++) {
+    AliAnalysisVertexingHF *worker=(AliAnalysisVertexingHF*)fThreadWorkers->UncheckedAt(iThread);
+    worker->fInputAOD=fInputAOD;
+    worker->fBzkG=fBzkG;
+    worker->fVertexerTracks->SetFieldkG(fBzkG);
+    delete worker->fV1;
+    worker->fV1=new AliESDVertex(*fV1);
+    delete worker->fV1AOD;
+    worker->fV1AOD=new AliAODVertex(*fV1AOD);
+    worker->fMinPt3Prong=fMinPt3Prong;
+  }
+
+  std::atomic<Int_t> nextTrkP1(0);
+  std::vector<std::vector<Long64_t> > selectedThread(fNThreads);
+  auto selectTriplets = [&](Int_t iThread) {
+    AliAnalysisVertexingHF *worker=(AliAnalysisVertexingHF*)fThreadWorkers->UncheckedAt(iThread);
+    // the tracks are moved during the vertexing, each thread has its copies
+    TObjArray tracks(nSeleTrks);
+    tracks.SetOwner();
+    for(Int_t iTrk=0; iTrk<nSeleTrks; iTrk++) {
+      tracks.AddLast(new AliESDtrack(*(AliESDtrack*)seleTrksArray.UncheckedAt(iTrk)));
+    }
+    std::vector<UChar_t> okThirdPos(nSeleTrks),okThirdNeg(nSeleTrks);
+    Int_t iTrkP1;
+    while((iTrkP1=nextTrkP1++)<nSeleTrks) {
+      worker->Select3ProngTriplets(event,iTrkP1,tracks,tracksAtVertex,nSeleTrks,seleFlags,dcaMax,
+				   prefilter,okThirdPos.data(),okThirdNeg.data(),selectedThread[iThread]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for(Int_t iThread=1; iThread<fNThreads; iThread++) threads.emplace_back(selectTriplets,iThread);
+  selectTriplets(0);
+  for(auto &thread : threads) thread.join();
+
+  selected3Prong.clear();
+  for(Int_t iThread=0; iThread<fNThreads; iThread++) {
+    selected3Prong.insert(selected3Prong.end(),selectedThread[iThread].begin(),selectedThread[iThread].end());
+  }
+  std::sort(selected3Prong.begin(),selected3Prong.end());
+  return;
+}
+//-----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::Select3ProngTriplets(AliVEvent *event,Int_t iTrkP1,
+						  TObjArray &seleTrksArray,
+						  const TObjArray &tracksAtVertex,
+						  Int_t nSeleTrks,
+						  const UChar_t *seleFlags,
+						  Float_t dcaMax,
+						  const AliVertexingHFPairPrefilter *prefilter,
+						  UChar_t *okThirdPos,UChar_t *okThirdNeg,
+						  std::vector<Long64_t> &selected3Prong) {
+  /// Vertexing and selection of the 3 prong triplets of the first positive
+  /// track iTrkP1, with the same track selections as the 2nd loops on
+  /// positive and negative tracks of FindCandidates. The vertex of the
+  /// pair is not required, so a few more triplets can be tried here.
+  /// Nothing is stored and no TRef is created, the keys of the triplets
+  /// passing the cuts are appended to selected3Prong
+
+  if(!TESTBIT(seleFlags[iTrkP1],kBitDispl)) return;
+  if(!TESTBIT(seleFlags[iTrkP1],kBit3Prong)) return;
+  AliESDtrack *postrack1 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkP1);
+  if(postrack1->Charge()<0 && !fLikeSign) return;
+
+  Double_t xdummy,ydummy,dcap1n1,dcap2n1,dcap1p2,dcap1n2,dcan1n2,dispersion;
+  Double_t mompos1[3],mompos2[3],momneg1[3],momneg2[3];
+  Bool_t ok3Prong=kFALSE,massCutOK=kTRUE;
+  TObjArray threeTrackArray(3);
+  SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+  postrack1->GetPxPyPz(mompos1);
+
+  for(Int_t iTrkN1=0; iTrkN1<nSeleTrks; iTrkN1++) {
+    if(iTrkN1==iTrkP1) continue;
+    AliESDtrack *negtrack1 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkN1);
+    if(negtrack1->Charge()>0 && !fLikeSign) continue;
+    if(!TESTBIT(seleFlags[iTrkN1],kBitDispl)) continue;
+    if(!TESTBIT(seleFlags[iTrkN1],kBit3Prong)) continue;
+    Bool_t isLikeSign2Prong=kFALSE;
+    if(postrack1->Charge()==negtrack1->Charge()) { // like-sign
+      isLikeSign2Prong=kTRUE;
+      if(!fLikeSign || !fLikeSign3prong) continue;
+      if(iTrkN1<iTrkP1) continue;
+    } else { // unlike-sign
+      if(postrack1->Charge()<0 || negtrack1->Charge()>0) continue;
+    }
+
+    SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+    SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
+    negtrack1->GetPxPyPz(momneg1);
+    dcap1n1 = postrack1->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+    if(dcap1n1>dcaMax) continue;
+    if(prefilter) {
+      prefilter->Select3Prong(iTrkP1,iTrkN1,okThirdPos);
+      prefilter->Select3Prong(iTrkN1,iTrkP1,okThirdNeg);
+    }
+
+    // triplets (p1,n1,p2)
+    for(Int_t iTrkP2=iTrkP1+1; iTrkP2<nSeleTrks; iTrkP2++) {
+      if(iTrkP2==iTrkN1) continue;
+      AliESDtrack *postrack2 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkP2);
+      if(postrack2->Charge()<0) continue;
+      if(!TESTBIT(seleFlags[iTrkP2],kBitDispl)) continue;
+      if(!TESTBIT(seleFlags[iTrkP2],kBit3Prong)) continue;
+      if(prefilter && !okThirdPos[iTrkP2]) continue;
+      if(isLikeSign2Prong && postrack1->Charge()<0) continue;
+      Bool_t okForLcTopKpi=kTRUE,okForDsToKKpi=kTRUE;
+      Int_t pidLcStatus=3;
+      if(!Check3ProngPID(seleFlags[iTrkN1],seleFlags[iTrkP1],seleFlags[iTrkP2],
+			 okForLcTopKpi,pidLcStatus,okForDsToKKpi)) continue;
+
+      SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+      SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
+      SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
+      dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+      if(dcap2n1>dcaMax) continue;
+      dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
+      if(dcap1p2>dcaMax) continue;
+
+      threeTrackArray.AddAt(postrack1,0);
+      threeTrackArray.AddAt(negtrack1,1);
+      threeTrackArray.AddAt(postrack2,2);
+      if(fMassCutBeforeVertexing) {
+	postrack2->GetPxPyPz(mompos2);
+	Double_t pxDau[3]={mompos1[0],momneg1[0],mompos2[0]};
+	Double_t pyDau[3]={mompos1[1],momneg1[1],mompos2[1]};
+	Double_t pzDau[3]={mompos1[2],momneg1[2],mompos2[2]};
+	massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
+	if(!massCutOK) { threeTrackArray.Clear(); continue; }
+      }
+      AliAODVertex *secVert3PrAOD = ReconstructSecondaryVertex(&threeTrackArray,dispersion);
+      AliAODRecoDecayHF3Prong *io3Prong = Make3Prong(&threeTrackArray,event,secVert3PrAOD,dispersion,0x0,0x0,
+						     dcap1n1,dcap2n1,dcap1p2,okForLcTopKpi,okForDsToKKpi,
+						     ok3Prong,kTRUE);
+      if(ok3Prong) selected3Prong.push_back(TripletKey(nSeleTrks,iTrkP1,iTrkN1,iTrkP2,0));
+      if(io3Prong) delete io3Prong;
+      if(secVert3PrAOD) delete secVert3PrAOD;
+      threeTrackArray.Clear();
+    }
+
+    // triplets (n1,p1,n2)
+    for(Int_t iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
+      if(iTrkN2==iTrkP1) continue;
+      AliESDtrack *negtrack2 = (AliESDtrack*)seleTrksArray.UncheckedAt(iTrkN2);
+      if(negtrack2->Charge()>0) continue;
+      if(!TESTBIT(seleFlags[iTrkN2],kBitDispl)) continue;
+      if(!TESTBIT(seleFlags[iTrkN2],kBit3Prong)) continue;
+      if(prefilter && !okThirdNeg[iTrkN2]) continue;
+      if(isLikeSign2Prong && postrack1->Charge()>0) continue;
+      Bool_t okForLcTopKpi=kTRUE,okForDsToKKpi=kTRUE;
+      Int_t pidLcStatus=3;
+      if(!Check3ProngPID(seleFlags[iTrkP1],seleFlags[iTrkN1],seleFlags[iTrkN2],
+			 okForLcTopKpi,pidLcStatus,okForDsToKKpi)) continue;
+
+      SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
+      SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
+      SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
+      dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+      if(dcap1n2>dcaMax) continue;
+      dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+      if(dcan1n2>dcaMax) continue;
+
+      threeTrackArray.AddAt(negtrack1,0);
+      threeTrackArray.AddAt(postrack1,1);
+      threeTrackArray.AddAt(negtrack2,2);
+      if(fMassCutBeforeVertexing) {
+	negtrack2->GetPxPyPz(momneg2);
+	Double_t pxDau[3]={momneg1[0],mompos1[0],momneg2[0]};
+	Double_t pyDau[3]={momneg1[1],mompos1[1],momneg2[1]};
+	Double_t pzDau[3]={momneg1[2],mompos1[2],momneg2[2]};
+	massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
+	if(!massCutOK) { threeTrackArray.Clear(); continue; }
+      }
+      AliAODVertex *secVert3PrAOD = ReconstructSecondaryVertex(&threeTrackArray,dispersion);
+      AliAODRecoDecayHF3Prong *io3Prong = Make3Prong(&threeTrackArray,event,secVert3PrAOD,dispersion,0x0,0x0,
+						     dcap1n1,dcap1n2,dcan1n2,okForLcTopKpi,okForDsToKKpi,
+						     ok3Prong,kTRUE);
+      if(ok3Prong) selected3Prong.push_back(TripletKey(nSeleTrks,iTrkP1,iTrkN1,iTrkN2,1));
+      if(io3Prong) delete io3Prong;
+      if(secVert3PrAOD) delete secVert3PrAOD;
+      threeTrackArray.Clear();
+    }
+  }
+  return;
+}
+//-----------------------------------------------------------------------------
 Bool_t AliAnalysisVertexingHF::CheckCutsConsistency(){
   //
   /// Check the Vertexer and the analysts task consitstency
@@ -13,6 +13,8 @@
 /// \author Contact: andrea.dainese@pd.infn.it
 //-------------------------------------------------------------------------
 
+#include <vector>
+
 #include <TNamed.h>
 #include <TList.h>
 
@@ -45,6 +47,7 @@ class AliAODVertex;
 class AliVertexerTracks;
 class AliESDv0;
 class AliAODv0;
+class AliVertexingHFPairPrefilter;
 
 //-----------------------------------------------------------------------------
 class AliAnalysisVertexingHF : public TNamed {
@@ -179,6 +182,14 @@ class AliAnalysisVertexingHF : public TNamed {
   void SetCutsDStartoKpipi(AliRDHFCutsDStartoKpipi* cuts) { fCutsDStartoKpipi = cuts; }
   AliRDHFCutsDStartoKpipi* GetCutsDStartoKpipi() const { return fCutsDStartoKpipi; }
   void SetMassCutBeforeVertexing(Bool_t flag) { fMassCutBeforeVertexing=flag; }
+  void SetUsePairPrefilter(Bool_t flag=kTRUE) { fUsePairPrefilter=flag; }
+  Bool_t GetUsePairPrefilter() const { return fUsePairPrefilter; }
+  /// Number of threads for the vertexing and the selection of the 3 prong
+  /// candidates. The candidates are still built and stored in the serial
+  /// order, so that the output does not depend on the number of threads.
+  /// ROOT::EnableThreadSafety() has to be called once at the setup when n>1.
+  void SetNThreads(Int_t n=1) { fNThreads=n; }
+  Int_t GetNThreads() const { return fNThreads; }
 
   void SetMasses();
   Bool_t CheckCutsConsistency();
@@ -328,6 +339,9 @@ class AliAnalysisVertexingHF : public TNamed {
   Bool_t fFindVertexForCascades;  /// reconstruct a secondary vertex or assume it's from the primary vertex
   Int_t  fV0TypeForCascadeVertex;  /// Select which V0 type we want to use for the cascas
   Bool_t fMassCutBeforeVertexing; /// to go faster in PbPb
+  Bool_t fUsePairPrefilter; /// reject pairs and triplets out of the mass windows for any vertex (see AliVertexingHFPairPrefilter)
+  Int_t  fNThreads; /// number of threads for the selection of the 3 prong candidates
+  TObjArray *fThreadWorkers; //!<! copies of this object used by the threads
   // dummies for invariant mass calculation
   AliAODRecoDecay *fMassCalc2; /// for 2 prong
   AliAODRecoDecay *fMassCalc3; /// for 3 prong
@@ -372,7 +386,7 @@ class AliAnalysisVertexingHF : public TNamed {
 				      TObjArray *twoTrackArray2,
 				      Double_t dcap1n1,Double_t dcap2n1,Double_t dcap1p2,
 				      Bool_t useForLc, Bool_t useForDs,
-				      Bool_t &ok3Prong);
+				      Bool_t &ok3Prong, Bool_t selectOnly=kFALSE);
   AliAODRecoDecayHF3Prong* Make3Prong(TObjArray *threeTrackArray,AliVEvent *event,
                                       AliAODVertex *secVert,
                                       Double_t dispersion,
@@ -414,6 +428,25 @@ class AliAnalysisVertexingHF : public TNamed {
   Bool_t SelectInvMassAndPtDstarD0pi(TObjArray *trkArray);
   Bool_t SelectInvMassAndPtCascade(TObjArray *trkArray);
 
+  Bool_t SetupPairPrefilter(AliVertexingHFPairPrefilter &prefilter) const;
+
+  Bool_t Check3ProngPID(UChar_t flagsOpp, UChar_t flags1, UChar_t flags2,
+			Bool_t &okForLcTopKpi, Int_t &pidLcStatus,
+			Bool_t &okForDsToKKpi) const;
+  Bool_t Can3ProngRunInThreads() const;
+  AliAnalysisVertexingHF* MakeThreadWorker() const;
+  void Select3ProngInThreads(AliVEvent *event,const TObjArray &seleTrksArray,
+			     const TObjArray &tracksAtVertex,Int_t nSeleTrks,
+			     const UChar_t *seleFlags,Float_t dcaMax,
+			     const AliVertexingHFPairPrefilter *prefilter,
+			     std::vector<Long64_t> &selected3Prong);
+  void Select3ProngTriplets(AliVEvent *event,Int_t iTrkP1,TObjArray &seleTrksArray,
+			    const TObjArray &tracksAtVertex,Int_t nSeleTrks,
+			    const UChar_t *seleFlags,Float_t dcaMax,
+			    const AliVertexingHFPairPrefilter *prefilter,
+			    UChar_t *okThirdPos,UChar_t *okThirdNeg,
+			    std::vector<Long64_t> &selected3Prong);
+
   void   SelectTracksAndCopyVertex(const AliVEvent *event,Int_t trkEntries,
 				   TObjArray &seleTrksArray,
 				   TObjArray &tracksAtVertex,
@@ -429,7 +462,7 @@ class AliAnalysisVertexingHF : public TNamed {
 				  TObjArray *twoTrackArrayV0);
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisVertexingHF,30);  // Reconstruction of HF decay candidates
+  ClassDef(AliAnalysisVertexingHF,32);  // Reconstruction of HF decay candidates
   /// \endcond
 };
 
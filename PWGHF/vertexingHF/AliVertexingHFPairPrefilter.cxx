@@ -0,0 +1,144 @@
+/**************************************************************************
+ * Copyright(c) 1998-2007, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+//----------------------------------------------------------------------------
+// Kinematic prefilter of the track pairs and triplets of AliAnalysisVertexingHF
+// (see the header for the bounds used)
+//----------------------------------------------------------------------------
+#include <TMath.h>
+#include <TObjArray.h>
+#include "AliExternalTrackParam.h"
+#include "AliVertexingHFPairPrefilter.h"
+
+namespace {
+  // relative margin on the bounds, covers the rounding of the momenta
+  // at the secondary vertex
+  const Double_t kTolerance = 1.e-6;
+}
+
+//----------------------------------------------------------------------------
+AliVertexingHFPairPrefilter::AliVertexingHFPairPrefilter() :
+f2ProngHyp(),
+f3ProngHyp(),
+fNTracks(0),
+fPt(),
+fPz(),
+fP2()
+{
+  /// Default constructor
+}
+//----------------------------------------------------------------------------
+void AliVertexingHFPairPrefilter::Add2ProngHypothesis(Double_t m0, Double_t m1,
+						      Double_t lolim2, Double_t hilim2,
+						      Double_t minPt)
+{
+  /// Add a 2-prong hypothesis, masses in the order of the tracks
+  Hypothesis hyp;
+  hyp.fMass2[0]=m0*m0;
+  hyp.fMass2[1]=m1*m1;
+  hyp.fMass2[2]=0.;
+  hyp.fLoLim2=lolim2;
+  hyp.fHiLim2=hilim2;
+  hyp.fMinPt=minPt;
+  f2ProngHyp.push_back(hyp);
+}
+//----------------------------------------------------------------------------
+void AliVertexingHFPairPrefilter::Add3ProngHypothesis(Double_t m0, Double_t m1, Double_t m2,
+						      Double_t lolim2, Double_t hilim2,
+						      Double_t minPt)
+{
+  /// Add a 3-prong hypothesis, masses in the order of the tracks
+  Hypothesis hyp;
+  hyp.fMass2[0]=m0*m0;
+  hyp.fMass2[1]=m1*m1;
+  hyp.fMass2[2]=m2*m2;
+  hyp.fLoLim2=lolim2;
+  hyp.fHiLim2=hilim2;
+  hyp.fMinPt=minPt;
+  f3ProngHyp.push_back(hyp);
+}
+//----------------------------------------------------------------------------
+void AliVertexingHFPairPrefilter::SetTracks(const TObjArray &tracksAtVertex, Int_t nTracks)
+{
+  /// Store pt, pz and p^2 of the selected tracks (parameters at the primary vertex)
+  fNTracks=nTracks;
+  fPt.resize(nTracks);
+  fPz.resize(nTracks);
+  fP2.resize(nTracks);
+  for(Int_t i=0; i<nTracks; i++){
+    const AliExternalTrackParam *track=(const AliExternalTrackParam*)tracksAtVertex.UncheckedAt(i);
+    Double_t pt=track->Pt();
+    Double_t tgl=track->GetTgl();
+    fPt[i]=pt;
+    fPz[i]=pt*tgl;
+    fP2[i]=pt*pt*(1.+tgl*tgl);
+  }
+}
+//----------------------------------------------------------------------------
+Bool_t AliVertexingHFPairPrefilter::Select2Prong(Int_t i0, Int_t i1) const
+{
+  /// kTRUE if the pair can pass one of the 2-prong hypotheses
+  Double_t sumPt=fPt[i0]+fPt[i1];
+  Double_t minPt=TMath::Abs(fPt[i0]-fPt[i1]);
+  Double_t pz=fPz[i0]+fPz[i1];
+  for(UInt_t ih=0; ih<f2ProngHyp.size(); ih++){
+    const Hypothesis &hyp=f2ProngHyp[ih];
+    if(sumPt<hyp.fMinPt*(1.-kTolerance)) continue;
+    Double_t e=TMath::Sqrt(hyp.fMass2[0]+fP2[i0])+TMath::Sqrt(hyp.fMass2[1]+fP2[i1]);
+    Double_t mt2=e*e-pz*pz;
+    Double_t tol=kTolerance*e*e;
+    if(mt2-minPt*minPt+tol>hyp.fLoLim2 && mt2-sumPt*sumPt-tol<hyp.fHiLim2) return kTRUE;
+  }
+  return kFALSE;
+}
+//----------------------------------------------------------------------------
+void AliVertexingHFPairPrefilter::Select3Prong(Int_t i0, Int_t i1, UChar_t *selected) const
+{
+  /// For each third track k, selected[k]=1 if the triplet (i0,i1,k) can pass
+  /// one of the 3-prong hypotheses, 0 otherwise
+  const Double_t *pt=fPt.data();
+  const Double_t *pz=fPz.data();
+  const Double_t *p2=fP2.data();
+  const Int_t n=fNTracks;
+  for(Int_t k=0; k<n; k++) selected[k]=0;
+
+  Double_t sumPt01=fPt[i0]+fPt[i1];
+  Double_t maxPt01=TMath::Max(fPt[i0],fPt[i1]);
+  Double_t pz01=fPz[i0]+fPz[i1];
+  for(UInt_t ih=0; ih<f3ProngHyp.size(); ih++){
+    const Hypothesis &hyp=f3ProngHyp[ih];
+    const Double_t e01=TMath::Sqrt(hyp.fMass2[0]+fP2[i0])+TMath::Sqrt(hyp.fMass2[1]+fP2[i1]);
+    const Double_t m22=hyp.fMass2[2];
+    const Double_t lolim2=hyp.fLoLim2;
+    const Double_t hilim2=hyp.fHiLim2;
+    const Double_t minPt=hyp.fMinPt*(1.-kTolerance);
+    // no branches, so that the loop can be vectorized
+    // (with -fno-math-errno -fno-trapping-math for gcc)
+    for(Int_t k=0; k<n; k++){
+      Double_t e=e01+TMath::Sqrt(m22+p2[k]);
+      Double_t pzTot=pz01+pz[k];
+      Double_t sumPt=sumPt01+pt[k];
+      Double_t maxPt=maxPt01>pt[k] ? maxPt01 : pt[k];
+      Double_t minPtTot=2.*maxPt-sumPt;
+      minPtTot=minPtTot>0. ? minPtTot : 0.;
+      Double_t mt2=e*e-pzTot*pzTot;
+      Double_t tol=kTolerance*e*e;
+      UChar_t ok=(UChar_t)((sumPt>=minPt) &
+			   (mt2-minPtTot*minPtTot+tol>lolim2) &
+			   (mt2-sumPt*sumPt-tol<hilim2));
+      selected[k]|=ok;
+    }
+  }
+}
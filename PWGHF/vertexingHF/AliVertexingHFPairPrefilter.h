@@ -0,0 +1,70 @@
+#ifndef ALIVERTEXINGHFPAIRPREFILTER_H
+#define ALIVERTEXINGHFPAIRPREFILTER_H
+/* Copyright(c) 1998-2007, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+//-------------------------------------------------------------------------
+/// \class AliVertexingHFPairPrefilter
+/// \brief Kinematic prefilter of the track combinations of AliAnalysisVertexingHF
+///
+/// The propagation of a track without material keeps its pt and pz
+/// (1/pt and tan(lambda) are not changed), only the azimuth of the
+/// momentum changes between the primary and the secondary vertex.
+/// For fixed daughter momenta p_i, pt_i, pz_i the invariant mass of the
+/// combination is therefore bounded by
+///   M2max = E^2 - PZ^2 - max(0, 2*max(pt_i) - sum(pt_i))^2
+///   M2min = E^2 - PZ^2 - sum(pt_i)^2
+/// and its pt by sum(pt_i), whatever the secondary vertex is.
+/// A combination whose bounds do not overlap the mass window (or the pt
+/// cut) of any hypothesis can not pass the invariant mass selections
+/// of AliAnalysisVertexingHF, so it is rejected before the DCA and the
+/// vertex fit without changing the candidates.
+///
+/// The track kinematics is stored in contiguous arrays, and the triplet
+/// selection is evaluated for all third tracks in one loop.
+//-------------------------------------------------------------------------
+
+#include <vector>
+
+#include <Rtypes.h>
+
+class TObjArray;
+
+class AliVertexingHFPairPrefilter {
+ public:
+  AliVertexingHFPairPrefilter();
+
+  void Clear2ProngHypotheses() {f2ProngHyp.clear();}
+  void Clear3ProngHypotheses() {f3ProngHyp.clear();}
+  /// mass hypotheses of the daughters, window lolim2 < m2 < hilim2, pt cut
+  void Add2ProngHypothesis(Double_t m0, Double_t m1,
+			   Double_t lolim2, Double_t hilim2, Double_t minPt);
+  void Add3ProngHypothesis(Double_t m0, Double_t m1, Double_t m2,
+			   Double_t lolim2, Double_t hilim2, Double_t minPt);
+  Int_t GetN2ProngHypotheses() const {return (Int_t)f2ProngHyp.size();}
+  Int_t GetN3ProngHypotheses() const {return (Int_t)f3ProngHyp.size();}
+
+  void SetTracks(const TObjArray &tracksAtVertex, Int_t nTracks);
+
+  Bool_t Select2Prong(Int_t i0, Int_t i1) const;
+  void Select3Prong(Int_t i0, Int_t i1, UChar_t *selected) const;
+
+ private:
+  /// invariant mass hypothesis
+  struct Hypothesis {
+    Double_t fMass2[3]; /// squared masses of the daughters
+    Double_t fLoLim2;   /// lower limit of the squared mass window
+    Double_t fHiLim2;   /// upper limit of the squared mass window
+    Double_t fMinPt;    /// lower limit of the candidate pt
+  };
+
+  std::vector<Hypothesis> f2ProngHyp; /// 2-prong hypotheses
+  std::vector<Hypothesis> f3ProngHyp; /// 3-prong hypotheses
+
+  Int_t fNTracks;             /// number of tracks
+  std::vector<Double_t> fPt;  /// pt of the tracks
+  std::vector<Double_t> fPz;  /// pz of the tracks
+  std::vector<Double_t> fP2;  /// squared momentum of the tracks
+};
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef BDTFlatForest__def
+#define BDTFlatForest__def
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+#include "BDTNode.h"
+
+// Flat (structure-of-arrays) copy of a forest of BDTNode trees, as built
+// by the generated ReadBDT_* classes. The nodes of each tree are stored in
+// breadth-first order, the two daughters of a node being adjacent
+// (left = child, right = child+1). Leaves point to themselves and never
+// go right, so each tree is evaluated with a fixed number of steps
+// (its depth) and no test on the node type.
+// The response is the same AdaBoost sum as in ReadBDT_*::GetMvaValue__,
+// accumulated in the same order, so the values are identical.
+
+class BDTFlatForest {
+
+public:
+
+  BDTFlatForest() :
+   fSelector(),
+   fCutValue(),
+   fCutType(),
+   fChild(),
+   fLeafValue(),
+   fTreeRoot(),
+   fTreeDepth(),
+   fBoostWeights(),
+   fNorm(0) {
+  }
+
+  // convert the forest (root nodes and boost weights)
+  void Build( const std::vector<BDTNode*>& forest, const std::vector<double>& boostWeights );
+  void Clear();
+
+  size_t GetNTrees( void ) const { return fTreeRoot.size(); }
+  size_t GetNNodes( void ) const { return fSelector.size(); }
+
+  // response for one candidate, inputValues has one entry per variable
+  double GetMvaValue( const double* inputValues ) const;
+  // response for nCandidates candidates stored row-wise in inputValues
+  // (nVars values per candidate), written to mvaValues
+  void   GetMvaValues( const double* inputValues, size_t nCandidates, size_t nVars, double* mvaValues ) const;
+
+  // response computed walking the BDTNode trees, as done by the generated classes
+  static double GetMvaValueNodes( const std::vector<BDTNode*>& forest, const std::vector<double>& boostWeights,
+                                  const std::vector<double>& inputValues );
+
+  // if true the generated classes keep their BDTNode trees after the conversion
+  // (needed only to compare with GetMvaValueNodes)
+  static bool& KeepNodeForest() { static bool keep = false; return keep; }
+
+private:
+
+  int AddNode( void );
+
+  std::vector<int>           fSelector;     // index of variable used in node selection
+  std::vector<double>        fCutValue;     // cut value of node (+inf for leaves)
+  std::vector<unsigned char> fCutType;      // 1: goes right if value > cut, 0: goes right otherwise
+  std::vector<int>           fChild;        // index of left daughter (right = left+1), self for leaves
+  std::vector<double>        fLeafValue;    // node type of leaves (-1 bkg, 1 sig)
+  std::vector<int>           fTreeRoot;     // index of root node of each tree
+  std::vector<int>           fTreeDepth;    // depth of each tree
+  std::vector<double>        fBoostWeights; // boost weight of each tree
+  double                     fNorm;         // sum of boost weights
+};
+
+//_______________________________________________________________________
+inline int BDTFlatForest::AddNode( void )
+{
+   fSelector.push_back(0);
+   fCutValue.push_back(HUGE_VAL);
+   fCutType.push_back(1);
+   fChild.push_back(0);
+   fLeafValue.push_back(0);
+   return (int)fSelector.size() - 1;
+}
+
+//_______________________________________________________________________
+inline void BDTFlatForest::Build( const std::vector<BDTNode*>& forest, const std::vector<double>& boostWeights )
+{
+   Clear();
+   std::vector<BDTNode*> level, nextLevel;
+   std::vector<int> levelIndex, nextLevelIndex;
+   for (size_t itree = 0; itree < forest.size(); itree++) {
+      level.assign(1, forest[itree]);
+      levelIndex.assign(1, AddNode());
+      fTreeRoot.push_back(levelIndex[0]);
+      int depth = 0;
+      while (!level.empty()) {
+         nextLevel.clear();
+         nextLevelIndex.clear();
+         for (size_t inode = 0; inode < level.size(); inode++) {
+            BDTNode* node = level[inode];
+            int index = levelIndex[inode];
+            if (node->GetNodeType() != 0) { // leaf
+               fChild[index] = index;
+               fLeafValue[index] = node->GetNodeType();
+               continue;
+            }
+            // add the daughters first, AddNode can reallocate the arrays
+            int left = AddNode();
+            AddNode();
+            fSelector[index] = node->GetSelector();
+            fCutValue[index] = node->GetCutValue();
+            fCutType[index]  = node->GetCutType() ? 1 : 0;
+            fChild[index]    = left;
+            nextLevel.push_back(node->GetLeft());
+            nextLevel.push_back(node->GetRight());
+            nextLevelIndex.push_back(left);
+            nextLevelIndex.push_back(left + 1);
+         }
+         if (!nextLevel.empty()) depth++;
+         level.swap(nextLevel);
+         levelIndex.swap(nextLevelIndex);
+      }
+      fTreeDepth.push_back(depth);
+      fBoostWeights.push_back(boostWeights[itree]);
+      fNorm += boostWeights[itree];
+   }
+}
+
+//_______________________________________________________________________
+inline void BDTFlatForest::Clear()
+{
+   fSelector.clear();
+   fCutValue.clear();
+   fCutType.clear();
+   fChild.clear();
+   fLeafValue.clear();
+   fTreeRoot.clear();
+   fTreeDepth.clear();
+   fBoostWeights.clear();
+   fNorm = 0;
+}
+
+//_______________________________________________________________________
+inline double BDTFlatForest::GetMvaValue( const double* inputValues ) const
+{
+   double myMVA = 0;
+   for (size_t itree = 0; itree < fTreeRoot.size(); itree++) {
+      int index = fTreeRoot[itree];
+      for (int idepth = fTreeDepth[itree]; idepth--;) {
+         index = fChild[index] + ((inputValues[fSelector[index]] > fCutValue[index]) == (fCutType[index] != 0));
+      }
+      myMVA += fBoostWeights[itree] * fLeafValue[index];
+   }
+   return myMVA /= fNorm;
+}
+
+//_______________________________________________________________________
+inline void BDTFlatForest::GetMvaValues( const double* inputValues, size_t nCandidates, size_t nVars, double* mvaValues ) const
+{
+   // loop on trees outside, so that each tree stays in cache for all candidates
+   for (size_t icand = 0; icand < nCandidates; icand++) mvaValues[icand] = 0;
+   for (size_t itree = 0; itree < fTreeRoot.size(); itree++) {
+      const int root  = fTreeRoot[itree];
+      const int depth = fTreeDepth[itree];
+      const double weight = fBoostWeights[itree];
+      const double* values = inputValues;
+      for (size_t icand = 0; icand < nCandidates; icand++, values += nVars) {
+         int index = root;
+         for (int idepth = depth; idepth--;) {
+            index = fChild[index] + ((values[fSelector[index]] > fCutValue[index]) == (fCutType[index] != 0));
+         }
+         mvaValues[icand] += weight * fLeafValue[index];
+      }
+   }
+   for (size_t icand = 0; icand < nCandidates; icand++) mvaValues[icand] /= fNorm;
+}
+
+//_______________________________________________________________________
+inline double BDTFlatForest::GetMvaValueNodes( const std::vector<BDTNode*>& forest, const std::vector<double>& boostWeights,
+                                               const std::vector<double>& inputValues )
+{
+   double myMVA = 0;
+   double norm  = 0;
+   for (unsigned int itree=0; itree<forest.size(); itree++){
+      BDTNode *current = forest[itree];
+      while (current->GetNodeType() == 0) { //intermediate node
+         if (current->GoesRight(inputValues)) current=(BDTNode*)current->GetRight();
+         else current=(BDTNode*)current->GetLeft();
+      }
+      myMVA += boostWeights[itree] *  current->GetNodeType();
+      norm  += boostWeights[itree];
+   }
+   return myMVA /= norm;
+}
+
+#endif
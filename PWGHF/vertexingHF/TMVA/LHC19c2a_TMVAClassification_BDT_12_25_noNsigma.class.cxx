@@ -2,18 +2,7 @@
 
 double ReadBDT_LHC19c2a_12_25_noNsigma::GetMvaValue__( const std::vector<double>& inputValues ) const
 {
-   double myMVA = 0;
-   double norm  = 0;
-   for (unsigned int itree=0; itree<fForest.size(); itree++){
-      BDTNode *current = fForest[itree];
-      while (current->GetNodeType() == 0) { //intermediate node
-         if (current->GoesRight(inputValues)) current=(BDTNode*)current->GetRight();
-         else current=(BDTNode*)current->GetLeft();
-      }
-      myMVA += fBoostWeights[itree] *  current->GetNodeType();
-      norm  += fBoostWeights[itree];
-   }
-   return myMVA /= norm;
+   return fFlatForest.GetMvaValue( &inputValues[0] );
 };
 
 void ReadBDT_LHC19c2a_12_25_noNsigma::Initialize()
@@ -26680,6 +26669,13 @@ NN(
 -1, 2.36718, 0, -1, 0.466623,-99) , 
 3, 0.893819, 1, 0, 0.48347,-99) , 
 5, 0.619039, 0, 0, 0.503761,-99)    );
+   // convert the forest to the flat layout used for the evaluation
+   // and free the nodes (added by ALICE analyzers)
+   fFlatForest.Build(fForest, fBoostWeights);
+   if (!BDTFlatForest::KeepNodeForest()) {
+      Clear();
+      fForest.clear();
+   }
    return;
 };
 
@@ -26708,6 +26704,30 @@ inline void ReadBDT_LHC19c2a_12_25_noNsigma::Clear()
       return retval;
    }
 
+// Added by ALICE analyzer
+void ReadBDT_LHC19c2a_12_25_noNsigma::GetMvaValues( const double* inputValues, size_t nCandidates, double* mvaValues ) const
+{
+   // classifier response values for a batch of candidates
+   if (!IsStatusClean()) {
+      std::cout << "Problem in class \"" << fClassName << "\": cannot return classifier response"
+                << " because status is dirty" << std::endl;
+      for (size_t icand = 0; icand < nCandidates; icand++) mvaValues[icand] = 0;
+      return;
+   }
+   fFlatForest.GetMvaValues( inputValues, nCandidates, fNvars, mvaValues );
+}
+
+// Added by ALICE analyzer
+double ReadBDT_LHC19c2a_12_25_noNsigma::GetMvaValueNodes( const std::vector<double>& inputValues ) const
+{
+   // classifier response value computed walking the BDTNode trees
+   if (fForest.empty()) {
+      std::cout << "Problem in class \"" << fClassName << "\": BDTNode trees not available" << std::endl;
+      return 0;
+   }
+   return BDTFlatForest::GetMvaValueNodes( fForest, fBoostWeights, inputValues );
+}
+
 // Added by ALICE analyzer
 extern "C"
 {
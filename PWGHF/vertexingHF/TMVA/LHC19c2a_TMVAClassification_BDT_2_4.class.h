@@ -114,6 +114,7 @@ centrality                    centrality                    centrality
 #include <iostream>
 #include "IClassifierReader.h"
 #include "BDTNode.h"
+#include "BDTFlatForest.h"
 
 class ReadBDT_LHC19c2a_2_4 : public IClassifierReader
 {
@@ -227,6 +228,13 @@ class ReadBDT_LHC19c2a_2_4 : public IClassifierReader
   // variables given to the constructor
   double GetMvaValue(const std::vector<double> &inputValues) const;
 
+  // classifier response for nCandidates candidates stored row-wise in
+  // "inputValues" (same variable order as above) - added by ALICE analyzers
+  void GetMvaValues(const double *inputValues, size_t nCandidates, double *mvaValues) const;
+  // classifier response walking the BDTNode trees, as in the original TMVA class
+  // (available only if BDTFlatForest::KeepNodeForest() was set at construction)
+  double GetMvaValueNodes(const std::vector<double> &inputValues) const;
+
  private:
 
    // method-specific destructor
@@ -259,6 +267,7 @@ class ReadBDT_LHC19c2a_2_4 : public IClassifierReader
   // private members (method specific)
   std::vector<BDTNode *> fForest; // i.e. root nodes of decision trees
   std::vector<double> fBoostWeights;      // the weights applied in the individual boosts
+  BDTFlatForest fFlatForest;              // flat copy of fForest used for the evaluation
 };
 
 #endif
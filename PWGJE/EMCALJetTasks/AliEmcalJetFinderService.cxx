@@ -0,0 +1,268 @@
+/**************************************************************************************
+ * Copyright (C) 2016, Copyright Holders of the ALICE Collaboration                   *
+ * All rights reserved.                                                               *
+ *                                                                                    *
+ * Redistribution and use in source and binary forms, with or without                 *
+ * modification, are permitted provided that the following conditions are met:        *
+ *     * Redistributions of source code must retain the above copyright               *
+ *       notice, this list of conditions and the following disclaimer.                *
+ *     * Redistributions in binary form must reproduce the above copyright            *
+ *       notice, this list of conditions and the following disclaimer in the          *
+ *       documentation and/or other materials provided with the distribution.         *
+ *     * Neither the name of the <organization> nor the                               *
+ *       names of its contributors may be used to endorse or promote products         *
+ *       derived from this software without specific prior written permission.        *
+ *                                                                                    *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND    *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED      *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE             *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY                *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES         *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;       *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND        *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT         *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS      *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ **************************************************************************************/
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <AliAnalysisManager.h>
+#include <AliVEvent.h>
+
+#include "AliFJWrapper.h"
+#include "AliParticleContainer.h"
+#include "AliClusterContainer.h"
+#include "AliEmcalContainerAcceptanceCache.h"
+#include "AliEmcalJetTask.h"
+
+#include "AliEmcalJetFinderService.h"
+
+/// \cond CLASSIMP
+ClassImp(AliEmcalJetFinderService);
+/// \endcond
+
+/**
+ * Default constructor. This constructor is only for ROOT I/O and
+ * not to be used by users.
+ */
+AliEmcalJetFinderService::AliEmcalJetFinderService() :
+  TNamed(),
+  fJetTasks(),
+  fNThreads(1),
+  fCurrentEvent(0),
+  fCurrentEntry(-1),
+  fNJets(),
+  fInputKeys()
+{
+}
+
+/**
+ * Standard named constructor.
+ * @param name Name of the service.
+ */
+AliEmcalJetFinderService::AliEmcalJetFinderService(const char *name) :
+  TNamed(name, name),
+  fJetTasks(),
+  fNThreads(1),
+  fCurrentEvent(0),
+  fCurrentEntry(-1),
+  fNJets(),
+  fInputKeys()
+{
+}
+
+/**
+ * Destructor. The jet tasks are owned by the analysis manager.
+ */
+AliEmcalJetFinderService::~AliEmcalJetFinderService()
+{
+}
+
+/**
+ * Attach a jet task to the service. From now on the task leaves the jet
+ * finding to the service (see AliEmcalJetTask::Run).
+ * @param task Jet task to be attached
+ * @return The jet task
+ */
+AliEmcalJetTask* AliEmcalJetFinderService::AddJetTask(AliEmcalJetTask *task)
+{
+  if (!task) return 0;
+  if (fJetTasks.FindObject(task)) {
+    Error("AddJetTask", "Jet task %s already attached.", task->GetName());
+    return task;
+  }
+  fJetTasks.Add(task);
+  task->SetJetFinderService(this);
+
+  return task;
+}
+
+/**
+ * Called by the attached jet tasks in place of AliEmcalJetTask::FindJets.
+ * The first call in an event finds the jets of all the attached tasks. The jets
+ * of the task are then in its FastJet wrapper, as after AliEmcalJetTask::FindJets.
+ * @param task Jet task asking for its jets
+ * @return Total number of jets found for the task
+ */
+Int_t AliEmcalJetFinderService::FindJets(AliEmcalJetTask *task)
+{
+  AliVEvent *event = task->InputEvent();
+  AliAnalysisManager *mgr = AliAnalysisManager::GetAnalysisManager();
+  Long64_t entry = mgr ? mgr->GetCurrentEntry() : -1;
+
+  if (event != fCurrentEvent || entry != fCurrentEntry || (Int_t)fNJets.size() != fJetTasks.GetEntriesFast()) {
+    ProcessEvent(event);
+    fCurrentEvent = event;
+    fCurrentEntry = entry;
+  }
+
+  Int_t i = fJetTasks.IndexOf(task);
+  if (i < 0 || fNJets[i] < 0) return task->FindJets();
+
+  return fNJets[i];
+}
+
+/**
+ * Finds the jets of all the attached tasks which can be handled by the service.
+ * The constituents are gathered once per set of inputs, the ghosts are generated once
+ * per ghost area and the clusterings are distributed over fNThreads threads.
+ * @param event Current event
+ */
+void AliEmcalJetFinderService::ProcessEvent(AliVEvent *event)
+{
+  const Int_t nTasks = fJetTasks.GetEntriesFast();
+  fNJets.assign(nTasks, -1);
+  if ((Int_t)fInputKeys.size() != nTasks) fInputKeys.assign(nTasks, std::string());
+
+  std::vector<AliEmcalJetTask*> tasks;
+  std::vector<Int_t> taskIndexes;
+  std::map<std::string, AliEmcalJetTask*> inputs;
+  for (Int_t i = 0; i < nTasks; i++) {
+    AliEmcalJetTask *task = static_cast<AliEmcalJetTask*>(fJetTasks.At(i));
+    if (!IsSharable(task)) continue;
+
+    task->fFastJetWrapper.Clear();
+    // the configuration of the containers does not change once they are connected to their arrays
+    if (fInputKeys[i].empty()) fInputKeys[i] = InputKey(task).Data();
+    const std::string &key = fInputKeys[i];
+    std::map<std::string, AliEmcalJetTask*>::iterator input = inputs.find(key);
+    if (input == inputs.end()) {
+      // the task may not have been executed yet in this event
+      TIter nextPartColl(&task->fParticleCollArray);
+      AliParticleContainer *tracks = 0;
+      while ((tracks = static_cast<AliParticleContainer*>(nextPartColl()))) tracks->NextEvent(event);
+      TIter nextClusColl(&task->fClusterCollArray);
+      AliClusterContainer *clusters = 0;
+      while ((clusters = static_cast<AliClusterContainer*>(nextClusColl()))) clusters->NextEvent(event);
+
+      task->FillInputVectors();
+      inputs[key] = task;
+    }
+    else {
+      task->fFastJetWrapper.AddInputVectors(input->second->fFastJetWrapper.GetInputVectors());
+    }
+
+    if (task->fFastJetWrapper.GetInputVectors().size() == 0) {
+      fNJets[i] = 0;
+      continue;
+    }
+    tasks.push_back(task);
+    taskIndexes.push_back(i);
+  }
+
+  // ghosts, shared by all the tasks with the same ghost area
+  std::map<Double_t, std::vector<fastjet::PseudoJet> > ghosts;
+  std::map<Double_t, Double_t> ghostAreas;
+  std::vector<const std::vector<fastjet::PseudoJet>*> taskGhosts(tasks.size(), 0);
+  std::vector<Double_t> taskGhostAreas(tasks.size(), 0.);
+  for (UInt_t j = 0; j < tasks.size(); j++) {
+    Double_t area = tasks[j]->fGhostArea;
+    if (ghosts.find(area) == ghosts.end()) {
+      if (tasks[j]->fFastJetWrapper.GenerateGhosts(ghosts[area], ghostAreas[area]) != 0) {
+        ghosts.erase(area);
+        continue;
+      }
+    }
+    taskGhosts[j] = &ghosts[area];
+    taskGhostAreas[j] = ghostAreas[area];
+  }
+
+  std::vector<Int_t> status(tasks.size(), -1);
+  auto cluster = [&](UInt_t j) {
+    if (taskGhosts[j]) status[j] = tasks[j]->fFastJetWrapper.RunWithGhosts(*taskGhosts[j], taskGhostAreas[j]);
+  };
+
+  const UInt_t nThreads = fNThreads < (Int_t)tasks.size() ? fNThreads : tasks.size();
+  if (nThreads < 2) {
+    for (UInt_t j = 0; j < tasks.size(); j++) cluster(j);
+  }
+  else {
+#ifdef FASTJET_VERSION
+    // the banner is printed by the first cluster sequence
+    fastjet::ClusterSequence::print_banner();
+#endif
+    std::atomic<UInt_t> next(0);
+    auto work = [&]() {
+      for (UInt_t j = next++; j < tasks.size(); j = next++) cluster(j);
+    };
+    std::vector<std::thread> threads;
+    for (UInt_t iThread = 1; iThread < nThreads; iThread++) threads.emplace_back(work);
+    work();
+    for (auto &thread : threads) thread.join();
+  }
+
+  for (UInt_t j = 0; j < tasks.size(); j++) {
+    if (status[j] == 0) fNJets[taskIndexes[j]] = tasks[j]->fFastJetWrapper.GetInclusiveJets().size();
+  }
+}
+
+/**
+ * Whether the jets of the task can be found by the service. Tasks not yet
+ * initialized, with utilities (which may act on the wrapper before the jet finding)
+ * or in legacy mode find their jets on their own.
+ * @param task Jet task
+ * @return kTRUE if the service can find the jets of the task
+ */
+Bool_t AliEmcalJetFinderService::IsSharable(AliEmcalJetTask *task) const
+{
+  if (!task->fLocalInitialized || !task->fJets) return kFALSE;
+  if (task->fParticleCollArray.GetEntriesFast() == 0 && task->fClusterCollArray.GetEntriesFast() == 0) return kFALSE;
+  if (task->fUtilities && task->fUtilities->GetEntriesFast() > 0) return kFALSE;
+  if (task->fLegacyMode) return kFALSE;
+
+  return kTRUE;
+}
+
+/**
+ * Key identifying the inputs of a task: the jet tasks with the same key get the same
+ * input vectors. The key is made of the keys of the particle and cluster containers,
+ * in order, as given by AliEmcalContainerAcceptanceCache::MakeKey: the class, the array
+ * and the MD5 sum of the full streamed configuration of the container (kinematic cuts,
+ * track selection, cluster energy and corrections, ...), so that any setting of the
+ * containers makes the inputs different. Inputs modified randomly (artificial tracking
+ * inefficiency, Q/pt shift) are never shared.
+ * @param task Jet task
+ * @return Input key of the task
+ */
+TString AliEmcalJetFinderService::InputKey(AliEmcalJetTask *task) const
+{
+  if (task->fApplyArtificialTrackingEfficiency || task->fApplyQoverPtShift) return TString::Format("task:%s", task->GetName());
+
+  TString key;
+  TIter nextPartColl(&task->fParticleCollArray);
+  AliParticleContainer *tracks = 0;
+  while ((tracks = static_cast<AliParticleContainer*>(nextPartColl()))) {
+    key += TString::Format("particles:%s;", AliEmcalContainerAcceptanceCache::MakeKey(tracks).c_str());
+  }
+  TIter nextClusColl(&task->fClusterCollArray);
+  AliClusterContainer *clusters = 0;
+  while ((clusters = static_cast<AliClusterContainer*>(nextClusColl()))) {
+    key += TString::Format("clusters:%s;", AliEmcalContainerAcceptanceCache::MakeKey(clusters).c_str());
+  }
+
+  return key;
+}
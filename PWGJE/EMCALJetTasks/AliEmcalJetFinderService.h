@@ -0,0 +1,111 @@
+/**************************************************************************************
+ * Copyright (C) 2016, Copyright Holders of the ALICE Collaboration                   *
+ * All rights reserved.                                                               *
+ *                                                                                    *
+ * Redistribution and use in source and binary forms, with or without                 *
+ * modification, are permitted provided that the following conditions are met:        *
+ *     * Redistributions of source code must retain the above copyright               *
+ *       notice, this list of conditions and the following disclaimer.                *
+ *     * Redistributions in binary form must reproduce the above copyright            *
+ *       notice, this list of conditions and the following disclaimer in the          *
+ *       documentation and/or other materials provided with the distribution.         *
+ *     * Neither the name of the <organization> nor the                               *
+ *       names of its contributors may be used to endorse or promote products         *
+ *       derived from this software without specific prior written permission.        *
+ *                                                                                    *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND    *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED      *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE             *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY                *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES         *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;       *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND        *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT         *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS      *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                       *
+ **************************************************************************************/
+#ifndef ALIEMCALJETFINDERSERVICE_H
+#define ALIEMCALJETFINDERSERVICE_H
+
+#include <string>
+#include <vector>
+
+#include <TNamed.h>
+#include <TObjArray.h>
+#include <TString.h>
+
+class AliVEvent;
+class AliEmcalJetTask;
+
+/**
+ * @class AliEmcalJetFinderService
+ * @brief Shared jet finding for several AliEmcalJetTask instances
+ * @ingroup PWGJEBASE
+ *
+ * Trains usually run several jet finders on the same constituents (charged and full
+ * jets, several radii, kt jets for the background estimation). Each AliEmcalJetTask
+ * would loop over its containers, apply the same cuts, place its own ghosts and run
+ * FastJet on its own. The jet tasks attached to a service instead leave the jet finding
+ * to it: at the first jet task executed in an event, the service
+ * - gathers the accepted constituents once for all the jet tasks with the same inputs
+ *   (same particle and cluster containers, see InputKey),
+ * - generates the ghosts once for each ghost area,
+ * - runs all the clusterings, concurrently on SetNThreads() threads.
+ *
+ * Each jet task then fills and publishes its jet branch as usual, under the usual name,
+ * so the downstream AliJetContainer users are unchanged.
+ *
+ * Usage in the train macro:
+ * ~~~{.cxx}
+ * AliEmcalJetFinderService *jetService = new AliEmcalJetFinderService("JetFinderService");
+ * jetService->SetNThreads(4);
+ * for (Double_t radius : {0.2, 0.3, 0.4}) {
+ *   jetService->AddJetTask(AliEmcalJetTask::AddTaskEmcalJet("usedefault", "", AliJetContainer::antikt_algorithm, radius, AliJetContainer::kChargedJet));
+ *   jetService->AddJetTask(AliEmcalJetTask::AddTaskEmcalJet("usedefault", "usedefault", AliJetContainer::antikt_algorithm, radius, AliJetContainer::kFullJet));
+ * }
+ * jetService->AddJetTask(AliEmcalJetTask::AddTaskEmcalJet("usedefault", "", AliJetContainer::kt_algorithm, 0.2, AliJetContainer::kChargedJet));
+ * ~~~
+ *
+ * The jet tasks attached to a service must not depend on objects produced by tasks
+ * executed between them, since all of them are processed together. Jet tasks with
+ * utilities or in legacy mode are not handled by the service and find their jets
+ * on their own. Running the clusterings on several threads requires a thread-safe
+ * FastJet build; the ghosts are generated before spawning the threads since FastJet
+ * places them with a shared random generator.
+ */
+class AliEmcalJetFinderService : public TNamed {
+ public:
+  AliEmcalJetFinderService();
+  AliEmcalJetFinderService(const char *name);
+  virtual ~AliEmcalJetFinderService();
+
+  AliEmcalJetTask*       AddJetTask(AliEmcalJetTask *task);
+  void                   SetNThreads(Int_t n)                       { fNThreads = n          ; }
+
+  Int_t                  GetNThreads()                        const { return fNThreads       ; }
+  TObjArray*             GetJetTasks()                              { return &fJetTasks      ; }
+
+  Int_t                  FindJets(AliEmcalJetTask *task);
+
+ protected:
+  void                   ProcessEvent(AliVEvent *event);
+  Bool_t                 IsSharable(AliEmcalJetTask *task) const;
+  TString                InputKey(AliEmcalJetTask *task) const;
+
+  TObjArray              fJetTasks;               ///< attached jet tasks (not owned)
+  Int_t                  fNThreads;               ///< number of threads for the clusterings
+
+  AliVEvent             *fCurrentEvent;           //!<! event processed last
+  Long64_t               fCurrentEntry;           //!<! entry of the event processed last
+  std::vector<Int_t>     fNJets;                  //!<! number of jets of each jet task in the current event, -1 if not found by the service
+  std::vector<std::string> fInputKeys;            //!<! input key of each jet task, computed at its first shared event
+
+ private:
+  AliEmcalJetFinderService(const AliEmcalJetFinderService&);            // not implemented
+  AliEmcalJetFinderService &operator=(const AliEmcalJetFinderService&); // not implemented
+
+  /// \cond CLASSIMP
+  ClassDef(AliEmcalJetFinderService, 1);
+  /// \endcond
+};
+#endif
@@ -52,6 +52,7 @@
 #include "AliEmcalParticleJetConstituent.h"
 
 #include "AliEmcalJetTask.h"
+#include "AliEmcalJetFinderService.h"
 
 using std::cout;
 using std::endl;
@@ -100,6 +101,7 @@ AliEmcalJetTask::AliEmcalJetTask() :
   fFillGhost(kFALSE),
   fJets(0),
   fFastJetWrapper("AliEmcalJetTask","AliEmcalJetTask"),
+  fJetFinderService(0),
   fClusterContainerIndexMap(),
   fParticleContainerIndexMap()
 {
@@ -142,6 +144,7 @@ AliEmcalJetTask::AliEmcalJetTask(const char *name) :
   fFillGhost(kFALSE),
   fJets(0),
   fFastJetWrapper(name,name),
+  fJetFinderService(0),
   fClusterContainerIndexMap(),
   fParticleContainerIndexMap()
 {
@@ -235,7 +238,7 @@ Bool_t AliEmcalJetTask::Run()
   InitEvent();
   // clear the jet array (normally a null operation)
   fJets->Delete();
-  Int_t n = FindJets();
+  Int_t n = fJetFinderService ? fJetFinderService->FindJets(this) : FindJets();
 
   if (n == 0) return kFALSE;
 
@@ -260,6 +263,24 @@ Int_t AliEmcalJetTask::FindJets()
 
   fFastJetWrapper.Clear();
 
+  FillInputVectors();
+
+  if (fFastJetWrapper.GetInputVectors().size() == 0) return 0;
+
+  // run jet finder
+  fFastJetWrapper.Run();
+
+  return fFastJetWrapper.GetInclusiveJets().size();
+}
+
+/**
+ * Adds the accepted objects of all particle and cluster containers as input vectors
+ * to the FastJet wrapper (after the artificial tracking inefficiency and the Q/pt shift,
+ * if enabled). The user index of each input vector identifies the container and
+ * the position of the object in it (see FillJetConstituents).
+ */
+void AliEmcalJetTask::FillInputVectors()
+{
   AliDebug(2,Form("Jet type = %d", fJetType));
 
   Int_t iColl = 1;
@@ -319,13 +340,6 @@ Int_t AliEmcalJetTask::FindJets()
     }
     iColl++;
   }
-
-  if (fFastJetWrapper.GetInputVectors().size() == 0) return 0;
-
-  // run jet finder
-  fFastJetWrapper.Run();
-
-  return fFastJetWrapper.GetInclusiveJets().size();
 }
 
 /**
@@ -31,6 +31,7 @@ class TClonesArray;
 class TObjArray;
 class AliVEvent;
 class AliEmcalJetUtility;
+class AliEmcalJetFinderService;
 
 #include "TF1.h"
 #include "TRandom3.h"
@@ -71,6 +72,10 @@ namespace fastjet {
  * and its derived classes. Utilities can be added via the AddUtility(AliEmcalJetUtility*) method.
  * All the utilities added in the list will be executed. Users can implement new utilities
  * deriving a new class from AliEmcalJetUtility to interface functionalities of the FastJet contribs.
+ *
+ * Several jet tasks can share the input gathering and run their clusterings concurrently
+ * by attaching them to the same AliEmcalJetFinderService (see AliEmcalJetFinderService::AddJetTask).
+ * The jet branch is still filled and published by each task.
  */
 class AliEmcalJetTask : public AliAnalysisTaskEmcal {
  public:
@@ -108,6 +113,7 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   void                   SetLegacyMode(Bool_t mode)                 { if (IsLocked()) return; fLegacyMode       = mode  ; }
   void                   SetFillGhost(Bool_t b=kTRUE)               { if (IsLocked()) return; fFillGhost        = b     ; }
   void                   SetRadius(Double_t r)                      { if (IsLocked()) return; fRadius           = r     ; }
+  void                   SetJetFinderService(AliEmcalJetFinderService *s) { fJetFinderService = s; }
 
   void                   SetEtaRange(Double_t emi, Double_t ema);
   void                   SetMinJetClusPt(Double_t min);
@@ -137,6 +143,7 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
 
   TClonesArray*          GetJets()                        { return fJets              ; }
   TObjArray*             GetUtilities()                   { return fUtilities         ; }
+  AliEmcalJetFinderService* GetJetFinderService()         { return fJetFinderService  ; }
 
   void                   FillJetConstituents(AliEmcalJet *jet, std::vector<fastjet::PseudoJet>& constituents,
                                              std::vector<fastjet::PseudoJet>& constituents_sub, Int_t flag = 0, TString particlesSubName = "");
@@ -183,6 +190,7 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
  protected:
 
   Int_t                  FindJets();
+  void                   FillInputVectors();
   void                   FillJetBranch();
   void                   ExecOnce();
   void                   InitEvent();
@@ -230,6 +238,7 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
 
   TClonesArray          *fJets;                   //!<!jet collection
   AliFJWrapper           fFastJetWrapper;         //!<!fastjet wrapper
+  AliEmcalJetFinderService *fJetFinderService;    ///< shared jet finding (not owned), if any
 
   static const Int_t     fgkConstIndexShift;      //!<!contituent index shift
 
@@ -243,8 +252,10 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   AliEmcalJetTask(const AliEmcalJetTask&);            // not implemented
   AliEmcalJetTask &operator=(const AliEmcalJetTask&); // not implemented
 
+  friend class AliEmcalJetFinderService;
+
   /// \cond CLASSIMP
-  ClassDef(AliEmcalJetTask, 30);
+  ClassDef(AliEmcalJetTask, 31);
   /// \endcond
 };
 #endif
@@ -88,6 +88,8 @@ class AliFJWrapper
   virtual void RemoveLastInputVector();
 
   virtual Int_t Run();
+  virtual Int_t RunWithGhosts(const std::vector<fastjet::PseudoJet>& ghosts, Double_t ghostArea);
+  virtual Int_t GenerateGhosts(std::vector<fastjet::PseudoJet>& ghosts, Double_t& ghostArea) const;
   virtual Int_t Filter();
   virtual void  DoGenericSubtraction(const fastjet::FunctionOfPseudoJet<Double32_t>& jetshape, std::vector<fastjet::contrib::GenericSubtractorInfo>& output);
   virtual Int_t DoGenericSubtractionJetMass();
@@ -172,6 +174,8 @@ class AliFJWrapper
   fastjet::ClusterSequenceArea          *fClustSeqES;           //!
   fastjet::ClusterSequence              *fClustSeqSA;                //!
   fastjet::ClusterSequenceActiveAreaExplicitGhosts *fClustSeqActGhosts; //!
+  fastjet::ClusterSequenceActiveAreaExplicitGhosts *fClustSeqSharedGhosts; //!
+  fastjet::ClusterSequenceAreaBase      *fClustSeqArea;       //! sequence of the inclusive jets (fClustSeq or fClustSeqSharedGhosts)
   fastjet::Strategy                      fStrategy;           //!
   fastjet::JetAlgorithm                  fAlgor;              //!
   fastjet::RecombinationScheme           fScheme;             //!
@@ -281,6 +285,8 @@ AliFJWrapper::AliFJWrapper(const char *name, const char *title)
   , fClustSeqES        (0)
   , fClustSeqSA        (0)
   , fClustSeqActGhosts (0)
+  , fClustSeqSharedGhosts (0)
+  , fClustSeqArea      (0)
   , fStrategy          (fj::Best)
   , fAlgor             (fj::kt_algorithm)
   , fScheme            (fj::BIpt_scheme)
@@ -365,6 +371,8 @@ void AliFJWrapper::ClearMemory()
   if (fClustSeqES)          { delete fClustSeqES;        fClustSeqES        = NULL; }
   if (fClustSeqSA)        { delete fClustSeqSA;        fClustSeqSA        = NULL; }
   if (fClustSeqActGhosts) { delete fClustSeqActGhosts; fClustSeqActGhosts = NULL; }
+  if (fClustSeqSharedGhosts) { delete fClustSeqSharedGhosts; fClustSeqSharedGhosts = NULL; }
+  fClustSeqArea = NULL;
   #ifdef FASTJET_VERSION
   if (fBkrdEstimator)          { delete fBkrdEstimator; fBkrdEstimator = NULL; }
   if (fGenSubtractor)          { delete fGenSubtractor; fGenSubtractor = NULL; }
@@ -514,7 +522,7 @@ Double_t AliFJWrapper::GetJetArea(UInt_t idx) const
 
   Double_t retval = -1; // really wrong area..
   if ( idx < fInclusiveJets.size() ) {
-    retval = fClustSeq->area(fInclusiveJets[idx]);
+    retval = fClustSeqArea->area(fInclusiveJets[idx]);
   } else {
     AliError(Form("[e] ::GetJetArea wrong index: %d",idx));
   }
@@ -554,7 +562,7 @@ fastjet::PseudoJet AliFJWrapper::GetJetAreaVector(UInt_t idx) const
   // Get the jet area as vector.
   fastjet::PseudoJet retval;
   if ( idx < fInclusiveJets.size() ) {
-    retval = fClustSeq->area_4vector(fInclusiveJets[idx]);
+    retval = fClustSeqArea->area_4vector(fInclusiveJets[idx]);
   } else {
     AliError(Form("[e] ::GetJetArea wrong index: %d",idx));
   }
@@ -621,7 +629,7 @@ AliFJWrapper::GetJetConstituents(UInt_t idx) const
   std::vector<fastjet::PseudoJet> retval;
 
   if ( idx < fInclusiveJets.size() ) {
-    retval = fClustSeq->constituents(fInclusiveJets[idx]);
+    retval = fClustSeqArea->constituents(fInclusiveJets[idx]);
   } else {
     AliError(Form("[e] ::GetJetConstituents wrong index: %d",idx));
   }
@@ -670,7 +678,7 @@ void AliFJWrapper::GetMedianAndSigma(Double_t &median, Double_t &sigma, Int_t re
   // Get the median and sigma from fastjet.
   // User can also do it on his own because the cluster sequence is exposed (via a getter)
 
-  if (!fClustSeq) {
+  if (!fClustSeqArea) {
     AliError("[e] Run the jfinder first.");
     return;
   }
@@ -678,11 +686,11 @@ void AliFJWrapper::GetMedianAndSigma(Double_t &median, Double_t &sigma, Int_t re
   Double_t mean_area = 0;
   try {
     if(0 == remove) {
-      fClustSeq->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
+      fClustSeqArea->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
     }  else {
-      std::vector<fastjet::PseudoJet> input_jets = sorted_by_pt(fClustSeq->inclusive_jets());
+      std::vector<fastjet::PseudoJet> input_jets = sorted_by_pt(fClustSeqArea->inclusive_jets());
       input_jets.erase(input_jets.begin(), input_jets.begin() + remove);
-      fClustSeq->get_median_rho_and_sigma(input_jets, *fRange, fUseArea4Vector, median, sigma, mean_area);
+      fClustSeqArea->get_median_rho_and_sigma(input_jets, *fRange, fUseArea4Vector, median, sigma, mean_area);
       input_jets.clear();
     }
   } catch (fj::Error) {
@@ -748,6 +756,7 @@ Int_t AliFJWrapper::Run()
 
   try {
     fClustSeq = new fj::ClusterSequenceArea(fInputVectors, *fJetDef, *fAreaDef);
+    fClustSeqArea = fClustSeq;
     if(fEventSub){
       DoEventConstituentSubtraction();
       fClustSeqES = new fj::ClusterSequenceArea(fEventSubCorrectedVectors, *fJetDef, *fAreaDef);
@@ -773,6 +782,74 @@ Int_t AliFJWrapper::Run()
   return 0;
 }
 
+//_________________________________________________________________________________________________
+Int_t AliFJWrapper::GenerateGhosts(std::vector<fastjet::PseudoJet>& ghosts, Double_t& ghostArea) const
+{
+  // Generate the ghosts which Run() would place for the active area with explicit ghosts,
+  // so that they can be shared by several wrappers (see RunWithGhosts).
+  // Not thread safe: the ghost positions come from the FastJet random generator.
+
+  ghosts.clear();
+  if (fAreaType != fj::active_area_explicit_ghosts || fNGhostRepeats != 1) {
+    AliError("[e] Shared ghosts only for active_area_explicit_ghosts with one repetition.");
+    return -1;
+  }
+
+  fj::GhostedAreaSpec ghostSpec(fMaxRap,
+                                fNGhostRepeats,
+                                fGhostArea,
+                                fGridScatter,
+                                fKtScatter,
+                                fMeanGhostKt);
+  ghostSpec.add_ghosts(ghosts);
+  ghostArea = ghostSpec.actual_ghost_area();
+
+  return 0;
+}
+
+//_________________________________________________________________________________________________
+Int_t AliFJWrapper::RunWithGhosts(const std::vector<fastjet::PseudoJet>& ghosts, Double_t ghostArea)
+{
+  // Run the jet finder with the active area computed from ghosts given by the caller
+  // (see GenerateGhosts) instead of the ones placed by FastJet. The inclusive jets, their
+  // areas and constituents are then accessed as after Run().
+  // Event-wise subtraction, plugins and the legacy mode are only available with Run().
+
+  if (fEventSub || fLegacyMode || fAlgor == fj::plugin_algorithm) {
+    AliError("[e] RunWithGhosts not available with event subtraction, legacy mode or plugins.");
+    return -1;
+  }
+
+#ifndef FASTJET_VERSION
+  fRange = new fj::RangeDefinition(fMaxRap - 0.95 * fR);
+#else
+  fRange = new fj::Selector(fj::SelectorAbsRapMax(fMaxRap - 0.95 * fR));
+#endif
+
+  fJetDef = new fj::JetDefinition(fAlgor, fR, fScheme, fStrategy);
+
+  try {
+    fClustSeqSharedGhosts = new fj::ClusterSequenceActiveAreaExplicitGhosts(fInputVectors,
+                                                                            *fJetDef,
+                                                                            ghosts,
+                                                                            ghostArea);
+    fClustSeqArea = fClustSeqSharedGhosts;
+  } catch (fj::Error) {
+    AliError(" [w] FJ Exception caught.");
+    return -1;
+  }
+
+#ifdef FASTJET_VERSION
+  fBkrdEstimator     = new fj::JetMedianBackgroundEstimator(fj::SelectorAbsRapMax(fMaxRap));
+#endif
+
+  fInclusiveJets.clear();
+  fEventSubJets.clear();
+  fInclusiveJets = fClustSeqSharedGhosts->inclusive_jets(0.0);
+
+  return 0;
+}
+
 //_________________________________________________________________________________________________
 Int_t AliFJWrapper::Filter()
 {
@@ -846,7 +923,7 @@ void AliFJWrapper::SubtractBackground(Double_t median_pt)
   // check what was specified (default is -1)
   if (median_pt < 0) {
     try {
-      fClustSeq->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
+      fClustSeqArea->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
     }
 
     catch (fj::Error) {
@@ -872,13 +949,13 @@ void AliFJWrapper::SubtractBackground(Double_t median_pt)
   for (unsigned i = 0; i < fInclusiveJets.size(); i++) {
     if ( fUseArea4Vector ) {
       // subtract the background using the area4vector
-      fj::PseudoJet area4v = fClustSeq->area_4vector(fInclusiveJets[i]);
+      fj::PseudoJet area4v = fClustSeqArea->area_4vector(fInclusiveJets[i]);
       fj::PseudoJet jet_sub = fInclusiveJets[i] - area4v * fMedUsedForBgSub;
       fSubtractedJetsPt.push_back(jet_sub.perp()); // here we put only the pt of the jet - note: this can be negative
     } else {
       // subtract the background using scalars
       // fj::PseudoJet jet_sub = fInclusiveJets[i] - area * fMedUsedForBgSub_;
-      Double_t area = fClustSeq->area(fInclusiveJets[i]);
+      Double_t area = fClustSeqArea->area(fInclusiveJets[i]);
       // standard subtraction
       Double_t pt_sub = fInclusiveJets[i].perp() - fMedUsedForBgSub * area;
       fSubtractedJetsPt.push_back(pt_sub); // here we put only the pt of the jet - note: this can be negative
@@ -13,6 +13,8 @@
 // Developers: F. Bellini (fbellini@cern.ch)
 
 #include <Riostream.h>
+#include <algorithm>
+#include <map>
 
 #include <TH1.h>
 #include <TList.h>
@@ -92,6 +94,7 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask() :
    fMiniEvent(0x0),
    fBigOutput(kFALSE),
    fMixPrintRefresh(-1),
+   fMixCacheSize(1000),
    fCheckDecay(kTRUE),
    fMaxNDaughters(-1),
    fCheckP(kFALSE),
@@ -160,6 +163,7 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask(const char *name, Bool_t useMC,Bo
    fMiniEvent(0x0),
    fBigOutput(kFALSE),
    fMixPrintRefresh(-1),
+   fMixCacheSize(1000),
    fCheckDecay(kTRUE),
    fMaxNDaughters(-1),
    fCheckP(kFALSE),
@@ -229,6 +233,7 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask(const AliRsnMiniAnalysisTask &cop
    fMiniEvent(0x0),
    fBigOutput(copy.fBigOutput),
    fMixPrintRefresh(copy.fMixPrintRefresh),
+   fMixCacheSize(copy.fMixCacheSize),
    fCheckDecay(copy.fCheckDecay),
    fMaxNDaughters(copy.fMaxNDaughters),
    fCheckP(copy.fCheckP),
@@ -299,6 +304,7 @@ AliRsnMiniAnalysisTask &AliRsnMiniAnalysisTask::operator=(const AliRsnMiniAnalys
    fESDtrackCuts = copy.fESDtrackCuts;
    fBigOutput = copy.fBigOutput;
    fMixPrintRefresh = copy.fMixPrintRefresh;
+   fMixCacheSize = copy.fMixCacheSize;
    fCheckDecay = copy.fCheckDecay;
    fMaxNDaughters = copy.fMaxNDaughters;
    fCheckP = copy.fCheckP;
@@ -567,7 +573,7 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    // prepare variables
    Int_t ievt, nEvents = (Int_t)fEvBuffer->GetEntries();
    Int_t idef, nDefs   = fHistograms.GetEntries();
-   Int_t imix, iloop, ifill;
+   Int_t ifill;
    AliRsnMiniOutput *def = 0x0;
    AliRsnMiniOutput::EComputation compType;
 
@@ -582,10 +588,15 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    // using the appropriate procedure depending on its type
    // only mother-related histograms are filled in UserExec,
    // since they require direct access to MC event
+   // the mixing keys are collected on the way, for the search of the mixing partners
+   std::vector<Float_t> keyVz(nEvents), keyMult(nEvents), keyAngle(nEvents);
    timer.Start();
    for (ievt = 0; ievt < nEvents; ievt++) {
       // get next entry
       fEvBuffer->GetEntry(ievt);
+      keyVz[ievt]    = fMiniEvent->Vz();
+      keyMult[ievt]  = fMiniEvent->Mult();
+      keyAngle[ievt] = fMiniEvent->Angle();
       if (printNum&&(ievt%printNum==0)) {
          AliInfo(Form("[%s] Std.Event %d/%d",GetName(), ievt,nEvents));
          timer.Stop(); timer.Print(); fflush(stdout); timer.Start(kFALSE);
@@ -635,82 +646,18 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
       return;
    }
 
-   // initialize mixing counter
-   Int_t    nmatched[nEvents];
-   TString *smatched = new TString[nEvents];
-   for (ievt = 0; ievt < nEvents; ievt++) {
-      smatched[ievt] = "|";
-      nmatched[ievt] = 0;
-   }
-
-
    AliInfo(Form("[%s] Std.Event %d/%d",GetName(), nEvents,nEvents));
    timer.Stop(); timer.Print(); timer.Start(); fflush(stdout);
 
    // search for good matchings
-   for (ievt = 0; ievt < nEvents; ievt++) {
-      if (printNum&&(ievt%printNum==0)) {
-         AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),ievt,nEvents));
-         timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
-      }
-      if (nmatched[ievt] >= fNMix) continue;
-      fEvBuffer->GetEntry(ievt);
-      AliRsnMiniEvent evMain(*fMiniEvent);
-      for (iloop = 1; iloop < nEvents; iloop++) {
-         imix = ievt + iloop;
-         if (imix >= nEvents) imix -= nEvents;
-         if (imix == ievt) continue;
-         // text next entry
-         fEvBuffer->GetEntry(imix);
-         // skip if events are not matched
-         if (!EventsMatch(&evMain, fMiniEvent)) continue;
-         // check that the array of good matches for mixed does not already contain main event
-         if (smatched[imix].Contains(Form("|%d|", ievt))) continue;
-         // check that the found good events has not enough matches already
-         if (nmatched[imix] >= fNMix) continue;
-         // add new mixing candidate
-         smatched[ievt].Append(Form("%d|", imix));
-         nmatched[ievt]++;
-         nmatched[imix]++;
-         if (nmatched[ievt] >= fNMix) break;
-      }
-      AliDebugClass(1, Form("Matches for event %5d = %d [%s] (missing are declared above)", evMain.ID(), nmatched[ievt], smatched[ievt].Data()));
-   }
+   std::vector< std::vector<Int_t> > matched(nEvents);
+   FindMixingPartners(keyVz, keyMult, keyAngle, matched, printNum);
 
    AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout); timer.Start();
 
    // perform mixing
-   TObjArray *list = 0x0;
-   TObjString *os = 0x0;
-   for (ievt = 0; ievt < nEvents; ievt++) {
-      if (printNum&&(ievt%printNum==0)) {
-         AliInfo(Form("[%s] EventMixing %d/%d",GetName(),ievt,nEvents));
-         timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
-      }
-      ifill = 0;
-      fEvBuffer->GetEntry(ievt);
-      AliRsnMiniEvent evMain(*fMiniEvent);
-      list = smatched[ievt].Tokenize("|");
-      TObjArrayIter next(list);
-      while ( (os = (TObjString *)next()) ) {
-         imix = os->GetString().Atoi();
-         fEvBuffer->GetEntry(imix);
-         for (idef = 0; idef < nDefs; idef++) {
-            def = (AliRsnMiniOutput *)fHistograms[idef];
-            if (!def) continue;
-            if (!def->IsTrackPairMix()) continue;
-            ifill += def->FillPair(&evMain, fMiniEvent, &fValues, kTRUE);
-            if (!def->IsSymmetric()) {
-               AliDebugClass(2, "Reflecting non symmetric pair");
-               ifill += def->FillPair(fMiniEvent, &evMain, &fValues, kFALSE);
-            }
-         }
-      }
-      delete list;
-   }
-
-   delete [] smatched;
+   FillMixing(matched, printNum);
 
    AliInfo(Form("[%s] EventMixing %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout);
@@ -1619,33 +1566,33 @@ void AliRsnMiniAnalysisTask::SetDselection(UShort_t originDselection)
 Bool_t AliRsnMiniAnalysisTask::EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEvent *event2)
 {
    if (!event1 || !event2) return kFALSE;
+   return KeysMatch(event1->Vz(), event1->Mult(), event1->Angle(), event2->Vz(), event2->Mult(), event2->Angle());
+}
+
+//__________________________________________________________________________________________________
+/// Check if two events are compatible, from their vz, mult and angle.
+/// Same criteria as EventsMatch.
+///
+Bool_t AliRsnMiniAnalysisTask::KeysMatch(Float_t vz1, Float_t mult1, Float_t angle1, Float_t vz2, Float_t mult2, Float_t angle2) const
+{
    Int_t ivz1, ivz2, imult1, imult2, iangle1, iangle2;
    Double_t dv, dm, da;
 
    if (fContinuousMix) {
-      dv = TMath::Abs(event1->Vz()    - event2->Vz()   );
-      dm = TMath::Abs(event1->Mult()  - event2->Mult() );
-      da = TMath::Abs(event1->Angle() - event2->Angle());
-      if (dv > fMaxDiffVz) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Vz = %f", event1->ID(), event2->ID(), dv));
-         return kFALSE;
-      }
-      if (dm > fMaxDiffMult ) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Mult = %f", event1->ID(), event2->ID(), dm));
-         return kFALSE;
-      }
-      if (da > fMaxDiffAngle) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Angle = %f", event1->ID(), event2->ID(), da));
-         return kFALSE;
-      }
+      dv = TMath::Abs(vz1    - vz2   );
+      dm = TMath::Abs(mult1  - mult2 );
+      da = TMath::Abs(angle1 - angle2);
+      if (dv > fMaxDiffVz) return kFALSE;
+      if (dm > fMaxDiffMult ) return kFALSE;
+      if (da > fMaxDiffAngle) return kFALSE;
       return kTRUE;
    } else {
-      ivz1 = (Int_t)(event1->Vz() / fMaxDiffVz);
-      ivz2 = (Int_t)(event2->Vz() / fMaxDiffVz);
-      imult1 = (Int_t)(event1->Mult() / fMaxDiffMult);
-      imult2 = (Int_t)(event2->Mult() / fMaxDiffMult);
-      iangle1 = (Int_t)(event1->Angle() / fMaxDiffAngle);
-      iangle2 = (Int_t)(event2->Angle() / fMaxDiffAngle);
+      ivz1 = (Int_t)(vz1 / fMaxDiffVz);
+      ivz2 = (Int_t)(vz2 / fMaxDiffVz);
+      imult1 = (Int_t)(mult1 / fMaxDiffMult);
+      imult2 = (Int_t)(mult2 / fMaxDiffMult);
+      iangle1 = (Int_t)(angle1 / fMaxDiffAngle);
+      iangle2 = (Int_t)(angle2 / fMaxDiffAngle);
       if (ivz1 != ivz2) return kFALSE;
       if (imult1 != imult2) return kFALSE;
       if (iangle1 != iangle2) return kFALSE;
@@ -1653,6 +1600,195 @@ Bool_t AliRsnMiniAnalysisTask::EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEv
    }
 }
 
+//__________________________________________________________________________________________________
+/// Search the mixing partners of each buffered event.
+///
+/// The partners are the same as the ones of a loop on all the other events of the buffer,
+/// starting from the next one and wrapping around at the end: an event is accepted if it matches,
+/// if it does not have the main event among its own partners already, and if both events
+/// have less than fNMix matches.
+/// Instead of the whole buffer, only the events in the neighbouring cells of a grid in
+/// (vz, mult, angle), whose cell size is the allowed difference, are checked, in the same order.
+///
+/// \param vz, mult, angle Mixing keys of the buffered events
+/// \param matched Output: list of partners of each event (the partners of later events are not repeated)
+/// \param printNum Print the progress every printNum events (0 = never)
+///
+void AliRsnMiniAnalysisTask::FindMixingPartners(const std::vector<Float_t> &vz, const std::vector<Float_t> &mult, const std::vector<Float_t> &angle,
+                                                std::vector< std::vector<Int_t> > &matched, Int_t printNum)
+{
+   Int_t ievt, imix, nEvents = (Int_t)vz.size();
+   matched.assign(nEvents, std::vector<Int_t>());
+
+   // cell index of each event: the cells are slightly larger than the allowed differences,
+   // to cover the rounding, so that matching events are at most one cell apart in each direction
+   // (single cell along a direction without a positive difference)
+   const Int_t    kNCellBits = 21;
+   const Long64_t kCellOffset = 1LL << (kNCellBits - 1);
+   const Double_t kMaxCell = kCellOffset - 2;
+   const std::vector<Float_t> *key[3] = {&vz, &mult, &angle};
+   Double_t width[3] = {fMaxDiffVz, fMaxDiffMult, fMaxDiffAngle};
+   std::vector<Int_t> cell[3];
+   for (Int_t idim = 0; idim < 3; idim++) {
+      cell[idim].assign(nEvents, 0);
+      if (!(width[idim] > 0.0)) continue;
+      Double_t size = width[idim] * (1.0 + 1E-5);
+      for (ievt = 0; ievt < nEvents; ievt++) {
+         Double_t c = TMath::Floor((*key[idim])[ievt] / size);
+         if (!(c > -kMaxCell)) c = -kMaxCell;
+         if (c > kMaxCell) c = kMaxCell;
+         cell[idim][ievt] = (Int_t)c;
+      }
+   }
+
+   // events of each cell, in increasing order
+   std::map<Long64_t, std::vector<Int_t> > cells;
+   for (ievt = 0; ievt < nEvents; ievt++) {
+      Long64_t id = ((cell[0][ievt] + kCellOffset) << (2 * kNCellBits)) | ((cell[1][ievt] + kCellOffset) << kNCellBits) | (cell[2][ievt] + kCellOffset);
+      cells[id].push_back(ievt);
+   }
+
+   std::vector<Int_t> nmatched(nEvents, 0);
+   std::vector<const std::vector<Int_t> *> neighbours;
+   std::vector<std::vector<Int_t>::const_iterator> next, end;
+   std::map<Long64_t, std::vector<Int_t> >::const_iterator it;
+   for (ievt = 0; ievt < nEvents; ievt++) {
+      if (printNum&&(ievt%printNum==0)) {
+         AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),ievt,nEvents));
+      }
+      if (nmatched[ievt] >= fNMix) continue;
+
+      // neighbouring cells
+      neighbours.clear();
+      for (Int_t i0 = -1; i0 <= 1; i0++) {
+         for (Int_t i1 = -1; i1 <= 1; i1++) {
+            for (Int_t i2 = -1; i2 <= 1; i2++) {
+               Long64_t id = ((cell[0][ievt] + i0 + kCellOffset) << (2 * kNCellBits)) | ((cell[1][ievt] + i1 + kCellOffset) << kNCellBits) | (cell[2][ievt] + i2 + kCellOffset);
+               it = cells.find(id);
+               if (it != cells.end()) neighbours.push_back(&it->second);
+            }
+         }
+      }
+
+      // candidates in the order of the loop on the buffer:
+      // first the events after the main one, then the ones before
+      for (Int_t pass = 0; pass < 2 && nmatched[ievt] < fNMix; pass++) {
+         next.clear();
+         end.clear();
+         for (UInt_t in = 0; in < neighbours.size(); in++) {
+            const std::vector<Int_t> &events = *neighbours[in];
+            if (pass == 0) {
+               next.push_back(std::upper_bound(events.begin(), events.end(), ievt));
+               end.push_back(events.end());
+            } else {
+               next.push_back(events.begin());
+               end.push_back(std::lower_bound(events.begin(), events.end(), ievt));
+            }
+         }
+         while (nmatched[ievt] < fNMix) {
+            // smallest next candidate of the neighbouring cells
+            Int_t imin = -1;
+            for (UInt_t in = 0; in < next.size(); in++) {
+               if (next[in] == end[in]) continue;
+               if (imin < 0 || *next[in] < *next[imin]) imin = in;
+            }
+            if (imin < 0) break;
+            imix = *next[imin];
+            ++next[imin];
+            // skip if events are not matched
+            if (!KeysMatch(vz[ievt], mult[ievt], angle[ievt], vz[imix], mult[imix], angle[imix])) continue;
+            // check that the list of good matches for mixed does not already contain main event
+            if (std::find(matched[imix].begin(), matched[imix].end(), ievt) != matched[imix].end()) continue;
+            // check that the found good events has not enough matches already
+            if (nmatched[imix] >= fNMix) continue;
+            // add new mixing candidate
+            matched[ievt].push_back(imix);
+            nmatched[ievt]++;
+            nmatched[imix]++;
+         }
+      }
+      AliDebugClass(1, Form("Matches for event %5d = %d", ievt, nmatched[ievt]));
+   }
+}
+
+//__________________________________________________________________________________________________
+/// Fill the mixing outputs, combining each buffered event with its partners.
+///
+/// The events are processed in blocks: all the events needed by a block (main events and
+/// their partners) are read once from the buffer, in increasing entry order, and kept in memory
+/// until the end of the block. A block holds at most fMixCacheSize events, unless a single
+/// event has more partners. The pairs are filled in the same order as with one read per pair.
+///
+/// \param matched List of partners of each event, as found by FindMixingPartners
+/// \param printNum Print the progress every printNum events (0 = never)
+///
+void AliRsnMiniAnalysisTask::FillMixing(const std::vector< std::vector<Int_t> > &matched, Int_t printNum)
+{
+   Int_t ievt, nEvents = (Int_t)matched.size();
+   Int_t idef, nDefs   = fHistograms.GetEntries();
+   AliRsnMiniOutput *def = 0x0;
+   UInt_t im;
+
+   std::vector<Int_t> block(nEvents, -1);   // last block which needs the event
+   std::vector<Int_t> slot(nEvents, -1);    // position of the event in the cache
+   std::vector<Int_t> entries;
+   std::vector<AliRsnMiniEvent *> cache;
+   Int_t iblock = 0, first = 0, last;
+   while (first < nEvents) {
+      // events of the block
+      entries.clear();
+      for (last = first; last < nEvents; last++) {
+         const std::vector<Int_t> &partners = matched[last];
+         if (partners.empty()) continue;
+         Int_t nNew = (block[last] != iblock);
+         for (im = 0; im < partners.size(); im++) nNew += (block[partners[im]] != iblock);
+         if (last > first && !entries.empty() && (Int_t)entries.size() + nNew > fMixCacheSize) break;
+         if (block[last] != iblock) { block[last] = iblock; entries.push_back(last); }
+         for (im = 0; im < partners.size(); im++) {
+            if (block[partners[im]] == iblock) continue;
+            block[partners[im]] = iblock;
+            entries.push_back(partners[im]);
+         }
+      }
+
+      // read them
+      std::sort(entries.begin(), entries.end());
+      while (cache.size() < entries.size()) cache.push_back(new AliRsnMiniEvent());
+      for (UInt_t ie = 0; ie < entries.size(); ie++) {
+         fEvBuffer->GetEntry(entries[ie]);
+         *cache[ie] = *fMiniEvent;
+         slot[entries[ie]] = ie;
+      }
+
+      // mix
+      for (ievt = first; ievt < last; ievt++) {
+         if (printNum&&(ievt%printNum==0)) {
+            AliInfo(Form("[%s] EventMixing %d/%d",GetName(),ievt,nEvents));
+         }
+         const std::vector<Int_t> &partners = matched[ievt];
+         if (partners.empty()) continue;
+         AliRsnMiniEvent *evMain = cache[slot[ievt]];
+         for (im = 0; im < partners.size(); im++) {
+            AliRsnMiniEvent *evMix = cache[slot[partners[im]]];
+            for (idef = 0; idef < nDefs; idef++) {
+               def = (AliRsnMiniOutput *)fHistograms[idef];
+               if (!def) continue;
+               if (!def->IsTrackPairMix()) continue;
+               def->FillPair(evMain, evMix, &fValues, kTRUE);
+               if (!def->IsSymmetric()) {
+                  AliDebugClass(2, "Reflecting non symmetric pair");
+                  def->FillPair(evMix, evMain, &fValues, kFALSE);
+               }
+            }
+         }
+      }
+      first = last;
+      iblock++;
+   }
+
+   for (UInt_t ie = 0; ie < cache.size(); ie++) delete cache[ie];
+}
+
 //---------------------------------------------------------------------
 /// Patch to be used with 2011 Pb-Pb data for flat centrality distribution
 ///
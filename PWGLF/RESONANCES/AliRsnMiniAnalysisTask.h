@@ -15,6 +15,8 @@
 #ifndef ALIRSNMINIANALYSISTASK_H
 #define ALIRSNMINIANALYSISTASK_H
 
+#include <vector>
+
 #include <TString.h>
 #include <TClonesArray.h>
 
@@ -66,6 +68,7 @@ public:
    void                SetMaxDiffAngle(Double_t val)      {fMaxDiffAngle = val;}
    void                SetEventCuts(AliRsnCutSet *cuts)   {fEventCuts    = cuts;}
    void                SetMixPrintRefresh(Int_t n)        {fMixPrintRefresh = n;}
+   void                SetMixCacheSize(Int_t n)           {fMixCacheSize = n;}
    void                SetCheckDecay(Bool_t checkDecay = kTRUE) {fCheckDecay = checkDecay;}
    void                SetMaxNDaughters(Short_t n)        {fMaxNDaughters = n;}
    void                SetCheckMomentumConservation(Bool_t checkP) {fCheckP = checkP;}
@@ -115,6 +118,10 @@ private:
    void     FillTrueMotherAOD(AliRsnMiniEvent *event);
    void     StoreTrueMother(AliRsnMiniPair *pair, AliRsnMiniEvent *event);
    Bool_t   EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEvent *event2);
+   Bool_t   KeysMatch(Float_t vz1, Float_t mult1, Float_t angle1, Float_t vz2, Float_t mult2, Float_t angle2) const;
+   void     FindMixingPartners(const std::vector<Float_t> &vz, const std::vector<Float_t> &mult, const std::vector<Float_t> &angle,
+                               std::vector< std::vector<Int_t> > &matched, Int_t printNum);
+   void     FillMixing(const std::vector< std::vector<Int_t> > &matched, Int_t printNum);
    AliQnCorrectionsQnVector * GetQnVectorFromList(const TList *list, const char *subdetector, const char *expectedstep) const;
 
    Bool_t               fUseMC;           ///<  use or not MC info
@@ -156,6 +163,7 @@ private:
    AliRsnMiniEvent     *fMiniEvent;       ///< mini-event cursor
    Bool_t               fBigOutput;       ///< flag if open file for output list
    Int_t                fMixPrintRefresh; ///< how often info in mixing part is printed
+   Int_t                fMixCacheSize;    ///< max number of buffered events kept in memory by the mixing pass
    Bool_t               fCheckDecay;      ///< check if the mother decayed via the requested channel
    Short_t              fMaxNDaughters;   ///< maximum number of allowed mother's daughter
    Bool_t               fCheckP;          ///< flag to set in order to check the momentum conservation for mothers
@@ -175,7 +183,7 @@ private:
    TObjArray            fResonanceFinders;  ///< list of AliRsnMiniResonanceFinder objects
 
 /// \cond CLASSIMP
-   ClassDef(AliRsnMiniAnalysisTask, 20);     
+   ClassDef(AliRsnMiniAnalysisTask, 21);     
 /// \endcond
 };
 
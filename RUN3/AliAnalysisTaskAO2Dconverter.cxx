@@ -21,6 +21,14 @@
 #include <TChain.h>
 #include <TTree.h>
 #include <TMath.h>
+#include <TROOT.h>
+#include <TBranch.h>
+#include <TLeaf.h>
+#include <TRegexp.h>
+#include <TObjString.h>
+#include <RZip.h>
+#include <chrono>
+#include <cstring>
 #include "AliAnalysisTask.h"
 #include "AliAnalysisManager.h"
 #include "AliESDEvent.h"
@@ -79,6 +87,22 @@ ULong64_t GetEventIdAsLong(AliVHeader *header)
   return id;
 }
 
+// Number of values accumulated per column before estimating the compressed size
+const size_t kPrecisionBlock = 8192;
+
+Int_t ZippedSize(const std::vector<Float_t>& values, Int_t compress)
+{
+  // Compressed size of a block of values with the given settings
+  Int_t srcsize = values.size() * sizeof(Float_t);
+  if (srcsize == 0)
+    return 0;
+  std::vector<char> target(srcsize + 512);
+  Int_t tgtsize = target.size();
+  Int_t nout = 0;
+  R__zip(compress, &srcsize, (char*)values.data(), &tgtsize, target.data(), &nout);
+  return (nout > 0 && nout < srcsize) ? nout : srcsize; // the basket is stored as is if it does not compress
+}
+
 } // namespace
 
 AliAnalysisTaskAO2Dconverter::AliAnalysisTaskAO2Dconverter(const char* name)
@@ -109,6 +133,13 @@ const TClass* AliAnalysisTaskAO2Dconverter::Generator[kGenerators] = { AliGenEve
 TTree* AliAnalysisTaskAO2Dconverter::CreateTree(TreeIndex t)
 {
   fTree[t] = new TTree(TreeName[t], TreeTitle[t]);
+  if (fImplicitMTCompression) {
+    // Each table is flushed on its own when it has buffered fWriterBufferSize bytes,
+    // the baskets of all its branches are then compressed in parallel by ROOT implicit MT
+    fTree[t]->SetAutoFlush(-fWriterBufferSize);
+    fTree[t]->SetImplicitMT(kTRUE);
+  } else
+    fTree[t]->SetAutoFlush(fNumberOfEventsPerCluster);
   // if (fTreeStatus[t])
   //   fTree[t]->Branch("fGlobalBC", &vtx.fGlobalBC, "fGlobalBC/l"); // Branch common to all trees
   return fTree[t];
@@ -125,7 +156,11 @@ void AliAnalysisTaskAO2Dconverter::FillTree(TreeIndex t)
 {
   if (!fTreeStatus[t])
     return;
+  for (auto& column : fTruncatedColumns[t])
+    TruncateColumn(column);
+  auto start = std::chrono::steady_clock::now();
   fTree[t]->Fill();
+  fWriterTime[t] += std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
 }
 
 void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
@@ -139,6 +174,18 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
     break;
   }
 
+  if (fImplicitMTCompression) {
+#ifdef R__USE_IMT
+    if (!ROOT::IsImplicitMTEnabled())
+      ROOT::EnableImplicitMT(fCompressionThreads);
+    AliInfo(Form("Implicit MT compression with %u threads, %lld bytes buffered per table", ROOT::GetImplicitMTPoolSize(), fWriterBufferSize));
+#else
+    AliWarning("ROOT built without implicit MT support, the baskets will be compressed serially");
+#endif
+  }
+  for (Int_t i = 0; i < kTrees; i++)
+    fWriterTime[i] = 0;
+
   // Reset the offsets
   fOffsetMuTrackID = 0;
   fOffsetTrackID = 0;
@@ -150,7 +197,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associate branches for fEventTree
   TTree* tEvents = CreateTree(kEvents);
-  tEvents->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kEvents]) {
     TString sstart = TString::Format("fStart[%d]/I", kTrees);
     TString sentries = TString::Format("fNentries[%d]/I", kTrees);
@@ -177,7 +223,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associate branches for fEventTree
   TTree* tTrigger = CreateTree(kTrigger);
-  tTrigger->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kTrigger]) {
     tTrigger->Branch("fGlobalBC", &trigger.fGlobalBC, "fGlobalBC/l");
     tTrigger->Branch("fTriggerMask", &trigger.fTriggerMask, "fTriggerMask/l");
@@ -187,7 +232,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   
   // Associate branches for fTrackTree
   TTree* tTracks = CreateTree(kTracks);
-  tTracks->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kTracks]) {
     tTracks->Branch("fCollisionsID", &tracks.fCollisionsID, "fCollisionsID/I");
 //    tTracks->Branch("fTOFclsIndex", &tracks.fTOFclsIndex, "fTOFclsIndex/I");
@@ -235,7 +279,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associate branches for Calo
   TTree* tCalo = CreateTree(kCalo);
-  tCalo->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kCalo]) {
     tCalo->Branch("fCollisionsID", &calo.fCollisionsID, "fCollisionsID/I");
     tCalo->Branch("fCellNumber", &calo.fCellNumber, "fCellNumber/S");
@@ -247,7 +290,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   PostTree(kCalo);
 
   TTree *tCaloTrigger = CreateTree(kCaloTrigger);
-  tCaloTrigger->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kCaloTrigger]) {
     tCaloTrigger->Branch("fCollisionsID", &calotrigger.fCollisionsID, "fCollisionsID/I");
     tCaloTrigger->Branch("fFastOrAbsID", &calotrigger.fFastorAbsID, "fFastorAbsID/S");
@@ -261,7 +303,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associuate branches for MUON tracks
   TTree* tMuon = CreateTree(kMuon);
-  tMuon->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kMuon]) {
     tMuon->Branch("fCollisionsID", &muons.fCollisionsID, "fCollisionsID/I");
 //    tMuon->Branch("fClusterIndex", &muons.fClusterIndex, "fClusterIndex/I");
@@ -280,7 +321,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associate branches for MUON tracks
   TTree* tMuonCls = CreateTree(kMuonCls);
-  tMuonCls->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kMuonCls]) {
     tMuonCls->Branch("fMuonsID",&mucls.fMuonsID,"fMuonsID/I");
     tMuonCls->Branch("fX",&mucls.fX,"fX/F");
@@ -295,7 +335,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associuate branches for ZDC
   TTree* tZdc = CreateTree(kZdc);
-  tZdc->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kZdc]) {
     tZdc->Branch("fCollisionsID", &zdc.fCollisionsID, "fCollisionsID/I");
     tZdc->Branch("fZEM1Energy", &zdc.fZEM1Energy, "fZEM1Energy/F");
@@ -315,7 +354,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associuate branches for VZERO
   TTree* tVzero = CreateTree(kVzero);
-  tVzero->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kVzero]) {
     tVzero->Branch("fCollisionsID", &vzero.fCollisionsID, "fCollisionsID/I");
     tVzero->Branch("fAdc", vzero.fAdc, "fAdc[64]/F");
@@ -326,7 +364,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associuate branches for V0s
   TTree* tV0s = CreateTree(kV0s);
-  tV0s->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kV0s]) {
     tV0s->Branch("fPosTrackID", &v0s.fPosTrackID, "fPosTrackID/I");
     tV0s->Branch("fNegTrackID", &v0s.fNegTrackID, "fNegTrackID/I");
@@ -335,7 +372,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   // Associuate branches for cascades
   TTree* tCascades = CreateTree(kCascades);
-  tCascades->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kCascades]) {
     tCascades->Branch("fV0sID", &cascs.fV0sID, "fV0sID/I");
     tCascades->Branch("fTracksID", &cascs.fTracksID, "fTracksID/I");
@@ -345,7 +381,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 #ifdef USE_TOF_CLUST
   // Associate branches for TOF
   TTree* TOF = CreateTree(kTOF);
-  TOF->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kTOF]) {
     TOF->Branch("fTOFChannel", &tofClusters.fTOFChannel, "fTOFChannel/I");
     TOF->Branch("fTOFncls", &tofClusters.fTOFncls, "fTOFncls/S");
@@ -358,7 +393,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
   if (fTaskMode == kMC) {
     TTree * tMCvtx = CreateTree(kMCvtx);
-    tMCvtx->SetAutoFlush(fNumberOfEventsPerCluster);
     if(fTreeStatus[kMCvtx]) {
       tMCvtx->Branch("fGeneratorsID", &mcvtx.fGeneratorsID, "fGeneratorsID/S");
       tMCvtx->Branch("fX", &mcvtx.fX, "fX/F");
@@ -372,7 +406,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
     // Associate branches for Kinematics
     TTree* Kinematics = CreateTree(kKinematics);
-    Kinematics->SetAutoFlush(fNumberOfEventsPerCluster);
     if (fTreeStatus[kMC]) {
       Kinematics->Branch("fCollisionsID", &mcparticle.fCollisionsID, "fCollisionsID/I");
 
@@ -396,7 +429,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
     // Range for the MC labels of each reconstructed track
     TTree* tRange = CreateTree(kRange);
-    tRange->SetAutoFlush(fNumberOfEventsPerCluster);
     if (fTreeStatus[kRange]) {
       tRange->Branch("fRange", &range.fRange, "fRange/i");
       FillTree(kRange); // Put the begin of the first range to 0
@@ -405,7 +437,6 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
     
     // MC labels of each reconstructed track
     TTree* tLabels = CreateTree(kLabels);
-    tLabels->SetAutoFlush(fNumberOfEventsPerCluster);
     if (fTreeStatus[kLabels]) {
       tLabels->Branch("fLabel", &labels.fLabel, "fLabel/I");
     }
@@ -414,6 +445,7 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
 
   Prune(); //Removing all unwanted branches (if any)
+  ApplyOutputSettings(); // Compression and precision of the remaining branches
 }
 
 void AliAnalysisTaskAO2Dconverter::Prune()
@@ -439,6 +471,121 @@ void AliAnalysisTaskAO2Dconverter::Prune()
   fPruneList = "";
 }
 
+void AliAnalysisTaskAO2Dconverter::ApplyOutputSettings()
+{
+  // Per-table compression
+  for (Int_t i = 0; i < kTrees; i++) {
+    if (!fTree[i] || fCompression[i] <= 0)
+      continue;
+    TObjArray* branches = fTree[i]->GetListOfBranches();
+    for (Int_t k = 0; k < branches->GetEntries(); k++)
+      ((TBranch*)branches->At(k))->SetCompressionSettings(fCompression[i]);
+  }
+
+  // Precision policy: resolve the columns once, they are truncated at each fill
+  for (Int_t i = 0; i < kTrees; i++)
+    fTruncatedColumns[i].clear();
+  if (fPrecisionPolicy.IsNull() || fPrecisionPolicy.IsWhitespace())
+    return;
+  TObjArray* arr = fPrecisionPolicy.Tokenize(" ");
+  for (Int_t i = 0; i < arr->GetEntries(); i++) {
+    TString rule = arr->At(i)->GetName();
+    Int_t slash = rule.First('/');
+    Int_t colon = rule.Last(':');
+    if (slash < 1 || colon < slash + 2)
+      AliFatal(Form("Wrong precision rule %s, expected table/column:bits", rule.Data()));
+    TString table = rule(0, slash);
+    TString pattern = rule(slash + 1, colon - slash - 1);
+    Int_t bits = TString(rule(colon + 1, rule.Length())).Atoi();
+    if (bits < 1 || bits > 22)
+      AliFatal(Form("Wrong number of mantissa bits in %s, expected 1-22", rule.Data()));
+    TRegexp re(pattern, kTRUE);
+
+    Bool_t found = kFALSE;
+    for (Int_t j = 0; j < kTrees; j++) {
+      if (!fTree[j] || !fTreeStatus[j] || !TreeName[j].EqualTo(table))
+        continue;
+      TObjArray* branches = fTree[j]->GetListOfBranches();
+      for (Int_t k = 0; k < branches->GetEntries(); k++) {
+        TBranch* branch = (TBranch*)branches->At(k);
+        TString bname = branch->GetName();
+        Ssiz_t len = 0;
+        if (bname.Index(re, &len) != 0 || len != bname.Length())
+          continue;
+        found = kTRUE;
+        if (!fTree[j]->GetBranchStatus(bname))
+          continue; // pruned
+        TLeaf* leaf = branch->GetLeaf(bname);
+        if (!leaf || strcmp(leaf->GetTypeName(), "Float_t") != 0) {
+          AliWarning(Form("Column %s/%s is not Float_t, precision rule ignored", table.Data(), bname.Data()));
+          continue;
+        }
+        // A later rule overrides an earlier one for the same column
+        TruncatedColumn* column = nullptr;
+        for (auto& c : fTruncatedColumns[j])
+          if (c.fAddress == (Float_t*)leaf->GetValuePointer())
+            column = &c;
+        if (!column) {
+          fTruncatedColumns[j].emplace_back();
+          column = &fTruncatedColumns[j].back();
+        }
+        column->fName = table + "/" + bname;
+        column->fAddress = (Float_t*)leaf->GetValuePointer();
+        column->fLength = leaf->GetLen();
+        column->fBits = bits;
+        column->fMask = ~((1u << (23 - bits)) - 1u);
+        column->fRound = 1u << (22 - bits);
+        column->fCompress = branch->GetCompressionSettings();
+      }
+    }
+    if (!found)
+      AliWarning(Form("Did not find column %s/%s, precision rule ignored (default precision kept)", table.Data(), pattern.Data()));
+  }
+  delete arr;
+}
+
+void AliAnalysisTaskAO2Dconverter::TruncateColumn(TruncatedColumn& c)
+{
+  // Round the mantissa to the kept bits. Inf and NaN are left untouched
+  for (Int_t i = 0; i < c.fLength; i++) {
+    if (fPrecisionReport)
+      c.fFull.push_back(c.fAddress[i]);
+    UInt_t u;
+    memcpy(&u, &c.fAddress[i], sizeof(u));
+    if ((u & 0x7f800000u) != 0x7f800000u) {
+      u = (u + c.fRound) & c.fMask;
+      memcpy(&c.fAddress[i], &u, sizeof(u));
+    }
+    if (fPrecisionReport)
+      c.fTruncated.push_back(c.fAddress[i]);
+  }
+  c.fBytes += c.fLength * sizeof(Float_t);
+  if (c.fFull.size() >= kPrecisionBlock)
+    CompressColumnBlock(c);
+}
+
+void AliAnalysisTaskAO2Dconverter::CompressColumnBlock(TruncatedColumn& c)
+{
+  c.fZipBytesFull += ZippedSize(c.fFull, c.fCompress);
+  c.fZipBytesTruncated += ZippedSize(c.fTruncated, c.fCompress);
+  c.fFull.clear();
+  c.fTruncated.clear();
+}
+
+void AliAnalysisTaskAO2Dconverter::PrintPrecisionReport() const
+{
+  // Print the estimated size saved by the truncation of each column.
+  // The blocks are compressed with the settings of the table, without the ROOT serialisation
+  Printf("AO2D precision report%s", fPrecisionReport ? "" : " (size estimate not enabled, see SetPrecisionReport)");
+  Printf("  %-28s %5s %14s %16s %16s %8s", "Column", "Bits", "Bytes", "Zipped (full)", "Zipped (trunc)", "Saved");
+  for (Int_t i = 0; i < kTrees; i++) {
+    for (const auto& c : fTruncatedColumns[i]) {
+      Printf("  %-28s %5d %14lld %16lld %16lld %7.1f%%", c.fName.Data(), c.fBits, c.fBytes, c.fZipBytesFull, c.fZipBytesTruncated,
+             c.fZipBytesFull > 0 ? 100. * (c.fZipBytesFull - c.fZipBytesTruncated) / c.fZipBytesFull : 0.);
+    }
+  }
+}
+
 void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
 {
   // Initialisation
@@ -996,10 +1143,61 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   fOffsetV0ID += nv0;
 }
 
+void AliAnalysisTaskAO2Dconverter::FinishTaskOutput()
+{
+  // Flush the baskets still in memory (compressed by implicit MT if requested) and collect
+  // the writer statistics before the trees are written by the manager
+  for (Int_t i = 0; i < kTrees; i++) {
+    if (!fTreeStatus[i] || !fTree[i])
+      continue;
+    auto start = std::chrono::steady_clock::now();
+    fTree[i]->FlushBaskets();
+    fWriterTime[i] += std::chrono::duration<Double_t>(std::chrono::steady_clock::now() - start).count();
+    fWriterEntries[i] = fTree[i]->GetEntries();
+    fWriterTotBytes[i] = fTree[i]->GetTotBytes();
+    fWriterZipBytes[i] = fTree[i]->GetZipBytes();
+    for (auto& column : fTruncatedColumns[i])
+      CompressColumnBlock(column);
+  }
+}
+
+void AliAnalysisTaskAO2Dconverter::PrintWriterReport() const
+{
+  // Print the size and writing time of each table
+  Printf("AO2D writer report (%s mode)", fImplicitMTCompression ? "implicit MT compression" : "serial");
+  Printf("  %-16s %12s %14s %14s %8s %10s %10s", "Table", "Entries", "Bytes", "Zipped bytes", "Ratio", "Time (s)", "MB/s");
+  Long64_t totBytes = 0, zipBytes = 0;
+  Double_t time = 0;
+  for (Int_t i = 0; i < kTrees; i++) {
+    if (!fTreeStatus[i] || fWriterEntries[i] == 0)
+      continue;
+    Printf("  %-16s %12lld %14lld %14lld %8.2f %10.3f %10.1f", TreeName[i].Data(), fWriterEntries[i], fWriterTotBytes[i], fWriterZipBytes[i],
+           fWriterZipBytes[i] > 0 ? (Double_t)fWriterTotBytes[i] / fWriterZipBytes[i] : 0., fWriterTime[i],
+           fWriterTime[i] > 0 ? fWriterTotBytes[i] / fWriterTime[i] / 1.e6 : 0.);
+    totBytes += fWriterTotBytes[i];
+    zipBytes += fWriterZipBytes[i];
+    time += fWriterTime[i];
+  }
+  Printf("  %-16s %12s %14lld %14lld %8.2f %10.3f %10.1f", "Total", "", totBytes, zipBytes,
+         zipBytes > 0 ? (Double_t)totBytes / zipBytes : 0., time, time > 0 ? totBytes / time / 1.e6 : 0.);
+}
+
 void AliAnalysisTaskAO2Dconverter::Terminate(Option_t *)
 {
   // terminate
   // called at the END of the analysis (when all events are processed)
+
+  // The writer statistics are only available when the task ran in this process (local mode)
+  Long64_t entries = 0;
+  for (Int_t i = 0; i < kTrees; i++)
+    entries += fWriterEntries[i];
+  if (entries > 0)
+    PrintWriterReport();
+  Bool_t truncated = kFALSE;
+  for (Int_t i = 0; i < kTrees; i++)
+    truncated = truncated || !fTruncatedColumns[i].empty();
+  if (truncated)
+    PrintPrecisionReport();
 }
 
 AliAnalysisTaskAO2Dconverter *AliAnalysisTaskAO2Dconverter::AddTask(TString suffix)
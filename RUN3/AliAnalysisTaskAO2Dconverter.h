@@ -10,6 +10,7 @@
 #include "AliEventCuts.h"
 
 #include <TString.h>
+#include <vector>
 
 #include "TClass.h"
 
@@ -32,9 +33,22 @@ public:
 
   virtual void UserCreateOutputObjects();
   virtual void UserExec(Option_t *option);
+  virtual void FinishTaskOutput();
   virtual void Terminate(Option_t *option);
 
   void SetNumberOfEventsPerCluster(int n) { fNumberOfEventsPerCluster = n; }
+  // Implicit MT compression: the tables are still filled and written one after the other on
+  // the calling thread, but each table is flushed when it has buffered bufferSize bytes and
+  // the baskets of its branches are then compressed in parallel by ROOT implicit MT
+  // (nThreads=0: all cores). There is no separate writer per table
+  void SetImplicitMTCompression(Bool_t imt = kTRUE, UInt_t nThreads = 0, Long64_t bufferSize = 32000000)
+  {
+    fImplicitMTCompression = imt;
+    fCompressionThreads = nThreads;
+    fWriterBufferSize = bufferSize;
+  }
+  Bool_t GetImplicitMTCompression() const { return fImplicitMTCompression; }
+  void PrintWriterReport() const;
 
   static AliAnalysisTaskAO2Dconverter* AddTask(TString suffix = "");
   enum TreeIndex { // Index of the output trees
@@ -85,6 +99,15 @@ public:
   static const TString TreeTitle[kTrees]; //! Titles of the TTree containers
 
   void Prune(TString p) { fPruneList = p; }; // Setter of the pruning list
+  // Precision policy: space separated list of table/column:bits, e.g. "O2tracks/fC[YZST1]*:10 O2tracks/fTOFsignal:16".
+  // The mantissa of the matching Float_t columns is rounded to the given number of bits (1-22) at fill time,
+  // a rule matching no column is ignored with a warning
+  void SetPrecisionPolicy(TString p) { fPrecisionPolicy = p; };
+  void SetPrecisionReport(Bool_t report = kTRUE) { fPrecisionReport = report; }; // Estimate the size saved per truncated column
+  // Compression settings (algorithm*100+level as in TFile, 0: output file settings) of one or all tables
+  void SetCompression(TreeIndex t, Int_t settings) { fCompression[t] = settings; };
+  void SetCompression(Int_t settings) { for (Int_t i = 0; i < kTrees; i++) fCompression[i] = settings; };
+  void PrintPrecisionReport() const;
   void SetMCMode() { fTaskMode = kMC; };     // Setter of the MC running mode
 
   AliAnalysisFilter fTrackFilter; // Standard track filter object
@@ -100,11 +123,44 @@ private:
   TTree* fTree[kTrees] = { nullptr }; //! Array with all the output trees
   void Prune();                       // Function to perform tree pruning
   void FillTree(TreeIndex t);         // Function to fill the trees (only the active ones)
+  void ApplyOutputSettings();         // Function to set the compression and resolve the precision policy
 
   // Task configuration variables
   TString fPruneList = "";                // Names of the branches that will not be saved to output file
   Bool_t fTreeStatus[kTrees] = { kTRUE }; // Status of the trees i.e. kTRUE (enabled) or kFALSE (disabled)
   int fNumberOfEventsPerCluster = 1000;   // Maximum basket size of the trees
+  Bool_t fImplicitMTCompression = kFALSE; // Compress the baskets of each table on the ROOT implicit MT pool
+  UInt_t fCompressionThreads = 0;         // Number of threads of the implicit MT pool (0: all cores)
+  Long64_t fWriterBufferSize = 32000000;  // Bytes buffered per table before flushing with implicit MT compression
+
+  // Writer statistics
+  Double_t fWriterTime[kTrees] = { 0 };   //! Time spent in filling and flushing each tree (s)
+  Long64_t fWriterEntries[kTrees] = { 0 }; //! Number of entries of each tree at the end of the task
+  Long64_t fWriterTotBytes[kTrees] = { 0 }; //! Uncompressed size of each tree at the end of the task
+  Long64_t fWriterZipBytes[kTrees] = { 0 }; //! Compressed size of each tree at the end of the task
+
+  // Output precision and compression
+  TString fPrecisionPolicy = "";          // Number of mantissa bits kept for the Float_t columns (table/column:bits)
+  Bool_t fPrecisionReport = kFALSE;       // Estimate the size saved by the truncation of each column
+  Int_t fCompression[kTrees] = { 0 };     // Compression settings of each table (0: output file settings)
+
+  struct TruncatedColumn {
+    TString fName;                  /// table/column
+    Float_t *fAddress = nullptr;    /// Address of the first value of the column
+    Int_t fLength = 1;              /// Number of values per entry
+    Int_t fBits = 23;               /// Number of mantissa bits kept
+    UInt_t fMask = ~0u;             /// Mask of the kept bits
+    UInt_t fRound = 0u;             /// Half of the last kept bit, added before masking
+    Int_t fCompress = 0;            /// Compression settings used for the size estimate
+    Long64_t fBytes = 0;            /// Uncompressed bytes
+    Long64_t fZipBytesFull = 0;     /// Estimated compressed bytes at full precision
+    Long64_t fZipBytesTruncated = 0; /// Estimated compressed bytes after the truncation
+    std::vector<Float_t> fFull;      /// Block of values at full precision for the size estimate
+    std::vector<Float_t> fTruncated; /// Block of truncated values for the size estimate
+  };
+  std::vector<TruncatedColumn> fTruncatedColumns[kTrees]; //! Columns truncated at fill time for each table
+  void TruncateColumn(TruncatedColumn &c);        // Round the mantissa of the current values of a column
+  static void CompressColumnBlock(TruncatedColumn &c); // Add the compressed size of the accumulated blocks
 
   TaskModes fTaskMode = kStandard; // Running mode of the task. Useful to set for e.g. MC mode
 
@@ -393,7 +449,7 @@ private:
   Int_t fOffsetV0ID = 0;      ///! Offset of track IDs (used in cascades)
   Int_t fOffsetLabel = 0;      ///! Offset of track IDs (used in cascades)
 
-  ClassDef(AliAnalysisTaskAO2Dconverter, 7);
+  ClassDef(AliAnalysisTaskAO2Dconverter, 10);
 };
 
 #endif